@@ -124,66 +124,69 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
         double layer_thickness = lay->thickness();
         string layer_type_name   = _toString(layerType,"layerType%d");
 
-        // Loop over repeats for this layer.
-        for (int j = 0; j < repeat; j++) {
-            string layer_name = _toString(layer_num, "layer%d");
-            DetElement layer(layer_name, layer_num);
-
-            // Layer box & volume
-            Volume layer_vol(layer_type_name, Box(cal_hx, cal_hy, layer_thickness / 2), air);
-            
-            // Create the slices (sublayers) within the layer.
-            double slice_pos_z = -(layer_thickness / 2);
-            int slice_number = 0;
-            
-            for (xml_coll_t k(x_layer, _U(slice)); k; ++k) {
-                xml_comp_t x_slice = k;
-                string slice_name = _toString(slice_number, "slice%d");
-                double slice_thickness = x_slice.thickness();
-                Material slice_material = theDetector.material(x_slice.materialStr());
-                DetElement slice(layer, slice_name, slice_number);
-
-                slice_pos_z += slice_thickness / 2;
-                // Slice volume & box
-                Volume slice_vol(slice_name, Box(cal_hx, cal_hy, slice_thickness / 2), slice_material);
-                
-                
-                if (x_slice.isSensitive()) {
-                    sens.setType("calorimeter");
-                    slice_vol.setSensitiveDetector(sens);                   
-                } 
-
-                
-                // Set region, limitset, and vis.
-                slice_vol.setAttributes(theDetector, x_slice.regionStr(), x_slice.limitsStr(), x_slice.visStr());
-                // slice PlacedVolume
-                PlacedVolume slice_phv = layer_vol.placeVolume(slice_vol, Position(0, 0, slice_pos_z));
-                slice_phv.addPhysVolID("slice", slice_number);
-                slice.setPlacement(slice_phv);
-
-                // Increment Z position for next slice.
-                slice_pos_z += slice_thickness / 2;
-                // Increment slice number.
-                ++slice_number;
+        // All repeats of this layer type are identical apart from their IDs: the layer volume
+        // with its slices is built once and placed repeat times.
+        DetElement layer_det(_toString(layer_num, "layer%d"), layer_num);
+
+        // Layer box & volume
+        Volume layer_vol(layer_type_name, Box(cal_hx, cal_hy, layer_thickness / 2), air);
+
+        // Create the slices (sublayers) within the layer.
+        double slice_pos_z = -(layer_thickness / 2);
+        int slice_number = 0;
+
+        for (xml_coll_t k(x_layer, _U(slice)); k; ++k) {
+            xml_comp_t x_slice = k;
+            string slice_name = _toString(slice_number, "slice%d");
+            double slice_thickness = x_slice.thickness();
+            Material slice_material = theDetector.material(x_slice.materialStr());
+            DetElement slice(layer_det, slice_name, slice_number);
+
+            slice_pos_z += slice_thickness / 2;
+            // Slice volume & box
+            Volume slice_vol(slice_name, Box(cal_hx, cal_hy, slice_thickness / 2), slice_material);
+
+
+            if (x_slice.isSensitive()) {
+                sens.setType("calorimeter");
+                slice_vol.setSensitiveDetector(sens);
             }
-            
-            
+
+
             // Set region, limitset, and vis.
-            layer_vol.setAttributes(theDetector, x_layer.regionStr(), x_layer.limitsStr(), x_layer.visStr());
-           
+            slice_vol.setAttributes(theDetector, x_slice.regionStr(), x_slice.limitsStr(), x_slice.visStr());
+            // slice PlacedVolume
+            PlacedVolume slice_phv = layer_vol.placeVolume(slice_vol, Position(0, 0, slice_pos_z));
+            slice_phv.addPhysVolID("slice", slice_number);
+            slice.setPlacement(slice_phv);
+
+            // Increment Z position for next slice.
+            slice_pos_z += slice_thickness / 2;
+            // Increment slice number.
+            ++slice_number;
+        }
+
+        // Set region, limitset, and vis.
+        layer_vol.setAttributes(theDetector, x_layer.regionStr(), x_layer.limitsStr(), x_layer.visStr());
+
+        // Loop over repeats for this layer.
+        for (int j = 0; j < repeat; j++) {
+            // the other repeats are clones of the first one, with the slices
+            DetElement layer = j == 0 ? layer_det : layer_det.clone(_toString(layer_num, "layer%d"), layer_num);
+
             // Layer position in Z within the stave.
             layer_pos_z += layer_thickness / 2;
             // Layer physical volume.
             PlacedVolume layer_phv = envelope.placeVolume(layer_vol, Position(0, 0, layer_pos_z));
             layer_phv.addPhysVolID(identifierLayer, layer_num);
             layer.setPlacement(layer_phv);
-            
+
             // Increment the layer Z position.
             layer_pos_z += layer_thickness / 2;
             // Increment the layer number.
             ++layer_num;
         }
-        
+
         ++layerType;
     }
 
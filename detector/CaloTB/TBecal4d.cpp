@@ -114,65 +114,68 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
       double layer_thickness = lay->thickness();
       string layer_type_name   = _toString(layerType,"layerType%d");
 
-      // Loop over repeats for this layer.
-      for (int j = 0; j < repeat; j++) 
+      // All repeats of this layer type are identical apart from their IDs:
+      // the layer volume with its slices is built once and placed repeat times.
+
+      // Layer box & volume
+      Volume layer_vol(layer_type_name, Box(cal_hx*4, cal_hy*8, layer_thickness / 2), air);
+
+      // Create the slices (sublayers) within the layer.
+      double slice_pos_z = -(layer_thickness / 2);
+      int slice_number = 0;
+
+      for (xml_coll_t k(x_layer, _U(slice)); k; ++k)
 	{
-	  string layer_name = _toString(layer_num, "layer%d");
-	  DetElement layer(layer_name, layer_num);
+	  xml_comp_t x_slice = k;
+	  string slice_name = _toString(slice_number, "slice%d");
+	  double slice_thickness = x_slice.thickness();
+	  Material slice_material = theDetector.material(x_slice.materialStr());
+
+	  slice_pos_z += slice_thickness / 2;
 
-	  // Layer box & volume
-	  Volume layer_vol(layer_type_name, Box(cal_hx*4, cal_hy*8, layer_thickness / 2), air);
-            
-	  // Create the slices (sublayers) within the layer.
-	  double slice_pos_z = -(layer_thickness / 2);
-	  int slice_number = 0;
-            
-	  for (xml_coll_t k(x_layer, _U(slice)); k; ++k) 
+	  //Case of absorber make it bigger than the actual layer (*4 for EBU)
+	  if(slice_number == 0)
 	    {
-	      xml_comp_t x_slice = k;
-	      string slice_name = _toString(slice_number, "slice%d");
-	      double slice_thickness = x_slice.thickness();
-	      Material slice_material = theDetector.material(x_slice.materialStr());
-                
-	      slice_pos_z += slice_thickness / 2;
-
-	      //Case of absorber make it bigger than the actual layer (*4 for EBU)
-	      if(slice_number == 0)
-		{
-		  // Slice volume & box
-		  Volume slice_vol(slice_name, Box(cal_hx*4, cal_hy*8, slice_thickness / 2), slice_material);
+	      // Slice volume & box
+	      Volume slice_vol(slice_name, Box(cal_hx*4, cal_hy*8, slice_thickness / 2), slice_material);
 
-		  // Set region, limitset, and vis.
-		  slice_vol.setAttributes(theDetector, x_slice.regionStr(), x_slice.limitsStr(), x_slice.visStr());
-		  // slice PlacedVolume
-		  layer_vol.placeVolume(slice_vol, Position(0, 0, slice_pos_z));
-		}
-	      else
+	      // Set region, limitset, and vis.
+	      slice_vol.setAttributes(theDetector, x_slice.regionStr(), x_slice.limitsStr(), x_slice.visStr());
+	      // slice PlacedVolume
+	      layer_vol.placeVolume(slice_vol, Position(0, 0, slice_pos_z));
+	    }
+	  else
+	    {
+	      // Slice volume & box
+	      Volume slice_vol(slice_name, Box(cal_hx, cal_hy, slice_thickness / 2), slice_material);
+
+	      if (x_slice.isSensitive())
 		{
-		  // Slice volume & box
-		  Volume slice_vol(slice_name, Box(cal_hx, cal_hy, slice_thickness / 2), slice_material);
-                
-		  if (x_slice.isSensitive()) 
-		    {
-		      sens.setType("calorimeter");
-		      slice_vol.setSensitiveDetector(sens);                   
-		    } 
-
-		  // Set region, limitset, and vis.
-		  slice_vol.setAttributes(theDetector, x_slice.regionStr(), x_slice.limitsStr(), x_slice.visStr());
-		  // slice PlacedVolume
-		  layer_vol.placeVolume(slice_vol, Position(0, 0, slice_pos_z));
-                }
-
-	      // Increment Z position for next slice.
-	      slice_pos_z += slice_thickness / 2;
-	      // Increment slice number.
-	      ++slice_number;
+		  sens.setType("calorimeter");
+		  slice_vol.setSensitiveDetector(sens);
+		}
+
+	      // Set region, limitset, and vis.
+	      slice_vol.setAttributes(theDetector, x_slice.regionStr(), x_slice.limitsStr(), x_slice.visStr());
+	      // slice PlacedVolume
+	      layer_vol.placeVolume(slice_vol, Position(0, 0, slice_pos_z));
 	    }
-            
-	  // Set region, limitset, and vis.
-	  layer_vol.setAttributes(theDetector, x_layer.regionStr(), x_layer.limitsStr(), x_layer.visStr());
-           
+
+	  // Increment Z position for next slice.
+	  slice_pos_z += slice_thickness / 2;
+	  // Increment slice number.
+	  ++slice_number;
+	}
+
+      // Set region, limitset, and vis.
+      layer_vol.setAttributes(theDetector, x_layer.regionStr(), x_layer.limitsStr(), x_layer.visStr());
+
+      // Loop over repeats for this layer.
+      for (int j = 0; j < repeat; j++)
+	{
+	  string layer_name = _toString(layer_num, "layer%d");
+	  DetElement layer(layer_name, layer_num);
+
 	  // Layer position in Z within the stave.
 	  layer_pos_z += layer_thickness / 2;
 	  // Layer physical volume.
@@ -180,13 +183,13 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 	  //layer_phv.addPhysVolID("layer", layer_num);
 	  layer_phv.addPhysVolID("K", layer_num);
 	  layer.setPlacement(layer_phv);
-            
+
 	  // Increment the layer Z position.
 	  layer_pos_z += layer_thickness / 2;
 	  // Increment the layer number.
 	  ++layer_num;
 	}
-        
+
       ++layerType;
     }
  
@@ -125,143 +125,76 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
       double layer_thickness = lay->thickness();
       string layer_type_name   = _toString(layerType,"layerType%d");
 
-      if(layer_num < HCAL_SSF_nlayers)
+      // All repeats of this layer type are identical apart from their IDs:
+      // the layer volume with its slices is built once and placed repeat times.
+
+      // small (SSF) or big (BL) layers - the layer box is always BL size
+      const bool is_SSF = layer_num < HCAL_SSF_nlayers;
+
+      // Layer box & volume
+      Volume layer_vol(layer_type_name, Box(cal_BL_hx, cal_BL_hy, layer_thickness / 2), air);
+
+      // Create the slices (sublayers) within the layer.
+      double slice_pos_z = -(layer_thickness / 2);
+      int slice_number = 0;
+
+      for (xml_coll_t k(x_layer, _U(slice)); k; ++k)
 	{
-	  // Loop over repeats for this layer.
-	  for (int j = 0; j < repeat; j++) 
+	  xml_comp_t x_slice = k;
+	  string slice_name = _toString(slice_number, "slice%d");
+	  double slice_thickness = x_slice.thickness();
+	  Material slice_material = theDetector.material(x_slice.materialStr());
+
+	  slice_pos_z += slice_thickness / 2;
+
+	  //Case of absorber in the SSF layers make it bigger than the actual layer (*2 for HBU SSF)
+	  const bool is_SSF_absorber = is_SSF && slice_number == 0;
+	  const double slice_hx = ( is_SSF && !is_SSF_absorber ) ? cal_SSF_hx : cal_BL_hx;
+	  const double slice_hy = ( is_SSF && !is_SSF_absorber ) ? cal_SSF_hy : cal_BL_hy;
+
+	  // Slice volume & box
+	  Volume slice_vol(slice_name, Box(slice_hx, slice_hy, slice_thickness / 2), slice_material);
+
+	  if (!is_SSF_absorber && x_slice.isSensitive())
 	    {
-	      string layer_name = _toString(layer_num, "layer%d");
-	      DetElement layer_SSF(layer_name, layer_num);
-
-	      // Layer box & volume
-	      Volume layer_SSF_vol(layer_type_name, Box(cal_BL_hx, cal_BL_hy, layer_thickness / 2), air);
-            
-	      // Create the slices (sublayers) within the layer.
-	      double slice_SSF_pos_z = -(layer_thickness / 2);
-	      int slice_number = 0;
-            
-	      for (xml_coll_t k(x_layer, _U(slice)); k; ++k) 
-		{
-		  xml_comp_t x_slice = k;
-		  string slice_name = _toString(slice_number, "slice%d");
-		  double slice_thickness = x_slice.thickness();
-		  Material slice_material = theDetector.material(x_slice.materialStr());
-                
-		  slice_SSF_pos_z += slice_thickness / 2;
-
-		  //Case of absorber make it bigger than the actual layer (*2 for HBU SSF)
-		  if(slice_number == 0)
-		    {
-		      // Slice volume & box
-		      Volume slice_SSF_vol(slice_name, Box(cal_BL_hx, cal_BL_hy, slice_thickness / 2), slice_material);
-
-		      // Set region, limitset, and vis.
-		      slice_SSF_vol.setAttributes(theDetector, x_slice.regionStr(), x_slice.limitsStr(), x_slice.visStr());
-		      // slice PlacedVolume
-		      layer_SSF_vol.placeVolume(slice_SSF_vol, Position(0, 0, slice_SSF_pos_z));
-		    }
-		  else
-		    {
-		      // Slice volume & box
-		      Volume slice_SSF_vol(slice_name, Box(cal_SSF_hx, cal_SSF_hy, slice_thickness / 2), slice_material);
-
-		      if (x_slice.isSensitive()) 
-			{
-			  sens.setType("calorimeter");
-			  slice_SSF_vol.setSensitiveDetector(sens);                   
-			} 
-
-		      // Set region, limitset, and vis.
-		      slice_SSF_vol.setAttributes(theDetector, x_slice.regionStr(), x_slice.limitsStr(), x_slice.visStr());
-		      // slice PlacedVolume
-		      layer_SSF_vol.placeVolume(slice_SSF_vol, Position(0, 0, slice_SSF_pos_z));
-		    }
-
-		  // Increment Z position for next slice.
-		  slice_SSF_pos_z += slice_thickness / 2;
-		  // Increment slice number.
-		  ++slice_number;
-		}
-            
-	      // Set region, limitset, and vis.
-	      layer_SSF_vol.setAttributes(theDetector, x_layer.regionStr(), x_layer.limitsStr(), x_layer.visStr());
-           
-	      // Layer position in Z within the stave.
-	      layer_pos_z += layer_thickness / 2;
-	      // Layer physical volume.
-	      PlacedVolume layer_SSF_phv = envelope.placeVolume(layer_SSF_vol, Position(0, 0, layer_pos_z));
-	      //layer_phv.addPhysVolID("layer", layer_num);
-	      layer_SSF_phv.addPhysVolID("K", layer_num);
-	      layer_SSF.setPlacement(layer_SSF_phv);
-            
-	      // Increment the layer Z position.
-	      layer_pos_z += layer_thickness / 2;
-	      // Increment the layer number.
-	      ++layer_num;
+	      sens.setType("calorimeter");
+	      slice_vol.setSensitiveDetector(sens);
 	    }
+
+	  // Set region, limitset, and vis.
+	  slice_vol.setAttributes(theDetector, x_slice.regionStr(), x_slice.limitsStr(), x_slice.visStr());
+	  // slice PlacedVolume
+	  layer_vol.placeVolume(slice_vol, Position(0, 0, slice_pos_z));
+
+	  // Increment Z position for next slice.
+	  slice_pos_z += slice_thickness / 2;
+	  // Increment slice number.
+	  ++slice_number;
 	}
-      else
+
+      // Set region, limitset, and vis.
+      layer_vol.setAttributes(theDetector, x_layer.regionStr(), x_layer.limitsStr(), x_layer.visStr());
+
+      // Loop over repeats for this layer.
+      for (int j = 0; j < repeat; j++)
 	{
-	  // Loop over repeats for this layer.
-	  for (int j = 0; j < repeat; j++) 
-	    {
-	      string layer_name = _toString(layer_num, "layer%d");
-	      DetElement layer_BL(layer_name, layer_num);
-
-	      // Layer box & volume
-	      Volume layer_BL_vol(layer_type_name, Box(cal_BL_hx, cal_BL_hy, layer_thickness / 2), air);
-            
-	      // Create the slices (sublayers) within the layer.
-	      double slice_BL_pos_z = -(layer_thickness / 2);
-	      int slice_number = 0;
-            
-	      for (xml_coll_t k(x_layer, _U(slice)); k; ++k) 
-		{
-		  xml_comp_t x_slice = k;
-		  string slice_name = _toString(slice_number, "slice%d");
-		  double slice_thickness = x_slice.thickness();
-		  Material slice_material = theDetector.material(x_slice.materialStr());
-                
-		  slice_BL_pos_z += slice_thickness / 2;
-
-		  // Slice volume & box
-		  Volume slice_BL_vol(slice_name, Box(cal_BL_hx, cal_BL_hy, slice_thickness / 2), slice_material);
-
-		  if (x_slice.isSensitive()) 
-		    {
-		      sens.setType("calorimeter");
-		      slice_BL_vol.setSensitiveDetector(sens);                   
-		    } 
-
-		  // Set region, limitset, and vis.
-		  slice_BL_vol.setAttributes(theDetector, x_slice.regionStr(), x_slice.limitsStr(), x_slice.visStr());
-		  // slice PlacedVolume
-		  layer_BL_vol.placeVolume(slice_BL_vol, Position(0, 0, slice_BL_pos_z));
-
-		  // Increment Z position for next slice.
-		  slice_BL_pos_z += slice_thickness / 2;
-		  // Increment slice number.
-		  ++slice_number;
-		}
-            
-	      // Set region, limitset, and vis.
-	      layer_BL_vol.setAttributes(theDetector, x_layer.regionStr(), x_layer.limitsStr(), x_layer.visStr());
-           
-	      // Layer position in Z within the stave.
-	      layer_pos_z += layer_thickness / 2;
-	      // Layer physical volume.
-	      PlacedVolume layer_BL_phv = envelope.placeVolume(layer_BL_vol, Position(0, 0, layer_pos_z));
-	      //layer_phv.addPhysVolID("layer", layer_num);
-	      layer_BL_phv.addPhysVolID("K", layer_num);
-	      layer_BL.setPlacement(layer_BL_phv);
-            
-	      // Increment the layer Z position.
-	      layer_pos_z += layer_thickness / 2;
-	      // Increment the layer number.
-	      ++layer_num;
-	    }
+	  string layer_name = _toString(layer_num, "layer%d");
+	  DetElement layer(layer_name, layer_num);
+
+	  // Layer position in Z within the stave.
+	  layer_pos_z += layer_thickness / 2;
+	  // Layer physical volume.
+	  PlacedVolume layer_phv = envelope.placeVolume(layer_vol, Position(0, 0, layer_pos_z));
+	  //layer_phv.addPhysVolID("layer", layer_num);
+	  layer_phv.addPhysVolID("K", layer_num);
+	  layer.setPlacement(layer_phv);
+
+	  // Increment the layer Z position.
+	  layer_pos_z += layer_thickness / 2;
+	  // Increment the layer number.
+	  ++layer_num;
 	}
-        
+
       ++layerType;
     }
  
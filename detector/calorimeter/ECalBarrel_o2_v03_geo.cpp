@@ -22,6 +22,7 @@
 #include "XML/Utilities.h"
 #include "DDRec/DetectorData.h"
 #include "DDSegmentation/Segmentation.h"
+#include "DenseCellIndex.h"
 
 using namespace std;
 
@@ -187,6 +188,10 @@ static Ref_t create_detector(Detector& theDetector, xml_h e, SensitiveDetector s
     std::cout << "Module y offset: " << mod_y_off << std::endl;
 #endif
 
+    // the sensitive slices for the dense cell index, the same in all towers and stacks
+    const dd4hep::DDSegmentation::BitFieldCoder& idDecoder = *readout.idSpec().decoder();
+    std::vector<lcgeo::DenseCellIndex::SensitiveArea> sensitiveAreas;
+
     DetElement stave_det("stave0", det_id);    
     for (int t = 0; t < n_towers; t++) {
       double t_pos_y = (t - (n_towers-1)/2)*(2*trd_y1t + towersAirGap);
@@ -264,6 +269,13 @@ static Ref_t create_detector(Detector& theDetector, xml_h e, SensitiveDetector s
 	      
 	      if ( x_slice.isSensitive() ) { // only one per layer
 		s_vol.setSensitiveDetector(sens);
+		if (t == 0 && m == 0) {
+		  lcgeo::DenseCellIndex::SensitiveArea area;
+		  lcgeo::DenseCellIndex::setField(idDecoder, area.volumeID, "layer", l_num);
+		  area.dx = l_dim_xj - tolerance;
+		  area.dy = l_dim_y - tolerance;
+		  sensitiveAreas.push_back(area);
+		}
 		caloLayer.distance = s_pos_z + s_thick/.2 + l_pos_z + l_thickness/2. + mod_y_off - ry;
 		caloLayer.sensitive_thickness       = s_thick ;
 		caloLayer.inner_nRadiationLengths   = nRadiationLengths;
@@ -380,6 +392,14 @@ static Ref_t create_detector(Detector& theDetector, xml_h e, SensitiveDetector s
 
     // Set envelope volume attributes
     envelope.setAttributes(theDetector,x_det.regionStr(),x_det.limitsStr(),x_det.visStr());
+
+    // Dense index of the cellIDs and the cells that exist
+    lcgeo::DenseCellIndex::FieldValues replicated;
+    lcgeo::DenseCellIndex::extend(replicated, "system", det_id);
+    lcgeo::DenseCellIndex::extend(replicated, "module", 0, nsides-1);
+    lcgeo::DenseCellIndex* cellIndex = lcgeo::DenseCellIndex::create(idDecoder, *seg.segmentation(), sensitiveAreas, replicated);
+    sdet.addExtension< lcgeo::DenseCellIndex >( cellIndex ) ;
+    dd4hep::printout(dd4hep::INFO, "ECalBarrel_o2_v03", "%ld readout channels", cellIndex->numberOfChannels());
     
     sdet.addExtension< LayeredCalorimeterData >( caloData ) ;
         
@@ -7,10 +7,12 @@
 //
 //====================================================================
 #include "DD4hep/DetFactoryHelper.h"
+#include "DD4hep/Printout.h"
 #include "XML/Layering.h"
 #include "XML/Utilities.h"
 #include "DDRec/DetectorData.h"
 #include "DDSegmentation/Segmentation.h"
+#include "DenseCellIndex.h"
 
 using namespace std;
 
@@ -153,6 +155,10 @@ static Ref_t create_detector(Detector& theDetector, xml_h e, SensitiveDetector s
   double layer_dim_x = innerFaceLen / 2 - gap * 2;
   int layer_num = 1;
 
+  // the sensitive slices for the dense cell index
+  const dd4hep::DDSegmentation::BitFieldCoder& idDecoder = *readout.idSpec().decoder();
+  std::vector<lcgeo::DenseCellIndex::SensitiveArea> sensitiveAreas;
+
   //#### LayeringExtensionImpl* layeringExtension = new LayeringExtensionImpl();
   //#### Position layerNormal(0,0,1);
       std::cout<<"XXX "<<std::setprecision(8);
@@ -204,6 +210,11 @@ static Ref_t create_detector(Detector& theDetector, xml_h e, SensitiveDetector s
           sens.setType("calorimeter");
           slice_vol.setSensitiveDetector(sens);
           sens_pos = slice_pos_z;
+          lcgeo::DenseCellIndex::SensitiveArea area;
+          lcgeo::DenseCellIndex::setField(idDecoder, area.volumeID, "layer", layer_num);
+          area.dx = layer_dim_x;
+          area.dy = detZ / 2;
+          sensitiveAreas.push_back(area);
 	  th_i += slice_thickness / 2. ;
 	  th_o  = slice_thickness / 2. ;
 	} else {
@@ -268,6 +279,14 @@ static Ref_t create_detector(Detector& theDetector, xml_h e, SensitiveDetector s
   envelopeVol.setAttributes(theDetector, x_det.regionStr(), x_det.limitsStr(), x_det.visStr());
   
 
+  // Dense index of the cellIDs and the cells that exist
+  lcgeo::DenseCellIndex::FieldValues replicated;
+  lcgeo::DenseCellIndex::extend(replicated, "system", x_det.id());
+  lcgeo::DenseCellIndex::extend(replicated, "module", 1, nsides);
+  lcgeo::DenseCellIndex* cellIndex = lcgeo::DenseCellIndex::create(idDecoder, *seg.segmentation(), sensitiveAreas, replicated);
+  sdet.addExtension< lcgeo::DenseCellIndex >( cellIndex ) ;
+  dd4hep::printout(dd4hep::INFO, "HCalBarrel_o1_v01", "%ld readout channels", cellIndex->numberOfChannels());
+
   //FOR NOW, USE A MORE "SIMPLE" VERSION OF EXTENSIONS, INCLUDING NECESSARY GEAR PARAMETERS
   //Copied from Frank's SHcalSc04 Implementation
   sdet.addExtension< LayeredCalorimeterData >( caloData ) ;
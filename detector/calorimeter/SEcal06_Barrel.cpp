@@ -18,6 +18,8 @@
 #include "DDRec/DetectorData.h"
 
 #include "SEcal06_Helpers.h"
+#include "LcgeoBuildMode.h"
+#include "DenseCellIndex.h"
 
 #include <sstream>
 
@@ -262,6 +264,10 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 
   helper.setPlugLength( Ecal_plugLength );
 
+  // in the reconstruction geometry mode only the reco data and the segmentation are set up
+  bool recoGeometryOnly = lcgeo::buildRecoGeometryOnly( theDetector );
+  helper.setBuildVolumes( !recoGeometryOnly );
+
   // check resulting thickness is consistent with what's in compact description
   float module_thickness = helper.getTotalThickness();
   if ( fabs( Ecal_barrel_thickness - module_thickness ) > 0.01 ) {
@@ -353,6 +359,11 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 
   // make the module
 
+  // Geant4 navigation hints from the compact file for the module and the alveoli
+  lcgeo::NavigationHints* navigationHints = new lcgeo::NavigationHints( x_det );
+  if ( !recoGeometryOnly ) navigationHints->tag( "module", mod_vol );
+  helper.setNavigationHints( navigationHints );
+
   helper.makeModule( mod_vol, stave_det,
 		     *caloData,
 		     theDetector, sens );
@@ -380,6 +391,23 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
   caloData->extent[3] = Ecal_Barrel_halfZ ;
   //-------------------------------------------------------
 
+  // dense index of the cellIDs and the cells that exist, e.g. for caching the cell positions in the simulation
+  lcgeo::DenseCellIndex::FieldValues replicated;
+  lcgeo::DenseCellIndex::extend( replicated, "system", det_id );
+  lcgeo::DenseCellIndex::extend( replicated, "module", 1, Ecal_barrel_z_modules );
+  lcgeo::DenseCellIndex::extend( replicated, "stave", 1, nsides );
+  lcgeo::DenseCellIndex* cellIndex = lcgeo::DenseCellIndex::create( *readout.idSpec().decoder(), *seg.segmentation(),
+                                                                    helper.getSensitiveAreas(), replicated );
+  sdet.addExtension< lcgeo::DenseCellIndex >( cellIndex );
+  sdet.addExtension< lcgeo::NavigationHints >( navigationHints );
+  cout << "SEcal06_Barrel : " << cellIndex->numberOfChannels() << " readout channels" << endl;
+
+  if ( recoGeometryOnly ) {
+    cout << "SEcal06_Barrel : reconstruction geometry only - no modules placed" << endl;
+    sdet.addExtension< LayeredCalorimeterData >( caloData ) ;
+    return sdet;
+  }
+
   //====================================================================
   // Place ECAL Barrel stave module into the envelope volume
   //====================================================================
@@ -68,6 +68,8 @@ using dd4hep::_toString;
 using dd4hep::rec::LayeredCalorimeterData;
 
 #include "SEcal06_Helpers.h"
+#include "LcgeoBuildMode.h"
+#include "DenseCellIndex.h"
 
 #undef NDEBUG
 #include <assert.h>
@@ -309,6 +311,10 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
   
   helper.setTranslation ( Position ( -EcalEndcap_inner_radius , EcalEndcap_inner_radius, -module_thickness/2. ) );
 
+  // in the reconstruction geometry mode only the reco data and the segmentation are set up
+  bool recoGeometryOnly = lcgeo::buildRecoGeometryOnly( theDetector );
+  helper.setBuildVolumes( !recoGeometryOnly );
+
   // make the module
 
   LayeredCalorimeterData* caloData = new LayeredCalorimeterData ;
@@ -316,6 +322,11 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 
   DetElement mod_det ("quad0",det_id);
 
+  // Geant4 navigation hints from the compact file for the module and the alveoli
+  lcgeo::NavigationHints* navigationHints = new lcgeo::NavigationHints( x_det );
+  if ( !recoGeometryOnly ) navigationHints->tag( "module", EnvLogEndCap );
+  helper.setNavigationHints( navigationHints );
+
   helper.makeModule( EnvLogEndCap, 
 		     mod_det,
 		     *caloData,
@@ -342,6 +353,23 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
   caloData->extent[2] = EcalEndcap_min_z ;
   caloData->extent[3] = EcalEndcap_max_z ;
 
+  // dense index of the cellIDs and the cells that exist, e.g. for caching the cell positions in the simulation
+  lcgeo::DenseCellIndex::FieldValues replicated;
+  lcgeo::DenseCellIndex::extend( replicated, "system", det_id );
+  lcgeo::DenseCellIndex::extend( replicated, "module", 0 );
+  lcgeo::DenseCellIndex::extend( replicated, "module", 6 );
+  lcgeo::DenseCellIndex::extend( replicated, "stave", 1, 4 );
+  lcgeo::DenseCellIndex* cellIndex = lcgeo::DenseCellIndex::create( *readout.idSpec().decoder(), *seg.segmentation(),
+                                                                    helper.getSensitiveAreas(), replicated );
+  sdet.addExtension< lcgeo::DenseCellIndex >( cellIndex );
+  sdet.addExtension< lcgeo::NavigationHints >( navigationHints );
+  cout << "SEcal06_Endcaps : " << cellIndex->numberOfChannels() << " readout channels" << endl;
+
+  if ( recoGeometryOnly ) {
+    cout << "SEcal06_Endcaps : reconstruction geometry only - no modules placed" << endl;
+    sdet.addExtension< LayeredCalorimeterData >( caloData ) ;
+    return sdet;
+  }
 
 
   //====================================================================
@@ -36,6 +36,10 @@ SEcal06_Helpers::SEcal06_Helpers() {
 
   _plugLength=0;
 
+  _buildVolumes=true;
+
+  _navigationHints=NULL;
+
   _magicMegatileStrategy=-1;
 }
 
@@ -568,7 +572,8 @@ void SEcal06_Helpers::makeModule( dd4hep::Volume & mod_vol,  // the volume we'll
 
       // create the radiator volume
       if ( radiator_dim_Z>0 ) {       // only create the volume if we have radiator
-        std::vector < dimposXYStruct > absorbersheets = getAbsPlateXYDimensions( currentLayerBase_pos_Z + this_struct_CFthick_beforeAbs + radiator_dim_Z ); // add CF before abs. added djeans 21 nov 2016
+        std::vector < dimposXYStruct > absorbersheets;
+        if ( _buildVolumes ) absorbersheets = getAbsPlateXYDimensions( currentLayerBase_pos_Z + this_struct_CFthick_beforeAbs + radiator_dim_Z ); // add CF before abs. added djeans 21 nov 2016
         // create and place the absorber sheets
         for ( size_t ipl=0; ipl<absorbersheets.size(); ipl++) {
           dimposXYStruct plSize = absorbersheets[ipl];
@@ -691,18 +696,23 @@ void SEcal06_Helpers::makeModule( dd4hep::Volume & mod_vol,  // the volume we'll
         double slab_dim_X  = slabDims[islab].sizeX;
 
         // make an air volume for the alveolus
-        dd4hep::Box        l_box( slab_dim_X/2. ,
-                                            slabDims[islab].sizeY/2. - _CF_alvWall,
-                                            slab_dim_Z/2. );
-
-        dd4hep::Volume     l_vol( _det_name+"_alveolus_"+l_name, l_box, _air_material);
-	l_vol.setVisAttributes(theDetector.visAttributes( "GrayVis" ) );
-
-        dd4hep::DetElement l_det( stave_det, l_name+dd4hep::_toString(int(islab),"tower%02d") , det_id );
-        dd4hep::Position   l_pos = getTranslatedPosition(slabDims[islab].posX, slabDims[islab].posY, slab_pos_Z );
-        dd4hep::PlacedVolume l_phv = mod_vol.placeVolume(l_vol,l_pos);
-        l_phv.addPhysVolID("tower", int(islab) );
-        l_det.setPlacement(l_phv);
+        dd4hep::Volume     l_vol;
+
+        if ( _buildVolumes ) {
+          dd4hep::Box        l_box( slab_dim_X/2. ,
+                                    slabDims[islab].sizeY/2. - _CF_alvWall,
+                                    slab_dim_Z/2. );
+
+          l_vol = dd4hep::Volume( _det_name+"_alveolus_"+l_name, l_box, _air_material);
+          l_vol.setVisAttributes(theDetector.visAttributes( "GrayVis" ) );
+          if ( _navigationHints ) _navigationHints->tag( "alveolus", l_vol );
+
+          dd4hep::DetElement l_det( stave_det, l_name+dd4hep::_toString(int(islab),"tower%02d") , det_id );
+          dd4hep::Position   l_pos = getTranslatedPosition(slabDims[islab].posX, slabDims[islab].posY, slab_pos_Z );
+          dd4hep::PlacedVolume l_phv = mod_vol.placeVolume(l_vol,l_pos);
+          l_phv.addPhysVolID("tower", int(islab) );
+          l_det.setPlacement(l_phv);
+        }
 
         // then fill it with the slab sublayers
         int s_num(0);
@@ -719,13 +729,15 @@ void SEcal06_Helpers::makeModule( dd4hep::Volume & mod_vol,  // the volume we'll
 
 	  if ( !x_slice.isSensitive() ) { // not the sensitive slice: just a layer of stuff
 
-	    dd4hep::Box      s_box( slab_dim_X/2. , slabDims[islab].sizeY/2. - _CF_alvWall, s_thick/2. );
-	    dd4hep::Volume   s_vol(_det_name+"_"+l_name+"_"+s_name, s_box, slice_material);
-	    s_vol.setVisAttributes(theDetector.visAttributes( vis_str ));
+	    if ( _buildVolumes ) {
+	      dd4hep::Box      s_box( slab_dim_X/2. , slabDims[islab].sizeY/2. - _CF_alvWall, s_thick/2. );
+	      dd4hep::Volume   s_vol(_det_name+"_"+l_name+"_"+s_name, s_box, slice_material);
+	      s_vol.setVisAttributes(theDetector.visAttributes( vis_str ));
 
-	    dd4hep::Position s_pos( 0, 0, s_pos_Z + s_thick/2. );
-	    //	    dd4hep::PlacedVolume slice_phv = 
-	    l_vol.placeVolume(s_vol, s_pos );
+	      dd4hep::Position s_pos( 0, 0, s_pos_Z + s_thick/2. );
+	      //	    dd4hep::PlacedVolume slice_phv = 
+	      l_vol.placeVolume(s_vol, s_pos );
+	    }
 
 
 	    if (x_slice.materialStr().compare(x_staves.materialStr()) == 0){
@@ -791,21 +803,34 @@ void SEcal06_Helpers::makeModule( dd4hep::Volume & mod_vol,  // the volume we'll
                 if ( isMagic ) Wafer_name="magic";
                 Wafer_name +=  dd4hep::_toString(wafer_num,"wafer%d");
 
-                dd4hep::Box* box = isMagic ? new dd4hep::Box( megatile_sensitive_size_x/2,unit_sensitive_dim_Y/2,s_thick/2.) : &WaferSiSolid;
-                dd4hep::Volume WaferSiLog(_det_name+"_"+l_name+"_"+s_name+"_"+Wafer_name,*box,slice_material);
-
-		std::string wafer_vis_str = isMagic ? "YellowVis" : vis_str;
-		
-		// Set region, limitset, and vis. 
-		WaferSiLog.setAttributes(theDetector,x_slice.regionStr(),x_slice.limitsStr(),wafer_vis_str);
-                WaferSiLog.setSensitiveDetector(sens);
-
-                dd4hep::Position w_pos(wafer_pos_X + megatile_size_x/2., wafer_pos_Y, s_pos_Z + s_thick/2. );
-                dd4hep::PlacedVolume wafer_phv = l_vol.placeVolume(WaferSiLog, w_pos );
-                wafer_phv.addPhysVolID("wafer", wafer_num);
-		wafer_phv.addPhysVolID("layer", myLayerNumTemp );
-
-		if ( multiSeg ) wafer_phv.addPhysVolID("slice", s_num ); // need to keep slice id in case of multireadout
+                if ( _buildVolumes ) {
+                  dd4hep::Box* box = isMagic ? new dd4hep::Box( megatile_sensitive_size_x/2,unit_sensitive_dim_Y/2,s_thick/2.) : &WaferSiSolid;
+                  dd4hep::Volume WaferSiLog(_det_name+"_"+l_name+"_"+s_name+"_"+Wafer_name,*box,slice_material);
+
+                  std::string wafer_vis_str = isMagic ? "YellowVis" : vis_str;
+
+                  // Set region, limitset, and vis. 
+                  WaferSiLog.setAttributes(theDetector,x_slice.regionStr(),x_slice.limitsStr(),wafer_vis_str);
+                  WaferSiLog.setSensitiveDetector(sens);
+
+                  dd4hep::Position w_pos(wafer_pos_X + megatile_size_x/2., wafer_pos_Y, s_pos_Z + s_thick/2. );
+                  dd4hep::PlacedVolume wafer_phv = l_vol.placeVolume(WaferSiLog, w_pos );
+                  wafer_phv.addPhysVolID("wafer", wafer_num);
+                  wafer_phv.addPhysVolID("layer", myLayerNumTemp );
+
+                  if ( multiSeg ) wafer_phv.addPhysVolID("slice", s_num ); // need to keep slice id in case of multireadout
+                }
+
+                // remember the sensitive area for the dense cell index
+                lcgeo::DenseCellIndex::SensitiveArea area;
+                const dd4hep::DDSegmentation::BitFieldCoder& idDecoder = *_geomseg->decoder();
+                lcgeo::DenseCellIndex::setField( idDecoder, area.volumeID, "tower", int(islab) );
+                lcgeo::DenseCellIndex::setField( idDecoder, area.volumeID, "layer", myLayerNumTemp );
+                lcgeo::DenseCellIndex::setField( idDecoder, area.volumeID, "wafer", wafer_num );
+                if ( multiSeg ) lcgeo::DenseCellIndex::setField( idDecoder, area.volumeID, "slice", s_num );
+                area.dx = isMagic ? megatile_sensitive_size_x/2. : unit_sensitive_dim_Y/2.;
+                area.dy = unit_sensitive_dim_Y/2.;
+                _sensitiveAreas.push_back( area );
 
                 if ( isMagic ) {
                   if ( megatileSeg ) { // define the special megatile
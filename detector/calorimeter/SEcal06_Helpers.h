@@ -12,6 +12,9 @@
 
 #include "DDSegmentation/MultiSegmentation.h"
 
+#include "DenseCellIndex.h"
+#include "NavigationHints.h"
+
 #include <iostream>
 
 #undef NDEBUG
@@ -181,6 +184,16 @@ class SEcal06_Helpers {
 
   void setPlugLength( float ll ) { _plugLength = ll; }
 
+  // if false, makeModule() only fills the reco data and sets up the segmentation, no volumes are created
+  void setBuildVolumes( bool b ) { _buildVolumes = b; }
+
+  // the sensitive wafers/megatiles made by makeModule(), with the tower, layer, wafer and slice set in the volumeID
+  // (module and stave are placed by the drivers)
+  const std::vector<lcgeo::DenseCellIndex::SensitiveArea> & getSensitiveAreas() const { return _sensitiveAreas; }
+
+  // makeModule() tags the alveoli ("alveolus") in these Geant4 navigation hints
+  void setNavigationHints( lcgeo::NavigationHints * hints ) { _navigationHints = hints; }
+
 
  private:
 
@@ -302,6 +315,11 @@ class SEcal06_Helpers {
 
   float _plugLength;
 
+  bool _buildVolumes;
+
+  std::vector<lcgeo::DenseCellIndex::SensitiveArea> _sensitiveAreas;
+
+  lcgeo::NavigationHints * _navigationHints;
 
 };
 
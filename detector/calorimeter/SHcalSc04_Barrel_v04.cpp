@@ -16,6 +16,9 @@
 #include "DDSegmentation/Segmentation.h"
 #include "DDSegmentation/MultiSegmentation.h"
 #include "LcgeoExceptions.h"
+#include "LcgeoBuildMode.h"
+#include "DenseCellIndex.h"
+#include "NavigationHints.h"
 
 #include <iostream>
 #include <vector>
@@ -155,6 +158,9 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 
   sens.setType("calorimeter");
 
+  // in the reconstruction geometry mode only the LayeredCalorimeterData and the segmentation are set up
+  bool buildVolumes = ! lcgeo::buildRecoGeometryOnly( theDetector ) ;
+
 //====================================================================
 //
 // Read all the constant from ILD_o1_v05.xml
@@ -312,43 +318,54 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
   double YXH  = Hcal_total_dim_y / 2.;
   double DHZ  = (Hcal_normal_dim_z - Hcal_lateral_plate_thickness) / 2.;
 
-  Trapezoid stave_shaper(  THX, BHX, DHZ, DHZ, YXH);
+  // Geant4 navigation hints from the compact file for the modules and the layers
+  lcgeo::NavigationHints* navigationHints = new lcgeo::NavigationHints( x_det ) ;
+
+  Volume  EnvLogHcalModuleBarrel;
+  Volume  EnvLogHcalModuleBarrel_LP;
+
+  if( buildVolumes ){
 
-  Tube solidCaloTube(0, Hcal_outer_radius, DHZ+boundarySafety);
+    Trapezoid stave_shaper(  THX, BHX, DHZ, DHZ, YXH);
+
+    Tube solidCaloTube(0, Hcal_outer_radius, DHZ+boundarySafety);
   
-  RotationZYX mrot(0,0,M_PI/2.);
+    RotationZYX mrot(0,0,M_PI/2.);
+
+    Rotation3D mrot3D(mrot);
+    Position mxyzVec(0,0,(Hcal_inner_radius + Hcal_total_dim_y / 2.));
+    Transform3D mtran3D(mrot3D,mxyzVec);
 
-  Rotation3D mrot3D(mrot);
-  Position mxyzVec(0,0,(Hcal_inner_radius + Hcal_total_dim_y / 2.));
-  Transform3D mtran3D(mrot3D,mxyzVec);
+    IntersectionSolid barrelModuleSolid(stave_shaper, solidCaloTube, mtran3D);
 
-  IntersectionSolid barrelModuleSolid(stave_shaper, solidCaloTube, mtran3D);
+    EnvLogHcalModuleBarrel = Volume(det_name+"_module",barrelModuleSolid,stavesMaterial);
 
-  Volume  EnvLogHcalModuleBarrel(det_name+"_module",barrelModuleSolid,stavesMaterial);
+    EnvLogHcalModuleBarrel.setAttributes(theDetector,x_det.regionStr(),x_det.limitsStr(),x_det.visStr());
+    navigationHints->tag( "module", EnvLogHcalModuleBarrel ) ;
 
-  EnvLogHcalModuleBarrel.setAttributes(theDetector,x_det.regionStr(),x_det.limitsStr(),x_det.visStr());
 
 
 
 
+    //stave modules lateral plate shaper parameters
+    double BHX_LP  = BHX;
+    double THX_LP  = THX;
+    double YXH_LP  = YXH;
 
-  //stave modules lateral plate shaper parameters
-  double BHX_LP  = BHX;
-  double THX_LP  = THX;
-  double YXH_LP  = YXH;
+    //build lateral palte here to simulate lateral plate in the middle of barrel.
+    double DHZ_LP  = Hcal_lateral_plate_thickness/2.0; 
 
-  //build lateral palte here to simulate lateral plate in the middle of barrel.
-  double DHZ_LP  = Hcal_lateral_plate_thickness/2.0; 
+    Trapezoid stave_shaper_LP(THX_LP, BHX_LP, DHZ_LP, DHZ_LP, YXH_LP);
 
-  Trapezoid stave_shaper_LP(THX_LP, BHX_LP, DHZ_LP, DHZ_LP, YXH_LP);
+    Tube solidCaloTube_LP(0, Hcal_outer_radius, DHZ_LP+boundarySafety);
 
-  Tube solidCaloTube_LP(0, Hcal_outer_radius, DHZ_LP+boundarySafety);
+    IntersectionSolid Module_lateral_plate(stave_shaper_LP, solidCaloTube_LP, mtran3D);
 
-  IntersectionSolid Module_lateral_plate(stave_shaper_LP, solidCaloTube_LP, mtran3D);
+    EnvLogHcalModuleBarrel_LP = Volume(det_name+"_Module_lateral_plate",Module_lateral_plate,stavesMaterial);
 
-  Volume  EnvLogHcalModuleBarrel_LP(det_name+"_Module_lateral_plate",Module_lateral_plate,stavesMaterial);
+    EnvLogHcalModuleBarrel_LP.setAttributes(theDetector,x_det.regionStr(),x_det.limitsStr(),x_det.visStr());
 
-  EnvLogHcalModuleBarrel_LP.setAttributes(theDetector,x_det.regionStr(),x_det.limitsStr(),x_det.visStr());
+  } // buildVolumes
 
 
 
@@ -387,6 +404,10 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
   //the left (or to the right) with the quantity xShift
 
 
+  // the sensitive slices for the dense cell index
+  const dd4hep::DDSegmentation::BitFieldCoder& idDecoder = *readout.idSpec().decoder() ;
+  std::vector<lcgeo::DenseCellIndex::SensitiveArea> sensitiveAreas ;
+
   //-------------------- start loop over HCAL layers ----------------------
 
   for (int layer_id = 1; layer_id <= (2*Hcal_nlayers); layer_id++)
@@ -504,13 +525,18 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 
 	}
       }
-      Box ChamberSolid((x_length + Hcal_layer_air_gap),  //x + air gaps at two side, do not need to build air gaps individualy.
+      string ChamberLogical_name      = det_name+_toString(layer_id,"_layer%d");
+
+      Volume ChamberLogical;
+
+      if( buildVolumes ){
+	Box ChamberSolid((x_length + Hcal_layer_air_gap),  //x + air gaps at two side, do not need to build air gaps individualy.
 			 z_width,   //z attention!
 			 y_height); //y attention!
 
-      string ChamberLogical_name      = det_name+_toString(layer_id,"_layer%d");
-
-      Volume ChamberLogical(ChamberLogical_name, ChamberSolid, air);   
+	ChamberLogical = Volume(ChamberLogical_name, ChamberSolid, air);   
+	navigationHints->tag( "layer", ChamberLogical ) ;
+      }
 
 
 
@@ -541,20 +567,22 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 	string   slice_name      = layer_name + _toString(slice_number,"_slice%d");
 	double   slice_thickness = x_slice.thickness();
 	Material slice_material  = theDetector.material(x_slice.materialStr());
-	DetElement slice(layer_name,_toString(slice_number,"slice%d"),x_det.id());
 	
 	slice_pos_z -= slice_thickness/2.;
 	
-	// Slice volume & box
-	Volume slice_vol(slice_name,Box(x_length,z_width,slice_thickness/2.),slice_material);
-
 	nRadiationLengths   += slice_thickness/(2.*slice_material.radLength());
 	nInteractionLengths += slice_thickness/(2.*slice_material.intLength());
 	thickness_sum       += slice_thickness/2;
 	
 	if ( x_slice.isSensitive() ) {
 
-	  slice_vol.setSensitiveDetector(sens);
+	  lcgeo::DenseCellIndex::SensitiveArea area ;
+	  lcgeo::DenseCellIndex::setField( idDecoder, area.volumeID, "layer", logical_layer_id ) ;
+	  lcgeo::DenseCellIndex::setField( idDecoder, area.volumeID, "tower", (layer_id > Hcal_nlayers)? 1:-1 ) ;
+	  lcgeo::DenseCellIndex::setField( idDecoder, area.volumeID, "slice", slice_number ) ;
+	  area.dx = x_length ;
+	  area.dy = z_width ;
+	  sensitiveAreas.push_back( area ) ;
 
 	  // if we have a multisegmentation based on slices, we need to use the correct slice here
 	  if ( sensitive_slice_number<0  || sensitive_slice_number == slice_number ) {
@@ -578,21 +606,30 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 	thickness_sum       += slice_thickness/2;
 
 
-	// Set region, limitset, and vis.
-	slice_vol.setAttributes(theDetector,x_slice.regionStr(),x_slice.limitsStr(),x_slice.visStr());
-	// slice PlacedVolume
-	PlacedVolume slice_phv = ChamberLogical.placeVolume(slice_vol,Position(0.,0.,slice_pos_z));
+	if( buildVolumes ){
+	  DetElement slice(layer_name,_toString(slice_number,"slice%d"),x_det.id());
+
+	  // Slice volume & box
+	  Volume slice_vol(slice_name,Box(x_length,z_width,slice_thickness/2.),slice_material);
+
+	  if ( x_slice.isSensitive() ) slice_vol.setSensitiveDetector(sens);
 
-	slice_phv.addPhysVolID("layer",logical_layer_id).addPhysVolID("slice", slice_number );
+	  // Set region, limitset, and vis.
+	  slice_vol.setAttributes(theDetector,x_slice.regionStr(),x_slice.limitsStr(),x_slice.visStr());
+	  // slice PlacedVolume
+	  PlacedVolume slice_phv = ChamberLogical.placeVolume(slice_vol,Position(0.,0.,slice_pos_z));
+
+	  slice_phv.addPhysVolID("layer",logical_layer_id).addPhysVolID("slice", slice_number );
 
 	
-	if ( x_slice.isSensitive() ) {
-	  int tower_id  = (layer_id > Hcal_nlayers)? 1:-1;
-	  slice_phv.addPhysVolID("tower",tower_id);
-	  printout( dd4hep::DEBUG,  "SHcalSc04_Barrel_v04", "  logical_layer_id:  %d  tower_id:  %d", logical_layer_id, tower_id  ) ;
-	}
+	  if ( x_slice.isSensitive() ) {
+	    int tower_id  = (layer_id > Hcal_nlayers)? 1:-1;
+	    slice_phv.addPhysVolID("tower",tower_id);
+	    printout( dd4hep::DEBUG,  "SHcalSc04_Barrel_v04", "  logical_layer_id:  %d  tower_id:  %d", logical_layer_id, tower_id  ) ;
+	  }
 	
-	slice.setPlacement(slice_phv);
+	  slice.setPlacement(slice_phv);
+	}
 	// Increment x position for next slice.
 	slice_pos_z -= slice_thickness/2.;
 	// Increment slice number.
@@ -618,10 +655,11 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 			   + Hcal_radiator_thickness + Hcal_chamber_thickness/2.);
 
 
-      pv =  EnvLogHcalModuleBarrel.placeVolume(ChamberLogical,
-					       Position(chamber_x_offset,
-							chamber_z_offset,
-							chamber_y_offset + chambers_y_off_correction));
+      if( buildVolumes )
+	pv =  EnvLogHcalModuleBarrel.placeVolume(ChamberLogical,
+						 Position(chamber_x_offset,
+							  chamber_z_offset,
+							  chamber_y_offset + chambers_y_off_correction));
       
 
 
@@ -660,6 +698,22 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 
 
 
+  // dense index of the cellIDs and the cells that exist, e.g. for caching the cell positions in the simulation
+  lcgeo::DenseCellIndex::FieldValues replicated ;
+  lcgeo::DenseCellIndex::extend( replicated, "system", det_id ) ;
+  lcgeo::DenseCellIndex::extend( replicated, "module", 1, 2 ) ;
+  lcgeo::DenseCellIndex::extend( replicated, "stave", 1, Hcal_inner_symmetry ) ;
+  lcgeo::DenseCellIndex* cellIndex = lcgeo::DenseCellIndex::create( idDecoder, *seg.segmentation(), sensitiveAreas, replicated ) ;
+  sdet.addExtension< lcgeo::DenseCellIndex >( cellIndex ) ;
+  sdet.addExtension< lcgeo::NavigationHints >( navigationHints ) ;
+  printout( dd4hep::INFO,  "SHcalSc04_Barrel_v04", "%ld readout channels", cellIndex->numberOfChannels() ) ;
+
+  if( ! buildVolumes ){
+    printout( dd4hep::INFO,  "SHcalSc04_Barrel_v04", "reconstruction geometry only - no modules placed" ) ;
+    sdet.addExtension< LayeredCalorimeterData >( caloData ) ;
+    return sdet;
+  }
+
 //====================================================================
 // Place HCAL Barrel stave module into the envelope
 //====================================================================
@@ -38,6 +38,9 @@
 #include "DDSegmentation/Segmentation.h"
 #include "DDSegmentation/MultiSegmentation.h"
 #include "LcgeoExceptions.h"
+#include "LcgeoBuildMode.h"
+#include "DenseCellIndex.h"
+#include "NavigationHints.h"
 
 using namespace std;
 
@@ -91,6 +94,9 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 
   sens.setType("calorimeter");
 
+  // in the reconstruction geometry mode only the LayeredCalorimeterData is filled
+  bool buildVolumes = ! lcgeo::buildRecoGeometryOnly( theDetector ) ;
+
   DetElement    stave_det("module0stave0",det_id);
  
   // The way to reaad constant from XML/Detector file.
@@ -177,6 +183,13 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
   caloData->extent[3] = HcalEndcap_max_z ;
   
 
+  // the sensitive slices for the dense cell index
+  const dd4hep::DDSegmentation::BitFieldCoder& idDecoder = *readout.idSpec().decoder() ;
+  std::vector<lcgeo::DenseCellIndex::SensitiveArea> sensitiveAreas ;
+
+  // Geant4 navigation hints from the compact file for the modules and the layers
+  lcgeo::NavigationHints* navigationHints = new lcgeo::NavigationHints( x_det ) ;
+
   int endcapID = 0;
   for(xml_coll_t c(x_det.child(_U(dimensions)),_U(dimensions)); c; ++c) 
     {
@@ -195,51 +208,59 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
       double x_offset = box_half_x*numSides-box_half_x*endcapID*2.0-box_half_x;
       double y_offset = pos_y;
       
-      Box    EndcapModule(box_half_x,box_half_y,box_half_z);
-      
       // define the name of each endcap Module
       string envelopeVol_name   = det_name+_toString(endcapID,"_EndcapModule%d");
+
+      Volume envelopeVol;
+      Volume FEEModule;
+      Volume FEELayer;
+
+      if( buildVolumes ){
+
+        Box    EndcapModule(box_half_x,box_half_y,box_half_z);
       
-      Volume envelopeVol(envelopeVol_name,EndcapModule,stavesMaterial);
+        envelopeVol = Volume(envelopeVol_name,EndcapModule,stavesMaterial);
       
-      // Set envelope volume attributes.
-      envelopeVol.setAttributes(theDetector,x_det.regionStr(),x_det.limitsStr(),x_det.visStr());
+        // Set envelope volume attributes.
+        envelopeVol.setAttributes(theDetector,x_det.regionStr(),x_det.limitsStr(),x_det.visStr());
+        navigationHints->tag( "module", envelopeVol ) ;
       
       
-      double FEE_half_x = box_half_x-Hcal_endcap_services_module_width/2.0;
-      double FEE_half_y = Hcal_endcap_services_module_width/2.0;
-      double FEE_half_z = box_half_z;
+        double FEE_half_x = box_half_x-Hcal_endcap_services_module_width/2.0;
+        double FEE_half_y = Hcal_endcap_services_module_width/2.0;
+        double FEE_half_z = box_half_z;
 
-      Box    FEEBox(FEE_half_x,FEE_half_y,FEE_half_z);
-      Volume FEEModule("Hcal_endcap_FEE",FEEBox,air);
+        Box    FEEBox(FEE_half_x,FEE_half_y,FEE_half_z);
+        FEEModule = Volume("Hcal_endcap_FEE",FEEBox,air);
 
-      double FEELayer_thickness = Hcal_steel_cassette_thickness + HcalServices_outer_FR4_thickness + HcalServices_outer_Cu_thickness;
-      Box    FEELayerBox(FEE_half_x,FEE_half_y,FEELayer_thickness/2.0);
-      Volume FEELayer("FEELayer",FEELayerBox,air);
+        double FEELayer_thickness = Hcal_steel_cassette_thickness + HcalServices_outer_FR4_thickness + HcalServices_outer_Cu_thickness;
+        Box    FEELayerBox(FEE_half_x,FEE_half_y,FEELayer_thickness/2.0);
+        FEELayer = Volume("FEELayer",FEELayerBox,air);
 
-      Box    FEELayerSteelBox(FEE_half_x,FEE_half_y,Hcal_steel_cassette_thickness/2.0);
-      Volume FEELayerSteel("FEELayerSteel",FEELayerSteelBox,stainless_steel);
-      pVol = FEELayer.placeVolume(FEELayerSteel,
+        Box    FEELayerSteelBox(FEE_half_x,FEE_half_y,Hcal_steel_cassette_thickness/2.0);
+        Volume FEELayerSteel("FEELayerSteel",FEELayerSteelBox,stainless_steel);
+        pVol = FEELayer.placeVolume(FEELayerSteel,
 				  Position(0,
-                                           0,
+                                             0,
 					   (-FEELayer_thickness/2.0
 					    +Hcal_steel_cassette_thickness/2.0)));
 
-      Box    FEELayerFR4Box(FEE_half_x,FEE_half_y,HcalServices_outer_FR4_thickness/2.0);
-      Volume FEELayerFR4("FEELayerFR4",FEELayerFR4Box,PCB);
-      pVol = FEELayer.placeVolume(FEELayerFR4,
+        Box    FEELayerFR4Box(FEE_half_x,FEE_half_y,HcalServices_outer_FR4_thickness/2.0);
+        Volume FEELayerFR4("FEELayerFR4",FEELayerFR4Box,PCB);
+        pVol = FEELayer.placeVolume(FEELayerFR4,
 				  Position(0,
-                                           0,
+                                             0,
 					   (-FEELayer_thickness/2.0+Hcal_steel_cassette_thickness
 					    +HcalServices_outer_FR4_thickness/2.0)));
 
-      Box    FEELayerCuBox(FEE_half_x,FEE_half_y,HcalServices_outer_Cu_thickness/2.0);
-      Volume FEELayerCu("FEELayerCu",FEELayerCuBox,copper);
-      pVol = FEELayer.placeVolume(FEELayerCu,
+        Box    FEELayerCuBox(FEE_half_x,FEE_half_y,HcalServices_outer_Cu_thickness/2.0);
+        Volume FEELayerCu("FEELayerCu",FEELayerCuBox,copper);
+        pVol = FEELayer.placeVolume(FEELayerCu,
 				  Position(0,
-                                           0,
+                                             0,
 					   (-FEELayer_thickness/2.0+Hcal_steel_cassette_thickness+HcalServices_outer_FR4_thickness +HcalServices_outer_Cu_thickness/2.0)));
 
+      } // buildVolumes
 
       // ========= Create Hcal Chamber (i.e. Layers) ==============================
       // It will be the sub volume for placing the slices.
@@ -261,7 +282,7 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 
 	double layer_thickness = layering.layer(layer_num)->thickness();
 	string layer_name      = envelopeVol_name+"_layer";
-	DetElement  layer(stave_det,layer_name,det_id);
+	DetElement  layer;
 	
 	// Active Layer box & volume
 	double active_layer_dim_x = box_half_x - Hcal_endcap_lateral_structure_thickness - Hcal_endcap_layer_air_gap;
@@ -270,8 +291,13 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 	
 	// Build chamber including air gap
 	// The Layer will be filled with slices, 
-	Volume layer_vol(layer_name, Box((active_layer_dim_x + Hcal_endcap_layer_air_gap),
-					 active_layer_dim_y,active_layer_dim_z), air);
+	Volume layer_vol;
+	if( buildVolumes ){
+	  layer = DetElement(stave_det,layer_name,det_id);
+	  layer_vol = Volume(layer_name, Box((active_layer_dim_x + Hcal_endcap_layer_air_gap),
+					     active_layer_dim_y,active_layer_dim_z), air);
+	  navigationHints->tag( "layer", layer_vol ) ;
+	}
 
 
 
@@ -303,13 +329,9 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 	  string   slice_name      = layer_name + _toString(slice_number,"_slice%d");
 	  double   slice_thickness = x_slice.thickness();
 	  Material slice_material  = theDetector.material(x_slice.materialStr());
-	  DetElement slice(layer,_toString(slice_number,"slice%d"),det_id);
 	  
 	  slice_pos_z += slice_thickness / 2.0;
 	  
-	  // Slice volume & box
-	  Volume slice_vol(slice_name,Box(active_layer_dim_x,active_layer_dim_y,slice_thickness/2.0),slice_material);
-	  
 	  nRadiationLengths   += slice_thickness/(2.*slice_material.radLength());
 	  nInteractionLengths += slice_thickness/(2.*slice_material.intLength());
 	  thickness_sum       += slice_thickness/2;
@@ -317,7 +339,15 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 
 	  if ( x_slice.isSensitive() ) {
 
-	    slice_vol.setSensitiveDetector(sens);
+	    for (int j = 0; j < repeat; j++) {
+	      lcgeo::DenseCellIndex::SensitiveArea area;
+	      lcgeo::DenseCellIndex::setField( idDecoder, area.volumeID, "tower", endcapID );
+	      lcgeo::DenseCellIndex::setField( idDecoder, area.volumeID, "layer", layer_num + j );
+	      lcgeo::DenseCellIndex::setField( idDecoder, area.volumeID, "slice", slice_number );
+	      area.dx = active_layer_dim_x;
+	      area.dy = active_layer_dim_y;
+	      sensitiveAreas.push_back( area );
+	    }
 
 	    // if we have a multisegmentation based on slices, we need to use the correct slice here
 	    if ( sensitive_slice_number<0  || sensitive_slice_number == slice_number ) {
@@ -340,20 +370,28 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 	  nInteractionLengths += slice_thickness/(2.*slice_material.intLength());
 	  thickness_sum += slice_thickness/2;
 
-	  // Set region, limitset, and vis.
-	  slice_vol.setAttributes(theDetector,x_slice.regionStr(),x_slice.limitsStr(),x_slice.visStr());
-	  // slice PlacedVolume
-	  PlacedVolume slice_phv = layer_vol.placeVolume(slice_vol,Position(0,0,slice_pos_z));
-	  slice_phv.addPhysVolID("slice",slice_number);
+	  if( buildVolumes ){
+	    DetElement slice(layer,_toString(slice_number,"slice%d"),det_id);
+
+	    // Slice volume & box
+	    Volume slice_vol(slice_name,Box(active_layer_dim_x,active_layer_dim_y,slice_thickness/2.0),slice_material);
+	    if ( x_slice.isSensitive() ) slice_vol.setSensitiveDetector(sens);
+
+	    // Set region, limitset, and vis.
+	    slice_vol.setAttributes(theDetector,x_slice.regionStr(),x_slice.limitsStr(),x_slice.visStr());
+	    // slice PlacedVolume
+	    PlacedVolume slice_phv = layer_vol.placeVolume(slice_vol,Position(0,0,slice_pos_z));
+	    slice_phv.addPhysVolID("slice",slice_number);
 	  
-	  slice.setPlacement(slice_phv);
+	    slice.setPlacement(slice_phv);
+	  }
 	  // Increment Z position for next slice.
 	  slice_pos_z += slice_thickness / 2.0;
 	  // Increment slice number.
 	  ++slice_number;             
 	}
 	// Set region, limitset, and vis.
-	layer_vol.setAttributes(theDetector,x_layer.regionStr(),x_layer.limitsStr(),x_layer.visStr());
+	if( buildVolumes ) layer_vol.setAttributes(theDetector,x_layer.regionStr(),x_layer.limitsStr(),x_layer.visStr());
 
 
 	//Store "outer" quantities
@@ -373,16 +411,18 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 	  // Layer position in y within the Endcap Modules.
 	  layer_pos_z += layer_thickness / 2.0;
 	  
-	  PlacedVolume layer_phv = envelopeVol.placeVolume(layer_vol,
-							   Position(0,0,layer_pos_z));
-	  // registry the ID of Layer, stave and module
-	  layer_phv.addPhysVolID("layer",layer_num);
+	  if( buildVolumes ){
+	    PlacedVolume layer_phv = envelopeVol.placeVolume(layer_vol,
+							     Position(0,0,layer_pos_z));
+	    // registry the ID of Layer, stave and module
+	    layer_phv.addPhysVolID("layer",layer_num);
 
-	  // then setPlacement for it.
-	  layer.setPlacement(layer_phv);
+	    // then setPlacement for it.
+	    layer.setPlacement(layer_phv);
 
-	  pVol = FEEModule.placeVolume(FEELayer,
-				       Position(0,0,layer_pos_z));
+	    pVol = FEEModule.placeVolume(FEELayer,
+					 Position(0,0,layer_pos_z));
+	  }
 	  //-----------------------------------------------------------------------------------------
 	  if ( caloData->layers.size() < (unsigned int)repeat ) {
 
@@ -409,6 +449,11 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 	
       }
       
+      // nothing to place - but go through all modules for the sensitive areas of the cell index
+      if( ! buildVolumes ){
+	endcapID++;
+	continue ;
+      }
       
       // =========== Place Hcal Endcap envelope ===================================
       // Finally place the Hcal Endcap envelope into the world volume.
@@ -486,6 +531,17 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
     endcapID++;
       
     }
+
+  // dense index of the cellIDs and the cells that exist, e.g. for caching the cell positions in the simulation
+  lcgeo::DenseCellIndex::FieldValues replicated;
+  lcgeo::DenseCellIndex::extend( replicated, "system", det_id );
+  lcgeo::DenseCellIndex::extend( replicated, "module", 0 );
+  lcgeo::DenseCellIndex::extend( replicated, "module", 6 );
+  lcgeo::DenseCellIndex::extend( replicated, "stave", 0, 1 );
+  lcgeo::DenseCellIndex* cellIndex = lcgeo::DenseCellIndex::create( idDecoder, *seg.segmentation(), sensitiveAreas, replicated );
+  sdet.addExtension< lcgeo::DenseCellIndex >( cellIndex );
+  sdet.addExtension< lcgeo::NavigationHints >( navigationHints );
+  printout( dd4hep::INFO, "SHcalSc04_Endcaps_v01", "%ld readout channels", cellIndex->numberOfChannels() );
   
   sdet.addExtension< LayeredCalorimeterData >( caloData ) ;  
   
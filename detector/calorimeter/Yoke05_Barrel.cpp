@@ -35,6 +35,7 @@
 #include "TGeoTrd2.h"
 #include "XML/Utilities.h"
 #include "DDRec/DetectorData.h"
+#include "LcgeoBuildMode.h"
 
 using namespace std;
 
@@ -107,6 +108,8 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 
   sens.setType("calorimeter");
 
+  // in the reconstruction geometry mode only the LayeredCalorimeterData is filled
+  bool buildVolumes = ! lcgeo::buildRecoGeometryOnly( theDetector ) ;
  
 //====================================================================
 //
@@ -212,11 +215,15 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 
 
 // ========= Create Yoke Barrel module   ====================================
-  PolyhedraRegular YokeBarrelSolid( symmetry, M_PI/2.0-M_PI/symmetry, rInnerBarrel, rOuterBarrel,  Yoke_Barrel_module_dim_z);
+  Volume mod_vol;
 
-  Volume mod_vol(det_name+"_module", YokeBarrelSolid, yokeMaterial);
+  if( buildVolumes ){
+    PolyhedraRegular YokeBarrelSolid( symmetry, M_PI/2.0-M_PI/symmetry, rInnerBarrel, rOuterBarrel,  Yoke_Barrel_module_dim_z);
 
-  mod_vol.setVisAttributes(theDetector.visAttributes(x_det.visStr()));
+    mod_vol = Volume(det_name+"_module", YokeBarrelSolid, yokeMaterial);
+
+    mod_vol.setVisAttributes(theDetector.visAttributes(x_det.visStr()));
+  }
      
  
 //====================================================================
@@ -277,11 +284,15 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 	caloLayer.cellSize0 = cell_sizeX;
 	caloLayer.cellSize1 = cell_sizeY;
       
-	Box        ChamberSolid(dx,l_thickness/2.0, dy);
-	Volume     ChamberLog(det_name+"_"+l_name,ChamberSolid,air);
-	DetElement layer(l_name, det_id);
+	Volume     ChamberLog;
+
+	if( buildVolumes ){
+	  Box        ChamberSolid(dx,l_thickness/2.0, dy);
+	  ChamberLog = Volume(det_name+"_"+l_name,ChamberSolid,air);
+	  DetElement layer(l_name, det_id);
 
-	ChamberLog.setVisAttributes(theDetector.visAttributes(x_layer.visStr()));
+	  ChamberLog.setVisAttributes(theDetector.visAttributes(x_layer.visStr()));
+	}
 
 	// Loop over the sublayers or slices for this layer.
 	int s_num = 1;
@@ -307,19 +318,11 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 	  double     s_thickness = x_slice.thickness();
 	  Material slice_material  = theDetector.material(x_slice.materialStr());
 
-	  double slab_dim_x = dx-tolerance;
-	  double slab_dim_y = s_thickness/2.;
-	  double slab_dim_z = dy-tolerance;
-
-	  Box        s_box(slab_dim_x,slab_dim_y,slab_dim_z);
-	  Volume     s_vol(det_name+"_"+l_name+"_"+s_name,s_box,slice_material);
-
 	  nRadiationLengths   += s_thickness/(2.*slice_material.radLength());
 	  nInteractionLengths += s_thickness/(2.*slice_material.intLength());
 	  thickness_sum       += s_thickness/2;
 
 	  if ( x_slice.isSensitive() ) {
-	    s_vol.setSensitiveDetector(sens);
 
 #if DD4HEP_VERSION_GE( 0, 15 )
 	  //Store "inner" quantities
@@ -338,14 +341,25 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 	  nRadiationLengths   += s_thickness/(2.*slice_material.radLength());
 	  nInteractionLengths += s_thickness/(2.*slice_material.intLength());
 	  thickness_sum       += s_thickness/2;
-	  
-	  // Set region, limitset, and vis.
-	  s_vol.setAttributes(theDetector,x_slice.regionStr(),x_slice.limitsStr(),x_slice.visStr());
 
 	  s_pos_y += s_thickness/2.;
 
-	  Position   s_pos(0,s_pos_y,0);      // Position of the layer.
-        ChamberLog.placeVolume(s_vol,s_pos);
+	  if( buildVolumes ){
+	    double slab_dim_x = dx-tolerance;
+	    double slab_dim_y = s_thickness/2.;
+	    double slab_dim_z = dy-tolerance;
+
+	    Box        s_box(slab_dim_x,slab_dim_y,slab_dim_z);
+	    Volume     s_vol(det_name+"_"+l_name+"_"+s_name,s_box,slice_material);
+
+	    if ( x_slice.isSensitive() ) s_vol.setSensitiveDetector(sens);
+
+	    // Set region, limitset, and vis.
+	    s_vol.setAttributes(theDetector,x_slice.regionStr(),x_slice.limitsStr(),x_slice.visStr());
+
+	    Position   s_pos(0,s_pos_y,0);      // Position of the layer.
+	    ChamberLog.placeVolume(s_vol,s_pos);
+	  }
 
 	  // Increment x position for next slice.
 	  s_pos_y += s_thickness/2.;
@@ -367,23 +381,25 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 	
 	double phirot = 0;
 
-	for(int j=0;j<symmetry;j++)
-	  {
-	    double Y = radius_low + l_thickness/2.0;
-	    Position xyzVec(-Y*sin(phirot), Y*cos(phirot), 0);
+	if( buildVolumes ){
+	  for(int j=0; j<symmetry;j++)
+	    {
+	      double Y = radius_low + l_thickness/2.0;
+	      Position xyzVec(-Y*sin(phirot), Y*cos(phirot), 0);
 
-	    RotationZYX rot(phirot,0,0);
-	    Rotation3D rot3D(rot);
+	      RotationZYX rot(phirot,0,0);
+	      Rotation3D rot3D(rot);
 
-	    Transform3D tran3D(rot3D,xyzVec); 
-	    PlacedVolume layer_phv =  mod_vol.placeVolume(ChamberLog,tran3D);
-	    layer_phv.addPhysVolID("layer", l_num).addPhysVolID("stave",j+1);
-	    string     stave_name  =  _toString(j+1,"stave%d");
-	    string stave_layer_name = stave_name+_toString(l_num,"layer%d");
-          plvec.push_back({stave_layer_name,layer_phv});
-	    phirot -= M_PI/symmetry*2.0;
+	      Transform3D tran3D(rot3D,xyzVec); 
+	      PlacedVolume layer_phv =  mod_vol.placeVolume(ChamberLog,tran3D);
+	      layer_phv.addPhysVolID("layer", l_num).addPhysVolID("stave",j+1);
+	      string     stave_name  =  _toString(j+1,"stave%d");
+	      string stave_layer_name = stave_name+_toString(l_num,"layer%d");
+            plvec.push_back({stave_layer_name,layer_phv});
+	      phirot -= M_PI/symmetry*2.0;
 
-	  }
+	    }
+	}
 
 	//-----------------------------------------------------------------------------------------
 
@@ -404,27 +420,29 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 // Place Yoke05 Barrel stave module into the world volume
 //====================================================================
 
-  for (int module_id = 1; module_id < 4; module_id++)
-    {
-      double module_z_offset =  (module_id-2) * Yoke_Barrel_module_dim_z;
+  if( buildVolumes ){
+    for (int module_id = 1; module_id < 4; module_id++)
+      {
+        double module_z_offset =  (module_id-2) * Yoke_Barrel_module_dim_z;
       
-      Position mpos(0,0,module_z_offset);
+        Position mpos(0,0,module_z_offset);
       
-      PlacedVolume m_phv = envelope.placeVolume(mod_vol,mpos);
-      m_phv.addPhysVolID("module",module_id).addPhysVolID("system", det_id);
-      m_phv.addPhysVolID("tower", 1);// Not used
-      string m_name = _toString(module_id,"module%d");
-      DetElement sd (m_name,det_id);
+        PlacedVolume m_phv = envelope.placeVolume(mod_vol,mpos);
+        m_phv.addPhysVolID("module",module_id).addPhysVolID("system", det_id);
+        m_phv.addPhysVolID("tower", 1);// Not used
+        string m_name = _toString(module_id,"module%d");
+        DetElement sd (m_name,det_id);
       
-      for( auto deelts : plvec ) {
-      	std::string deteltname = deelts.first +_toString(module_id,"module%d");
-      	DetElement layerDet (sd, deteltname, det_id);
-      	layerDet.setPlacement( deelts.second ) ;
-      }
+        for( auto deelts : plvec ) {
+	  std::string deteltname = deelts.first +_toString(module_id,"module%d");
+	  DetElement layerDet (sd, deteltname, det_id);
+	  layerDet.setPlacement( deelts.second ) ;
+        }
       
-      sd.setPlacement(m_phv);
-      sdet.add(sd);
-    }
+        sd.setPlacement(m_phv);
+        sdet.add(sd);
+      }
+  }
 
   sdet.addExtension< LayeredCalorimeterData >( caloData ) ;
   
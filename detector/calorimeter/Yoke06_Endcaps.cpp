@@ -35,6 +35,7 @@
 #include "XML/Layering.h"
 #include "XML/Utilities.h"
 #include "DDRec/DetectorData.h"
+#include "LcgeoBuildMode.h"
 
 using namespace std;
 
@@ -100,6 +101,8 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 
   sens.setType("calorimeter");
 
+  // in the reconstruction geometry mode only the LayeredCalorimeterData is filled
+  bool buildVolumes = ! lcgeo::buildRecoGeometryOnly( theDetector ) ;
  
 //====================================================================
 //
@@ -194,9 +197,13 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
   SubtractionSolid YokeEndcapSolid( PolyhedraRegular( symmetry, M_PI/symmetry, rInnerEndcap, rOuterEndcap,  Yoke_Endcap_module_dim_z), innerBox, Position(0, 0, 0) );
 
 
-  Volume mod_vol(det_name+"_module", YokeEndcapSolid, yokeMaterial);
+  Volume mod_vol;
 
-  mod_vol.setVisAttributes(theDetector.visAttributes(x_det.visStr()));
+  if( buildVolumes ){
+    mod_vol = Volume(det_name+"_module", YokeEndcapSolid, yokeMaterial);
+
+    mod_vol.setVisAttributes(theDetector.visAttributes(x_det.visStr()));
+  }
      
 
 //====================================================================
@@ -231,13 +238,18 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 
 	//	SubtractionSolid YokeEndcapSolid( PolyhedraRegular( symmetry, M_PI/symmetry, rInnerEndcap, rOuterEndcap,  Yoke_Endcap_module_dim_z), innerBox, Position(0, 0, 0) );
 
-	SubtractionSolid ChamberSolid( PolyhedraRegular( symmetry, M_PI/symmetry, rInnerEndcap + tolerance, rOuterEndcap - tolerance,  l_thickness),
-				       innerBox, Position(0, 0, 0) );
+	Volume     ChamberLog;
+	DetElement layer;
 
-	Volume     ChamberLog(det_name+"_"+l_name,ChamberSolid,air);
-	DetElement layer(l_name, det_id);
+	if( buildVolumes ){
+	  SubtractionSolid ChamberSolid( PolyhedraRegular( symmetry, M_PI/symmetry, rInnerEndcap + tolerance, rOuterEndcap - tolerance,  l_thickness),
+					 innerBox, Position(0, 0, 0) );
 
-	ChamberLog.setVisAttributes(theDetector.visAttributes(x_layer.visStr()));
+	  ChamberLog = Volume(det_name+"_"+l_name,ChamberSolid,air);
+	  layer = DetElement(l_name, det_id);
+
+	  ChamberLog.setVisAttributes(theDetector.visAttributes(x_layer.visStr()));
+	}
 
 	// Loop over the sublayers or slices for this layer.
 	int s_num = 1;
@@ -264,19 +276,12 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 	  
 	  // PolyhedraRegular sliceSolid( symmetry, M_PI/symmetry, rInnerEndcap + tolerance, rOuterEndcap - tolerance,  s_thickness);
 
-	  SubtractionSolid sliceSolid( PolyhedraRegular( symmetry, M_PI/symmetry, rInnerEndcap + tolerance, rOuterEndcap - tolerance,  s_thickness),
-				       innerBox, Position(0, 0, 0) );
-
-
-	  Volume     s_vol(det_name+"_"+l_name+"_"+s_name,sliceSolid,slice_material);
-          DetElement slice(layer,s_name,det_id);
 
 	  nRadiationLengths   += s_thickness/(2.*slice_material.radLength());
 	  nInteractionLengths += s_thickness/(2.*slice_material.intLength());
 	  thickness_sum       += s_thickness/2;
 
 	  if ( x_slice.isSensitive() ) {
-	    s_vol.setSensitiveDetector(sens);
 
 #if DD4HEP_VERSION_GE( 0, 15 )
 	  //Store "inner" quantities
@@ -296,14 +301,24 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 	  nInteractionLengths += s_thickness/(2.*slice_material.intLength());
 	  thickness_sum       += s_thickness/2;
 	  
-	  // Set region, limitset, and vis.
-	  s_vol.setAttributes(theDetector,x_slice.regionStr(),x_slice.limitsStr(),x_slice.visStr());
-
 	  s_pos_z += s_thickness/2.;
 
-	  Position   s_pos(0,0,s_pos_z);      // Position of the layer.
-	  PlacedVolume  s_phv = ChamberLog.placeVolume(s_vol,s_pos);
-	  slice.setPlacement(s_phv);
+	  if( buildVolumes ){
+	    SubtractionSolid sliceSolid( PolyhedraRegular( symmetry, M_PI/symmetry, rInnerEndcap + tolerance, rOuterEndcap - tolerance,  s_thickness),
+					 innerBox, Position(0, 0, 0) );
+
+	    Volume     s_vol(det_name+"_"+l_name+"_"+s_name,sliceSolid,slice_material);
+	    DetElement slice(layer,s_name,det_id);
+
+	    if ( x_slice.isSensitive() ) s_vol.setSensitiveDetector(sens);
+
+	    // Set region, limitset, and vis.
+	    s_vol.setAttributes(theDetector,x_slice.regionStr(),x_slice.limitsStr(),x_slice.visStr());
+
+	    Position   s_pos(0,0,s_pos_z);      // Position of the layer.
+	    PlacedVolume  s_phv = ChamberLog.placeVolume(s_vol,s_pos);
+	    slice.setPlacement(s_phv);
+	  }
 
 	  // Increment x position for next slice.
 	  s_pos_z += s_thickness/2.;
@@ -332,15 +347,17 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
 	      + iron_thickness*(i+1+(i-9)*4.6) + (i+0.5)*gap_thickness; 
 	  }	
 
-	Position xyzVec(0,0,shift_middle);
-	
-	PlacedVolume layer_phv =  mod_vol.placeVolume(ChamberLog,xyzVec);
-	layer_phv.addPhysVolID("layer", l_num);
-	//string stave_name  = "stave1";
-	string stave_layer_name = "stave1"+_toString(l_num,"layer%d");
-	DetElement stave(stave_layer_name,det_id);;
-	stave.setPlacement(layer_phv);
-	sdet.add(stave);
+	if( buildVolumes ){
+	  Position xyzVec(0,0,shift_middle);
+
+	  PlacedVolume layer_phv =  mod_vol.placeVolume(ChamberLog,xyzVec);
+	  layer_phv.addPhysVolID("layer", l_num);
+	  //string stave_name  = "stave1";
+	  string stave_layer_name = "stave1"+_toString(l_num,"layer%d");
+	  DetElement stave(stave_layer_name,det_id);;
+	  stave.setPlacement(layer_phv);
+	  sdet.add(stave);
+	}
 
       //-----------------------------------------------------------------------------------------
 	
@@ -389,45 +406,47 @@ static Ref_t create_detector(Detector& theDetector, xml_h element, SensitiveDete
   double zEndcap          =   zStartEndcap + yokeEndcapThickness/2.0 + 0.1; // Need 0.1 (1.0*mm) according to the Mokka Yoke05 driver.
   double zPlug            =   zStartEndcap - plug_thickness/2.0 -0.05; //  Need 0.05 (0.5*mm) according to the Mokka Yoke05 driver.
   
-  for(int module_num=0;module_num<2;module_num++) {
+  if( buildVolumes ){
+    for(int module_num=0; module_num<2;module_num++) {
 
-    int module_id = ( module_num == 0 ) ? 0:6;
-    double this_module_z_offset = ( module_id == 0 ) ? - zEndcap : zEndcap; 
-    double this_module_rotY = ( module_id == 0 ) ? M_PI:0; 
+      int module_id = ( module_num == 0 ) ? 0:6;
+      double this_module_z_offset = ( module_id == 0 ) ? - zEndcap : zEndcap; 
+      double this_module_rotY = ( module_id == 0 ) ? M_PI:0; 
   
-    Position xyzVec(0,0,this_module_z_offset);
-    RotationZYX rot(0,this_module_rotY,0);
-    Rotation3D rot3D(rot);
-    Transform3D tran3D(rot3D,xyzVec);
-
-    PlacedVolume pv = envelope.placeVolume(mod_vol,tran3D);
-    pv.addPhysVolID("module",module_id); // z: -/+ 0/6
-
-    string m_name = _toString(module_id,"module%d");
-    DetElement sd (m_name,det_id);
-    sd.setPlacement(pv);
-    sdet.add(sd);
-
-    //====================================================================
-    // If build_plug is true, Place the plug module into the world volume
-    //====================================================================
-    if(build_plug == true){
-      //      PolyhedraRegular YokePlugSolid( symmetry, M_PI/symmetry, rInnerPlug, rOuterPlug,  Yoke_Plug_module_dim_z);
-
-      SubtractionSolid YokePlugSolid( PolyhedraRegular( symmetry, M_PI/symmetry, rInnerPlug, rOuterPlug,  Yoke_Plug_module_dim_z),
-				      innerBox, Position(0, 0, 0) );
-
-      Volume plug_vol(det_name+"_plug", YokePlugSolid, yokeMaterial);
-      plug_vol.setVisAttributes(theDetector.visAttributes(x_det.visStr()));
-
-      double this_plug_z_offset = ( module_id == 0 ) ? - zPlug : zPlug; 
-      Position   plug_pos(0,0,this_plug_z_offset);
-      PlacedVolume  plug_phv = envelope.placeVolume(plug_vol,plug_pos);
-      string plug_name = _toString(module_id,"plug%d");
-      DetElement plug (plug_name,det_id);
-      plug.setPlacement(plug_phv);
-    }
+      Position xyzVec(0,0,this_module_z_offset);
+      RotationZYX rot(0,this_module_rotY,0);
+      Rotation3D rot3D(rot);
+      Transform3D tran3D(rot3D,xyzVec);
+
+      PlacedVolume pv = envelope.placeVolume(mod_vol,tran3D);
+      pv.addPhysVolID("module",module_id); // z: -/+ 0/6
+
+      string m_name = _toString(module_id,"module%d");
+      DetElement sd (m_name,det_id);
+      sd.setPlacement(pv);
+      sdet.add(sd);
+
+      //====================================================================
+      // If build_plug is true, Place the plug module into the world volume
+      //====================================================================
+      if(build_plug == true){
+        //      PolyhedraRegular YokePlugSolid( symmetry, M_PI/symmetry, rInnerPlug, rOuterPlug,  Yoke_Plug_module_dim_z);
+
+        SubtractionSolid YokePlugSolid( PolyhedraRegular( symmetry, M_PI/symmetry, rInnerPlug, rOuterPlug,  Yoke_Plug_module_dim_z),
+					innerBox, Position(0, 0, 0) );
+
+        Volume plug_vol(det_name+"_plug", YokePlugSolid, yokeMaterial);
+        plug_vol.setVisAttributes(theDetector.visAttributes(x_det.visStr()));
+
+        double this_plug_z_offset = ( module_id == 0 ) ? - zPlug : zPlug; 
+        Position   plug_pos(0,0,this_plug_z_offset);
+        PlacedVolume  plug_phv = envelope.placeVolume(plug_vol,plug_pos);
+        string plug_name = _toString(module_id,"plug%d");
+        DetElement plug (plug_name,det_id);
+        plug.setPlacement(plug_phv);
+      }
 
+    }
   }
 
   sdet.addExtension< LayeredCalorimeterData >( caloData ) ;
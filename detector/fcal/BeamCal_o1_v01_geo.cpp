@@ -4,6 +4,8 @@
 #include "XML/Utilities.h"
 #include "DDRec/DetectorData.h"
 
+#include "OtherDetectorHelpers.h"
+
 #include <string>
 
 // workaround for DD4hep v00-14 (and older) 
@@ -69,6 +71,8 @@ static dd4hep::Ref_t create_detector(dd4hep::Detector& theDetector,
   //Parameters we have to know about
   dd4hep::xml::Component xmlParameter = xmlBeamCal.child(_Unicode(parameter));
   const double fullCrossingAngle  = xmlParameter.attr< double >(_Unicode(crossingangle));
+  // the BeamCal is centred on the outgoing (downstream) beam, the frames are computed once for all layers
+  const ODH::CrossingFrames frames( fullCrossingAngle );
   std::cout << " The crossing angle is: " << fullCrossingAngle << " radian"  << std::endl;
 
 
@@ -90,10 +94,7 @@ static dd4hep::Ref_t create_detector(dd4hep::Detector& theDetector,
 
   // this needs the full crossing angle, because the beamCal is centred on the
   // outgoing beampipe, and the incoming beampipe is a full crossing angle away
-  const dd4hep::Position    incomingBeamPipePosition( std::tan(-fullCrossingAngle) * bcalCentreZ, 0.0, 0.0);
-  //The extra parenthesis are paramount!
-  const dd4hep::Rotation3D  incomingBeamPipeRotation( ( dd4hep::RotationY( -fullCrossingAngle ) ) );
-  const dd4hep::Transform3D incomingBPTransform( incomingBeamPipeRotation, incomingBeamPipePosition );
+  const dd4hep::Transform3D incomingBPTransform( frames.otherBeamLine( ODH::kDnstream, bcalCentreZ ) );
 
   //Envelope to place the layers in
   
@@ -109,7 +110,7 @@ static dd4hep::Ref_t create_detector(dd4hep::Detector& theDetector,
   dd4hep::Position incomingBeamPipeAtEndOfBeamCalPosition(-incomingBeamPipeRadius, incomingBeamPipeRadius, bcalInnerZ+bcalThickness);
   //This Rotation needs to be the fullCrossing angle, because the incoming beampipe has that much to the outgoing beam pipe
   //And the BeamCal is centred on the outgoing beampipe
-  incomingBeamPipeAtEndOfBeamCalPosition = dd4hep::RotationY(-fullCrossingAngle) * incomingBeamPipeAtEndOfBeamCalPosition;
+  incomingBeamPipeAtEndOfBeamCalPosition = frames.otherRotation( ODH::kDnstream ) * incomingBeamPipeAtEndOfBeamCalPosition;
   const double cutOutRadius = ( incomingBeamPipeAtEndOfBeamCalPosition.Rho() ) + 0.01*dd4hep::cm;
   std::cout << "cutOutRadius: " << cutOutRadius/dd4hep::cm << " cm " << std::endl;
 
@@ -148,8 +149,7 @@ static dd4hep::Ref_t create_detector(dd4hep::Detector& theDetector,
       dd4hep::SubtractionSolid layer_subtracted;
       { // put this in extra block to limit scope
 	const double thisPositionZ = bcalCentreZ + referencePosition + layerThickness*0.5;
-	const dd4hep::Position thisBPPosition( std::tan(-fullCrossingAngle) * thisPositionZ, 0.0, 0.0);
-	const dd4hep::Transform3D thisBPTransform( incomingBeamPipeRotation, thisBPPosition );
+	const dd4hep::Transform3D thisBPTransform( frames.otherBeamLine( ODH::kDnstream, thisPositionZ ) );
 	layer_subtracted = dd4hep::SubtractionSolid(layer_base, incomingBeamPipe, thisBPTransform);
       }
 
@@ -196,9 +196,7 @@ static dd4hep::Ref_t create_detector(dd4hep::Detector& theDetector,
 	  //to know the global position of the slice, because the cutout depends
 	  //on the outgoing beam pipe position
 	  const double thisPositionZ = bcalCentreZ + referencePosition + 0.5*layerThickness + inThisLayerPosition + slice_thickness*0.5;
-	  const dd4hep::Position thisBPPosition( std::tan(-fullCrossingAngle) * thisPositionZ, 0.0, 0.0);
-	  //The extra parenthesis are paramount! But.. there are none
-	  const dd4hep::Transform3D thisBPTransform( incomingBeamPipeRotation, thisBPPosition );
+	  const dd4hep::Transform3D thisBPTransform( frames.otherBeamLine( ODH::kDnstream, thisPositionZ ) );
 	  slice_subtracted = dd4hep::SubtractionSolid(sliceBase, incomingBeamPipe, thisBPTransform);
 	} else {
 	  //If we do not have the absorber structure then we create the slice with a wedge cutout, i.e, keyhole shape
@@ -272,17 +270,12 @@ static dd4hep::Ref_t create_detector(dd4hep::Detector& theDetector,
 
   }// for all layer collections
 
-  const dd4hep::Position bcForwardPos (std::tan(0.5*fullCrossingAngle)*bcalCentreZ,0.0, bcalCentreZ);
-  const dd4hep::Position bcBackwardPos(std::tan(0.5*fullCrossingAngle)*bcalCentreZ,0.0,-bcalCentreZ);
-  const dd4hep::Rotation3D bcForwardRot ( dd4hep::RotationY(+fullCrossingAngle*0.5 ) );
-  const dd4hep::Rotation3D bcBackwardRot( dd4hep::RotationZYX ( (180*dd4hep::degree), (180*dd4hep::degree-fullCrossingAngle*0.5), (0.0)));
-  
   dd4hep::PlacedVolume pv =
-    envelope.placeVolume(envelopeVol, dd4hep::Transform3D( bcForwardRot, bcForwardPos ) );
+    envelope.placeVolume(envelopeVol, frames.forwardPlacement( bcalCentreZ ) );
   pv.addPhysVolID("barrel", 1);
   beamCalDE_1.setPlacement(pv);
   dd4hep::PlacedVolume pv2 =
-    envelope.placeVolume(envelopeVol, dd4hep::Transform3D( bcBackwardRot, bcBackwardPos ) );
+    envelope.placeVolume(envelopeVol, frames.backwardPlacement( bcalCentreZ ) );
   pv2.addPhysVolID("barrel", 2);
   beamCalDE_2.setPlacement(pv2);
 
@@ -4,6 +4,10 @@
 #include "XML/Utilities.h"
 #include "DDRec/DetectorData.h"
 
+#include "DenseCellIndex.h"
+#include "OtherDetectorHelpers.h"
+
+#include <cmath>
 #include <string>
 
 // workaround for DD4hep v00-14 (and older) 
@@ -63,10 +67,13 @@ static dd4hep::Ref_t create_detector(dd4hep::Detector& theDetector,
 
   // counter for the current layer to be placed
   int thisLayerId = 1;
+  lcgeo::DenseCellIndex::FieldValues cellIndexValues;
 
   //Parameters we have to know about
   dd4hep::xml::Component xmlParameter = xmlBeamCal.child(_Unicode(parameter));
   const double fullCrossingAngle  = xmlParameter.attr< double >(_Unicode(crossingangle));
+  // the BeamCal is centred on the outgoing (downstream) beam, the frames are computed once for all layers
+  const ODH::CrossingFrames frames( fullCrossingAngle );
   std::cout << " The crossing angle is: " << fullCrossingAngle << " radian"  << std::endl;
 
 
@@ -88,10 +95,7 @@ static dd4hep::Ref_t create_detector(dd4hep::Detector& theDetector,
 
   // this needs the full crossing angle, because the beamCal is centred on the
   // outgoing beampipe, and the incoming beampipe is a full crossing angle away
-  const dd4hep::Position    incomingBeamPipePosition( std::tan(-fullCrossingAngle) * bcalCentreZ, 0.0, 0.0);
-  //The extra parenthesis are paramount!
-  const dd4hep::Rotation3D  incomingBeamPipeRotation( ( dd4hep::RotationY( -fullCrossingAngle ) ) );
-  const dd4hep::Transform3D incomingBPTransform( incomingBeamPipeRotation, incomingBeamPipePosition );
+  const dd4hep::Transform3D incomingBPTransform( frames.otherBeamLine( ODH::kDnstream, bcalCentreZ ) );
 
   //Envelope to place the layers in
   
@@ -107,7 +111,7 @@ static dd4hep::Ref_t create_detector(dd4hep::Detector& theDetector,
   dd4hep::Position incomingBeamPipeAtEndOfBeamCalPosition(-incomingBeamPipeRadius, incomingBeamPipeRadius, bcalInnerZ+bcalThickness);
   //This Rotation needs to be the fullCrossing angle, because the incoming beampipe has that much to the outgoing beam pipe
   //And the BeamCal is centred on the outgoing beampipe
-  incomingBeamPipeAtEndOfBeamCalPosition = dd4hep::RotationY(-fullCrossingAngle) * incomingBeamPipeAtEndOfBeamCalPosition;
+  incomingBeamPipeAtEndOfBeamCalPosition = frames.otherRotation( ODH::kDnstream ) * incomingBeamPipeAtEndOfBeamCalPosition;
   const double cutOutRadius = ( incomingBeamPipeAtEndOfBeamCalPosition.Rho() ) + 0.01*dd4hep::cm;
   std::cout << "cutOutRadius: " << cutOutRadius/dd4hep::cm << " cm " << std::endl;
 
@@ -185,9 +189,7 @@ static dd4hep::Ref_t create_detector(dd4hep::Detector& theDetector,
 	  //to know the global position of the slice, because the cutout depends
 	  //on the outgoing beam pipe position
 	  const double thisPositionZ = bcalCentreZ + referencePosition + 0.5*layerThickness + inThisLayerPosition + slice_thickness*0.5;
-	  const dd4hep::Position thisBPPosition( std::tan(-fullCrossingAngle) * thisPositionZ, 0.0, 0.0);
-	  //The extra parenthesis are paramount! But.. there are none
-	  const dd4hep::Transform3D thisBPTransform( incomingBeamPipeRotation, thisBPPosition );
+	  const dd4hep::Transform3D thisBPTransform( frames.otherBeamLine( ODH::kDnstream, thisPositionZ ) );
 	  slice_subtracted = dd4hep::SubtractionSolid(sliceBase, incomingBeamPipe, thisBPTransform);
 	} else {
 	  //If we do not have the absorber structure then we create the slice with a wedge cutout, i.e, keyhole shape
@@ -203,6 +205,7 @@ static dd4hep::Ref_t create_detector(dd4hep::Detector& theDetector,
                 
 	if ( compSlice.isSensitive() )  {
 	  slice_vol.setSensitiveDetector(sens);
+	  lcgeo::DenseCellIndex::extend( cellIndexValues, "slice", sliceID );
           
 #if DD4HEP_VERSION_GE( 0, 15 )
           //Store "inner" quantities
@@ -261,22 +264,37 @@ static dd4hep::Ref_t create_detector(dd4hep::Detector& theDetector,
 
   }// for all layer collections
 
-  const dd4hep::Position bcForwardPos (std::tan(0.5*fullCrossingAngle)*bcalCentreZ,0.0, bcalCentreZ);
-  const dd4hep::Position bcBackwardPos(std::tan(0.5*fullCrossingAngle)*bcalCentreZ,0.0,-bcalCentreZ);
-  const dd4hep::Rotation3D bcForwardRot ( dd4hep::RotationY(+fullCrossingAngle*0.5 ) );
-  const dd4hep::Rotation3D bcBackwardRot( dd4hep::RotationZYX ( (180*dd4hep::degree), (180*dd4hep::degree-fullCrossingAngle*0.5), (0.0)));
-  
   dd4hep::PlacedVolume pv =
-    envelope.placeVolume(envelopeVol, dd4hep::Transform3D( bcForwardRot, bcForwardPos ) );
+    envelope.placeVolume(envelopeVol, frames.forwardPlacement( bcalCentreZ ) );
   pv.addPhysVolID("barrel", 1);
   beamCalDE_1.setPlacement(pv);
   dd4hep::PlacedVolume pv2 =
-    envelope.placeVolume(envelopeVol, dd4hep::Transform3D( bcBackwardRot, bcBackwardPos ) );
+    envelope.placeVolume(envelopeVol, frames.backwardPlacement( bcalCentreZ ) );
   pv2.addPhysVolID("barrel", 2);
   beamCalDE_2.setPlacement(pv2);
 
   sdet.addExtension< dd4hep::rec::LayeredCalorimeterData >( caloData ) ;
 
+  // dense index of the (layer, r, phi) cells, e.g. for accumulating the pair background in the simulation
+  const dd4hep::DDSegmentation::Segmentation& seg = *sens.readout().segmentation().segmentation();
+  const dd4hep::DDSegmentation::BitFieldCoder& idDecoder = *sens.readout().idSpec().decoder();
+  lcgeo::DenseCellIndex::SensitiveRing sensorRing;
+  sensorRing.rMin = bcalInnerR;
+  sensorRing.rMax = bcalOuterR;
+  lcgeo::DenseCellIndex::extend( cellIndexValues, "system", xmlBeamCal.id() );
+  lcgeo::DenseCellIndex::extend( cellIndexValues, "barrel", 1, 2 );
+  lcgeo::DenseCellIndex::extend( cellIndexValues, "layer", 1, thisLayerId-1 );
+  lcgeo::DenseCellIndex::extend( cellIndexValues, idDecoder, seg, sensorRing );
+  lcgeo::DenseCellIndex* cellIndex = new lcgeo::DenseCellIndex( idDecoder, cellIndexValues );
+  // no cells in the keyhole cutout of the sensors
+  cellIndex->setValid( seg, sensorRing, [=]( double x, double y ) {
+      double phi = std::atan2( y, x );
+      if( phi < 0. ) phi += 2.*M_PI;
+      return std::sqrt( x*x + y*y ) < cutOutRadius && phi > bcalCutOutStart && phi < bcalCutOutEnd;
+    } );
+  sdet.addExtension< lcgeo::DenseCellIndex >( cellIndex );
+  std::cout << "BeamCal: " << cellIndex->numberOfChannels() << " readout channels" << std::endl;
+
   return sdet;
 }
 
@@ -4,6 +4,8 @@
 #include "XML/Utilities.h"
 #include "DDRec/DetectorData.h"
 
+#include "OtherDetectorHelpers.h"
+
 #include <string>
 
 using dd4hep::Assembly;
@@ -22,12 +24,8 @@ using dd4hep::PolyhedraRegular;
 using dd4hep::Position;
 using dd4hep::Readout;
 using dd4hep::Ref_t;
-using dd4hep::Rotation3D;
-using dd4hep::RotationY;
-using dd4hep::RotationZYX;
 using dd4hep::SensitiveDetector;
 using dd4hep::SubtractionSolid;
-using dd4hep::Transform3D;
 using dd4hep::Translation3D;
 using dd4hep::Trapezoid;
 using dd4hep::Tube;
@@ -222,18 +220,16 @@ static Ref_t create_detector(Detector& theDetector,
         
     }// for all layer collections
     
-    const Position bcForwardPos (std::tan(0.5*fullCrossingAngle)*lcalCentreZ,0.0, lcalCentreZ);
-    const Position bcBackwardPos(std::tan(0.5*fullCrossingAngle)*lcalCentreZ,0.0,-lcalCentreZ);
-    const Rotation3D bcForwardRot ( RotationY(fullCrossingAngle*0.5 ) );
-    const Rotation3D bcBackwardRot( RotationZYX ( (M_PI), (M_PI-fullCrossingAngle*0.5), (0.0)));
+    // the LumiCal is centred on the outgoing beam
+    const ODH::CrossingFrames frames( fullCrossingAngle );
     
     PlacedVolume pv =
-    envelope.placeVolume(envelopeVol, Transform3D( bcForwardRot, bcForwardPos ) );
+    envelope.placeVolume(envelopeVol, frames.forwardPlacement( lcalCentreZ ) );
     pv.addPhysVolID("barrel", 1);
     lumiCalDE_1.setPlacement(pv);
 
     PlacedVolume pv2 =
-    envelope.placeVolume(envelopeVol, Transform3D( bcBackwardRot, bcBackwardPos ) );
+    envelope.placeVolume(envelopeVol, frames.backwardPlacement( lcalCentreZ ) );
     pv2.addPhysVolID("barrel", 2);
     lumiCalDE_2.setPlacement(pv2);
     
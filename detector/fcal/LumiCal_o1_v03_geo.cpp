@@ -5,6 +5,9 @@
 #include "XML/Utilities.h"
 #include "DDRec/DetectorData.h"
 
+#include "DenseCellIndex.h"
+#include "OtherDetectorHelpers.h"
+
 #include <string>
 
 using dd4hep::Assembly;
@@ -79,6 +82,8 @@ static Ref_t create_detector(Detector& theDetector,
     //Parameters we have to know about
     dd4hep::xml::Component xmlParameter = xmlLumiCal.child(_Unicode(parameter));
     const double fullCrossingAngle  = xmlParameter.attr< double >(_Unicode(crossingangle));
+    // the LumiCal is centred on the outgoing (downstream) beam
+    const ODH::CrossingFrames frames( fullCrossingAngle );
 
     
     //LumiCal Dimensions
@@ -103,7 +108,7 @@ static Ref_t create_detector(Detector& theDetector,
     const double staggerPhi    = layerStagger*cellPhiSize;   
     const double lcalThickness = Layering(xmlLumiCal).totalThickness();
     const double lcalCentreZ   = lcalInnerZ+lcalThickness*0.5;
-    const double lcalXoffset = lcalCentreZ * std::tan( fullCrossingAngle/2. );
+    const double lcalXoffset = frames.xOffset( ODH::kDnstream, lcalCentreZ );
 
     // inner/outer radii are not the sensor dims, these we have to compute
     const double sensInnerR = lcalInnerR/cos( lcalSectors*cellPhiSize/2. ) + lcalRGap;
@@ -214,6 +219,7 @@ static Ref_t create_detector(Detector& theDetector,
     //  Loop over all the layer (repeat=NN) sections
     //  counter for the current layer to be placed
     int thisLayerId = 0;
+    lcgeo::DenseCellIndex::FieldValues cellIndexValues;
     double mtotalRadLen = 0.;
     double mtotalDepthZ = 0.;
    //This is the starting point to place all layers, we need this when we have more than one layer block
@@ -288,6 +294,7 @@ static Ref_t create_detector(Detector& theDetector,
                     nInteractionLengths=0.;
                     thickness_sum = 0.;
 #endif                    
+                    // the slices are placed without a "slice" ID, so it stays 0 in the cellIDs and the index
                     slice_vol.setSensitiveDetector(sens);
                 }
                 
@@ -355,13 +362,12 @@ static Ref_t create_detector(Detector& theDetector,
 	     << " ( rad. length X0: "<< mtotalRadLen << "   )"<<std::endl;
     std::cout << "-----------------------------------------------------------------"  << std::endl<<std::endl;;
     
-    const Position bcForwardPos ( lcalXoffset,0.0, lcalCentreZ);
+    // at -z only mirrored by a rotation around the y-axis, not turned around z as the other forward calorimeters
     const Position bcBackwardPos( lcalXoffset,0.0,-lcalCentreZ);
-    const RotationY bcForwardRot ( fullCrossingAngle*0.5  );
-    const RotationY bcBackwardRot( M_PI-fullCrossingAngle*0.5 );
+    const RotationY& bcBackwardRot( frames.mirrorRotation( ODH::kDnstream ) );
     
     PlacedVolume pv =
-    envelope.placeVolume(envelopeVol, Transform3D( bcForwardRot, bcForwardPos ) );
+    envelope.placeVolume(envelopeVol, frames.forwardPlacement( lcalCentreZ ) );
     pv.addPhysVolID("barrel", 1);
     lumiCalDE_1.setPlacement(pv);
 
@@ -371,6 +377,21 @@ static Ref_t create_detector(Detector& theDetector,
     lumiCalDE_2.setPlacement(pv2);
     
     sdet.addExtension< LayeredCalorimeterData >( caloData ) ;
+
+    // dense index of the (layer, r, phi) cells, e.g. for accumulating the pair background in the simulation
+    const dd4hep::DDSegmentation::Segmentation& seg = *sens.readout().segmentation().segmentation();
+    const dd4hep::DDSegmentation::BitFieldCoder& idDecoder = *sens.readout().idSpec().decoder();
+    lcgeo::DenseCellIndex::SensitiveRing sensorRing;
+    sensorRing.rMin = sensInnerR;
+    sensorRing.rMax = sensOuterR;
+    lcgeo::DenseCellIndex::extend( cellIndexValues, "system", xmlLumiCal.id() );
+    lcgeo::DenseCellIndex::extend( cellIndexValues, "barrel", 1, 2 );
+    lcgeo::DenseCellIndex::extend( cellIndexValues, "layer", 0, thisLayerId-1 );
+    lcgeo::DenseCellIndex::extend( cellIndexValues, idDecoder, seg, sensorRing );
+    lcgeo::DenseCellIndex* cellIndex = new lcgeo::DenseCellIndex( idDecoder, cellIndexValues );
+    cellIndex->setValid( seg, sensorRing );
+    sdet.addExtension< lcgeo::DenseCellIndex >( cellIndex );
+    std::cout << "   LumiCal readout channels : " << cellIndex->numberOfChannels() << std::endl;
     
     return sdet;
 }
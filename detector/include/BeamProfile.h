@@ -0,0 +1,132 @@
+//====================================================================
+//  lcgeo - LC detector models in DD4hep
+//--------------------------------------------------------------------
+//  Beam profile of a test beam and the energy points of a scan, for
+//  the test beam runner TestBeamScan and the DDG4 action TestBeamGun
+//  - uses the C++ standard library only
+//====================================================================
+#ifndef BeamProfile_h
+#define BeamProfile_h
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace lcgeo {
+
+  /// one particle of the beam: start point in mm, unit direction and energy in GeV
+  struct BeamParticle {
+    double x = 0., y = 0., z = 0. ;
+    double dx = 0., dy = 0., dz = 1. ;
+    double energy = 0. ;
+  };
+
+  /** The transverse profile, divergence and energy spread of a test beam along z. The spot is either
+   *  Gaussian (widths are the sigmas) or flat (widths are the half widths of a rectangle), the slopes
+   *  dx/dz and dy/dz are Gaussian with the divergences as sigmas and the energy is Gaussian with the
+   *  relative energy spread. Each particle is drawn from its own generator seeded with the seed, the
+   *  energy point and the event number, so that a scan gives the same beam whatever the number of
+   *  threads and the order of the events:
+   *  @code
+   *    lcgeo::BeamProfile beam ;
+   *    beam.widthX = beam.widthY = 10. ;
+   *    beam.z = -1000. ;
+   *    lcgeo::BeamParticle p = beam.sample( 10., point, event ) ;
+   *  @endcode
+   */
+  struct BeamProfile {
+
+    enum Shape { Gaussian, Flat } ;
+
+    Shape shape = Gaussian ;
+    double meanX = 0., meanY = 0. ;             // mm
+    double widthX = 0., widthY = 0. ;           // mm, sigma or half width
+    double z = 0. ;                             // mm
+    double divergenceX = 0., divergenceY = 0. ; // rad
+    double energySpread = 0. ;                  // relative
+    unsigned seed = 0 ;
+
+    /// the shape for "gaussian" or "flat" - throws a std::runtime_error for other names
+    static Shape shapeOf( const std::string& name ){
+      if( name == "gaussian" ) return Gaussian ;
+      if( name == "flat" ) return Flat ;
+      throw std::runtime_error( "BeamProfile: unknown beam profile " + name + ", use gaussian or flat" ) ;
+    }
+
+    /// a beam particle for the nominal energy in GeV of the energy point and the event
+    BeamParticle sample( double energy, int point, int event ) const {
+      std::seed_seq seq{ seed, unsigned( point ), unsigned( event ) } ;
+      std::mt19937_64 rng( seq ) ;
+      std::normal_distribution<double> gauss ;
+      std::uniform_real_distribution<double> flat( -1., 1. ) ;
+
+      BeamParticle p ;
+      const double u = shape == Flat ? flat( rng ) : gauss( rng ) ;
+      const double v = shape == Flat ? flat( rng ) : gauss( rng ) ;
+      p.x = meanX + widthX * u ;
+      p.y = meanY + widthY * v ;
+      p.z = z ;
+      const double slopeX = divergenceX * gauss( rng ) ;
+      const double slopeY = divergenceY * gauss( rng ) ;
+      const double norm = 1. / std::sqrt( 1. + slopeX * slopeX + slopeY * slopeY ) ;
+      p.dx = slopeX * norm ;
+      p.dy = slopeY * norm ;
+      p.dz = norm ;
+      p.energy = energy * ( 1. + energySpread * gauss( rng ) ) ;
+      if( p.energy < 0. ) p.energy = 0. ;
+      return p ;
+    }
+  };
+
+  /** The energy points in GeV of a scan, given as a comma separated list of energies and ranges
+   *  first:last:step, e.g. "1,2,5:50:5" - throws a std::runtime_error for anything else.
+   */
+  inline std::vector<double> parseEnergyPoints( const std::string& text ){
+    std::vector<double> energies ;
+    if( ! text.empty() && text.back() == ',' )
+      throw std::runtime_error( "parseEnergyPoints: no energy after the last comma in " + text ) ;
+    std::stringstream list( text ) ;
+    std::string item ;
+    while( std::getline( list, item, ',' ) ){
+      std::vector<double> values ;
+      std::stringstream range( item ) ;
+      std::string value ;
+      while( std::getline( range, value, ':' ) ){
+	char* end = 0 ;
+	values.push_back( std::strtod( value.c_str(), &end ) ) ;
+	if( value.empty() || *end != 0 || ! ( values.back() > 0. ) )
+	  throw std::runtime_error( "parseEnergyPoints: not an energy " + value + " in " + text ) ;
+      }
+      if( values.size() == 1 ){
+	energies.push_back( values[0] ) ;
+      } else if( values.size() == 3 && values[1] >= values[0] ){
+	// the last energy is included up to rounding of the step
+	const int n = int( std::floor( ( values[1] - values[0] ) / values[2] + 1e-9 ) ) ;
+	for( int i = 0 ; i <= n ; ++i ) energies.push_back( values[0] + i * values[2] ) ;
+      } else {
+	throw std::runtime_error( "parseEnergyPoints: not a range first:last:step " + item + " in " + text ) ;
+      }
+    }
+    if( energies.empty() )
+      throw std::runtime_error( "parseEnergyPoints: no energies in " + text ) ;
+    return energies ;
+  }
+
+  /// the output file of an energy point: the energy inserted before the extension, e.g. scan_10GeV.txt
+  inline std::string energyPointFileName( const std::string& fileName, double energy ){
+    char label[ 64 ] ;
+    std::snprintf( label, sizeof(label), "_%gGeV", energy ) ;
+    const std::size_t dot = fileName.find_last_of( '.' ) ;
+    const std::size_t slash = fileName.find_last_of( '/' ) ;
+    if( dot == std::string::npos || ( slash != std::string::npos && dot < slash ) ) return fileName + label ;
+    return fileName.substr( 0, dot ) + label + fileName.substr( dot ) ;
+  }
+
+}
+
+#endif
@@ -0,0 +1,81 @@
+//====================================================================
+//  lcgeo - LC detector models in DD4hep
+//--------------------------------------------------------------------
+//  Global positions of the calorimeter cells that have been hit,
+//  cached by the sensitive actions per thread
+//====================================================================
+#ifndef CellPositionCache_h
+#define CellPositionCache_h
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace lcgeo {
+
+  /** Global positions of the cells, stored at the dense index of the cell (see lcgeo::DenseCellIndex)
+   *  when the cell is hit for the first time. Memory is allocated in pages of cells that have been hit.
+   *
+   *  The cache is filled lazily by each sensitive action (ie. per thread) rather than being built by the
+   *  drivers as a shared extension of the DetElement: a table of all valid cells of the ILD Ecal would take
+   *  several GB, the hit cells of a run are a small fraction, and the global transformations are not final
+   *  while the drivers run. A cellID fixes the placement, so the cached position is the one computed for
+   *  the first hit of the cell (tested in TestCellPositionCache).
+   *  @code
+   *    lcgeo::CellPositionCache cache ;
+   *    cache.resize( index->size() ) ;
+   *    Position global = cache.position<Position>( index->index( cellID ), [&](){ return compute( cellID ) ; } ) ;
+   *  @endcode
+   */
+  class CellPositionCache {
+
+  public:
+
+    /// empty cache for nCells cells
+    void resize( long nCells ){
+      _pages.clear() ;
+      _pages.resize( ( nCells + pageSize - 1 ) / pageSize ) ;
+    }
+
+    /// the x,y,z of the cell with the given index - NaN if not yet set
+    double* entry( long index ){
+      std::unique_ptr<double[]>& page = _pages[ index / pageSize ] ;
+      if( ! page ){
+	page.reset( new double[ 3 * pageSize ] ) ;
+	std::fill( page.get(), page.get() + 3 * pageSize, std::numeric_limits<double>::quiet_NaN() ) ;
+      }
+      return page.get() + 3 * ( index % pageSize ) ;
+    }
+
+    /** the position of the cell with the given index: compute() the first time, from the cache afterwards.
+     *  Cells with a negative index (outside of the dense index) are always computed.
+     */
+    template <class Position, class Compute>
+    Position position( long index, Compute compute ){
+      double* cached = ( index >= 0 ) ? entry( index ) : nullptr ;
+      Position global ;
+      if( cached && ! std::isnan( cached[0] ) ){
+	global.SetCoordinates( cached ) ;
+	return global ;
+      }
+      global = compute() ;
+      if( cached ) global.GetCoordinates( cached ) ;
+      return global ;
+    }
+
+    /// number of pages allocated
+    long numberOfPages() const {
+      return std::count_if( _pages.begin(), _pages.end(), []( const std::unique_ptr<double[]>& p ){ return bool( p ) ; } ) ;
+    }
+
+    static constexpr long pageSize = 4096 ;
+
+  private:
+    std::vector< std::unique_ptr<double[]> > _pages {} ;
+  };
+
+}
+
+#endif
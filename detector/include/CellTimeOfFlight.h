@@ -0,0 +1,110 @@
+//====================================================================
+//  lcgeo - LC detector models in DD4hep
+//--------------------------------------------------------------------
+//  Straight line time of flight from the IP to the calorimeter cells,
+//  attached to the DetElement by the plugin lcgeo_CellTimeOfFlight
+//====================================================================
+#ifndef CellTimeOfFlight_h
+#define CellTimeOfFlight_h
+
+#include "DenseCellIndex.h"
+
+#include "DD4hep/DD4hepUnits.h"
+#include "DDSegmentation/Segmentation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace lcgeo {
+
+  /** Time of flight of a particle with the speed of light from the origin to the centre of the cells of a
+   *  readout, for subtracting it from the hit times in timing cuts. Two modes are supported:
+   *   - per sensitive volume: for every placement of a sensitive volume the distance of a local point p to the
+   *     origin is |R p + t|^2 = |p|^2 + 2 p.(R^T t) + |t|^2, so four numbers per volume give the exact time of
+   *     flight of all its cells from their local position in the segmentation
+   *   - per cell: a table of the times of flight of all valid cells of the lcgeo::DenseCellIndex, made from the
+   *     placements with fillCells(), for O(1) lookups without the segmentation
+   *  Times are in dd4hep units (ns):
+   *  @code
+   *    const lcgeo::CellTimeOfFlight* tof = det.extension<lcgeo::CellTimeOfFlight>( false ) ;
+   *    double t = hitTime - tof->timeOfFlight( cellID ) ;
+   *  @endcode
+   */
+  class CellTimeOfFlight {
+
+  public:
+
+    typedef dd4hep::DDSegmentation::CellID CellID ;
+
+    /// the placement of a sensitive volume, reduced to what is needed for the distance of its points to the origin
+    struct Placement {
+      double a[3] = { 0., 0., 0. } ; // R^T t
+      double t2 = 0. ;               // |t|^2
+    };
+
+    /** the cells are given by the dense index of the readout, volumeMask selects the fields of the cellID that
+     *  identify the placement of the sensitive volume
+     */
+    CellTimeOfFlight( const DenseCellIndex& index, const dd4hep::DDSegmentation::Segmentation& seg, CellID volumeMask ) :
+      _index( &index ), _seg( &seg ), _volumeMask( volumeMask ) {}
+
+    /// the fields of the cellID that identify the placement of the sensitive volume
+    CellID volumeMask() const { return _volumeMask ; }
+
+    /// add the placement of the sensitive volume with the world transformation R (row major) and t
+    void addPlacement( CellID volumeID, const double* rotation, const double* translation ){
+      Placement& p = _placements[ volumeID & _volumeMask ] ;
+      for( int i = 0 ; i < 3 ; ++i )
+	p.a[i] = rotation[i] * translation[0] + rotation[3+i] * translation[1] + rotation[6+i] * translation[2] ;
+      p.t2 = translation[0] * translation[0] + translation[1] * translation[1] + translation[2] * translation[2] ;
+    }
+
+    /// true if there is a placement for the sensitive volume of the cell
+    bool hasPlacement( CellID cellID ) const { return _placements.count( cellID & _volumeMask ) != 0 ; }
+
+    /// number of placements of sensitive volumes
+    long numberOfPlacements() const { return _placements.size() ; }
+
+    /// make the table of the times of flight of all valid cells of the index from the placements
+    void fillCells(){
+      _cells.assign( _index->size(), std::numeric_limits<float>::quiet_NaN() ) ;
+      for( long idx = 0 ; idx < _index->size() ; ++idx )
+	if( _index->isValidIndex( idx ) ) _cells[ idx ] = fromPlacement( _index->cellID( idx ) ) ;
+    }
+
+    /// true if the times of flight are stored per cell
+    bool hasCellTable() const { return ! _cells.empty() ; }
+
+    /// time of flight from the origin to the centre of the cell - NaN if the cell is unknown
+    double timeOfFlight( CellID cellID ) const {
+      if( ! _cells.empty() ){
+	const long idx = _index->index( cellID ) ;
+	if( idx >= 0 ) return _cells[ idx ] ;
+      }
+      return fromPlacement( cellID ) ;
+    }
+
+  private:
+
+    double fromPlacement( CellID cellID ) const {
+      auto it = _placements.find( cellID & _volumeMask ) ;
+      if( it == _placements.end() ) return std::numeric_limits<double>::quiet_NaN() ;
+      const Placement& p = it->second ;
+      const dd4hep::DDSegmentation::Vector3D l = _seg->position( cellID ) ;
+      const double d2 = l.X * l.X + l.Y * l.Y + l.Z * l.Z + 2. * ( l.X * p.a[0] + l.Y * p.a[1] + l.Z * p.a[2] ) + p.t2 ;
+      return std::sqrt( std::max( d2, 0. ) ) / dd4hep::c_light ;
+    }
+
+    const DenseCellIndex* _index = nullptr ;
+    const dd4hep::DDSegmentation::Segmentation* _seg = nullptr ;
+    CellID _volumeMask = 0 ;
+    std::unordered_map< CellID, Placement > _placements {} ;
+    std::vector<float> _cells {} ;
+  };
+
+}
+
+#endif
@@ -0,0 +1,330 @@
+//====================================================================
+//  lcgeo - LC detector models in DD4hep
+//--------------------------------------------------------------------
+//  Dense index for the cellIDs of a readout, published by the
+//  calorimeter drivers as extension of their DetElement
+//====================================================================
+#ifndef DenseCellIndex_h
+#define DenseCellIndex_h
+
+#include "LcgeoExceptions.h"
+
+#include "DD4hep/DD4hepUnits.h"
+#include "DDSegmentation/BitFieldCoder.h"
+#include "DDSegmentation/Segmentation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lcgeo {
+
+  /** Bijective map between the cellIDs of a readout and the consecutive numbers [0,size()).
+   *  Every field of the cellID that is given a set of values contributes the number of its
+   *  values as factor to the size of the index, all other fields have to be zero. The drivers
+   *  know the values of their fields while building the detector and attach the index to the
+   *  DetElement, together with a bitmap of the cells that exist in the detector:
+   *  @code
+   *    const lcgeo::DenseCellIndex* index = det.extension<lcgeo::DenseCellIndex>( false ) ;
+   *    std::vector<float> energy( index->size() ) ;
+   *    long i = index->index( cellID ) ;  // -1 for cellIDs outside of the index
+   *    std::cout << index->numberOfChannels() << " readout channels" << std::endl ;
+   *  @endcode
+   */
+  class DenseCellIndex {
+
+  public:
+
+    typedef dd4hep::DDSegmentation::CellID CellID ;
+
+    /// the values of the fields
+    typedef std::map< std::string, std::set<long> > FieldValues ;
+
+    /// a rectangular sensitive area with half lengths dx, dy around the origin of the local frame of a volume
+    struct SensitiveArea {
+      CellID volumeID = 0 ;
+      double dx = 0. ;
+      double dy = 0. ;
+    };
+
+    /// a ring rMin < r < rMax around the origin of the local frame of the sensitive volumes, segmented in r and phi
+    struct SensitiveRing {
+      double rMin = 0. ;
+      double rMax = 0. ;
+    };
+
+    /// add value to the values of the field
+    static void extend( FieldValues& values, const std::string& field, long value ){
+      values[ field ].insert( value ) ;
+    }
+
+    /// add [min,max] to the values of the field
+    static void extend( FieldValues& values, const std::string& field, long min, long max ){
+      std::set<long>& v = values[ field ] ;
+      for( long i = min ; i <= max ; ++i ) v.insert( i ) ;
+    }
+
+    /// add the values of all fields of the cells in the area, as given by the segmentation at the corners of the area
+    static void extend( FieldValues& values, const dd4hep::DDSegmentation::BitFieldCoder& decoder,
+			const dd4hep::DDSegmentation::Segmentation& seg, const SensitiveArea& area ){
+      CellID lo, hi ;
+      cornerCells( seg, area, lo, hi ) ;
+      for( std::size_t i = 0 ; i < decoder.size() ; ++i ){
+	const long a = decoder[i].value( lo ), b = decoder[i].value( hi ) ;
+	extend( values, decoder[i].name(), std::min( a, b ), std::max( a, b ) ) ;
+      }
+    }
+
+    /** add the values of all fields of the cells in the ring, as given by the segmentation at radii across the
+     *  ring and at phi = -pi, 0, pi, e.g. for PolarGridRPhi and PolarGridRPhi2
+     */
+    static void extend( FieldValues& values, const dd4hep::DDSegmentation::BitFieldCoder& decoder,
+			const dd4hep::DDSegmentation::Segmentation& seg, const SensitiveRing& ring ){
+      const double eps = 1e-5 * dd4hep::mm, phiEps = 1e-7 ;
+      const double phis[] = { -M_PI + phiEps, 0., M_PI - phiEps } ;
+      const int nR = 64 ;
+      const dd4hep::DDSegmentation::Vector3D global ;
+      std::vector<long> vMin( decoder.size(), 0 ), vMax( decoder.size(), 0 ) ;
+      bool first = true ;
+      for( int i = 0 ; i <= nR ; ++i ){
+	const double r = ring.rMin + eps + ( ring.rMax - ring.rMin - 2. * eps ) * i / nR ;
+	for( double phi : phis ){
+	  const CellID id = seg.cellID( dd4hep::DDSegmentation::Vector3D( r * std::cos( phi ), r * std::sin( phi ), 0. ), global, 0 ) ;
+	  for( std::size_t f = 0 ; f < decoder.size() ; ++f ){
+	    const long v = decoder[f].value( id ) ;
+	    vMin[f] = first ? v : std::min( vMin[f], v ) ;
+	    vMax[f] = first ? v : std::max( vMax[f], v ) ;
+	  }
+	  first = false ;
+	}
+      }
+      for( std::size_t f = 0 ; f < decoder.size() ; ++f )
+	if( vMin[f] != 0 || vMax[f] != 0 ) extend( values, decoder[f].name(), vMin[f], vMax[f] ) ;
+    }
+
+    /** set the field of the volumeID to value, if the decoder has the field - as for placements, negative
+     *  values of unsigned fields are stored modulo the field size
+     */
+    static void setField( const dd4hep::DDSegmentation::BitFieldCoder& decoder, CellID& volumeID, const std::string& field, long value ){
+      for( std::size_t i = 0 ; i < decoder.size() ; ++i ){
+	const dd4hep::DDSegmentation::BitFieldElement& element = decoder[i] ;
+	if( element.name() != field ) continue ;
+	volumeID = ( volumeID & ~element.mask() ) | ( ( CellID( value ) << element.offset() ) & element.mask() ) ;
+      }
+    }
+
+    /** the index of all cells of the sensitive areas, which are replicated for all values of the fields in
+     *  replicated, e.g. module and stave of identical modules. The replicated fields of the volumeIDs
+     *  of the areas are ignored.
+     */
+    static DenseCellIndex* create( const dd4hep::DDSegmentation::BitFieldCoder& decoder,
+				   const dd4hep::DDSegmentation::Segmentation& seg,
+				   std::vector<SensitiveArea> areas, const FieldValues& replicated ){
+      FieldValues values( replicated ) ;
+      std::vector<std::string> spanFields ;
+      for( const auto& r : replicated ) spanFields.push_back( r.first ) ;
+
+      for( SensitiveArea& area : areas ){
+	for( const auto& r : replicated ) setField( decoder, area.volumeID, r.first, *r.second.begin() ) ;
+	extend( values, decoder, seg, area ) ;
+      }
+      DenseCellIndex* index = new DenseCellIndex( decoder, values ) ;
+      for( const SensitiveArea& area : areas ) index->setValid( seg, area, spanFields ) ;
+      return index ;
+    }
+
+    DenseCellIndex() = default ;
+
+    /** the fields are taken from the decoder, the field with the largest offset varies fastest in the index.
+     *  Values of fields that the decoder does not have are ignored, so that the drivers can fill them
+     *  independently of the optional fields of the readout (e.g. slice).
+     */
+    DenseCellIndex( const dd4hep::DDSegmentation::BitFieldCoder& decoder, const FieldValues& values ){
+
+      for( std::size_t i = 0 ; i < decoder.size() ; ++i ){
+	const dd4hep::DDSegmentation::BitFieldElement& element = decoder[i] ;
+	const CellID mask = element.width() < 64 ? ( ( CellID(1) << element.width() ) - 1 ) : ~CellID(0) ;
+	FieldValues::const_iterator it = values.find( element.name() ) ;
+	if( it == values.end() || it->second.empty() ){
+	  _fixedMask |= mask << element.offset() ;
+	  continue ;
+	}
+	Field field ;
+	field.name = element.name() ;
+	field.offset = element.offset() ;
+	field.width = element.width() ;
+	field.isSigned = element.isSigned() ;
+	field.mask = mask ;
+	// values the field cannot hold are dropped
+	for( long v : it->second )
+	  if( v >= element.minValue() && v <= element.maxValue() ) field.values.push_back( v ) ;
+	if( field.values.empty() )
+	  throw GeometryException( "DenseCellIndex: no valid values for field " + element.name() ) ;
+	field.min = field.values.front() ;
+	field.ordinals.assign( field.values.back() - field.min + 1, -1 ) ;
+	for( std::size_t o = 0 ; o < field.values.size() ; ++o ) field.ordinals[ field.values[o] - field.min ] = o ;
+	_fields.push_back( field ) ;
+      }
+
+      // strides from the fastest (last) field to the slowest
+      long stride = 1 ;
+      for( std::size_t i = _fields.size() ; i-- > 0 ; ){
+	_fields[i].stride = stride ;
+	const long count = _fields[i].values.size() ;
+	if( count > ( long(1) << 62 ) / stride )
+	  throw GeometryException( "DenseCellIndex: too many cells for a dense index" ) ;
+	stride *= count ;
+      }
+      _size = stride ;
+    }
+
+    /// number of indices, ie. the product of the numbers of values of all fields
+    long size() const { return _size ; }
+
+    /// index of the cellID or -1 if a field has a value that is not in the index
+    long index( CellID cellID ) const {
+      if( ( cellID & _fixedMask ) != 0 ) return -1 ;
+      long idx = 0 ;
+      for( const Field& f : _fields ){
+	const long o = f.ordinal( f.value( cellID ) ) ;
+	if( o < 0 ) return -1 ;
+	idx += o * f.stride ;
+      }
+      return idx ;
+    }
+
+    /// cellID of the index, the inverse of index()
+    CellID cellID( long idx ) const {
+      CellID id = 0 ;
+      for( const Field& f : _fields ){
+	const long value = f.values[ ( idx / f.stride ) % f.values.size() ] ;
+	id |= ( CellID( value ) & f.mask ) << f.offset ;
+      }
+      return id ;
+    }
+
+    /// mark the cell with this index as existing in the detector
+    void setValid( long idx ){
+      if( _valid.empty() ) _valid.resize( _size, false ) ;
+      if( ! _valid[ idx ] ){
+	_valid[ idx ] = true ;
+	++_nChannels ;
+      }
+    }
+
+    /** mark the cells of the sensitive area as existing in the detector, for all values of the fields
+     *  in spanFields. The cells are found from the segmentation at the corners of the area.
+     */
+    void setValid( const dd4hep::DDSegmentation::Segmentation& seg, const SensitiveArea& area,
+		   const std::vector<std::string>& spanFields = std::vector<std::string>() ){
+      CellID lo, hi ;
+      cornerCells( seg, area, lo, hi ) ;
+
+      // the contributions to the index of each field
+      std::vector< std::vector<long> > terms( _fields.size() ) ;
+      for( std::size_t i = 0 ; i < _fields.size() ; ++i ){
+	const Field& f = _fields[i] ;
+	const bool span = std::find( spanFields.begin(), spanFields.end(), f.name ) != spanFields.end() ;
+	const long vMin = std::min( f.value( lo ), f.value( hi ) ), vMax = std::max( f.value( lo ), f.value( hi ) ) ;
+	for( std::size_t o = 0 ; o < f.values.size() ; ++o )
+	  if( span || ( f.values[o] >= vMin && f.values[o] <= vMax ) ) terms[i].push_back( o * f.stride ) ;
+	if( terms[i].empty() ) return ; // area is not in the index
+      }
+
+      std::vector<std::size_t> pos( _fields.size(), 0 ) ;
+      while( true ){
+	long idx = 0 ;
+	for( std::size_t i = 0 ; i < terms.size() ; ++i ) idx += terms[i][ pos[i] ] ;
+	setValid( idx ) ;
+	std::size_t i = terms.size() ;
+	while( i > 0 && ++pos[i-1] == terms[i-1].size() ) pos[--i] = 0 ;
+	if( i == 0 ) break ;
+      }
+    }
+
+    /** mark the cells of the segmentation that overlap with the ring in r as existing in the detector, for all values
+     *  of the other fields - unless excluded( x, y ) is true for the local centre, e.g. for a cutout of the sensors.
+     *  The first element of the cell dimensions has to be the size in r. Cells that the segmentation does not give
+     *  back for a point inside the ring at their phi are not marked, e.g. the phi values beyond
+     *  the number of phi bins of a ring of PolarGridRPhi2 or the second phi value of the cell at phi = +-pi.
+     */
+    void setValid( const dd4hep::DDSegmentation::Segmentation& seg, const SensitiveRing& ring,
+		   const std::function<bool(double,double)>& excluded = std::function<bool(double,double)>() ){
+      const double eps = 1e-5 * dd4hep::mm, phiEps = 1e-7 ;
+      const dd4hep::DDSegmentation::Vector3D global ;
+      for( long idx = 0 ; idx < _size ; ++idx ){
+	const CellID id = cellID( idx ) ;
+	const dd4hep::DDSegmentation::Vector3D centre = seg.position( id ) ;
+	const double r = std::sqrt( centre.X * centre.X + centre.Y * centre.Y ) ;
+	const double halfDr = 0.5 * seg.cellDimensions( id ).at( 0 ) ;
+	if( r + halfDr <= ring.rMin || r - halfDr >= ring.rMax ) continue ;
+	if( excluded && excluded( centre.X, centre.Y ) ) continue ;
+	// the cell has to be found inside the ring, slightly off the centre in phi so that a cell at phi = +-pi is found once
+	const double rIn = std::min( std::max( r, ring.rMin + eps ), ring.rMax - eps ) ;
+	const double phi = std::atan2( centre.Y, centre.X ) + phiEps ;
+	const dd4hep::DDSegmentation::Vector3D p( rIn * std::cos( phi ), rIn * std::sin( phi ), 0. ) ;
+	if( index( seg.cellID( p, global, id ) ) != idx ) continue ;
+	setValid( idx ) ;
+      }
+    }
+
+    /// true if the cell exists in the detector
+    bool isValid( CellID cellID ) const {
+      const long idx = index( cellID ) ;
+      return idx >= 0 && isValidIndex( idx ) ;
+    }
+
+    /// true if the cell with this index exists in the detector
+    bool isValidIndex( long idx ) const { return ! _valid.empty() && _valid[ idx ] ; }
+
+    /// number of cells that exist in the detector, ie. the number of readout channels
+    long numberOfChannels() const { return _nChannels ; }
+
+  private:
+
+    /// cellIDs at the lower and upper corner of the area, slightly inside
+    static void cornerCells( const dd4hep::DDSegmentation::Segmentation& seg, const SensitiveArea& area, CellID& lo, CellID& hi ){
+      const double eps = 1e-5 * dd4hep::mm ;
+      const dd4hep::DDSegmentation::Vector3D global ;
+      lo = seg.cellID( dd4hep::DDSegmentation::Vector3D( -area.dx + eps, -area.dy + eps, 0. ), global, area.volumeID ) ;
+      hi = seg.cellID( dd4hep::DDSegmentation::Vector3D(  area.dx - eps,  area.dy - eps, 0. ), global, area.volumeID ) ;
+    }
+
+    /// position of a field in the cellID and its values
+    struct Field {
+      std::string name {} ;
+      unsigned offset = 0 ;
+      unsigned width = 0 ;
+      bool isSigned = false ;
+      CellID mask = 0 ;
+      long min = 0 ;
+      long stride = 1 ;
+      std::vector<long> values {} ;  // the values of the field in increasing order
+      std::vector<int> ordinals {} ; // position of value-min in values, -1 if not a value
+
+      long value( CellID cellID ) const {
+	long v = long( ( cellID >> offset ) & mask ) ;
+	if( isSigned && ( v >> ( width - 1 ) ) ) v -= long(1) << width ;
+	return v ;
+      }
+      long ordinal( long v ) const {
+	v -= min ;
+	return ( v < 0 || v >= long( ordinals.size() ) ) ? -1 : ordinals[ v ] ;
+      }
+    };
+
+    std::vector<Field> _fields {} ;
+    CellID _fixedMask = 0 ;
+    long _size = 0 ;
+    std::vector<bool> _valid {} ;
+    long _nChannels = 0 ;
+  };
+
+}
+
+#endif
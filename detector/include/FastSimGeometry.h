@@ -0,0 +1,146 @@
+//====================================================================
+//  lcgeo - LC detector models in DD4hep
+//--------------------------------------------------------------------
+//  Simplified layer description of the trackers and calorimeters for
+//  parametric fast simulations, written by the plugin
+//  lcgeo_FastSimGeometry - uses the C++ standard library only
+//====================================================================
+#ifndef FastSimGeometry_h
+#define FastSimGeometry_h
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace lcgeo {
+
+  /** The layers of the trackers and calorimeters of a detector model as cylinders (barrels) and disks (endcaps)
+   *  with their material and cell sizes, as filled by the drivers in ZPlanarData, ZDiskPetalsData and
+   *  LayeredCalorimeterData. Endcap layers are given for both sides. Lengths are in mm.
+   *
+   *  The file is binary, starting with a magic string that contains the format version, followed by the
+   *  detector names and the fixed size layer records, in the byte order of the machine that wrote it.
+   *  Reading it needs nothing but this header, i.e. no DD4hep or ROOT:
+   *  @code
+   *    lcgeo::FastSimGeometry geo = lcgeo::FastSimGeometry::read( "CLIC_o3_v14.fsgeo" ) ;
+   *    for( const lcgeo::FastSimGeometry::Layer& l : geo.layers() )
+   *      std::cout << geo.detectorName( l ) << " " << l.layer << " " << l.rMin << " " << l.radiationLengths << std::endl ;
+   *  @endcode
+   */
+  class FastSimGeometry {
+
+  public:
+
+    enum Type { TrackerBarrel = 0, TrackerEndcap = 1, CalorimeterBarrel = 2, CalorimeterEndcap = 3 } ;
+
+    /// one layer - barrels span [rMin,rMax] in r and [zMin,zMax] in z, endcaps the same at one side
+    struct Layer {
+      double rMin = 0. ;
+      double rMax = 0. ;
+      double zMin = 0. ;
+      double zMax = 0. ;
+      double thickness = 0. ;            // sensitive and passive material of the layer
+      double sensitiveThickness = 0. ;
+      double radiationLengths = 0. ;     // traversing the layer perpendicular
+      double interactionLengths = 0. ;
+      double cellSize0 = 0. ;            // strip pitch or cell size, 0 if not known
+      double cellSize1 = 0. ;            // strip length or cell size, 0 if not known
+      double phi0 = 0. ;                 // phi of the first ladder, petal or polygon side
+      std::int32_t detector = 0 ;        // index in detectors()
+      std::int32_t type = TrackerBarrel ;
+      std::int32_t layer = 0 ;
+      std::int32_t symmetry = 0 ;        // number of ladders, petals or polygon sides, 0 if not known
+    };
+
+    /// add a layer of the detector with this name
+    void add( const std::string& detector, Layer l ){
+      std::size_t i = 0 ;
+      while( i < _detectors.size() && _detectors[i] != detector ) ++i ;
+      if( i == _detectors.size() ) _detectors.push_back( detector ) ;
+      l.detector = i ;
+      _layers.push_back( l ) ;
+    }
+
+    const std::vector<Layer>& layers() const { return _layers ; }
+
+    const std::vector<std::string>& detectors() const { return _detectors ; }
+
+    const std::string& detectorName( const Layer& l ) const { return _detectors.at( l.detector ) ; }
+
+    /// write to a binary file
+    void write( const std::string& fileName ) const {
+      std::ofstream out( fileName, std::ios::binary ) ;
+      if( ! out )
+	throw std::runtime_error( "FastSimGeometry: cannot write " + fileName ) ;
+      out.write( magic(), magicSize ) ;
+      writeInt( out, _detectors.size() ) ;
+      for( const std::string& name : _detectors ){
+	writeInt( out, name.size() ) ;
+	out.write( name.data(), name.size() ) ;
+      }
+      writeInt( out, _layers.size() ) ;
+      out.write( reinterpret_cast<const char*>( _layers.data() ), _layers.size() * sizeof(Layer) ) ;
+      if( ! out )
+	throw std::runtime_error( "FastSimGeometry: error writing " + fileName ) ;
+    }
+
+    /// read a file written with write()
+    static FastSimGeometry read( const std::string& fileName ){
+      std::ifstream in( fileName, std::ios::binary ) ;
+      char fileMagic[ magicSize ] ;
+      if( ! in || ! in.read( fileMagic, magicSize ) || std::memcmp( fileMagic, magic(), magicSize ) != 0 )
+	throw std::runtime_error( "FastSimGeometry: " + fileName + " is not a fast simulation geometry file of this version" ) ;
+
+      FastSimGeometry geo ;
+      const std::uint32_t nDetectors = readInt( in ) ;
+      for( std::uint32_t i = 0 ; in && i < nDetectors ; ++i ){
+	const std::uint32_t length = readInt( in ) ;
+	if( length > maxNameLength )
+	  throw std::runtime_error( "FastSimGeometry: corrupt detector name in " + fileName ) ;
+	std::string name( length, ' ' ) ;
+	in.read( &name[0], name.size() ) ;
+	geo._detectors.push_back( name ) ;
+      }
+      const std::uint32_t nLayers = readInt( in ) ;
+      if( nLayers > maxLayers )
+	throw std::runtime_error( "FastSimGeometry: corrupt number of layers in " + fileName ) ;
+      geo._layers.resize( nLayers ) ;
+      if( ! in || ! in.read( reinterpret_cast<char*>( geo._layers.data() ), geo._layers.size() * sizeof(Layer) ) )
+	throw std::runtime_error( "FastSimGeometry: " + fileName + " is truncated" ) ;
+      for( const Layer& l : geo._layers )
+	if( l.detector < 0 || std::size_t( l.detector ) >= geo._detectors.size() )
+	  throw std::runtime_error( "FastSimGeometry: corrupt layer record in " + fileName ) ;
+      return geo ;
+    }
+
+  private:
+
+    static void writeInt( std::ofstream& out, std::size_t n ){
+      const std::uint32_t i = n ;
+      out.write( reinterpret_cast<const char*>( &i ), sizeof(i) ) ;
+    }
+
+    static std::uint32_t readInt( std::ifstream& in ){
+      std::uint32_t i = 0 ;
+      in.read( reinterpret_cast<char*>( &i ), sizeof(i) ) ;
+      return in ? i : 0 ;
+    }
+
+    /// first bytes of a fast simulation geometry file, the last character is the format version
+    static const char* magic() { return "LCGEOFS1" ; }
+    static const std::size_t magicSize = 8 ;
+
+    /// sanity limits for reading
+    static const std::uint32_t maxNameLength = 1024 ;
+    static const std::uint32_t maxLayers = 1000000 ;
+
+    std::vector<std::string> _detectors {} ;
+    std::vector<Layer> _layers {} ;
+  };
+
+}
+
+#endif
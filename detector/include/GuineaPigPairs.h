@@ -0,0 +1,246 @@
+//====================================================================
+//  lcgeo - LC detector models in DD4hep
+//--------------------------------------------------------------------
+//  Reader for the pair background files of GuineaPig (.pair), memory
+//  mapped and parsed on several threads - uses the C++ standard
+//  library and POSIX only
+//====================================================================
+#ifndef GuineaPigPairs_h
+#define GuineaPigPairs_h
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace lcgeo {
+
+  /// one particle of a pair file: energy, velocity and creation point as written by GuineaPig
+  struct GuineaPigParticle {
+    double energy = 0. ;                         // in GeV, negative for positrons
+    double betaX = 0., betaY = 0., betaZ = 0. ;  // velocity / c
+    double x = 0., y = 0., z = 0. ;              // in nm
+
+    int pdg() const { return energy < 0. ? -11 : 11 ; }
+    double charge() const { return energy < 0. ? 1. : -1. ; }
+  };
+
+  /** The particles of one bunch crossing in a GuineaPig pair file, one line with seven numbers per particle.
+   *  The file is memory mapped and read in chunks of lines, each chunk is split at line boundaries and
+   *  parsed on several threads, so that a file with 10^6 particles needs neither a copy of the text nor a
+   *  vector of all particles:
+   *  @code
+   *    lcgeo::GuineaPigPairFile file( "pairs_1.pair" ) ;
+   *    std::vector<lcgeo::GuineaPigParticle> particles ;
+   *    while( file.read( particles, 100000, 4 ) )
+   *      for( const lcgeo::GuineaPigParticle& p : particles )
+   *        std::cout << p.pdg() << " " << p.energy << std::endl ;
+   *  @endcode
+   */
+  class GuineaPigPairFile {
+
+  public:
+
+    explicit GuineaPigPairFile( const std::string& fileName ) : _fileName( fileName ) {
+      const int fd = ::open( fileName.c_str(), O_RDONLY ) ;
+      if( fd < 0 )
+	throw std::runtime_error( "GuineaPigPairFile: cannot open " + fileName ) ;
+      struct stat st ;
+      if( ::fstat( fd, &st ) != 0 ){
+	::close( fd ) ;
+	throw std::runtime_error( "GuineaPigPairFile: cannot stat " + fileName ) ;
+      }
+      _size = st.st_size ;
+      if( _size > 0 ){
+	void* data = ::mmap( 0, _size, PROT_READ, MAP_PRIVATE, fd, 0 ) ;
+	if( data == MAP_FAILED ){
+	  ::close( fd ) ;
+	  throw std::runtime_error( "GuineaPigPairFile: cannot map " + fileName ) ;
+	}
+	::madvise( data, _size, MADV_SEQUENTIAL ) ;
+	_data = static_cast<const char*>( data ) ;
+      }
+      ::close( fd ) ;
+    }
+
+    ~GuineaPigPairFile(){
+      if( _data ) ::munmap( const_cast<char*>( _data ), _size ) ;
+    }
+
+    GuineaPigPairFile( const GuineaPigPairFile& ) = delete ;
+    GuineaPigPairFile& operator=( const GuineaPigPairFile& ) = delete ;
+
+    const std::string& fileName() const { return _fileName ; }
+
+    /// true if all particles have been read
+    bool atEnd() const { return _pos >= _size ; }
+
+    /** replace particles by the next lines of the file, at most maxParticles (all if 0), parsed on nThreads
+     *  threads - false if there are no more particles. Lines that are not seven numbers throw a
+     *  std::runtime_error, empty lines are skipped.
+     */
+    bool read( std::vector<GuineaPigParticle>& particles, std::size_t maxParticles = 0, unsigned nThreads = 1 ){
+      particles.clear() ;
+      while( particles.empty() && ! atEnd() ){
+	const std::size_t begin = _pos ;
+	_pos = maxParticles > 0 ? skipLines( begin, maxParticles ) : _size ;
+	parse( begin, _pos, particles, nThreads ) ;
+      }
+      return ! particles.empty() ;
+    }
+
+    /** parse a number at p, skipping blanks but not newlines, and return the end of it - 0 if there is no
+     *  number. Numbers with at most 15 significant digits and a decimal exponent up to 22 are computed
+     *  exactly with one multiplication or division, all others with strtod.
+     */
+    static const char* parseDouble( const char* p, const char* end, double& value ){
+      while( p < end && ( *p == ' ' || *p == '\t' || *p == '\r' ) ) ++p ;
+      const char* start = p ;
+      bool negative = false ;
+      if( p < end && ( *p == '-' || *p == '+' ) ) negative = ( *p++ == '-' ) ;
+
+      std::uint64_t mantissa = 0 ;
+      int digits = 0, exponent = 0 ;
+      bool any = false ;
+      for( ; p < end && *p >= '0' && *p <= '9' ; ++p ){
+	any = true ;
+	if( digits < 19 ){
+	  mantissa = 10 * mantissa + ( *p - '0' ) ;
+	  digits += ( mantissa != 0 ) ;
+	} else {
+	  ++exponent ;
+	}
+      }
+      if( p < end && *p == '.' ){
+	for( ++p ; p < end && *p >= '0' && *p <= '9' ; ++p ){
+	  any = true ;
+	  if( digits < 19 ){
+	    mantissa = 10 * mantissa + ( *p - '0' ) ;
+	    digits += ( mantissa != 0 ) ;
+	    --exponent ;
+	  }
+	}
+      }
+      if( ! any ) return 0 ;
+
+      if( p < end && ( *p == 'e' || *p == 'E' ) ){
+	const char* e = p + 1 ;
+	bool negativeExponent = false ;
+	if( e < end && ( *e == '-' || *e == '+' ) ) negativeExponent = ( *e++ == '-' ) ;
+	if( e < end && *e >= '0' && *e <= '9' ){
+	  int n = 0 ;
+	  for( ; e < end && *e >= '0' && *e <= '9' ; ++e ) if( n < 100000 ) n = 10 * n + ( *e - '0' ) ;
+	  exponent += negativeExponent ? -n : n ;
+	  p = e ;
+	}
+      }
+
+      static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+				       1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 } ;
+      if( digits <= 15 && exponent >= -22 && exponent <= 22 ){
+	const double m = double( mantissa ) ;
+	value = exponent < 0 ? m / powers[ -exponent ] : m * powers[ exponent ] ;
+	if( negative ) value = -value ;
+      } else {
+	char buffer[ 128 ] ;
+	const std::size_t n = std::min<std::size_t>( p - start, sizeof(buffer) - 1 ) ;
+	std::memcpy( buffer, start, n ) ;
+	buffer[ n ] = 0 ;
+	value = std::strtod( buffer, 0 ) ;
+      }
+      return p ;
+    }
+
+  private:
+
+    /// the position after n lines from pos
+    std::size_t skipLines( std::size_t pos, std::size_t n ) const {
+      for( std::size_t i = 0 ; i < n && pos < _size ; ++i ){
+	const void* nl = std::memchr( _data + pos, '\n', _size - pos ) ;
+	pos = nl ? static_cast<const char*>( nl ) - _data + 1 : _size ;
+      }
+      return pos ;
+    }
+
+    /// parse the lines in [begin,end), split at line boundaries into one range per thread
+    void parse( std::size_t begin, std::size_t end, std::vector<GuineaPigParticle>& particles, unsigned nThreads ) const {
+      if( nThreads < 1 ) nThreads = 1 ;
+      // small ranges are not worth a thread
+      const std::size_t minBytes = 1 << 16 ;
+      if( ( end - begin ) / nThreads < minBytes ) nThreads = std::max<std::size_t>( 1, ( end - begin ) / minBytes ) ;
+
+      std::vector<std::size_t> bounds( 1, begin ) ;
+      for( unsigned t = 1 ; t < nThreads ; ++t ){
+	std::size_t pos = std::max( bounds.back(), begin + ( end - begin ) * t / nThreads ) ;
+	const void* nl = pos < end ? std::memchr( _data + pos, '\n', end - pos ) : 0 ;
+	bounds.push_back( nl ? static_cast<const char*>( nl ) - _data + 1 : end ) ;
+      }
+      bounds.push_back( end ) ;
+
+      if( nThreads == 1 ){
+	parseLines( begin, end, particles ) ;
+	return ;
+      }
+      std::vector< std::vector<GuineaPigParticle> > parts( nThreads ) ;
+      std::vector<std::exception_ptr> errors( nThreads ) ;
+      std::vector<std::thread> threads ;
+      for( unsigned t = 0 ; t < nThreads ; ++t )
+	threads.emplace_back( [&, t](){
+	    try{
+	      parseLines( bounds[t], bounds[t+1], parts[t] ) ;
+	    } catch( ... ){
+	      errors[t] = std::current_exception() ;
+	    }
+	  } ) ;
+      for( std::thread& t : threads ) t.join() ;
+      for( const std::exception_ptr& e : errors ) if( e ) std::rethrow_exception( e ) ;
+
+      std::size_t n = 0 ;
+      for( const auto& part : parts ) n += part.size() ;
+      particles.reserve( n ) ;
+      for( const auto& part : parts ) particles.insert( particles.end(), part.begin(), part.end() ) ;
+    }
+
+    void parseLines( std::size_t begin, std::size_t end, std::vector<GuineaPigParticle>& particles ) const {
+      particles.reserve( particles.size() + ( end - begin ) / 80 ) ;
+      const char* p = _data + begin ;
+      const char* const stop = _data + end ;
+      while( p < stop ){
+	const char* eol = static_cast<const char*>( std::memchr( p, '\n', stop - p ) ) ;
+	if( ! eol ) eol = stop ;
+	const char* q = p ;
+	while( q < eol && ( *q == ' ' || *q == '\t' || *q == '\r' ) ) ++q ;
+	if( q < eol ){
+	  GuineaPigParticle particle ;
+	  double* values[] = { &particle.energy, &particle.betaX, &particle.betaY, &particle.betaZ, &particle.x, &particle.y, &particle.z } ;
+	  for( double* v : values ){
+	    q = parseDouble( q, eol, *v ) ;
+	    if( ! q )
+	      throw std::runtime_error( "GuineaPigPairFile: not a pair file line at byte " + std::to_string( p - _data )
+					+ " of " + _fileName ) ;
+	  }
+	  particles.push_back( particle ) ;
+	}
+	p = eol < stop ? eol + 1 : stop ;
+      }
+    }
+
+    std::string _fileName {} ;
+    const char* _data = 0 ;
+    std::size_t _size = 0 ;
+    std::size_t _pos = 0 ;
+  };
+
+}
+
+#endif
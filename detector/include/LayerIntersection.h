@@ -0,0 +1,136 @@
+//====================================================================
+//  lcgeo - LC detector models in DD4hep
+//--------------------------------------------------------------------
+//  Structure of arrays tables of the tracker layers described by
+//  ZPlanarData and ZDiskPetalsData, with batched intersection of
+//  straight tracks (library lcgeoIntersection)
+//====================================================================
+#ifndef LayerIntersection_h
+#define LayerIntersection_h
+
+#include "DDRec/DetectorData.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace lcgeo {
+
+  /** A batch of straight tracks, stored as structure of arrays: origin (x,y,z) and direction (dx,dy,dz),
+   *  the direction does not need to be normalised - the path length s of the hits is in units of it.
+   */
+  struct RayBatch {
+    std::vector<double> x {}, y {}, z {} ;
+    std::vector<double> dx {}, dy {}, dz {} ;
+
+    std::size_t size() const { return x.size() ; }
+
+    void reserve( std::size_t n ){
+      x.reserve( n ) ; y.reserve( n ) ; z.reserve( n ) ;
+      dx.reserve( n ) ; dy.reserve( n ) ; dz.reserve( n ) ;
+    }
+
+    void add( double x0, double y0, double z0, double dx0, double dy0, double dz0 ){
+      x.push_back( x0 ) ; y.push_back( y0 ) ; z.push_back( z0 ) ;
+      dx.push_back( dx0 ) ; dy.push_back( dy0 ) ; dz.push_back( dz0 ) ;
+    }
+  };
+
+  /** The hits of a batch of tracks on all layers of a table, stored per layer: the entries of layer l are
+   *  [ l * nTracks, (l+1) * nTracks ). index is the ladder (barrel) or petal (disk), -1 if the track misses
+   *  the layer, then position and path length are undefined. edge is the distance of the crossing to the
+   *  closest edge of the ladder or petal in its plane, negative outside - for a miss the one of the closest
+   *  ladder or petal, -infinity if the track does not reach the layer.
+   */
+  struct LayerHits {
+    std::size_t nTracks = 0 ;
+    std::size_t nLayers = 0 ;
+    std::vector<int> index {} ;
+    std::vector<double> x {}, y {}, z {}, s {}, edge {} ;
+
+    void resize( std::size_t layers, std::size_t tracks ){
+      nLayers = layers ;
+      nTracks = tracks ;
+      const std::size_t n = layers * tracks ;
+      index.resize( n ) ; x.resize( n ) ; y.resize( n ) ; z.resize( n ) ; s.resize( n ) ; edge.resize( n ) ;
+    }
+
+    std::size_t entry( std::size_t layer, std::size_t track ) const { return layer * nTracks + track ; }
+  };
+
+  /** The ladders of the layers in ZPlanarData: ladder k of a layer is the plane with the normal at
+   *  phi0 + k * 2pi / ladderNumber, at the distance of the middle of the sensitive thickness from the z-axis,
+   *  limited to widthSensitive (shifted by offsetSensitive) and zHalfSensitive. All ladders of a layer are at
+   *  the same distance: modules alternating in radius (e.g. TrackerBarrel_o1_v05) are not described exactly.
+   *  @code
+   *    lcgeo::PlanarLayerTable table( *det.extension<dd4hep::rec::ZPlanarData>() ) ;
+   *    lcgeo::LayerHits hits ;
+   *    table.intersect( rays, hits ) ;
+   *    int ladder = hits.index[ hits.entry( layer, track ) ] ;
+   *  @endcode
+   */
+  class PlanarLayerTable {
+
+  public:
+
+    PlanarLayerTable() = default ;
+
+    explicit PlanarLayerTable( const dd4hep::rec::ZPlanarData& data ) ;
+
+    std::size_t size() const { return _nLadders.size() ; }
+
+    /// the hits of all tracks on all layers, the tracks are the inner loop
+    void intersect( const RayBatch& rays, LayerHits& hits ) const ;
+
+  private:
+    std::vector<int> _nLadders {} ;
+    std::vector<double> _phi0 {}, _invDphi {} ;
+    std::vector<double> _distance {}, _offset {}, _halfWidth {}, _zHalf {} ;
+    std::vector<std::size_t> _first {} ;      // ladder 0 of the layer in the padded tables _index, _cos, _sin
+    std::vector<double> _index {} ;           // ladder number of the padded entries
+    std::vector<double> _cos {}, _sin {} ;    // ladder normals of all layers
+  };
+
+  /** The petals of the layers in ZDiskPetalsData, on both sides of the IP if reflected: entries [0,n) of the
+   *  table are the layers at +z, [n,2n) the same layers mirrored to -z. Petal k is at phi0 + k * 2pi / petalNumber,
+   *  at zPosition + zOffsetSensitive with alternating sign of the offset, and covers the radii
+   *  [distanceSensitive, distanceSensitive + lengthSensitive]. If widthOuterSensitive is given the petal is the
+   *  trapezoid from widthInnerSensitive to widthOuterSensitive, otherwise the ring sector of the petal.
+   *  This needs petalNumber to be the number of petals in phi: drivers that store the number of rings there
+   *  (e.g. TrackerEndcap_o2_v06) cannot be described by the table.
+   */
+  class DiskLayerTable {
+
+  public:
+
+    DiskLayerTable() = default ;
+
+    explicit DiskLayerTable( const dd4hep::rec::ZDiskPetalsData& data, bool reflected = true ) ;
+
+    std::size_t size() const { return _z.size() ; }
+
+    /// the layer in ZDiskPetalsData of the table entry
+    int layer( std::size_t i ) const { return i % _nDataLayers ; }
+
+    /// +1 or -1
+    int side( std::size_t i ) const { return i < _nDataLayers ? 1 : -1 ; }
+
+    /// the hits of all tracks on all layers, the tracks are the inner loop
+    void intersect( const RayBatch& rays, LayerHits& hits ) const ;
+
+  private:
+    std::size_t _nDataLayers = 1 ;
+    std::vector<int> _nPetals {} ;
+    std::vector<double> _phi0 {}, _invDphi {} ;
+    std::vector<double> _z {}, _zOffset {} ;
+    std::vector<double> _rMin {}, _rMax {} ;
+    std::vector<double> _halfWidthInner {}, _halfWidthOuter {} ;
+    std::vector<double> _sinHalf {}, _cosHalf {} ; // half opening angle of the ring sectors
+    std::vector<std::size_t> _first {} ;      // petal 0 of the layer in the padded tables _index, _zSign, _cos, _sin
+    std::vector<double> _index {} ;           // petal number of the padded entries
+    std::vector<double> _zSign {} ;           // sign of zOffsetSensitive of the petal
+    std::vector<double> _cos {}, _sin {} ;    // petal axes of all layers
+  };
+
+}
+
+#endif
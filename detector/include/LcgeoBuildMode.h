@@ -0,0 +1,33 @@
+//====================================================================
+//  lcgeo - LC detector models in DD4hep
+//--------------------------------------------------------------------
+//  Helper for selecting the amount of geometry built by the drivers
+//====================================================================
+#ifndef LcgeoBuildMode_h
+#define LcgeoBuildMode_h
+
+#include "DD4hep/Detector.h"
+
+namespace lcgeo {
+
+  /// name of the (optional) compact constant that switches on the reconstruction geometry mode
+  static const char* const RECO_GEOMETRY_ONLY = "lcgeo_reco_geometry_only" ;
+
+  /** Returns true if the drivers supporting it should only build their envelope and the
+   *  DDRec data extensions (e.g. LayeredCalorimeterData) and skip the detailed volume tree.
+   *  This is only the case if the compact file defines a non zero constant 'lcgeo_reco_geometry_only',
+   *  a build with dd4hep::BUILD_RECO ('-build_type RECO') still builds the full volume tree.
+   *  Note: no sensitive volumes are placed in this mode, i.e. the geometry cannot be used for
+   *  simulation and the VolumeManager only knows about the envelopes of these subdetectors.
+   */
+  inline bool buildRecoGeometryOnly( dd4hep::Detector& theDetector ){
+
+    const dd4hep::Detector::HandleMap& constants = theDetector.constants() ;
+
+    if( constants.find( RECO_GEOMETRY_ONLY ) == constants.end() ) return false ;
+
+    return theDetector.constant<int>( RECO_GEOMETRY_ONLY ) != 0 ;
+  }
+}
+
+#endif
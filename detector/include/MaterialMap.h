@@ -0,0 +1,225 @@
+//====================================================================
+//  lcgeo - LC detector models in DD4hep
+//--------------------------------------------------------------------
+//  Precomputed (r,z) material map for fast material lookups in the
+//  reconstruction, attached to the world DetElement by the plugin
+//  lcgeo_MaterialMap
+//====================================================================
+#ifndef MaterialMap_h
+#define MaterialMap_h
+
+#include "LcgeoExceptions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace lcgeo {
+
+  /** Material averaged over phi and over the cells of a regular grid in r and z, with r in [0,rMax]
+   *  and z in [-zMax,zMax]. Lookups are O(1), the material along a straight line is integrated in
+   *  steps of half the cell size. Lengths are in dd4hep units (cm), densities in g/cm3.
+   *
+   *  The file starts with a magic string and the format version, followed by the size of a cell, the
+   *  binning and the name of the detector model the map was made for, so that a map is not used with
+   *  a different geometry or binning.
+   *
+   *  The map is attached to the world DetElement:
+   *  @code
+   *    const lcgeo::MaterialMap* map = theDetector.world().extension<lcgeo::MaterialMap>() ;
+   *    double x0 = map->radiationLengths( p0, p1 ) ;
+   *  @endcode
+   */
+  class MaterialMap {
+
+  public:
+
+    /// averaged material of one cell
+    struct Cell {
+      float density = 0.f ;   // [g/cm3]
+      float invX0 = 0.f ;     // 1 / radiation length [1/cm]
+      float invLambda = 0.f ; // 1 / nuclear interaction length [1/cm]
+      float ZoverA = 0.f ;    // mass weighted Z/A [mol/g]
+    };
+
+    MaterialMap() = default ;
+
+    MaterialMap( int nR, double rMax, int nZ, double zMax ) :
+      _nR( nR ), _nZ( nZ ), _rMax( rMax ), _zMax( zMax ), _dR( rMax / nR ), _dZ( 2. * zMax / nZ ),
+      _cells( std::size_t( nR ) * nZ ) {}
+
+    int nR() const { return _nR ; }
+    int nZ() const { return _nZ ; }
+    double rMax() const { return _rMax ; }
+    double zMax() const { return _zMax ; }
+
+    /// center of cell (ir,iz)
+    double r( int ir ) const { return ( ir + 0.5 ) * _dR ; }
+    double z( int iz ) const { return -_zMax + ( iz + 0.5 ) * _dZ ; }
+
+    /// name of the detector model the map was made for
+    const std::string& model() const { return _model ; }
+    void setModel( const std::string& model ) { _model = model ; }
+
+    /** true if the map can be used for the given model and extent (and binning, if nR and nZ are not 0),
+     *  otherwise the reason is returned in reason
+     */
+    bool isCompatible( const std::string& model, double rMax, double zMax, int nR, int nZ, std::string& reason ) const {
+      auto differ = []( double a, double b ){ return std::fabs( a - b ) > 1e-9 * std::max( std::fabs( a ), std::fabs( b ) ) ; } ;
+      if( ! model.empty() && ! _model.empty() && model != _model )
+	reason = "the map was made for the model " + _model + ", not " + model ;
+      else if( differ( rMax, _rMax ) || differ( zMax, _zMax ) )
+	reason = "the map covers r < " + std::to_string( _rMax ) + ", |z| < " + std::to_string( _zMax )
+	  + " instead of r < " + std::to_string( rMax ) + ", |z| < " + std::to_string( zMax ) ;
+      else if( ( nR != 0 && nR != _nR ) || ( nZ != 0 && nZ != _nZ ) )
+	reason = "the map has " + std::to_string( _nR ) + " x " + std::to_string( _nZ ) + " cells instead of "
+	  + std::to_string( nR ) + " x " + std::to_string( nZ ) ;
+      else
+	return true ;
+      return false ;
+    }
+
+    /// true if (r,z) is inside the map
+    bool contains( double r, double z ) const { return r < _rMax && std::fabs( z ) < _zMax ; }
+
+    Cell& cell( int ir, int iz ) { return _cells[ std::size_t( iz ) * _nR + ir ] ; }
+    const Cell& cell( int ir, int iz ) const { return _cells[ std::size_t( iz ) * _nR + ir ] ; }
+
+    /// material at (r,z) - points outside of the map get the material of the closest cell
+    const Cell& cell( double r, double z ) const {
+      const int ir = std::min( std::max( int( r / _dR ), 0 ), _nR - 1 ) ;
+      const int iz = std::min( std::max( int( ( z + _zMax ) / _dZ ), 0 ), _nZ - 1 ) ;
+      return cell( ir, iz ) ;
+    }
+
+    /// material at the 3D point p
+    const Cell& cell( const double* p ) const { return cell( std::sqrt( p[0]*p[0] + p[1]*p[1] ), p[2] ) ; }
+
+    /// number of radiation lengths on the straight line from p0 to p1 (the part inside the map)
+    double radiationLengths( const double* p0, const double* p1 ) const { return integrate( p0, p1, &Cell::invX0 ) ; }
+
+    /// number of nuclear interaction lengths on the straight line from p0 to p1 (the part inside the map)
+    double interactionLengths( const double* p0, const double* p1 ) const { return integrate( p0, p1, &Cell::invLambda ) ; }
+
+    /// mean and maximal relative deviation of radiationLengths() from the exact navigation, as measured when the map was made
+    void setValidation( double meanRelError, double maxRelError ) { _meanRelError = meanRelError ; _maxRelError = maxRelError ; }
+    double meanRelativeError() const { return _meanRelError ; }
+    double maxRelativeError() const { return _maxRelError ; }
+
+    /// write the map to a binary file
+    void write( const std::string& fileName ) const {
+      std::ofstream out( fileName, std::ios::binary ) ;
+      if( ! out )
+	throw GeometryException( "MaterialMap: cannot write " + fileName ) ;
+      out.write( magic(), magicSize ) ;
+      writeInt( out, formatVersion ) ;
+      writeInt( out, sizeof(Cell) ) ;
+      out.write( reinterpret_cast<const char*>( &_nR ), sizeof(_nR) ) ;
+      out.write( reinterpret_cast<const char*>( &_nZ ), sizeof(_nZ) ) ;
+      out.write( reinterpret_cast<const char*>( &_rMax ), sizeof(_rMax) ) ;
+      out.write( reinterpret_cast<const char*>( &_zMax ), sizeof(_zMax) ) ;
+      out.write( reinterpret_cast<const char*>( &_meanRelError ), sizeof(_meanRelError) ) ;
+      out.write( reinterpret_cast<const char*>( &_maxRelError ), sizeof(_maxRelError) ) ;
+      writeInt( out, _model.size() ) ;
+      out.write( _model.data(), _model.size() ) ;
+      out.write( reinterpret_cast<const char*>( _cells.data() ), _cells.size() * sizeof(Cell) ) ;
+      if( ! out )
+	throw GeometryException( "MaterialMap: error writing " + fileName ) ;
+    }
+
+    /// read a map written with write(), the header and the size of the file are checked
+    static MaterialMap read( const std::string& fileName ){
+      std::ifstream in( fileName, std::ios::binary ) ;
+      char fileMagic[ magicSize ] ;
+      if( ! in || ! in.read( fileMagic, magicSize ) || std::memcmp( fileMagic, magic(), magicSize ) != 0 )
+	throw GeometryException( "MaterialMap: " + fileName + " is not a material map file" ) ;
+      const std::uint32_t version = readInt( in ) ;
+      if( ! in || version != formatVersion )
+	throw GeometryException( "MaterialMap: " + fileName + " has format version " + std::to_string( version )
+				 + ", expected " + std::to_string( formatVersion ) ) ;
+      const std::uint32_t cellSize = readInt( in ) ;
+      if( ! in || cellSize != sizeof(Cell) )
+	throw GeometryException( "MaterialMap: " + fileName + " has cells of " + std::to_string( cellSize )
+				 + " bytes, expected " + std::to_string( sizeof(Cell) ) ) ;
+      int nR = 0, nZ = 0 ;
+      double rMax = 0., zMax = 0., meanRelError = -1., maxRelError = -1. ;
+      in.read( reinterpret_cast<char*>( &nR ), sizeof(nR) ) ;
+      in.read( reinterpret_cast<char*>( &nZ ), sizeof(nZ) ) ;
+      in.read( reinterpret_cast<char*>( &rMax ), sizeof(rMax) ) ;
+      in.read( reinterpret_cast<char*>( &zMax ), sizeof(zMax) ) ;
+      in.read( reinterpret_cast<char*>( &meanRelError ), sizeof(meanRelError) ) ;
+      in.read( reinterpret_cast<char*>( &maxRelError ), sizeof(maxRelError) ) ;
+      if( ! in || nR <= 0 || nZ <= 0 || std::size_t( nR ) * nZ > maxCells
+	  || ! std::isfinite( rMax ) || ! std::isfinite( zMax ) || rMax <= 0. || zMax <= 0. )
+	throw GeometryException( "MaterialMap: corrupt binning in " + fileName ) ;
+      const std::uint32_t modelLength = readInt( in ) ;
+      if( ! in || modelLength > maxModelLength )
+	throw GeometryException( "MaterialMap: corrupt model name in " + fileName ) ;
+      std::string model( modelLength, ' ' ) ;
+      in.read( &model[0], modelLength ) ;
+      MaterialMap map( nR, rMax, nZ, zMax ) ;
+      map.setValidation( meanRelError, maxRelError ) ;
+      map.setModel( model ) ;
+      if( ! in || ! in.read( reinterpret_cast<char*>( map._cells.data() ), map._cells.size() * sizeof(Cell) ) )
+	throw GeometryException( "MaterialMap: " + fileName + " is truncated" ) ;
+      if( in.peek() != std::ifstream::traits_type::eof() )
+	throw GeometryException( "MaterialMap: " + fileName + " is longer than its binning, " + std::to_string( nR )
+				 + " x " + std::to_string( nZ ) + " cells" ) ;
+      return map ;
+    }
+
+  private:
+
+    double integrate( const double* p0, const double* p1, float Cell::* quantity ) const {
+      const double d[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] } ;
+      const double length = std::sqrt( d[0]*d[0] + d[1]*d[1] + d[2]*d[2] ) ;
+      const int nSteps = std::max( 1, int( std::ceil( length / ( 0.5 * std::min( _dR, _dZ ) ) ) ) ) ;
+      const double ds = length / nSteps ;
+      double sum = 0. ;
+      for( int i = 0 ; i < nSteps ; ++i ){
+	const double t = ( i + 0.5 ) / nSteps ;
+	const double x = p0[0] + t * d[0], y = p0[1] + t * d[1], z = p0[2] + t * d[2] ;
+	const double r = std::sqrt( x*x + y*y ) ;
+	if( contains( r, z ) ) sum += cell( r, z ).*quantity * ds ;
+      }
+      return sum ;
+    }
+
+    static void writeInt( std::ofstream& out, std::uint32_t i ){
+      out.write( reinterpret_cast<const char*>( &i ), sizeof(i) ) ;
+    }
+
+    static std::uint32_t readInt( std::ifstream& in ){
+      std::uint32_t i = 0 ;
+      in.read( reinterpret_cast<char*>( &i ), sizeof(i) ) ;
+      return i ;
+    }
+
+    /// first bytes of a material map file, followed by the format version
+    static const char* magic() { return "LCGEOMAP" ; }
+    static const std::size_t magicSize = 8 ;
+    static const std::uint32_t formatVersion = 2 ;
+
+    /// sanity limits for reading
+    static const std::size_t maxCells = 100000000 ;
+    static const std::uint32_t maxModelLength = 1024 ;
+
+    int _nR = 0 ;
+    int _nZ = 0 ;
+    double _rMax = 0. ;
+    double _zMax = 0. ;
+    double _dR = 0. ;
+    double _dZ = 0. ;
+    double _meanRelError = -1. ;
+    double _maxRelError = -1. ;
+    std::string _model {} ;
+    std::vector<Cell> _cells {} ;
+  };
+
+}
+
+#endif
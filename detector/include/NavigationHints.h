@@ -0,0 +1,86 @@
+//====================================================================
+//  lcgeo - LC detector models in DD4hep
+//--------------------------------------------------------------------
+//  Geant4 navigation (voxelisation) hints for mother volumes with many
+//  daughters, tagged by the drivers and applied by the DDG4 action
+//  NavigationHintsAction
+//====================================================================
+#ifndef NavigationHints_h
+#define NavigationHints_h
+
+#include "DD4hep/Volumes.h"
+#include "XML/XMLDetector.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace lcgeo {
+
+  /** Recommended Geant4 smartless values for the mother volumes of a subdetector, i.e. the average number of
+   *  voxels per daughter used by G4SmartVoxelHeader (Geant4 default: 2). The values are given in the compact
+   *  file per kind of volume, which the driver defines, e.g. for SEcal06:
+   *  @code
+   *    <detector name="EcalBarrel" type="SEcal06_Barrel" ... >
+   *      <navigation volume="alveolus" smartless="0.5"/>
+   *      <navigation volume="module"   smartless="4"/>
+   *  @endcode
+   *  The drivers tag their volumes with tag( kind, volume ) and attach the hints to the DetElement:
+   *  @code
+   *    lcgeo::NavigationHints* hints = new lcgeo::NavigationHints( x_det ) ;
+   *    hints->tag( "alveolus", l_vol ) ;
+   *    sdet.addExtension<lcgeo::NavigationHints>( hints ) ;
+   *  @endcode
+   *  Kinds that are not in the compact file are ignored, so the hints have no effect by default.
+   */
+  class NavigationHints {
+
+  public:
+
+    /// a tagged volume
+    struct Hint {
+      dd4hep::Volume volume {} ;
+      std::string kind {} ;
+      double smartless = 0. ;
+    };
+
+    NavigationHints() = default ;
+
+    /// read the smartless values per kind of volume from the <navigation> elements of the detector
+    NavigationHints( dd4hep::xml::DetElement x_det ){
+      for( dd4hep::xml::Collection_t c( x_det, _Unicode( navigation ) ) ; c ; ++c ){
+	dd4hep::xml::Component x_nav( c ) ;
+	setSmartless( x_nav.attr<std::string>( _Unicode( volume ) ), x_nav.attr<double>( _Unicode( smartless ) ) ) ;
+      }
+    }
+
+    /// set the smartless value for a kind of volume, values <= 0 remove it
+    void setSmartless( const std::string& kind, double smartless ){
+      if( smartless > 0. ) _smartless[ kind ] = smartless ;
+      else _smartless.erase( kind ) ;
+    }
+
+    /// tag the volume as kind, if there is a smartless value for that kind
+    void tag( const std::string& kind, dd4hep::Volume volume ){
+      auto it = _smartless.find( kind ) ;
+      if( it == _smartless.end() || ! volume.isValid() ) return ;
+      Hint h ;
+      h.volume = volume ;
+      h.kind = kind ;
+      h.smartless = it->second ;
+      _hints.push_back( h ) ;
+    }
+
+    /// true if there is nothing to apply
+    bool empty() const { return _hints.empty() ; }
+
+    const std::vector<Hint>& hints() const { return _hints ; }
+
+  private:
+    std::map< std::string, double > _smartless {} ;
+    std::vector<Hint> _hints {} ;
+  };
+
+}
+
+#endif
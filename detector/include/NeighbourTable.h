@@ -0,0 +1,112 @@
+//====================================================================
+//  lcgeo - LC detector models in DD4hep
+//--------------------------------------------------------------------
+//  Compressed sparse row table of the neighbouring surfaces, published
+//  by the tracker drivers next to NeighbourSurfacesData
+//====================================================================
+#ifndef NeighbourTable_h
+#define NeighbourTable_h
+
+#include "DDSegmentation/Segmentation.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace lcgeo {
+
+  /** The neighbours in the same layer of all sensors of a subdetector, as in
+   *  dd4hep::rec::NeighbourSurfacesData::sameLayer, stored as compressed sparse rows: the sorted
+   *  cellIDs of the sensors, the offsets of their neighbours and the flat array of all neighbours.
+   *  The table uses three allocations in total and a lookup is a binary search in a contiguous array:
+   *  @code
+   *    const lcgeo::NeighbourTable* table = det.extension<lcgeo::NeighbourTable>( false ) ;
+   *    lcgeo::NeighbourTable::Range n = table->sameLayer( cellID ) ;
+   *    for( const dd4hep::CellID* it = n.begin ; it != n.end ; ++it ) { ... }
+   *  @endcode
+   */
+  class NeighbourTable {
+
+  public:
+
+    typedef dd4hep::DDSegmentation::CellID CellID ;
+
+    /// the neighbours of a sensor, empty if the sensor is not in the table
+    struct Range {
+      const CellID* begin = nullptr ;
+      const CellID* end = nullptr ;
+      std::size_t size() const { return end - begin ; }
+      bool empty() const { return begin == end ; }
+    };
+
+    NeighbourTable() = default ;
+
+    /// copy a map of sensor cellIDs to vectors of neighbours, e.g. NeighbourSurfacesData::sameLayer
+    template <typename Map>
+    explicit NeighbourTable( const Map& sameLayer ){
+      std::size_t nNeighbours = 0 ;
+      for( const auto& entry : sameLayer ) nNeighbours += entry.second.size() ;
+
+      _keys.reserve( sameLayer.size() ) ;
+      _offsets.reserve( sameLayer.size() + 1 ) ;
+      _neighbours.reserve( nNeighbours ) ;
+
+      _offsets.push_back( 0 ) ;
+      for( const auto& entry : sameLayer ){
+	_keys.push_back( entry.first ) ;
+	_neighbours.insert( _neighbours.end(), entry.second.begin(), entry.second.end() ) ;
+	_offsets.push_back( _neighbours.size() ) ;
+      }
+
+      // maps are sorted already, anything else is sorted here
+      if( ! std::is_sorted( _keys.begin(), _keys.end() ) ) sortKeys() ;
+    }
+
+    /// number of sensors in the table
+    std::size_t size() const { return _keys.size() ; }
+
+    /// total number of neighbours
+    std::size_t numberOfNeighbours() const { return _neighbours.size() ; }
+
+    /// the neighbours of the sensor in the same layer
+    Range sameLayer( CellID cellID ) const {
+      Range r ;
+      auto it = std::lower_bound( _keys.begin(), _keys.end(), cellID ) ;
+      if( it == _keys.end() || *it != cellID ) return r ;
+      const std::size_t i = it - _keys.begin() ;
+      r.begin = _neighbours.data() + _offsets[i] ;
+      r.end   = _neighbours.data() + _offsets[i+1] ;
+      return r ;
+    }
+
+  private:
+
+    void sortKeys(){
+      std::vector<std::size_t> order( _keys.size() ) ;
+      for( std::size_t i = 0 ; i < order.size() ; ++i ) order[i] = i ;
+      std::sort( order.begin(), order.end(), [this]( std::size_t a, std::size_t b ){ return _keys[a] < _keys[b] ; } ) ;
+
+      std::vector<CellID> keys, neighbours ;
+      std::vector<std::size_t> offsets ;
+      keys.reserve( _keys.size() ) ;
+      offsets.reserve( _offsets.size() ) ;
+      neighbours.reserve( _neighbours.size() ) ;
+      offsets.push_back( 0 ) ;
+      for( std::size_t i : order ){
+	keys.push_back( _keys[i] ) ;
+	neighbours.insert( neighbours.end(), _neighbours.begin() + _offsets[i], _neighbours.begin() + _offsets[i+1] ) ;
+	offsets.push_back( neighbours.size() ) ;
+      }
+      _keys.swap( keys ) ;
+      _offsets.swap( offsets ) ;
+      _neighbours.swap( neighbours ) ;
+    }
+
+    std::vector<CellID> _keys {} ;
+    std::vector<std::size_t> _offsets {} ;
+    std::vector<CellID> _neighbours {} ;
+  };
+
+}
+
+#endif
@@ -0,0 +1,214 @@
+#ifndef Other_Helpers_hh
+#define Other_Helpers_hh 1
+//====================================================================
+//  LCGeo - LC detector models in DD4hep 
+//--------------------------------------------------------------------
+//  Helper functions used by detector constructers
+//  A.Sailer, CERN
+//  $Id$
+//====================================================================
+
+#include "DD4hep/Objects.h"
+
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace ODH {//OtherDetectorHelpers
+
+  typedef enum { // These constants are also used in the MySQL database:
+    kCenter                     = 0, // centered on the z-axis
+    kUpstream                   = 1, // on the upstream branch, rotated by half the crossing angle
+    kDnstream                   = 2, // on the downstream branch, rotated by half the crossing angle
+    kPunchedCenter              = 3, // centered, with one or two inner holes
+    kPunchedUpstream            = 4, // on the upstream branch, with two inner holes
+    kPunchedDnstream            = 5, // on the downstrem branch, with two inner holes
+    kUpstreamClippedFront       = 6, // upstream, with the front face parallel to the xy-plane
+    kDnstreamClippedFront       = 7, // downstream, with the front face parallel to the xy-plane
+    kUpstreamClippedRear        = 8, // upstream, with the rear face parallel to the xy-plane
+    kDnstreamClippedRear        = 9, // downstream, with the rear face parallel to the xy-plane
+    kUpstreamClippedBoth        = 10, // upstream, with both faces parallel to the xy-plane
+    kDnstreamClippedBoth        = 11, // downstream, with both faces parallel to the xy-plane
+    kUpstreamSlicedFront        = 12, // upstream, with the front face parallel to a tilted piece
+    kDnstreamSlicedFront        = 13, // downstream, with the front face parallel to a tilted piece
+    kUpstreamSlicedRear         = 14, // upstream, with the rear face parallel to a tilted piece
+    kDnstreamSlicedRear         = 15, // downstream, with the rear face parallel to a tilted piece
+    kUpstreamSlicedBoth         = 16, // upstream, with both faces parallel to a tilted piece
+    kDnstreamSlicedBoth         = 17 // downstream, with both faces parallel to a tilted piece
+  } ECrossType;
+
+
+
+  /// name in the compact files and beam branch of a crossing type
+  struct CrossTypeEntry {
+    const char* name ;
+    ECrossType type ;
+    int branch ; // -1: upstream, 0: centered, +1: downstream
+  };
+
+  /// all crossing types, ordered by their value
+  constexpr CrossTypeEntry crossTypes[] = {
+    { "Center",               kCenter,                0 },
+    { "Upstream",             kUpstream,             -1 },
+    { "Dnstream",             kDnstream,             +1 },
+    { "PunchedCenter",        kPunchedCenter,         0 },
+    { "PunchedUpstream",      kPunchedUpstream,      -1 },
+    { "PunchedDnstream",      kPunchedDnstream,      +1 },
+    { "UpstreamClippedFront", kUpstreamClippedFront, -1 },
+    { "DnstreamClippedFront", kDnstreamClippedFront, +1 },
+    { "UpstreamClippedRear",  kUpstreamClippedRear,  -1 },
+    { "DnstreamClippedRear",  kDnstreamClippedRear,  +1 },
+    { "UpstreamClippedBoth",  kUpstreamClippedBoth,  -1 },
+    { "DnstreamClippedBoth",  kDnstreamClippedBoth,  +1 },
+    { "UpstreamSlicedFront",  kUpstreamSlicedFront,  -1 },
+    { "DnstreamSlicedFront",  kDnstreamSlicedFront,  +1 },
+    { "UpstreamSlicedRear",   kUpstreamSlicedRear,   -1 },
+    { "DnstreamSlicedRear",   kDnstreamSlicedRear,   +1 },
+    { "UpstreamSlicedBoth",   kUpstreamSlicedBoth,   -1 },
+    { "DnstreamSlicedBoth",   kDnstreamSlicedBoth,   +1 }
+  };
+
+  constexpr int nCrossTypes = sizeof(crossTypes) / sizeof(crossTypes[0]) ;
+
+  constexpr bool crossTypesOrdered( int i = 0 ) {
+    return i == nCrossTypes || ( crossTypes[i].type == i && crossTypesOrdered( i + 1 ) ) ;
+  }
+  static_assert( crossTypesOrdered(), "ODH::crossTypes has to be ordered by ECrossType" ) ;
+
+  /// the beam branch of a crossing type: -1 upstream, 0 centered, +1 downstream
+  constexpr int getBranch( ECrossType crossType ) {
+    return ( crossType >= 0 && crossType < nCrossTypes ) ? crossTypes[ crossType ].branch : 0 ;
+  }
+
+  inline ECrossType getCrossType( std::string const & type) {
+    for( const CrossTypeEntry& ct : crossTypes ) {
+      if( type == ct.name ) return ct.type ;
+    }
+    throw std::runtime_error("Unknown Crossing Type for this geometry");
+  }
+
+  inline bool checkForSensibleGeometry(double crossingAngle, ECrossType crossType) {
+    if (crossingAngle == 0 && crossType != kCenter) {
+      std::cout << "Mask: You are trying to build a crossing geometry without a crossing angle.\n"
+	"This is probably not what you want - better check your geometry data!" << std::endl ;
+      return false; // premature exit, dd4hep will abort now
+    }
+    return true;
+  }
+
+
+  inline double getCurrentAngle( double crossingAngle, ECrossType crossType ) {
+    return getBranch( crossType ) * crossingAngle ;
+  }
+
+
+  /** The frames of the incoming (upstream) and outgoing (downstream) beams of the forward region,
+   *  computed once per detector model from the full crossing angle of the compact file. The rotations
+   *  and the sines, cosines and tangents of half and full crossing angle are kept, so that the drivers
+   *  do not recompute them for every section or layer:
+   *  @code
+   *    ODH::CrossingFrames frames( xmlParameter.attr< double >(_Unicode(crossingangle)) ) ;
+   *    envelope.placeVolume( tubeLog,  frames.placement( crossType, zPosition ) ) ;
+   *    envelope.placeVolume( tubeLog2, frames.mirrorPlacement( crossType, zPosition ) ) ;
+   *  @endcode
+   */
+  class CrossingFrames {
+
+  public:
+
+    explicit CrossingFrames( double fullCrossingAngle ) : _fullAngle( fullCrossingAngle ) {
+      for( int b = -1 ; b <= 1 ; ++b ) {
+	Branch& br = _branches[ b + 1 ] ;
+	br.angle       = b * ( fullCrossingAngle * 0.5 ) ;
+	br.mirrorAngle = M_PI - br.angle ;
+	br.rotation       = dd4hep::RotationY( br.angle ) ;
+	br.mirrorRotation = dd4hep::RotationY( br.mirrorAngle ) ;
+	br.sin = std::sin( br.angle ) ;
+	br.cos = std::cos( br.angle ) ;
+	br.tan = std::tan( br.angle ) ;
+	br.mirrorSin = std::sin( br.mirrorAngle ) ;
+	br.mirrorCos = std::cos( br.mirrorAngle ) ;
+	// the other beam is twice the angle away from this branch
+	br.otherRotation = dd4hep::RotationY( -2 * br.angle ) ;
+	br.otherTan = std::tan( -2 * br.angle ) ;
+	br.otherMirrorRotation = dd4hep::RotationY( +2 * br.angle ) ;
+	br.otherMirrorTan = std::tan( +2 * br.angle ) ;
+      }
+      _backwardRotation = dd4hep::RotationZYX( M_PI, M_PI - fullCrossingAngle * 0.5, 0.0 ) ;
+    }
+
+    double fullAngle() const { return _fullAngle ; }
+    double halfAngle() const { return _branches[2].angle ; }
+
+    /// angle of the branch of the crossing type at +z: minus/plus half the crossing angle or 0
+    double angle( ECrossType crossType ) const { return branch( crossType ).angle ; }
+    /// angle for the mirrored placement at -z, i.e. pi - angle(crossType)
+    double mirrorAngle( ECrossType crossType ) const { return branch( crossType ).mirrorAngle ; }
+
+    const dd4hep::RotationY& rotation( ECrossType crossType ) const { return branch( crossType ).rotation ; }
+    const dd4hep::RotationY& mirrorRotation( ECrossType crossType ) const { return branch( crossType ).mirrorRotation ; }
+    /// rotation from the frame of the branch to the frame of the other beam
+    const dd4hep::RotationY& otherRotation( ECrossType crossType ) const { return branch( crossType ).otherRotation ; }
+
+    /// x of the beam axis of the branch at z
+    double xOffset( ECrossType crossType, double z ) const { return z * branch( crossType ).tan ; }
+
+    /// placement of a volume centred at distance z from the IP along the axis of the branch, at +z
+    dd4hep::Transform3D placement( ECrossType crossType, double z ) const {
+      const Branch& br = branch( crossType ) ;
+      return dd4hep::Transform3D( br.rotation, dd4hep::Position( z * br.sin, 0, z * br.cos ) ) ;
+    }
+    /// the same placement mirrored to -z by a rotation of (almost) 180 degrees around the y-axis
+    dd4hep::Transform3D mirrorPlacement( ECrossType crossType, double z ) const {
+      const Branch& br = branch( crossType ) ;
+      return dd4hep::Transform3D( br.mirrorRotation, dd4hep::Position( z * br.mirrorSin, 0, z * br.mirrorCos ) ) ;
+    }
+
+    /// the beam axis of the branch, crossing the plane at z, e.g. for punching the beam pipes
+    dd4hep::Transform3D beamLine( ECrossType crossType, double z ) const {
+      const Branch& br = branch( crossType ) ;
+      return dd4hep::Transform3D( br.rotation, dd4hep::Position( z * br.tan, 0, 0 ) ) ;
+    }
+    /// the axis of the other beam seen in the frame of the branch, crossing the plane at z
+    dd4hep::Transform3D otherBeamLine( ECrossType crossType, double z ) const {
+      const Branch& br = branch( crossType ) ;
+      return dd4hep::Transform3D( br.otherRotation, dd4hep::Position( z * br.otherTan, 0, 0 ) ) ;
+    }
+    /// the same for the solid of the mirrored placement, where +x and -x are exchanged
+    dd4hep::Transform3D mirrorOtherBeamLine( ECrossType crossType, double z ) const {
+      const Branch& br = branch( crossType ) ;
+      return dd4hep::Transform3D( br.otherMirrorRotation, dd4hep::Position( z * br.otherMirrorTan, 0, 0 ) ) ;
+    }
+
+    /// placement of a forward calorimeter centred on the outgoing beam at +z
+    dd4hep::Transform3D forwardPlacement( double z ) const {
+      const Branch& br = _branches[2] ;
+      return dd4hep::Transform3D( br.rotation, dd4hep::Position( z * br.tan, 0, z ) ) ;
+    }
+    /// placement of a forward calorimeter centred on the outgoing beam at -z, rotated by 180 degrees around z and y
+    dd4hep::Transform3D backwardPlacement( double z ) const {
+      const Branch& br = _branches[2] ;
+      return dd4hep::Transform3D( _backwardRotation, dd4hep::Position( z * br.tan, 0, -z ) ) ;
+    }
+
+  private:
+
+    struct Branch {
+      double angle = 0., mirrorAngle = 0. ;
+      dd4hep::RotationY rotation {}, mirrorRotation {}, otherRotation {}, otherMirrorRotation {} ;
+      double sin = 0., cos = 1., tan = 0. ;
+      double mirrorSin = 0., mirrorCos = -1. ;
+      double otherTan = 0., otherMirrorTan = 0. ;
+    };
+
+    const Branch& branch( ECrossType crossType ) const { return _branches[ getBranch( crossType ) + 1 ] ; }
+
+    double _fullAngle ;
+    Branch _branches[3] {} ;
+    dd4hep::RotationZYX _backwardRotation {} ;
+  };
+
+}//namespace
+
+#endif // Other_Helpers_hh
@@ -0,0 +1,74 @@
+//====================================================================
+//  lcgeo - LC detector models in DD4hep
+//--------------------------------------------------------------------
+//  Helper for placing phi-symmetric arrays of ladders/modules
+//====================================================================
+#ifndef PhiSymmetricArray_h
+#define PhiSymmetricArray_h
+
+#include "DD4hep/Objects.h"
+
+#include <cmath>
+#include <vector>
+
+namespace lcgeo {
+
+  /** Transformations of n identical objects (ladders, modules, ...) arranged phi-symmetrically
+   *  around the z axis. Object i has the angle phi_i = phi0 + i * dphi. Its radial direction points
+   *  along phi_i + radialPhiOffset and its tangential direction is perpendicular to that (counter
+   *  clockwise). The sin/cos values and the rotation of every object are computed once in the c'tor,
+   *  so all components of a ladder (support, sensor, cables, ...) share them.
+   *
+   *  Example (ladders rotated around z, as in ZPlanarTracker):
+   *  @code
+   *    PhiSymmetricArray ladders( nLadders, dphi, phi0, []( double phi ){ return RotationZYX( phi, 0, 0 ) ; } ) ;
+   *    for( int j = 0 ; j < nLadders ; ++j )
+   *      layer_assembly.placeVolume( sens_vol, ladders.transform( j, sens_distance + sens_thickness/2., sens_offset ) ) ;
+   *  @endcode
+   */
+  class PhiSymmetricArray {
+
+  public:
+
+    /** n objects at phi_i = phi0 + i * dphi, the rotation of object i is rotation( phi_i ) */
+    template <typename ROTATION>
+    PhiSymmetricArray( int n, double dphi, double phi0, ROTATION rotation, double radialPhiOffset = 0. ) {
+      _phi.reserve( n ) ; _sin.reserve( n ) ; _cos.reserve( n ) ; _rot.reserve( n ) ;
+      for( int i = 0 ; i < n ; ++i ){
+	const double phi = phi0 + i * dphi ;
+	_phi.push_back( phi ) ;
+	_sin.push_back( std::sin( phi + radialPhiOffset ) ) ;
+	_cos.push_back( std::cos( phi + radialPhiOffset ) ) ;
+	_rot.push_back( dd4hep::Rotation3D( rotation( phi ) ) ) ;
+      }
+    }
+
+    /// number of objects
+    int size() const { return _phi.size() ; }
+
+    /// angle phi_i of object i
+    double phi( int i ) const { return _phi[i] ; }
+
+    /// rotation of object i
+    const dd4hep::Rotation3D& rotation( int i ) const { return _rot[i] ; }
+
+    /// point at distance r along the radial direction of object i, shifted by offset along its tangential direction
+    dd4hep::Position position( int i, double r, double offset, double z=0. ) const {
+      return dd4hep::Position( r * _cos[i] - offset * _sin[i] , r * _sin[i] + offset * _cos[i] , z ) ;
+    }
+
+    /// transformation of object i placed at position( i, r, offset, z )
+    dd4hep::Transform3D transform( int i, double r, double offset, double z=0. ) const {
+      return dd4hep::Transform3D( _rot[i], position( i, r, offset, z ) ) ;
+    }
+
+  private:
+    std::vector<double> _phi {} ;
+    std::vector<double> _sin {} ;
+    std::vector<double> _cos {} ;
+    std::vector<dd4hep::Rotation3D> _rot {} ;
+  };
+
+}
+
+#endif
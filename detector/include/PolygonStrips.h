@@ -0,0 +1,85 @@
+//====================================================================
+//  lcgeo - LC detector models in DD4hep
+//--------------------------------------------------------------------
+//  2D polygon helpers for replacing Boolean solids of prisms
+//  (e.g. a layer with box shaped cut outs) by extruded polygons
+//====================================================================
+#ifndef PolygonStrips_h
+#define PolygonStrips_h
+
+#include <cmath>
+#include <vector>
+
+namespace lcgeo {
+
+  /// point in a 2D plane
+  struct Point2D {
+    double x ;
+    double y ;
+  };
+
+  /// polygon as list of vertices
+  typedef std::vector<Point2D> Polygon2D ;
+
+  /** Infinite strip |n.(p-c)| < halfWidth in a 2D plane, i.e. the cross section of a box
+   *  that is long enough to cut through the polygon. n=(nx,ny) is the unit normal of the strip.
+   */
+  struct Strip2D {
+    double cx ;
+    double cy ;
+    double nx ;
+    double ny ;
+    double halfWidth ;
+  };
+
+  /// signed area of the polygon - positive for counter clockwise vertices
+  inline double polygonArea( const Polygon2D& poly ){
+    double a = 0. ;
+    for( unsigned i = 0, n = poly.size() ; i < n ; ++i ){
+      const Point2D& p = poly[i] ;
+      const Point2D& q = poly[ (i+1) % n ] ;
+      a += p.x * q.y - q.x * p.y ;
+    }
+    return 0.5 * a ;
+  }
+
+  /// part of the polygon with n.p >= d (Sutherland-Hodgman clipping, keeps the orientation)
+  inline Polygon2D clipPolygon( const Polygon2D& poly, double nx, double ny, double d ){
+    Polygon2D out ;
+    for( unsigned i = 0, n = poly.size() ; i < n ; ++i ){
+      const Point2D& p = poly[i] ;
+      const Point2D& q = poly[ (i+1) % n ] ;
+      const double dp = nx * p.x + ny * p.y - d ;
+      const double dq = nx * q.x + ny * q.y - d ;
+      if( dp >= 0. ) out.push_back( p ) ;
+      if( ( dp > 0. && dq < 0. ) || ( dp < 0. && dq > 0. ) ){
+	const double t = dp / ( dp - dq ) ;
+	out.push_back( { p.x + t * ( q.x - p.x ) , p.y + t * ( q.y - p.y ) } ) ;
+      }
+    }
+    return out ;
+  }
+
+  /** Convex polygon minus the given strips: returns the remaining disjoint convex pieces with
+   *  the orientation of the input polygon. Pieces with an area below minArea are dropped.
+   */
+  inline std::vector<Polygon2D> subtractStrips( const Polygon2D& convexPoly, const std::vector<Strip2D>& strips,
+						double minArea=0. ){
+    std::vector<Polygon2D> pieces( 1, convexPoly ) ;
+
+    for( const auto& s : strips ){
+      const double d = s.nx * s.cx + s.ny * s.cy ;
+      std::vector<Polygon2D> cut ;
+      for( const auto& piece : pieces ){
+	Polygon2D upper = clipPolygon( piece,  s.nx,  s.ny,    d + s.halfWidth  ) ;
+	Polygon2D lower = clipPolygon( piece, -s.nx, -s.ny, -( d - s.halfWidth ) ) ;
+	if( upper.size() > 2 && std::fabs( polygonArea( upper ) ) > minArea ) cut.push_back( upper ) ;
+	if( lower.size() > 2 && std::fabs( polygonArea( lower ) ) > minArea ) cut.push_back( lower ) ;
+      }
+      pieces.swap( cut ) ;
+    }
+    return pieces ;
+  }
+}
+
+#endif
@@ -0,0 +1,170 @@
+//====================================================================
+//  lcgeo - LC detector models in DD4hep
+//--------------------------------------------------------------------
+//  Analytic placement of the sensors of the regular tracker layouts
+//  (TrackerBarrel_o1_v05, TrackerEndcap_o2_v06), published by the
+//  drivers as extension of their DetElement
+//====================================================================
+#ifndef SensorLayout_h
+#define SensorLayout_h
+
+#include "LcgeoExceptions.h"
+
+#include "DD4hep/Objects.h"
+#include "DDSegmentation/BitFieldCoder.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace lcgeo {
+
+  /** The transformations of all sensors of a tracker with a regular layout, computed from a few numbers per
+   *  layer (barrel) or ring (endcap) instead of being stored per sensor. The cellID fields side, layer,
+   *  module and sensor select the sensor:
+   *   - Barrel: the modules of a layer are at phi_k = phi0 + k * dphi (module = k), each with nz sensors
+   *     along z (sensor = j). Every other module is shifted radially by dr, every other sensor by zdr.
+   *   - Endcap: the modules of a ring (module = ring) are at phi_k = phi0 + k * dphi (sensor = k), at z0
+   *     shifted by +dz/-dz for every other module and mirrored at z = 0 for side < 0.
+   *  The transformations are relative to the envelope of the subdetector, sensorTransform() gives the one
+   *  of the sensitive component, i.e. of the local frame of the DDRec surface of the sensor:
+   *  @code
+   *    const lcgeo::SensorLayout* layout = det.extension<lcgeo::SensorLayout>( false ) ;
+   *    dd4hep::Transform3D t = layout->sensorTransform( cellID ) ;  // envelope <- sensor
+   *  @endcode
+   */
+  class SensorLayout {
+
+  public:
+
+    typedef dd4hep::DDSegmentation::CellID CellID ;
+
+    enum Type { Barrel, Endcap } ;
+
+    /// the modules of one layer (barrel) or ring (endcap)
+    struct Ring {
+      int nphi = 0 ;           // number of modules in phi
+      double phi0 = 0. ;       // phi of the first module
+      double dphi = 0. ;       // phi step
+      double r = 0. ;          // radius of the module centres
+      double dr = 0. ;         // barrel: radial shift of every other module
+      double phiTilt = 0. ;    // barrel: tilt of the modules
+      int nz = 1 ;             // barrel: number of sensors along z
+      double z0 = 0. ;         // barrel: z of the first sensor, endcap: z of the ring
+      double dz = 0. ;         // barrel: z step, endcap: alternating z shift
+      double zdr = 0. ;        // barrel: radial shift of every other sensor along z
+      double sensitiveZ = 0. ; // position of the sensitive component along the local z axis of the module
+    };
+
+    SensorLayout() = default ;
+
+    /// the layout of the given type for the cellID encoding of the readout
+    SensorLayout( Type type, const std::string& cellIDEncoding, bool reflected = false ) :
+      _type( type ), _reflected( reflected ), _decoder( cellIDEncoding ) {
+      _side   = fieldIndex( "side" ) ;
+      _layer  = fieldIndex( "layer" ) ;
+      _module = fieldIndex( "module" ) ;
+      _sensor = fieldIndex( "sensor" ) ;
+    }
+
+    Type type() const { return _type ; }
+
+    /// add the modules of a layer - for the barrel ring is 0
+    void addRing( int layer, int ring, const Ring& r ){
+      if( layer < 0 || ring < 0 )
+	throw GeometryException( "SensorLayout: negative layer or ring number" ) ;
+      if( int( _rings.size() ) <= layer ) _rings.resize( layer + 1 ) ;
+      if( int( _rings[layer].size() ) <= ring ) _rings[layer].resize( ring + 1 ) ;
+      _rings[layer][ring] = r ;
+    }
+
+    /// true if the layout has a sensor with the side, layer, module and sensor of the cellID
+    bool contains( CellID cellID ) const {
+      int side, layer, module, sensor ;
+      decode( cellID, side, layer, module, sensor ) ;
+      const Ring* r = ring( layer, _type == Barrel ? 0 : module ) ;
+      if( r == nullptr ) return false ;
+      if( _type == Barrel )
+	return side == 0 && module >= 0 && module < r->nphi && sensor >= 0 && sensor < r->nz ;
+      return ( side > 0 || ( side < 0 && _reflected ) ) && sensor >= 0 && sensor < r->nphi ;
+    }
+
+    /// transformation of the module volume, relative to the envelope
+    dd4hep::Transform3D moduleTransform( int side, int layer, int module, int sensor ) const {
+      const Ring* r = ring( layer, _type == Barrel ? 0 : module ) ;
+      if( r == nullptr )
+	throw GeometryException( "SensorLayout: no layer " + std::to_string( layer ) + " ring " + std::to_string( module ) ) ;
+
+      if( _type == Barrel ){
+	const double phi = r->phi0 + module * r->dphi ;
+	const double rc = r->r + ( module % 2 ) * r->dr ;
+	double x = rc * std::cos( phi ), y = rc * std::sin( phi ) ;
+	if( sensor % 2 ){
+	  x += r->zdr * std::cos( phi + r->phiTilt ) ;
+	  y += r->zdr * std::sin( phi + r->phiTilt ) ;
+	}
+	return dd4hep::Transform3D( dd4hep::RotationZYX( 0, M_PI/2 - phi - r->phiTilt, -M_PI/2 ),
+				    dd4hep::Position( x, y, r->z0 + sensor * r->dz ) ) ;
+      }
+
+      const double phi = r->phi0 + sensor * r->dphi ;
+      const double x = -r->r * std::cos( phi ), y = -r->r * std::sin( phi ) ;
+      const double z = r->z0 + ( sensor % 2 ? -r->dz : r->dz ) ;
+      if( side < 0 )
+	return dd4hep::Transform3D( dd4hep::RotationZ( phi + M_PI/2 ) * dd4hep::RotationX( M_PI ), dd4hep::Position( x, y, -z ) ) ;
+      return dd4hep::Transform3D( dd4hep::RotationZ( phi + M_PI/2 ), dd4hep::Position( x, y, z ) ) ;
+    }
+
+    /// transformation of the sensitive component of the sensor with this cellID, relative to the envelope
+    dd4hep::Transform3D sensorTransform( CellID cellID ) const {
+      int side, layer, module, sensor ;
+      decode( cellID, side, layer, module, sensor ) ;
+      const Ring* r = ring( layer, _type == Barrel ? 0 : module ) ;
+      const double z = r ? r->sensitiveZ : 0. ;
+      return moduleTransform( side, layer, module, sensor ) * dd4hep::Transform3D( dd4hep::Translation3D( 0., 0., z ) ) ;
+    }
+
+    /// number of sensors, counting both sides of a reflected endcap
+    long numberOfSensors() const {
+      long n = 0 ;
+      for( const auto& layer : _rings )
+	for( const Ring& r : layer ) n += long( r.nphi ) * ( _type == Barrel ? r.nz : 1 ) ;
+      return ( _type == Endcap && _reflected ) ? 2 * n : n ;
+    }
+
+  private:
+
+    /// index of the field in the decoder, -1 if the encoding does not have it
+    int fieldIndex( const std::string& name ) const {
+      for( std::size_t i = 0 ; i < _decoder.size() ; ++i )
+	if( _decoder[i].name() == name ) return i ;
+      return -1 ;
+    }
+
+    /// missing fields are zero, except for the side of an endcap without side field, which is +1
+    void decode( CellID cellID, int& side, int& layer, int& module, int& sensor ) const {
+      side   = _side   >= 0 ? _decoder[_side].value( cellID ) : ( _type == Endcap ? 1 : 0 ) ;
+      layer  = _layer  >= 0 ? _decoder[_layer].value( cellID ) : 0 ;
+      module = _module >= 0 ? _decoder[_module].value( cellID ) : 0 ;
+      sensor = _sensor >= 0 ? _decoder[_sensor].value( cellID ) : 0 ;
+    }
+
+    const Ring* ring( int layer, int iring ) const {
+      if( layer < 0 || layer >= int( _rings.size() ) || iring < 0 || iring >= int( _rings[layer].size() ) ) return nullptr ;
+      const Ring& r = _rings[layer][iring] ;
+      return r.nphi > 0 ? &r : nullptr ;
+    }
+
+    Type _type = Barrel ;
+    bool _reflected = false ;
+    dd4hep::DDSegmentation::BitFieldCoder _decoder {} ;
+    int _side = -1 ;
+    int _layer = -1 ;
+    int _module = -1 ;
+    int _sensor = -1 ;
+    std::vector< std::vector<Ring> > _rings {} ;
+  };
+
+}
+
+#endif
@@ -0,0 +1,288 @@
+//====================================================================
+//  lcgeo - LC detector models in DD4hep
+//--------------------------------------------------------------------
+//  Bounding volume hierarchy over the DDRec surfaces for sub-linear
+//  point, box and ray queries, attached to the world DetElement by
+//  the plugin lcgeo_SurfaceIndex
+//====================================================================
+#ifndef SurfaceIndex_h
+#define SurfaceIndex_h
+
+#include <DDRec/ISurface.h>
+#include <DDRec/Surface.h>
+#include <DDRec/Vector3D.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace lcgeo {
+
+  /** Axis aligned bounding box hierarchy over a list of surfaces.
+   *
+   *  The bounding box of every surface is computed once from its outline (Surface::getLines),
+   *  the tree is split at the median of the longest axis down to a few surfaces per leaf.
+   *  Queries:
+   *   - nearestSurface( p ):   surface with the smallest distance to p, among the surfaces for which
+   *                            the projection of p is inside the bounds
+   *   - surfacesInBox( lo, hi ): all surfaces whose bounding box intersects the box
+   *   - intersections( p, d ): all planar and cylindrical surfaces hit by the ray p + s*d, 0 <= s <= sMax,
+   *                            ordered by s (cones and other surface types are not intersected)
+   *
+   *  The index is attached to the world DetElement:
+   *  @code
+   *    const lcgeo::SurfaceIndex* index = theDetector.world().extension<lcgeo::SurfaceIndex>() ;
+   *    const dd4hep::rec::ISurface* surf = index->nearestSurface( point ) ;
+   *  @endcode
+   */
+  class SurfaceIndex {
+
+  public:
+
+    typedef dd4hep::rec::Vector3D Vector3D ;
+    typedef dd4hep::rec::ISurface ISurface ;
+
+    /// hit of a ray on a surface at the path length s
+    struct Intersection {
+      const ISurface* surface ;
+      double s ;
+    };
+
+    SurfaceIndex() = default ;
+
+    explicit SurfaceIndex( const std::vector<ISurface*>& surfaces, unsigned maxLeafSize = 4 ) : _maxLeafSize( maxLeafSize ) {
+      _items.reserve( surfaces.size() ) ;
+      for( ISurface* s : surfaces )
+	_items.push_back( makeItem( s ) ) ;
+      if( ! _items.empty() ) build( 0, _items.size() ) ;
+    }
+
+    /// number of indexed surfaces
+    std::size_t size() const { return _items.size() ; }
+
+    /// number of nodes of the tree
+    std::size_t nodes() const { return _nodes.size() ; }
+
+    /// surface closest to p (within maxDistance), nullptr if there is none
+    const ISurface* nearestSurface( const Vector3D& p, double maxDistance = std::numeric_limits<double>::max(), double epsilon = 1e-4 ) const {
+      const ISurface* best = nullptr ;
+      double bestDist = maxDistance ;
+      if( _nodes.empty() ) return best ;
+
+      std::vector<std::pair<double, unsigned> > stack { { boxDistance( _nodes[0], p ), 0 } } ;
+      while( ! stack.empty() ){
+	auto top = stack.back() ; stack.pop_back() ;
+	if( top.first >= bestDist ) continue ;
+	const Node& n = _nodes[ top.second ] ;
+	if( n.leaf ){
+	  for( unsigned i = n.first ; i < n.first + n.count ; ++i ){
+	    if( boxDistance( _items[i], p ) >= bestDist ) continue ;
+	    const double d = surfaceDistance( _items[i].surface, p, epsilon ) ;
+	    if( d < bestDist ){ bestDist = d ; best = _items[i].surface ; }
+	  }
+	  continue ;
+	}
+	// visit the closer child first
+	const double dl = boxDistance( _nodes[ n.left ], p ), dr = boxDistance( _nodes[ n.right ], p ) ;
+	if( dl < dr ){ stack.push_back( { dr, n.right } ) ; stack.push_back( { dl, n.left } ) ; }
+	else         { stack.push_back( { dl, n.left } ) ;  stack.push_back( { dr, n.right } ) ; }
+      }
+      return best ;
+    }
+
+    /// all surfaces whose bounding box intersects the box [lo,hi]
+    std::vector<const ISurface*> surfacesInBox( const Vector3D& lo, const Vector3D& hi ) const {
+      std::vector<const ISurface*> result ;
+      if( _nodes.empty() ) return result ;
+      const double qlo[3] = { lo.x(), lo.y(), lo.z() }, qhi[3] = { hi.x(), hi.y(), hi.z() } ;
+      std::vector<unsigned> stack( 1, 0 ) ;
+      while( ! stack.empty() ){
+	const Node& n = _nodes[ stack.back() ] ; stack.pop_back() ;
+	if( ! overlaps( n, qlo, qhi ) ) continue ;
+	if( n.leaf ){
+	  for( unsigned i = n.first ; i < n.first + n.count ; ++i )
+	    if( overlaps( _items[i], qlo, qhi ) ) result.push_back( _items[i].surface ) ;
+	} else {
+	  stack.push_back( n.left ) ;
+	  stack.push_back( n.right ) ;
+	}
+      }
+      return result ;
+    }
+
+    /// all surfaces hit by the ray p + s*d with 0 <= s <= sMax, ordered by s (d has to be a unit vector)
+    std::vector<Intersection> intersections( const Vector3D& p, const Vector3D& d, double sMax, double epsilon = 1e-4 ) const {
+      std::vector<Intersection> result ;
+      if( _nodes.empty() ) return result ;
+      const double o[3] = { p.x(), p.y(), p.z() } ;
+      const double inv[3] = { 1. / d.x(), 1. / d.y(), 1. / d.z() } ;
+      std::vector<unsigned> stack( 1, 0 ) ;
+      while( ! stack.empty() ){
+	const Node& n = _nodes[ stack.back() ] ; stack.pop_back() ;
+	if( ! rayHitsBox( n, o, inv, sMax ) ) continue ;
+	if( n.leaf ){
+	  for( unsigned i = n.first ; i < n.first + n.count ; ++i )
+	    if( rayHitsBox( _items[i], o, inv, sMax ) )
+	      intersect( _items[i].surface, p, d, sMax, epsilon, result ) ;
+	} else {
+	  stack.push_back( n.left ) ;
+	  stack.push_back( n.right ) ;
+	}
+      }
+      std::sort( result.begin(), result.end(), []( const Intersection& a, const Intersection& b ){ return a.s < b.s ; } ) ;
+      return result ;
+    }
+
+    //--------------------------------------------------------------------------------------------
+    // exact geometry of a single surface - also used for the linear reference implementation
+
+    /** distance of p to the surface, if the projection of p onto the surface is inside its bounds,
+     *  otherwise infinity
+     */
+    static double surfaceDistance( const ISurface* s, const Vector3D& p, double epsilon = 1e-4 ){
+      const double d = s->distance( p ) ;
+      const Vector3D projected = p - d * s->normal( p ) ;
+      return s->insideBounds( projected, epsilon ) ? std::fabs( d ) : std::numeric_limits<double>::max() ;
+    }
+
+    /// add the intersections of the ray p + s*d (0 <= s <= sMax) with a planar or cylindrical surface
+    static void intersect( const ISurface* surf, const Vector3D& p, const Vector3D& d, double sMax, double epsilon,
+			   std::vector<Intersection>& result ){
+      double s[2] ;
+      int n = 0 ;
+      if( surf->type().isPlane() ){
+	const Vector3D normal = surf->normal() ;
+	const double dn = d * normal ;
+	if( dn == 0. ) return ;
+	s[ n++ ] = ( ( surf->origin() - p ) * normal ) / dn ;
+      } else if( const dd4hep::rec::ICylinder* cyl = dynamic_cast<const dd4hep::rec::ICylinder*>( surf ) ){
+	// cylinder along z around center
+	const Vector3D c = cyl->center() ;
+	const double px = p.x() - c.x(), py = p.y() - c.y() ;
+	const double a = d.x() * d.x() + d.y() * d.y() ;
+	if( a == 0. ) return ;
+	const double b = px * d.x() + py * d.y() ;
+	const double disc = b * b - a * ( px * px + py * py - cyl->radius() * cyl->radius() ) ;
+	if( disc < 0. ) return ;
+	s[ n++ ] = ( -b - std::sqrt( disc ) ) / a ;
+	s[ n++ ] = ( -b + std::sqrt( disc ) ) / a ;
+      }
+      for( int i = 0 ; i < n ; ++i ){
+	if( s[i] < 0. || s[i] > sMax ) continue ;
+	if( surf->insideBounds( p + s[i] * d, epsilon ) ) result.push_back( { surf, s[i] } ) ;
+      }
+    }
+
+    /// axis aligned bounding box of the surface (from its outline, including its thickness)
+    static void boundingBox( ISurface* s, double* lo, double* hi ){
+      for( int k = 0 ; k < 3 ; ++k ){ lo[k] = std::numeric_limits<double>::max() ; hi[k] = -lo[k] ; }
+      auto extend = [&]( const Vector3D& v ){
+	for( int k = 0 ; k < 3 ; ++k ){ lo[k] = std::min( lo[k], v[k] ) ; hi[k] = std::max( hi[k], v[k] ) ; }
+      } ;
+      extend( s->origin() ) ;
+      if( dd4hep::rec::Surface* surf = dynamic_cast<dd4hep::rec::Surface*>( s ) ){
+	for( const auto& line : surf->getLines() ){ extend( line.first ) ; extend( line.second ) ; }
+      }
+      // the outline of a cylinder is a polygon inside the circle - add the circle's bounding box
+      if( const dd4hep::rec::ICylinder* cyl = dynamic_cast<const dd4hep::rec::ICylinder*>( s ) ){
+	const double r = cyl->radius() ;
+	const Vector3D c = cyl->center() ;
+	lo[0] = std::min( lo[0], c.x() - r ) ; hi[0] = std::max( hi[0], c.x() + r ) ;
+	lo[1] = std::min( lo[1], c.y() - r ) ; hi[1] = std::max( hi[1], c.y() + r ) ;
+      }
+      // thickness of the surface and numerical margin
+      const double margin = 1e-3 + std::max( s->innerThickness(), s->outerThickness() ) ;
+      for( int k = 0 ; k < 3 ; ++k ){ lo[k] -= margin ; hi[k] += margin ; }
+    }
+
+  private:
+
+    struct Box {
+      double lo[3] ;
+      double hi[3] ;
+    };
+
+    struct Item : Box {
+      const ISurface* surface ;
+      double center[3] ;
+    };
+
+    struct Node : Box {
+      bool leaf ;
+      unsigned first, count ; // items of a leaf
+      unsigned left, right ;  // children of an inner node
+    };
+
+    static Item makeItem( ISurface* s ){
+      Item item ;
+      item.surface = s ;
+      boundingBox( s, item.lo, item.hi ) ;
+      for( int k = 0 ; k < 3 ; ++k ) item.center[k] = 0.5 * ( item.lo[k] + item.hi[k] ) ;
+      return item ;
+    }
+
+    /// build the node for the items [begin,end), returns its index
+    unsigned build( unsigned begin, unsigned end ){
+      const unsigned index = _nodes.size() ;
+      _nodes.push_back( Node() ) ;
+      Node n ;
+      for( int k = 0 ; k < 3 ; ++k ){ n.lo[k] = std::numeric_limits<double>::max() ; n.hi[k] = -n.lo[k] ; }
+      for( unsigned i = begin ; i < end ; ++i )
+	for( int k = 0 ; k < 3 ; ++k ){ n.lo[k] = std::min( n.lo[k], _items[i].lo[k] ) ; n.hi[k] = std::max( n.hi[k], _items[i].hi[k] ) ; }
+
+      n.leaf = ( end - begin <= _maxLeafSize ) ;
+      n.first = begin ; n.count = end - begin ;
+      n.left = n.right = 0 ;
+
+      if( ! n.leaf ){
+	int axis = 0 ;
+	for( int k = 1 ; k < 3 ; ++k )
+	  if( n.hi[k] - n.lo[k] > n.hi[axis] - n.lo[axis] ) axis = k ;
+	const unsigned mid = ( begin + end ) / 2 ;
+	std::nth_element( _items.begin() + begin, _items.begin() + mid, _items.begin() + end,
+			  [axis]( const Item& a, const Item& b ){ return a.center[axis] < b.center[axis] ; } ) ;
+	n.left = build( begin, mid ) ;
+	n.right = build( mid, end ) ;
+      }
+      _nodes[ index ] = n ;
+      return index ;
+    }
+
+    static double boxDistance( const Box& b, const Vector3D& p ){
+      double d2 = 0. ;
+      for( int k = 0 ; k < 3 ; ++k ){
+	const double d = std::max( std::max( b.lo[k] - p[k], p[k] - b.hi[k] ), 0. ) ;
+	d2 += d * d ;
+      }
+      return std::sqrt( d2 ) ;
+    }
+
+    static bool overlaps( const Box& b, const double* lo, const double* hi ){
+      return b.lo[0] <= hi[0] && lo[0] <= b.hi[0] && b.lo[1] <= hi[1] && lo[1] <= b.hi[1] && b.lo[2] <= hi[2] && lo[2] <= b.hi[2] ;
+    }
+
+    /// slab test of the ray o + s*d, 0 <= s <= sMax, inv = 1/d
+    static bool rayHitsBox( const Box& b, const double* o, const double* inv, double sMax ){
+      double t0 = 0., t1 = sMax ;
+      for( int k = 0 ; k < 3 ; ++k ){
+	double tNear = ( b.lo[k] - o[k] ) * inv[k], tFar = ( b.hi[k] - o[k] ) * inv[k] ;
+	// ray parallel to the slab: 0 * inf gives NaN
+	if( std::isnan( tNear ) || std::isnan( tFar ) ) continue ;
+	if( tNear > tFar ) std::swap( tNear, tFar ) ;
+	t0 = std::max( t0, tNear ) ;
+	t1 = std::min( t1, tFar ) ;
+	if( t0 > t1 ) return false ;
+      }
+      return true ;
+    }
+
+    unsigned _maxLeafSize = 4 ;
+    std::vector<Item> _items {} ;
+    std::vector<Node> _nodes {} ;
+  };
+
+}
+
+#endif
@@ -1,23 +1,114 @@
 #include "XML/XMLDetector.h"
+#include "DD4hep/Handle.h"
+#include "DD4hep/Printout.h"
+#include <functional>
+#include <map>
+#include <memory>
 #include <string>
+#include <vector>
+#include "LcgeoExceptions.h"
 
 namespace {
   /** Wrapper class to replace the Database class used in Mokka to read the parameters.
    *  Assumes parameters are stored as attributes of the corresponding xml element.
+   *  All attributes are read once into a table when the handler is created, looked up by the
+   *  const char* names without building a std::string, and numerical values are converted on first
+   *  access and cached. Fetching a parameter that does not exist throws a
+   *  lcgeo::GeometryException, parameters that have never been fetched are reported (DEBUG level)
+   *  when the last copy of the handler goes out of scope or is reassigned.
    */
   struct XMLHandlerDB{
+
+    /// value of one attribute
+    struct Parameter{
+      std::string value {} ;
+      double number = 0. ;
+      int integer = 0 ;
+      bool boolean = false ;
+      bool evaluated = false ;        // number
+      bool evaluatedInteger = false ;
+      bool evaluatedBoolean = false ;
+      bool used = false ;
+    };
+
+    /// parameter table of one xml element - shared between copies of the handler
+    struct Table{
+      std::string tag {} ;
+      std::map< std::string, Parameter, std::less<> > parameters {} ;
+
+      ~Table(){
+	for( const auto& p : parameters ){
+	  if( ! p.second.used )
+	    dd4hep::printout( dd4hep::DEBUG, "XMLHandlerDB", "parameter %s=\"%s\" of element <%s> has not been used",
+			      p.first.c_str(), p.second.value.c_str(), tag.c_str() ) ;
+	}
+      }
+    };
+
     xml_comp_t x_det ;
-    /** C'tor initializes the handle */
-  XMLHandlerDB(xml_comp_t det) : x_det(det) {}
-  
-    double fetchDouble( const char* _name){ return  x_det.attr<double>( dd4hep::xml::Strng_t(_name) )  ; }
+    std::shared_ptr<Table> table ;
+
+    /** C'tor initializes the handle and reads all attributes */
+    XMLHandlerDB(xml_comp_t det) : x_det(det), table( std::make_shared<Table>() ) {
+
+      dd4hep::xml::Handle_t h = x_det ;
+      table->tag = h.tag() ;
 
-    int    fetchInt( const char* _name){ return  x_det.attr<int>( dd4hep::xml::Strng_t(_name) ) ; }
+      for( const auto& a : h.attributes() )
+	table->parameters[ dd4hep::xml::_toString( h.attr_name( a ) ) ].value = dd4hep::xml::_toString( h.attr_value( a ) ) ;
+    }
 
-    std::string fetchString( const char* _name){ return  x_det.attr<std::string>( dd4hep::xml::Strng_t(_name) ) ;}
+    double fetchDouble( const char* _name){
+      Parameter& p = parameter( _name ) ;
+      if( ! p.evaluated ){
+	p.number = dd4hep::_toDouble( p.value ) ;
+	p.evaluated = true ;
+      }
+      return p.number ;
+    }
+
+    int    fetchInt( const char* _name){
+      Parameter& p = parameter( _name ) ;
+      if( ! p.evaluatedInteger ){
+	p.integer = dd4hep::_toInt( p.value ) ;
+	p.evaluatedInteger = true ;
+      }
+      return p.integer ;
+    }
+
+    bool   fetchBool( const char* _name){
+      Parameter& p = parameter( _name ) ;
+      if( ! p.evaluatedBoolean ){
+	p.boolean = dd4hep::_toBool( p.value ) ;
+	p.evaluatedBoolean = true ;
+      }
+      return p.boolean ;
+    }
+
+    std::string fetchString( const char* _name){ return parameter( _name ).value ; }
+
+    /// true if the element has an attribute of the given name (does not mark it as used)
+    bool hasParameter( const char* _name) const { return table->parameters.find( _name ) != table->parameters.end() ; }
+
+    /// names of all parameters that have not been fetched so far
+    std::vector<std::string> unusedParameters() const {
+      std::vector<std::string> names ;
+      for( const auto& p : table->parameters )
+	if( ! p.second.used ) names.push_back( p.first ) ;
+      return names ;
+    }
 
     /** allow this to be used as a 'pointer' ( as was used for Mokka Database object)*/
     XMLHandlerDB* operator->() { return this ; }
+
+  private:
+    Parameter& parameter( const char* _name ){
+      auto it = table->parameters.find( _name ) ;
+      if( it == table->parameters.end() )
+	throw lcgeo::GeometryException( std::string("XMLHandlerDB: no parameter '") + _name + "' in element <" + table->tag + ">" ) ;
+      it->second.used = true ;
+      return it->second ;
+    }
   };
 
 }
@@ -29,7 +29,6 @@ using dd4hep::Material;
 using dd4hep::PlacedVolume;
 using dd4hep::Position;
 using dd4hep::Ref_t;
-using dd4hep::RotateY;
 using dd4hep::RotationY;
 using dd4hep::SensitiveDetector;
 using dd4hep::Solid;
@@ -163,7 +162,9 @@ static Ref_t create_element(Detector& theDetector,
   
   //Parameters we have to know about
   dd4hep::xml::Component xmlParameter = xmlBeampipe.child(_Unicode(parameter));
-  const double crossingAngle  = xmlParameter.attr< double >(_Unicode(crossingangle))*0.5; //  only half the angle
+  // frames of the incoming and outgoing beams, computed once for all sections
+  const ODH::CrossingFrames frames( xmlParameter.attr< double >(_Unicode(crossingangle)) );
+  const double crossingAngle  = frames.halfAngle(); //  only half the angle
 
 
   double min_radius = 1.e99 ;
@@ -214,9 +215,8 @@ static Ref_t create_element(Detector& theDetector,
       throw std::runtime_error( " Beampipe_o1_v01_geo.cpp : checkForSensibleGeometry() failed " ) ;
       //      return false;
     }
-    const double rotateAngle = getCurrentAngle(crossingAngle, crossType); // for the placement at +z (better make it const now)
-    const double mirrorAngle = M_PI - rotateAngle; // for the "mirrored" placement at -z
-    // the "mirroring" in fact is done by a rotation of (almost) 180 degrees around the y-axis
+    const double rotateAngle = frames.angle(crossType); // for the placement at +z (better make it const now)
+    // the "mirroring" at -z in fact is done by a rotation of (almost) 180 degrees around the y-axis
 
     switch (crossType) {
     case ODH::kCenter:
@@ -225,8 +225,8 @@ static Ref_t create_element(Detector& theDetector,
       // a volume on the z-axis, on the upstream branch, or on the downstream branch
       
       // absolute transformations for the placement in the world
-      Transform3D transformer(RotationY(rotateAngle), RotateY( Position(0, 0, zPosition), rotateAngle) );
-      Transform3D transmirror(RotationY(mirrorAngle), RotateY( Position(0, 0, zPosition), mirrorAngle) );
+      Transform3D transformer( frames.placement(crossType, zPosition) );
+      Transform3D transmirror( frames.mirrorPlacement(crossType, zPosition) );
       
       // solid for the tube (including vacuum and wall): a solid cone
       ConeSegment tubeSolid( zHalf, 0, rOuterStart, 0, rOuterEnd , phi1, phi2);
@@ -307,12 +307,12 @@ static Ref_t create_element(Detector& theDetector,
       const double rDnstreamPunch = rInnerEnd; // (the database entries are "abused" in this case)
       
       // relative transformations for the composition of the SubtractionVolumes
-      Transform3D upstreamTransformer(RotationY(-crossingAngle), Position(zPosition * tan(-crossingAngle), 0, 0));
-      Transform3D dnstreamTransformer(RotationY(+crossingAngle), Position(zPosition * tan(+crossingAngle), 0, 0));
+      Transform3D upstreamTransformer( frames.beamLine(ODH::kUpstream, zPosition) );
+      Transform3D dnstreamTransformer( frames.beamLine(ODH::kDnstream, zPosition) );
   
       // absolute transformations for the final placement in the world (angles always equal zero and 180 deg)
-      Transform3D placementTransformer(RotationY(rotateAngle), RotateY( Position(0, 0, zPosition) , rotateAngle) );
-      Transform3D placementTransmirror(RotationY(mirrorAngle), RotateY( Position(0, 0, zPosition) , mirrorAngle) );
+      Transform3D placementTransformer( frames.placement(crossType, zPosition) );
+      Transform3D placementTransmirror( frames.mirrorPlacement(crossType, zPosition) );
   
       // solid for the tube (including vacuum and wall): a solid cone
       ConeSegment tubeSolid( zHalf, 0, rOuterStart, 0, rOuterEnd, phi1, phi2);
@@ -377,12 +377,12 @@ static Ref_t create_element(Detector& theDetector,
       const double rOffsetPunch = (crossType == ODH::kPunchedDnstream) ? (rInnerStart) : (rInnerEnd); // (the database entries are "abused" in this case)
       
       // relative transformations for the composition of the SubtractionVolumes
-      Transform3D punchTransformer(RotationY(-2 * rotateAngle), Position(zPosition * tan(-2 * rotateAngle), 0, 0));
-      Transform3D punchTransmirror(RotationY(+2 * rotateAngle), Position(zPosition * tan(+2 * rotateAngle), 0, 0));
+      Transform3D punchTransformer( frames.otherBeamLine(crossType, zPosition) );
+      Transform3D punchTransmirror( frames.mirrorOtherBeamLine(crossType, zPosition) );
       
       // absolute transformations for the final placement in the world
-      Transform3D placementTransformer(RotationY(rotateAngle), RotateY( Position(0, 0, zPosition) , rotateAngle) );
-      Transform3D placementTransmirror(RotationY(mirrorAngle), RotateY( Position(0, 0, zPosition) , mirrorAngle) );
+      Transform3D placementTransformer( frames.placement(crossType, zPosition) );
+      Transform3D placementTransmirror( frames.mirrorPlacement(crossType, zPosition) );
       
       // solid for the tube (including vacuum and wall): a solid cone
       ConeSegment tubeSolid( zHalf, 0, rOuterStart, 0, rOuterEnd, phi1, phi2);
@@ -442,8 +442,8 @@ static Ref_t create_element(Detector& theDetector,
       Transform3D clipTransmirror(RotationY(+clipAngle), Position(0, 0, clipShift));
   
       // absolute transformations for the final placement in the world
-      Transform3D placementTransformer(RotationY(rotateAngle), RotateY( Position(0, 0, zPosition - clipSize / 2) , rotateAngle) );
-      Transform3D placementTransmirror(RotationY(mirrorAngle), RotateY( Position(0, 0, zPosition - clipSize / 2) , mirrorAngle) );
+      Transform3D placementTransformer( frames.placement(crossType, zPosition - clipSize / 2) );
+      Transform3D placementTransmirror( frames.mirrorPlacement(crossType, zPosition - clipSize / 2) );
   
       // solid for the tube (including vacuum and wall): a solid cone
 
@@ -505,8 +505,8 @@ static Ref_t create_element(Detector& theDetector,
       Transform3D clipTransmirror(RotationY(+clipAngle), Position(0, 0, clipShift));
       
       // absolute transformations for the final placement in the world
-      Transform3D placementTransformer(RotationY(rotateAngle), RotateY( Position(0, 0, zPosition + clipSize / 2) , rotateAngle) );
-      Transform3D placementTransmirror(RotationY(mirrorAngle), RotateY( Position(0, 0, zPosition + clipSize / 2) , mirrorAngle) );
+      Transform3D placementTransformer( frames.placement(crossType, zPosition + clipSize / 2) );
+      Transform3D placementTransmirror( frames.mirrorPlacement(crossType, zPosition + clipSize / 2) );
       
       // solid for the tube (including vacuum and wall): a solid cone
       ConeSegment wholeSolid( 0, rOuterStart, 0, rOuterEnd, zHalf + clipSize / 2, phi1, phi2); // a bit longer
@@ -570,8 +570,8 @@ static Ref_t create_element(Detector& theDetector,
       Transform3D clipTransmirrorRear(RotationY(+clipAngle), Position(0, 0, clipShiftRear));
   
       // absolute transformations for the final placement in the world
-      Transform3D placementTransformer(RotationY(rotateAngle), RotateY( Position(0, 0, zPosition) , rotateAngle) );
-      Transform3D placementTransmirror(RotationY(mirrorAngle), RotateY( Position(0, 0, zPosition) , mirrorAngle) );
+      Transform3D placementTransformer( frames.placement(crossType, zPosition) );
+      Transform3D placementTransmirror( frames.mirrorPlacement(crossType, zPosition) );
       
       // solid for the tube (including vacuum and wall): a solid cone
       ConeSegment wholeSolid( 0, rOuterStart, 0, rOuterEnd, zHalf + clipSize, phi1, phi2); // a bit longer
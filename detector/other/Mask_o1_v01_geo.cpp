@@ -22,7 +22,6 @@ using dd4hep::Material;
 using dd4hep::PlacedVolume;
 using dd4hep::Position;
 using dd4hep::Ref_t;
-using dd4hep::RotateY;
 using dd4hep::RotationY;
 using dd4hep::SensitiveDetector;
 using dd4hep::Solid;
@@ -57,7 +56,9 @@ static Ref_t create_element(Detector& theDetector,
   
   //Parameters we have to know about
   dd4hep::xml::Component xmlParameter = xmlMask.child(_Unicode(parameter));
-  const double crossingAngle  = xmlParameter.attr< double >(_Unicode(crossingangle))*0.5; //  only half the angle
+  // frames of the incoming and outgoing beams, computed once for all sections
+  const ODH::CrossingFrames frames( xmlParameter.attr< double >(_Unicode(crossingangle)) );
+  const double crossingAngle  = frames.halfAngle(); //  only half the angle
 
   for(xml_coll_t c( xmlMask ,Unicode("section")); c; ++c) {
 
@@ -95,9 +96,8 @@ static Ref_t create_element(Detector& theDetector,
       throw std::runtime_error( " Mask_o1_v01_geo.cpp : checkForSensibleGeometry() failed " ) ;
     }
 
-    const double rotateAngle = getCurrentAngle(crossingAngle, crossType); // for the placement at +z (better make it const now)
-    const double mirrorAngle = M_PI - rotateAngle; // for the "mirrored" placement at -z
-    // the "mirroring" in fact is done by a rotation of (almost) 180 degrees around the y-axis
+    // placement at +z along the branch of the crossType, the "mirroring" at -z
+    // in fact is done by a rotation of (almost) 180 degrees around the y-axis
 
     switch (crossType) {
     case ODH::kCenter:
@@ -106,8 +106,8 @@ static Ref_t create_element(Detector& theDetector,
       // a volume on the z-axis, on the upstream branch, or on the downstream branch
       
       // absolute transformations for the placement in the world
-      Transform3D transformer(RotationY(rotateAngle), RotateY( Position(0, 0, zPosition), rotateAngle) );
-      Transform3D transmirror(RotationY(mirrorAngle), RotateY( Position(0, 0, zPosition), mirrorAngle) );
+      Transform3D transformer( frames.placement(crossType, zPosition) );
+      Transform3D transmirror( frames.mirrorPlacement(crossType, zPosition) );
       
       // solid for the tube (including vacuum and wall): a solid cone
       ConeSegment tubeSolid( zHalf, rInnerStart, rOuterStart, rInnerEnd, rOuterEnd , phi1, phi2);
@@ -130,12 +130,12 @@ static Ref_t create_element(Detector& theDetector,
       const double rDnstreamPunch = rInnerEnd; // (the database entries are "abused" in this case)
 
       // relative transformations for the composition of the SubtractionVolumes
-      Transform3D upstreamTransformer(RotationY(-crossingAngle), Position(zPosition * tan(-crossingAngle), 0, 0));
-      Transform3D dnstreamTransformer(RotationY(+crossingAngle), Position(zPosition * tan(+crossingAngle), 0, 0));
+      Transform3D upstreamTransformer( frames.beamLine(ODH::kUpstream, zPosition) );
+      Transform3D dnstreamTransformer( frames.beamLine(ODH::kDnstream, zPosition) );
 
       // absolute transformations for the final placement in the world (angles always equal zero and 180 deg)
-      Transform3D placementTransformer(RotationY(rotateAngle), RotateY( Position(0, 0, zPosition) , rotateAngle) );
-      Transform3D placementTransmirror(RotationY(mirrorAngle), RotateY( Position(0, 0, zPosition) , mirrorAngle) );
+      Transform3D placementTransformer( frames.placement(crossType, zPosition) );
+      Transform3D placementTransmirror( frames.mirrorPlacement(crossType, zPosition) );
 
       // the main solid and the two pieces (only tubes, for the moment) which will be punched out
       ConeSegment wholeSolid(  zHalf, 0, rOuterStart, 0, rOuterEnd, phi1, phi2 );
@@ -185,12 +185,12 @@ static Ref_t create_element(Detector& theDetector,
       const double rOffsetPunch = (crossType == ODH::kPunchedDnstream) ? (rInnerStart) : (rInnerEnd); // (the database entries are "abused" in this case)
       
       // relative transformations for the composition of the SubtractionVolumes
-      Transform3D punchTransformer(RotationY(-2 * rotateAngle), Position(zPosition * tan(-2 * rotateAngle), 0, 0));
-      Transform3D punchTransmirror(RotationY(+2 * rotateAngle), Position(zPosition * tan(+2 * rotateAngle), 0, 0));
+      Transform3D punchTransformer( frames.otherBeamLine(crossType, zPosition) );
+      Transform3D punchTransmirror( frames.mirrorOtherBeamLine(crossType, zPosition) );
       
       // absolute transformations for the final placement in the world
-      Transform3D placementTransformer(RotationY(rotateAngle), RotateY( Position(0, 0, zPosition) , rotateAngle) );
-      Transform3D placementTransmirror(RotationY(mirrorAngle), RotateY( Position(0, 0, zPosition) , mirrorAngle) );
+      Transform3D placementTransformer( frames.placement(crossType, zPosition) );
+      Transform3D placementTransmirror( frames.mirrorPlacement(crossType, zPosition) );
 
       // the main solid and the piece (only a tube, for the moment) which will be punched out
       ConeSegment wholeSolid( zHalf, rCenterPunch , rOuterStart, rCenterPunch, rOuterEnd, phi1, phi2);
@@ -12,6 +12,7 @@
 #include "XML/Utilities.h"
 #include <cmath>
 #include "DDRec/DetectorData.h"
+#include "LcgeoBuildMode.h"
 
 //#include "GearWrapper.h"
 
@@ -109,13 +110,17 @@ static Ref_t create_element(Detector& theDetector, xml_h element, SensitiveDetec
 
 #if !code_is_cleaned_up 
 
-  Tube   coil_tube( x_tube.rmin(), x_tube.rmax(), x_tube.dz() );
+  // in the reconstruction geometry mode only the LayeredCalorimeterData is filled
+  if( ! lcgeo::buildRecoGeometryOnly( theDetector ) ){
 
-  Volume coil_vol( "coil_vol", coil_tube , coilMaterial );
-  pv  =  envelope.placeVolume( coil_vol ) ;
-  coil.setVisAttributes( theDetector, "BlueVis" , coil_vol );
+    Tube   coil_tube( x_tube.rmin(), x_tube.rmax(), x_tube.dz() );
 
-  cout << " ... for the time being simply use a tube of aluminum ..." << endl ;
+    Volume coil_vol( "coil_vol", coil_tube , coilMaterial );
+    pv  =  envelope.placeVolume( coil_vol ) ;
+    coil.setVisAttributes( theDetector, "BlueVis" , coil_vol );
+
+    cout << " ... for the time being simply use a tube of aluminum ..." << endl ;
+  }
 
   //=========================================================================================================
 #else
@@ -33,6 +33,7 @@
 #include "DD4hep/DetType.h"
 #include "DDRec/Surface.h"
 #include "XMLHandlerDB.h"
+#include "LcgeoBuildMode.h"
 
 #include "SServices00.h"
  
@@ -76,6 +77,10 @@ static Ref_t create_element(Detector& theDetector, xml_h element, Ref_t)  {
 //====================================================================
   cout << "\nBuilding SServices00"<< endl;
 
+  // in the reconstruction geometry mode only the SIT and VXD cables are built, as they carry
+  // the helper surfaces needed for tracking - the TPC and calorimeter services are skipped
+  bool buildCaloServices = ! lcgeo::buildRecoGeometryOnly( theDetector ) ;
+
   //==================================================
   //           BuildTPCEndplateServices
   //==================================================
@@ -113,7 +118,7 @@ static Ref_t create_element(Detector& theDetector, xml_h element, Ref_t)  {
   for(int i=0;i<N_TPC_RINGS;i++)
     TPCEndplateServices.settpcEndplateServicesRing_R_ro(tpcEndplateServices_R[i],tpcEndplateServices_r[i]);
   
-  TPCEndplateServices.DoBuildTPCEndplateServices(pv,envelope_assembly);
+  if( buildCaloServices ) TPCEndplateServices.DoBuildTPCEndplateServices(pv,envelope_assembly);
  
 
 
@@ -178,7 +183,7 @@ static Ref_t create_element(Detector& theDetector, xml_h element, Ref_t)  {
 
   EcalBarrelServices.setenv_safety( theDetector.constant<double>("env_safety"));
 
-  EcalBarrelServices.DoBuildEcalBarrelServices(pv,envelope_assembly);
+  if( buildCaloServices ) EcalBarrelServices.DoBuildEcalBarrelServices(pv,envelope_assembly);
 
 
 
@@ -211,7 +216,7 @@ static Ref_t create_element(Detector& theDetector, xml_h element, Ref_t)  {
   EcalBarrel_EndCapServices.setZPlus_Cu_Thickness(ZPlus_Cu_Thickness);
   EcalBarrel_EndCapServices.setenv_safety( theDetector.constant<double>("env_safety"));
 
-  EcalBarrel_EndCapServices.DoBuildEcalBarrel_EndCapServices(pv,envelope_assembly);
+  if( buildCaloServices ) EcalBarrel_EndCapServices.DoBuildEcalBarrel_EndCapServices(pv,envelope_assembly);
 
 
 
@@ -256,7 +261,7 @@ static Ref_t create_element(Detector& theDetector, xml_h element, Ref_t)  {
   HcalBarrel_EndCapServices.setHcalServices_outer_Cu_thickness( theDetector.constant<double>("HcalServices_outer_Cu_thickness") );
   HcalBarrel_EndCapServices.setenv_safety( theDetector.constant<double>("env_safety"));
 
-  HcalBarrel_EndCapServices.DoBuildHcalBarrel_EndCapServices(pv,envelope_assembly);
+  if( buildCaloServices ) HcalBarrel_EndCapServices.DoBuildHcalBarrel_EndCapServices(pv,envelope_assembly);
 
 
 
@@ -979,6 +984,38 @@ dd4hep::Solid BuildHcalBarrel_EndCapServices::CutLayer(dd4hep::Solid &layerSolid
 }
 
 
+bool BuildHcalBarrel_EndCapServices::CutLayerPieces(double halfX, double halfY, double y_position,
+						    std::vector<lcgeo::Polygon2D> &pieces) {
+
+  // same cut boxes as in CutLayer
+  double tolerance = 2 * dd4hep::mm;
+  double halfWidth  = InnerServicesWidth/2. + tolerance;
+  double halfLength = Hcal_total_dim_y + 8*(SurfaceTolerance);
+
+  double xShift = (Hcal_bottom_dim_x + Hcal_total_dim_y * tan(M_PI/8.)) / 2.;
+  double yShift = Hcal_y_dim2_for_x/2. - y_position;
+
+  // box rotated by -pi/8 on the right, by +pi/8 on the left and the central box
+  std::vector<lcgeo::Strip2D> strips = {
+    {  xShift, yShift, cos(M_PI/8.), -sin(M_PI/8.), halfWidth },
+    { -xShift, yShift, cos(M_PI/8.),  sin(M_PI/8.), halfWidth },
+    {      0., yShift, 1., 0., halfWidth } };
+
+  // clockwise as needed for extruded solids
+  lcgeo::Polygon2D layer = { {-halfX,-halfY}, {-halfX,halfY}, {halfX,halfY}, {halfX,-halfY} };
+
+  // the boxes are longer than the layer in z - check that the layer does not reach their ends in x-y
+  for(const auto& s : strips)
+    for(const auto& p : layer)
+      if( std::fabs( -s.ny*(p.x-s.cx) + s.nx*(p.y-s.cy) ) >= halfLength )
+	return false;
+
+  pieces = lcgeo::subtractStrips(layer, strips, SurfaceTolerance*SurfaceTolerance);
+
+  return true;
+}
+
+
 bool BuildHcalBarrel_EndCapServices::DoBuildHcalBarrel_EndCapServices(dd4hep::PlacedVolume &pVol,
 								      dd4hep::Assembly &envelope) {
 
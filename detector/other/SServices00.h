@@ -4,6 +4,7 @@
 #include "DD4hep/DetFactoryHelper.h"
 #include "DD4hep/DD4hepUnits.h"
 #include "DD4hep/DetElement.h"
+#include "PolygonStrips.h"
 
 //=====================================
 // class for  BuildTPCEndplateServices
@@ -315,9 +316,41 @@ public:
 					      double layerThickness,
 					      double y_position, double layer_x_dim){
 
-    dd4hep::Box layerBox (layer_x_dim/2. - 4*(SurfaceTolerance),
-			  layerThickness/2. - 4*(SurfaceTolerance),
-			  Ecal_cables_gap/2. - 4*(SurfaceTolerance));
+    double halfX = layer_x_dim/2. - 4*(SurfaceTolerance);
+    double halfY = layerThickness/2. - 4*(SurfaceTolerance);
+    double halfZ = Ecal_cables_gap/2. - 4*(SurfaceTolerance);
+
+    dd4hep::RotationZYX rot(0,0,M_PI*0.5);
+    dd4hep::Position pos(0,0, y_position);
+    dd4hep::Transform3D tran3D(rot,pos);
+
+    std::vector<lcgeo::Polygon2D> pieces;
+
+    if( CutLayerPieces(halfX,halfY,y_position,pieces) ) {
+
+      // the cut layer as (up to four) extruded polygons instead of three nested subtractions
+      for(unsigned i=0; i<pieces.size(); i++) {
+
+	std::vector<double> px, py;
+	for(const auto& p : pieces[i]) {
+	  px.push_back(p.x);
+	  py.push_back(p.y);
+	}
+
+	dd4hep::ExtrudedPolygon pieceSolid(px, py, {-halfZ, halfZ}, {0., 0.}, {0., 0.}, {1., 1.});
+
+	dd4hep::Volume pieceLogical(dd4hep::_toString((int)i,"ElectronicsInterfaceLayerLogical_%d"),pieceSolid,
+				    layerMaterial);
+
+	pVol = ModuleLogicalZMinus.placeVolume(pieceLogical,tran3D);
+
+	pVol = ModuleLogicalZPlus.placeVolume(pieceLogical,tran3D);
+      }
+
+      return true;
+    }
+
+    dd4hep::Box layerBox (halfX, halfY, halfZ);
 
     dd4hep::Solid layerSolid(layerBox);
 
@@ -326,11 +359,6 @@ public:
     dd4hep::Volume layerLogical("ElectronicsInterfaceLayerLogical",cutSolid,
 				layerMaterial);
 
-
-    dd4hep::RotationZYX rot(0,0,M_PI*0.5);
-    dd4hep::Position pos(0,0, y_position);
-    dd4hep::Transform3D tran3D(rot,pos);
-
     pVol = ModuleLogicalZMinus.placeVolume(layerLogical,tran3D);
 
     pVol = ModuleLogicalZPlus.placeVolume(layerLogical,tran3D);
@@ -342,6 +370,10 @@ public:
 
   dd4hep::Solid CutLayer(dd4hep::Solid &layerSolid, double y_position) ;
 
+  /// the layer box of CutLayer minus the three cut boxes as convex polygons in the x-y plane of the layer,
+  /// returns false if the cut boxes are too short to be treated as infinite strips
+  bool CutLayerPieces(double halfX, double halfY, double y_position, std::vector<lcgeo::Polygon2D>& pieces) ;
+
 
 
   bool DoBuildHcalBarrel_EndCapServices(dd4hep::PlacedVolume &pVol,
@@ -8,6 +8,7 @@
 #include "DD4hep/DD4hepUnits.h"
 #include "DDRec/DetectorData.h"
 #include "XMLHandlerDB.h"
+#include "OtherDetectorHelpers.h"
 #include <cmath>
 #include <map>
 
@@ -23,7 +24,6 @@ using dd4hep::Material;
 using dd4hep::PlacedVolume;
 using dd4hep::Position;
 using dd4hep::Ref_t;
-using dd4hep::RotateY;
 using dd4hep::RotationY;
 using dd4hep::SensitiveDetector;
 using dd4hep::Solid;
@@ -34,32 +34,6 @@ using dd4hep::Volume;
 
 using dd4hep::rec::ConicalSupportData;
 
-namespace {
-  typedef enum { // These constants are also used in the MySQL database:
-    kCenter = 0, // centered on the z-axis
-    kUpstream = 1, // on the upstream branch, rotated by half the crossing angle
-    kDnstream = 2, // on the downstream branch, rotated by half the crossing angle
- 	
-    kPunchedCenter = 3, // centered, with one or two inner holes
-    kPunchedUpstream = 4, // on the upstream branch, with two inner holes
-    kPunchedDnstream = 5, // on the downstrem branch, with two inner holes
- 	
-    kUpstreamClippedFront = 6, // upstream, with the front face parallel to the xy-plane
-    kDnstreamClippedFront = 7, // downstream, with the front face parallel to the xy-plane
-    kUpstreamClippedRear = 8, // upstream, with the rear face parallel to the xy-plane
-    kDnstreamClippedRear = 9, // downstream, with the rear face parallel to the xy-plane
-    kUpstreamClippedBoth = 10, // upstream, with both faces parallel to the xy-plane
-    kDnstreamClippedBoth = 11, // downstream, with both faces parallel to the xy-plane
- 	
-    kUpstreamSlicedFront = 12, // upstream, with the front face parallel to a tilted piece
-    kDnstreamSlicedFront = 13, // downstream, with the front face parallel to a tilted piece
-    kUpstreamSlicedRear = 14, // upstream, with the rear face parallel to a tilted piece
-    kDnstreamSlicedRear = 15, // downstream, with the rear face parallel to a tilted piece
-    kUpstreamSlicedBoth = 16, // upstream, with both faces parallel to a tilted piece
-    kDnstreamSlicedBoth = 17 // downstream, with both faces parallel to a tilted piece
-  } ECrossType;
-}
-
 
 /** Construction of VTX detector, ported from Mokka driver TubeX01.cc
  *
@@ -109,7 +83,9 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector /*
   // G4VisAttributes *vacuumVisAttrib = new G4VisAttributes(G4Colour(0.0, 0.0, 0.5)); // dark blue
   // vacuumVisAttrib->SetVisibility(false); // there isn't anything, so what do you expect?
   
-  const double crossingAngle = theDetector.constant<double>("ILC_Main_Crossing_Angle") / 2 ; //  only half the angle
+  // frames of the incoming and outgoing beams, computed once for all sections
+  const ODH::CrossingFrames frames( theDetector.constant<double>("ILC_Main_Crossing_Angle") );
+  const double crossingAngle = frames.halfAngle() ; //  only half the angle
   
   // const String dbName = env.GetDBName() + "_" + env.GetParameterAsString("ILC_Main_Crossing_Angle");
   // Database *db = new Database(dbName.c_str());
@@ -166,7 +142,7 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector /*
     const double rOuterEndOffset   = (rOuterEndRef   == "") ? (0) : (referenceOffsets[rOuterEndRef]);
   
     // fields in the data tuple
-    const ECrossType crossType  = ECrossType(db->fetchInt("crossType")); // positioning of the volume
+    const ODH::ECrossType crossType  = ODH::ECrossType(db->fetchInt("crossType")); // positioning of the volume
     const double zStart       = db->fetchDouble("zStart")      + zStartOffset;
     const double zEnd         = db->fetchDouble("zEnd")        + zEndOffset;
     const double rInnerStart  = db->fetchDouble("rInnerStart") + rInnerStartOffset;
@@ -178,7 +154,7 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector /*
     
     
 
-    if( crossType == kCenter ) { // store only the central sections !
+    if( crossType == ODH::kCenter ) { // store only the central sections !
 
       ConicalSupportData::Section section ;
       section.rInner = rInnerStart ;
@@ -238,7 +214,7 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector /*
     Material wallMaterial    = theDetector.material(materialName);
 
     // this could mess up your geometry, so better check it
-    if (crossingAngle == 0 && crossType != kCenter) {
+    if (crossingAngle == 0 && crossType != ODH::kCenter) {
 
       std::cout << "TubeX01: You are trying to build a crossing geometry without a crossing angle.\n"
 	"This is probably not what you want - better check your geometry data!" << std::endl ;
@@ -246,45 +222,20 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector /*
       return 0 ;//false; // premature exit, Mokka will abort now
     }
 
-    double tmpAngle;
-    switch (crossType) {
-    case kUpstream:
-    case kPunchedUpstream:
-    case kUpstreamClippedFront:
-    case kUpstreamClippedRear:
-    case kUpstreamClippedBoth:
-    case kUpstreamSlicedFront:
-    case kUpstreamSlicedRear:
-    case kUpstreamSlicedBoth:
-      tmpAngle = -crossingAngle; break;
-    case kDnstream:
-    case kPunchedDnstream:
-    case kDnstreamClippedFront:
-    case kDnstreamClippedRear:
-    case kDnstreamClippedBoth:
-    case kDnstreamSlicedFront:
-    case kDnstreamSlicedRear:
-    case kDnstreamSlicedBoth:
-      tmpAngle = +crossingAngle; break;
-    default:
-      tmpAngle = 0; break;
-    }
-    const double rotateAngle = tmpAngle; // for the placement at +z (better make it const now)
-    const double mirrorAngle = M_PI - rotateAngle; // for the "mirrored" placement at -z
-    // const double mirrorAngle = 180 * deg - rotateAngle; // for the "mirrored" placement at -z
-    // the "mirroring" in fact is done by a rotation of (almost) 180 degrees around the y-axis
+    const double rotateAngle = frames.angle(crossType); // for the placement at +z (better make it const now)
+    // the "mirroring" at -z in fact is done by a rotation of (almost) 180 degrees around the y-axis
 
     
     
     switch (crossType) {
-    case kCenter:
-    case kUpstream:
-    case kDnstream: {
+    case ODH::kCenter:
+    case ODH::kUpstream:
+    case ODH::kDnstream: {
       // a volume on the z-axis, on the upstream branch, or on the downstream branch
       
       // absolute transformations for the placement in the world
-      Transform3D transformer(RotationY(rotateAngle), RotateY( Position(0, 0, zPosition), rotateAngle) );
-      Transform3D transmirror(RotationY(mirrorAngle), RotateY( Position(0, 0, zPosition), mirrorAngle) );
+      Transform3D transformer( frames.placement(crossType, zPosition) );
+      Transform3D transmirror( frames.mirrorPlacement(crossType, zPosition) );
       
 
       // solid for the tube (including vacuum and wall): a solid cone
@@ -320,7 +271,7 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector /*
     }  
       break;
       
-    case kPunchedCenter: {
+    case ODH::kPunchedCenter: {
       // a volume on the z-axis with one or two inner holes
       // (implemented as a cone from which tubes are punched out)
       
@@ -328,12 +279,12 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector /*
       const double rDnstreamPunch = rInnerEnd; // (the database entries are "abused" in this case)
       
       // relative transformations for the composition of the SubtractionVolumes
-      Transform3D upstreamTransformer(RotationY(-crossingAngle), Position(zPosition * tan(-crossingAngle), 0, 0));
-      Transform3D dnstreamTransformer(RotationY(+crossingAngle), Position(zPosition * tan(+crossingAngle), 0, 0));
+      Transform3D upstreamTransformer( frames.beamLine(ODH::kUpstream, zPosition) );
+      Transform3D dnstreamTransformer( frames.beamLine(ODH::kDnstream, zPosition) );
   
       // absolute transformations for the final placement in the world (angles always equal zero and 180 deg)
-      Transform3D placementTransformer(RotationY(rotateAngle), RotateY( Position(0, 0, zPosition) , rotateAngle) );
-      Transform3D placementTransmirror(RotationY(mirrorAngle), RotateY( Position(0, 0, zPosition) , mirrorAngle) );
+      Transform3D placementTransformer( frames.placement(crossType, zPosition) );
+      Transform3D placementTransmirror( frames.mirrorPlacement(crossType, zPosition) );
   
       // solid for the tube (including vacuum and wall): a solid cone
       ConeSegment tubeSolid( zHalf, 0, rOuterStart, 0, rOuterEnd, phi1, phi2);
@@ -407,21 +358,21 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector /*
     }
 
 
-    case kPunchedUpstream:
-    case kPunchedDnstream: {
+    case ODH::kPunchedUpstream:
+    case ODH::kPunchedDnstream: {
       // a volume on the upstream or downstream branch with two inner holes
       // (implemented as a cone from which another tube is punched out)
       
-      const double rCenterPunch = (crossType == kPunchedUpstream) ? (rInnerStart) : (rInnerEnd); // just alias names denoting what is meant here
-      const double rOffsetPunch = (crossType == kPunchedDnstream) ? (rInnerStart) : (rInnerEnd); // (the database entries are "abused" in this case)
+      const double rCenterPunch = (crossType == ODH::kPunchedUpstream) ? (rInnerStart) : (rInnerEnd); // just alias names denoting what is meant here
+      const double rOffsetPunch = (crossType == ODH::kPunchedDnstream) ? (rInnerStart) : (rInnerEnd); // (the database entries are "abused" in this case)
       
       // relative transformations for the composition of the SubtractionVolumes
-      Transform3D punchTransformer(RotationY(-2 * rotateAngle), Position(zPosition * tan(-2 * rotateAngle), 0, 0));
-      Transform3D punchTransmirror(RotationY(+2 * rotateAngle), Position(zPosition * tan(+2 * rotateAngle), 0, 0));
+      Transform3D punchTransformer( frames.otherBeamLine(crossType, zPosition) );
+      Transform3D punchTransmirror( frames.mirrorOtherBeamLine(crossType, zPosition) );
       
       // absolute transformations for the final placement in the world
-      Transform3D placementTransformer(RotationY(rotateAngle), RotateY( Position(0, 0, zPosition) , rotateAngle) );
-      Transform3D placementTransmirror(RotationY(mirrorAngle), RotateY( Position(0, 0, zPosition) , mirrorAngle) );
+      Transform3D placementTransformer( frames.placement(crossType, zPosition) );
+      Transform3D placementTransmirror( frames.mirrorPlacement(crossType, zPosition) );
       
       // solid for the tube (including vacuum and wall): a solid cone
       ConeSegment tubeSolid( zHalf, 0, rOuterStart, 0, rOuterEnd, phi1, phi2);
@@ -472,10 +423,10 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector /*
       break;
     }
       
-      case kUpstreamClippedFront:
-      case kDnstreamClippedFront:
-      case kUpstreamSlicedFront:
-      case kDnstreamSlicedFront: {
+      case ODH::kUpstreamClippedFront:
+      case ODH::kDnstreamClippedFront:
+      case ODH::kUpstreamSlicedFront:
+      case ODH::kDnstreamSlicedFront: {
         // a volume on the upstream or donwstream branch, but with the front face parallel to the xy-plane
         // or to a piece tilted in the other direction ("sliced" like a salami with 2 * rotateAngle)
         // (implemented as a slightly longer cone from which the end is clipped off)
@@ -485,14 +436,14 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector /*
         Tube clipSolid( 0, 2 * clipSize, clipSize, phi1, phi2); // should be large enough
         
         // relative transformations for the composition of the SubtractionVolumes
-        const double clipAngle = (crossType == kUpstreamClippedFront || crossType == kDnstreamClippedFront) ? (rotateAngle) : (2 * rotateAngle);
+        const double clipAngle = (crossType == ODH::kUpstreamClippedFront || crossType == ODH::kDnstreamClippedFront) ? (rotateAngle) : (2 * rotateAngle);
         const double clipShift = (zStart - clipSize) / cos(clipAngle) - (zPosition - clipSize / 2); // question: why is this correct?
         Transform3D clipTransformer(RotationY(-clipAngle), Position(0, 0, clipShift));
         Transform3D clipTransmirror(RotationY(+clipAngle), Position(0, 0, clipShift));
   
         // absolute transformations for the final placement in the world
-        Transform3D placementTransformer(RotationY(rotateAngle), RotateY( Position(0, 0, zPosition - clipSize / 2) , rotateAngle) );
-        Transform3D placementTransmirror(RotationY(mirrorAngle), RotateY( Position(0, 0, zPosition - clipSize / 2) , mirrorAngle) );
+        Transform3D placementTransformer( frames.placement(crossType, zPosition - clipSize / 2) );
+        Transform3D placementTransmirror( frames.mirrorPlacement(crossType, zPosition - clipSize / 2) );
   
         // solid for the tube (including vacuum and wall): a solid cone
 
@@ -542,10 +493,10 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector /*
         break;
       }
 	
-    case kUpstreamClippedRear:
-    case kDnstreamClippedRear:
-    case kUpstreamSlicedRear:
-    case kDnstreamSlicedRear: {
+    case ODH::kUpstreamClippedRear:
+    case ODH::kDnstreamClippedRear:
+    case ODH::kUpstreamSlicedRear:
+    case ODH::kDnstreamSlicedRear: {
       // a volume on the upstream or donwstream branch, but with the rear face parallel to the xy-plane
       // or to a piece tilted in the other direction ("sliced" like a salami with 2 * rotateAngle)
       // (implemented as a slightly longer cone from which the end is clipped off)
@@ -555,14 +506,14 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector /*
       Tube clipSolid( 0, 2 * clipSize, clipSize, phi1, phi2); // should be large enough
       
       // relative transformations for the composition of the SubtractionVolumes
-      const double clipAngle = (crossType == kUpstreamClippedRear || crossType == kDnstreamClippedRear) ? (rotateAngle) : (2 * rotateAngle);
+      const double clipAngle = (crossType == ODH::kUpstreamClippedRear || crossType == ODH::kDnstreamClippedRear) ? (rotateAngle) : (2 * rotateAngle);
       const double clipShift = (zEnd + clipSize) / cos(clipAngle) - (zPosition + clipSize / 2); // question: why is this correct?
       Transform3D clipTransformer(RotationY(-clipAngle), Position(0, 0, clipShift));
       Transform3D clipTransmirror(RotationY(+clipAngle), Position(0, 0, clipShift));
       
       // absolute transformations for the final placement in the world
-      Transform3D placementTransformer(RotationY(rotateAngle), RotateY( Position(0, 0, zPosition + clipSize / 2) , rotateAngle) );
-      Transform3D placementTransmirror(RotationY(mirrorAngle), RotateY( Position(0, 0, zPosition + clipSize / 2) , mirrorAngle) );
+      Transform3D placementTransformer( frames.placement(crossType, zPosition + clipSize / 2) );
+      Transform3D placementTransmirror( frames.mirrorPlacement(crossType, zPosition + clipSize / 2) );
       
       // solid for the tube (including vacuum and wall): a solid cone
       ConeSegment wholeSolid( 0, rOuterStart, 0, rOuterEnd, zHalf + clipSize / 2, phi1, phi2); // a bit longer
@@ -611,10 +562,10 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector /*
       break;
     }
 
-    case kUpstreamClippedBoth:
-    case kDnstreamClippedBoth:
-    case kUpstreamSlicedBoth:
-    case kDnstreamSlicedBoth: {
+    case ODH::kUpstreamClippedBoth:
+    case ODH::kDnstreamClippedBoth:
+    case ODH::kUpstreamSlicedBoth:
+    case ODH::kDnstreamSlicedBoth: {
       // a volume on the upstream or donwstream branch, but with both faces parallel to the xy-plane
       // or to a piece tilted in the other direction ("sliced" like a salami with 2 * rotateAngle)
       // (implemented as a slightly longer cone from which the end is clipped off)
@@ -624,7 +575,7 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector /*
       Tube clipSolid( 0, 2 * clipSize, clipSize, phi1, phi2); // should be large enough
         
       // relative transformations for the composition of the SubtractionVolumes
-      const double clipAngle = (crossType == kUpstreamClippedBoth || crossType == kDnstreamClippedBoth) ? (rotateAngle) : (2 * rotateAngle);
+      const double clipAngle = (crossType == ODH::kUpstreamClippedBoth || crossType == ODH::kDnstreamClippedBoth) ? (rotateAngle) : (2 * rotateAngle);
       const double clipShiftFrnt = (zStart - clipSize) / cos(clipAngle) - zPosition;
       const double clipShiftRear = (zEnd   + clipSize) / cos(clipAngle) - zPosition;
       Transform3D clipTransformerFrnt(RotationY(-clipAngle), Position(0, 0, clipShiftFrnt));
@@ -633,8 +584,8 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector /*
       Transform3D clipTransmirrorRear(RotationY(+clipAngle), Position(0, 0, clipShiftRear));
   
       // absolute transformations for the final placement in the world
-      Transform3D placementTransformer(RotationY(rotateAngle), RotateY( Position(0, 0, zPosition) , rotateAngle) );
-      Transform3D placementTransmirror(RotationY(mirrorAngle), RotateY( Position(0, 0, zPosition) , mirrorAngle) );
+      Transform3D placementTransformer( frames.placement(crossType, zPosition) );
+      Transform3D placementTransmirror( frames.mirrorPlacement(crossType, zPosition) );
       
       // solid for the tube (including vacuum and wall): a solid cone
       ConeSegment wholeSolid( 0, rOuterStart, 0, rOuterEnd, zHalf + clipSize, phi1, phi2); // a bit longer
@@ -21,6 +21,7 @@
 #include "XML/Utilities.h"
 #include <map>
 #include "DDRec/DetectorData.h"
+#include "NeighbourTable.h"
 #include "XML/DocumentHandler.h"
 #include <UTIL/BitField64.h>
 #include <UTIL/BitSet32.h>
@@ -256,6 +257,7 @@ static Ref_t create_detector(Detector& theDetector,xml_h e,SensitiveDetector sen
   sdet.addExtension<dd4hep::rec::ZDiskPetalsData>(zDiskPetalsData);
   //added extension 
   sdet.addExtension<dd4hep::rec::NeighbourSurfacesData>(neighbourSurfacesData);
+  sdet.addExtension<lcgeo::NeighbourTable>(new lcgeo::NeighbourTable(neighbourSurfacesData->sameLayer));
   std::cout<<"XXX Tracker endcap layers:"<<zDiskPetalsData->layers.size()<<std::endl;
   
   return sdet;
@@ -8,6 +8,7 @@
 #include "DD4hep/DD4hepUnits.h"
 #include "DD4hep/DetType.h"
 #include "LcgeoExceptions.h"
+#include "NavigationHints.h"
 #include "lcgeo.h"
 #include "DDRec/Surface.h"
 #include "DDRec/DetectorData.h"
@@ -89,7 +90,8 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector se
   // Geometry parameters from the geometry environment and from the database
   // Database *db = new Database(env.GetDBName());
     
-  XMLHandlerDB db(  x_det.child( _Unicode( global ) ) );
+  xml_comp_t x_global = x_det.child( _Unicode( global ) ) ;
+  XMLHandlerDB db(  x_global );
     
   const double TPCMaxStepLength    = db->fetchDouble("TPC_max_step_length") ;
   const double padHeight           = db->fetchDouble("TPC_pad_height") ;
@@ -100,6 +102,7 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector se
   const double dr_OuterWall        = db->fetchDouble("dr_OuterWall") ;
   const double dz_Readout          = db->fetchDouble("dz_Readout") ;
   const double dz_Endplate         = db->fetchDouble("dz_Endplate") ;
+  const bool padRowDoublets        = ( db->hasParameter("TPC_pad_row_doublets") ? db->fetchBool("TPC_pad_row_doublets") : true ) ;
 
   //    Material* const material_TPC_Gas = CGAGeometryManager::GetMaterial(db->fetchString("chamber_Gas"));
   Material material_TPC_Gas =  theDetector.material(db->fetchString("chamber_Gas") ) ;
@@ -411,6 +414,11 @@ Material endplate_MaterialMix = theDetector.material( "TPC_endplate_mix" ) ;
 
   Volume sensitiveGasLog( "TPCSensitiveLog", senstiveGasSolid, material_TPC_Gas );
 
+  // Geant4 navigation hints from the compact file for the gas volume with the pad rows
+  lcgeo::NavigationHints* navigationHints = new lcgeo::NavigationHints( x_det ) ;
+  navigationHints->tag( "gas", sensitiveGasLog ) ;
+  tpc.addExtension< lcgeo::NavigationHints >( navigationHints ) ;
+
   //  sensitiveGasLog->SetVisAttributes(VisAttributes::Invisible);
 
   // new PVPlacement(Transform3D(RotationMatrix().rotateY(   0 * deg), ThreeVector(0, 0, +( dz_Cathode/2.0 + dz_Sensitive/2.0 ) )), sensitiveGasLog, "TPCSensitiveLog_+z", motherLog, false, 0);
@@ -433,81 +441,82 @@ Material endplate_MaterialMix = theDetector.material( "TPC_endplate_mix" ) ;
 
   //---------------------------------------------------- Pad row doublets -------------------------------------------------------------------------------//
 
+  // by default every pad row is built from two half-rings (sensor 1: lower, sensor 0: upper half) so that
+  // Geant4 is forced to stop at the pad-row centre; with TPC_pad_row_doublets="false" only one ring volume
+  // per pad row is created, halving the number of solids, volumes and placements in the gas volume
+
+  cout << "TPC10: Building " << ( padRowDoublets ? 2 * numberPadRows : numberPadRows ) << " pad row volumes "
+       << ( padRowDoublets ? "(two half-rings per pad row)" : "(one ring per pad row)" ) << endl;
+
   for (int layer = 0; layer < numberPadRows; layer++) {
+
+    DetElement   layerDEfwd( sensGasDEfwd ,   _toString( layer, "tpc_row_fwd_%03d") , x_det.id() );
+    DetElement   layerDEbwd( sensGasDEbwd ,   _toString( layer, "tpc_row_bwd_%03d") , x_det.id() );
+
+    if( padRowDoublets ) {
+      // create twice the number of rings as there are pads, producing an lower and upper part of the pad with the boundry between them the pad-ring centre
     
-#if 1
-    // create twice the number of rings as there are pads, producing an lower and upper part of the pad with the boundry between them the pad-ring centre
-    
-    const double inner_lowerlayer_radius = rMin_Sensitive + (layer * (padHeight));
-    const double outer_lowerlayer_radius = inner_lowerlayer_radius + (padHeight/2.0);
+      const double inner_lowerlayer_radius = rMin_Sensitive + (layer * (padHeight));
+      const double outer_lowerlayer_radius = inner_lowerlayer_radius + (padHeight/2.0);
     
-    const double inner_upperlayer_radius = outer_lowerlayer_radius ;
-    const double outer_upperlayer_radius = inner_upperlayer_radius + (padHeight/2.0);
+      const double inner_upperlayer_radius = outer_lowerlayer_radius ;
+      const double outer_upperlayer_radius = inner_upperlayer_radius + (padHeight/2.0);
     
-    Tube lowerlayerSolid( inner_lowerlayer_radius, outer_lowerlayer_radius, dz_Sensitive / 2.0, phi1, phi2);
-    Tube upperlayerSolid( inner_upperlayer_radius, outer_upperlayer_radius, dz_Sensitive / 2.0, phi1, phi2);
+      Tube lowerlayerSolid( inner_lowerlayer_radius, outer_lowerlayer_radius, dz_Sensitive / 2.0, phi1, phi2);
+      Tube upperlayerSolid( inner_upperlayer_radius, outer_upperlayer_radius, dz_Sensitive / 2.0, phi1, phi2);
 
-    //fixme: layerstring
-    Volume lowerlayerLog( _toString( layer ,"TPC_lowerlayer_log_%02d") ,lowerlayerSolid, material_TPC_Gas );
-    Volume upperlayerLog( _toString( layer ,"TPC_upperlayer_log_%02d") ,upperlayerSolid, material_TPC_Gas );
+      //fixme: layerstring
+      Volume lowerlayerLog( _toString( layer ,"TPC_lowerlayer_log_%02d") ,lowerlayerSolid, material_TPC_Gas );
+      Volume upperlayerLog( _toString( layer ,"TPC_upperlayer_log_%02d") ,upperlayerSolid, material_TPC_Gas );
 
-    tpc.setVisAttributes(theDetector,  "Invisible" ,  lowerlayerLog) ;
-    tpc.setVisAttributes(theDetector,  "Invisible" ,  upperlayerLog) ;
+      tpc.setVisAttributes(theDetector,  "Invisible" ,  lowerlayerLog) ;
+      tpc.setVisAttributes(theDetector,  "Invisible" ,  upperlayerLog) ;
     
+      Vector3D o(  inner_upperlayer_radius + 1e-10  , 0. , 0. ) ;
+      // create an unbounded surface (i.e. an infinite cylinder) and assign it to the forward gaseous volume only
+      VolCylinder surf( upperlayerLog , SurfaceType(SurfaceType::Sensitive, SurfaceType::Invisible, SurfaceType::Unbounded ) ,  (padHeight/2.0) ,  (padHeight/2.0) ,o ) ;
 
-    DetElement   layerDEfwd( sensGasDEfwd ,   _toString( layer, "tpc_row_fwd_%03d") , x_det.id() );
-    DetElement   layerDEbwd( sensGasDEbwd ,   _toString( layer, "tpc_row_bwd_%03d") , x_det.id() );
- 
-    Vector3D o(  inner_upperlayer_radius + 1e-10  , 0. , 0. ) ;
-    // create an unbounded surface (i.e. an infinite cylinder) and assign it to the forward gaseous volume only
-    VolCylinder surf( upperlayerLog , SurfaceType(SurfaceType::Sensitive, SurfaceType::Invisible, SurfaceType::Unbounded ) ,  (padHeight/2.0) ,  (padHeight/2.0) ,o ) ;
+      volSurfaceList( layerDEfwd )->push_back( surf ) ;
+      //    volSurfaceList( layerDEbwd )->push_back( surf ) ;
 
-    volSurfaceList( layerDEfwd )->push_back( surf ) ;
-//    volSurfaceList( layerDEbwd )->push_back( surf ) ;
 
+      pv = sensitiveGasLog.placeVolume( lowerlayerLog ) ;
+      pv.addPhysVolID("layer", layer ).addPhysVolID( "module", 0 ).addPhysVolID("sensor", 1 ) ;
 
-    pv = sensitiveGasLog.placeVolume( lowerlayerLog ) ;
-    pv.addPhysVolID("layer", layer ).addPhysVolID( "module", 0 ).addPhysVolID("sensor", 1 ) ;
+      pv = sensitiveGasLog.placeVolume( upperlayerLog ) ;
+      pv.addPhysVolID("layer", layer ).addPhysVolID( "module", 0 ).addPhysVolID("sensor", 0 ) ;
+      layerDEfwd.setPlacement( pv ) ;
+      layerDEbwd.setPlacement( pv ) ;
 
-    pv = sensitiveGasLog.placeVolume( upperlayerLog ) ;
-    pv.addPhysVolID("layer", layer ).addPhysVolID( "module", 0 ).addPhysVolID("sensor", 0 ) ;
-    layerDEfwd.setPlacement( pv ) ;
-    layerDEbwd.setPlacement( pv ) ;
+      lowerlayerLog.setSensitiveDetector(sens);
+      upperlayerLog.setSensitiveDetector(sens);
 
-    lowerlayerLog.setSensitiveDetector(sens);
-    upperlayerLog.setSensitiveDetector(sens);
-
-#else
-    // create just one volume per pad ring
+    } else {
+      // create just one volume per pad ring - the surface sits at the pad-ring centre as for the doublets
     
-    const double inner_radius = rMin_Sensitive + (layer * (padHeight) );
-    const double outer_radius = inner_radius +  padHeight ;
+      const double inner_radius = rMin_Sensitive + (layer * (padHeight) );
+      const double outer_radius = inner_radius +  padHeight ;
     
-    Tube layerSolid( inner_radius, outer_radius, dz_Sensitive / 2.0, phi1, phi2);
+      Tube layerSolid( inner_radius, outer_radius, dz_Sensitive / 2.0, phi1, phi2);
 
-    Volume layerLog( _toString( layer ,"TPC_layer_log_%02d") , layerSolid, material_TPC_Gas );
+      Volume layerLog( _toString( layer ,"TPC_layer_log_%02d") , layerSolid, material_TPC_Gas );
 
-    tpc.setVisAttributes(theDetector,  "Invisible" ,  layerLog) ;
+      tpc.setVisAttributes(theDetector,  "Invisible" ,  layerLog) ;
     
-    DetElement   layerDEfwd( sensGasDEfwd ,   _toString( layer, "tpc_row_fwd_%03d") , x_det.id() );
-    DetElement   layerDEbwd( sensGasDEbwd ,   _toString( layer, "tpc_row_bwd_%03d") , x_det.id() );
- 
-    Vector3D o(  inner_radius + (padHeight/2.0)  , 0. , 0. ) ;
+      Vector3D o(  inner_radius + (padHeight/2.0)  , 0. , 0. ) ;
 
-    VolCylinder surf( layerLog , SurfaceType(SurfaceType::Sensitive, SurfaceType::Invisible ) ,  (padHeight/2.0) ,  (padHeight/2.0) ,o ) ;
+      VolCylinder surf( layerLog , SurfaceType(SurfaceType::Sensitive, SurfaceType::Invisible, SurfaceType::Unbounded ) ,  (padHeight/2.0) ,  (padHeight/2.0) ,o ) ;
 
-    volSurfaceList( layerDEfwd )->push_back( surf ) ;
-    volSurfaceList( layerDEbwd )->push_back( surf ) ;
+      volSurfaceList( layerDEfwd )->push_back( surf ) ;
 
-    pv = sensitiveGasLog.placeVolume( layerLog ) ;
-    pv.addPhysVolID("layer", layer  ).addPhysVolID( "module", 0 ) ;
+      pv = sensitiveGasLog.placeVolume( layerLog ) ;
+      pv.addPhysVolID("layer", layer  ).addPhysVolID( "module", 0 ).addPhysVolID("sensor", 0 ) ;
 
-    layerDEfwd.setPlacement( pv ) ;
-    layerDEbwd.setPlacement( pv ) ;
+      layerDEfwd.setPlacement( pv ) ;
+      layerDEbwd.setPlacement( pv ) ;
 
-    layerLog.setSensitiveDetector(sens);
-
-#endif
+      layerLog.setSensitiveDetector(sens);
+    }
   }
 
   // Assembly of the TPC Readout
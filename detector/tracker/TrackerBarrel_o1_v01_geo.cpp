@@ -9,6 +9,7 @@
 #include "DD4hep/Printout.h"
 #include "XML/Utilities.h"
 #include "DDRec/DetectorData.h"
+#include "PhiSymmetricArray.h"
 
 using namespace std;
 
@@ -119,6 +120,8 @@ static Ref_t create_detector(Detector& theDetector, xml_h e, SensitiveDetector s
         
         double     phi_incr = (M_PI * 2) / nphi;            // Phi increment for one sensor.
         double     phic     = phi0;                         // Phi of the sensor center.
+        // rotations of the modules in phi, shared by all sensors of a module along z
+        const lcgeo::PhiSymmetricArray modules( nphi, phi_incr, phi0, [phi_tilt]( double phi ){ return RotationZYX(0,((M_PI/2)-phi-phi_tilt),-M_PI/2) ; } ) ;
         double     z0       = z_layout.z0();                // Z position of first sensor in phi.
         double     nz       = z_layout.nz();                // Number of sensors to place in z.
         double     z_dr     = z_layout.dr();                // Radial displacement parameter, of every other sensor.
@@ -161,7 +164,7 @@ static Ref_t create_detector(Detector& theDetector, xml_h e, SensitiveDetector s
                 // Module PhysicalVolume.
                 //         Transform3D tr(RotationZYX(0,-((M_PI/2)-phic-phi_tilt),M_PI/2),Position(x,y,sensor_z));
                 //NOTE (Nikiforos, 26/08 Rotations needed to be fixed so that component1 (silicon) is on the outside
-                Transform3D tr(RotationZYX(0,((M_PI/2)-phic-phi_tilt),-M_PI/2),Position(x,y,sensor_z));
+                Transform3D tr(modules.rotation(ii),Position(x,y,sensor_z));
                 
                 //FIXME
                 pv = lay_vol.placeVolume(m_env,tr);
@@ -12,6 +12,8 @@
 #include "DD4hep/Printout.h"
 #include "XML/Utilities.h"
 #include "DDRec/DetectorData.h"
+#include "PhiSymmetricArray.h"
+#include "NeighbourTable.h"
 
 #include <UTIL/BitField64.h>
 #include <UTIL/BitSet32.h>
@@ -137,6 +139,8 @@ static Ref_t create_detector(Detector& theDetector, xml_h e, SensitiveDetector s
         
         double     phi_incr = (M_PI * 2) / nphi;            // Phi increment for one sensor.
         double     phic     = phi0;                         // Phi of the sensor center.
+        // rotations of the modules in phi, shared by all sensors of a module along z
+        const lcgeo::PhiSymmetricArray modules( nphi, phi_incr, phi0, [phi_tilt]( double phi ){ return RotationZYX(0,((M_PI/2)-phi-phi_tilt),-M_PI/2) ; } ) ;
         double     z0       = z_layout.z0();                // Z position of first sensor in phi.
         double     nz       = z_layout.nz();                // Number of sensors to place in z.
         double     z_dr     = z_layout.dr();                // Radial displacement parameter, of every other sensor.
@@ -223,7 +227,7 @@ static Ref_t create_detector(Detector& theDetector, xml_h e, SensitiveDetector s
                 
                 DetElement sens_elt(lay_elt,sensor_name,sensor_idx);
                 // Module PhysicalVolume.
-                Transform3D tr(RotationZYX(0,((M_PI/2)-phic-phi_tilt),-M_PI/2),Position(x,y,sensor_z));
+                Transform3D tr(modules.rotation(ii),Position(x,y,sensor_z));
                 
                 //FIXME
                 pv = lay_vol.placeVolume(m_env,tr);
@@ -300,6 +304,7 @@ static Ref_t create_detector(Detector& theDetector, xml_h e, SensitiveDetector s
     sdet.setAttributes(theDetector,envelope,x_det.regionStr(),x_det.limitsStr(),x_det.visStr());
     sdet.addExtension< ZPlanarData >( zPlanarData ) ;
     sdet.addExtension< NeighbourSurfacesData >( neighbourSurfacesData ) ;
+    sdet.addExtension< lcgeo::NeighbourTable >( new lcgeo::NeighbourTable( neighbourSurfacesData->sameLayer ) ) ;
     
     //envelope.setVisAttributes(theDetector.invisible());
     /*pv = theDetector.pickMotherVolume(sdet).placeVolume(assembly);
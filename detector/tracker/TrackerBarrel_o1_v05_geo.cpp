@@ -15,6 +15,9 @@
 #include "XML/Utilities.h"
 #include "XML/DocumentHandler.h"
 #include "DDRec/DetectorData.h"
+#include "PhiSymmetricArray.h"
+#include "NeighbourTable.h"
+#include "SensorLayout.h"
 
 #include <UTIL/BitField64.h>
 #include <UTIL/BitSet32.h>
@@ -74,6 +77,7 @@ static Ref_t create_detector(Detector& theDetector, xml_h e, SensitiveDetector s
     //-----------------------------------------------------------------------------------
     ZPlanarData*  zPlanarData = new ZPlanarData() ;
     NeighbourSurfacesData*  neighbourSurfacesData = new NeighbourSurfacesData() ;
+    lcgeo::SensorLayout*  sensorLayout = new lcgeo::SensorLayout( lcgeo::SensorLayout::Barrel, cellIDEncoding ) ;
     
     sens.setType("tracker");
     
@@ -152,6 +156,8 @@ static Ref_t create_detector(Detector& theDetector, xml_h e, SensitiveDetector s
         
         double     phi_incr = (M_PI * 2) / nphi;            // Phi increment for one sensor.
         double     phic     = phi0;                         // Phi of the sensor center.
+        // rotations of the modules in phi, shared by all sensors of a module along z
+        const lcgeo::PhiSymmetricArray modules( nphi, phi_incr, phi0, [phi_tilt]( double phi ){ return RotationZYX(0,((M_PI/2)-phi-phi_tilt),-M_PI/2) ; } ) ;
         double     z0       = z_layout.z0();                // Z position of first sensor in phi.
         double     nz       = z_layout.nz();                // Number of sensors to place in z.
         double     z_dr     = z_layout.dr();                // Radial displacement parameter, of every other sensor.
@@ -170,6 +176,21 @@ static Ref_t create_detector(Detector& theDetector, xml_h e, SensitiveDetector s
         
         ZPlanarData::LayerLayout thisLayer ;
         
+        // the analytic layout of the sensors of this layer, as placed below
+        lcgeo::SensorLayout::Ring sensorRing ;
+        sensorRing.nphi    = nphi ;
+        sensorRing.phi0    = phi0 ;
+        sensorRing.dphi    = phi_incr ;
+        sensorRing.r       = rc ;
+        sensorRing.dr      = rphi_dr ;
+        sensorRing.phiTilt = phi_tilt ;
+        sensorRing.nz      = int(nz) ;
+        sensorRing.z0      = -z0 ;
+        sensorRing.dz      = z_incr ;
+        sensorRing.zdr     = z_dr ;
+        sensorRing.sensitiveZ = waferVols.empty() ? 0. : waferVols[0]->GetMatrix()->GetTranslation()[2] ;
+        sensorLayout->addRing( lay_id, 0, sensorRing ) ;
+        
        
         // Loop over the number of sensors in phi.
         for (int ii = 0; ii < nphi; ii++)        {
@@ -238,7 +259,7 @@ static Ref_t create_detector(Detector& theDetector, xml_h e, SensitiveDetector s
                 
                 DetElement sens_elt(lay_elt,sensor_name,sensor_idx);
                 // Module PhysicalVolume.
-                Transform3D tr(RotationZYX(0,((M_PI/2)-phic-phi_tilt),-M_PI/2),Position(x,y,sensor_z));
+                Transform3D tr(modules.rotation(ii),Position(x,y,sensor_z));
                 
                 //FIXME
                 pv = lay_vol.placeVolume(m_env,tr);
@@ -315,6 +336,8 @@ static Ref_t create_detector(Detector& theDetector, xml_h e, SensitiveDetector s
     sdet.setAttributes(theDetector,envelope,x_det.regionStr(),x_det.limitsStr(),x_det.visStr());
     sdet.addExtension< ZPlanarData >( zPlanarData ) ;
     sdet.addExtension< NeighbourSurfacesData >( neighbourSurfacesData ) ;
+    sdet.addExtension< lcgeo::NeighbourTable >( new lcgeo::NeighbourTable( neighbourSurfacesData->sameLayer ) ) ;
+    sdet.addExtension< lcgeo::SensorLayout >( sensorLayout ) ;
     
     //envelope.setVisAttributes(theDetector.invisible());
     /*pv = theDetector.pickMotherVolume(sdet).placeVolume(assembly);
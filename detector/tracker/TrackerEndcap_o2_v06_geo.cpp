@@ -28,6 +28,8 @@
 #include "XML/DocumentHandler.h"
 #include <map>
 #include "DDRec/DetectorData.h"
+#include "NeighbourTable.h"
+#include "SensorLayout.h"
 
 #include <UTIL/BitField64.h>
 #include <UTIL/BitSet32.h>
@@ -91,6 +93,7 @@ static Ref_t create_detector(Detector& theDetector, xml_h e, SensitiveDetector s
     
     ZDiskPetalsData*  zDiskPetalsData = new ZDiskPetalsData ;
     NeighbourSurfacesData*  neighbourSurfacesData = new NeighbourSurfacesData() ;
+    lcgeo::SensorLayout*  sensorLayout = new lcgeo::SensorLayout( lcgeo::SensorLayout::Endcap, cellIDEncoding, reflect ) ;
     std::map< std::string, double > moduleSensThickness;
     
     
@@ -193,6 +196,17 @@ static Ref_t create_detector(Detector& theDetector, xml_h e, SensitiveDetector s
             
             r=r+mod_shape->GetDY();
             
+            // the analytic layout of the sensors of this ring, as placed below
+            lcgeo::SensorLayout::Ring sensorRing ;
+            sensorRing.nphi = nmodules ;
+            sensorRing.phi0 = phi0 ;
+            sensorRing.dphi = iphi ;
+            sensorRing.r    = r ;
+            sensorRing.z0   = zstart ;
+            sensorRing.dz   = dz ;
+            sensorRing.sensitiveZ = sensVols.empty() ? 0. : sensVols[0]->GetMatrix()->GetTranslation()[2] ;
+            sensorLayout->addRing( l_id, mod_num, sensorRing ) ;
+            
             //NOTE: As in the barrel, what we call "module" in the xml is like a single trapezoidal wafer
             //For reasons of bit conservation in the encoding and to be more similar to the ILD geometry
             //A module has to be something that consists of many "sensors" (wafers) 
@@ -319,6 +333,8 @@ static Ref_t create_detector(Detector& theDetector, xml_h e, SensitiveDetector s
 
     sdet.addExtension< ZDiskPetalsData >( zDiskPetalsData ) ;
     sdet.addExtension< NeighbourSurfacesData >( neighbourSurfacesData ) ;
+    sdet.addExtension< lcgeo::NeighbourTable >( new lcgeo::NeighbourTable( neighbourSurfacesData->sameLayer ) ) ;
+    sdet.addExtension< lcgeo::SensorLayout >( sensorLayout ) ;
 
     
     return sdet;
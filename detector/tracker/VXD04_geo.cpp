@@ -12,6 +12,7 @@
 #include "DDRec/DetectorData.h"
 #include "XML/Utilities.h"
 #include "XMLHandlerDB.h"
+#include "PhiSymmetricArray.h"
 
 //#include "DDRec/DDGear.h"
 //#define MOKKA_GEAR
@@ -322,6 +323,9 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector se
     //here we place the physical volumes of both the flex cable (kapton & metal traces) and the foam spacer
     
     phirot = (2*M_PI)/nb_ladder;
+
+    // transformations of all ladders of this layer - ladder i is rotated by i*phirot around the (rotated) y axis
+    const lcgeo::PhiSymmetricArray ladders( int(nb_ladder), phirot, 0., []( double phi ){ return RotationZYX( 0, phi, (M_PI*0.5) ) ; }, -M_PI*0.5 ) ;
     
     double ladder_clothest_approch = beryllium_ladder_block_thickness*2 +0.1;
 
@@ -342,17 +346,8 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector se
        
       for (double ladder_loop=0;ladder_loop<nb_ladder;ladder_loop++) {
 	
-	double phirot2 = ladder_loop*phirot;
-
-	// RotationMatrix *rot = new RotationMatrix();
-	// rot->rotateX(M_PI*0.5);
-	// rot->rotateY(phirot2);
-	RotationZYX rot( 0, phirot2 , (M_PI*0.5) ) ;
-	
 	supp_assembly.placeVolume( FlexCableLogical,
-				   Transform3D( rot, Position(( layer_radius + metal_traces_thickness + (flex_cable_thickness/2.))*sin(phirot2)+offset_phi*cos(phirot2),
-							      -(layer_radius + metal_traces_thickness + (flex_cable_thickness/2.))*cos(phirot2)+offset_phi*sin(phirot2),
-							      0.))  );
+				   ladders.transform( int(ladder_loop), layer_radius + metal_traces_thickness + (flex_cable_thickness/2.), offset_phi )  );
 	// Phys=
 	//   new PVPlacement(rot,
 	// 			ThreeVector((layer_radius + metal_traces_thickness + (flex_cable_thickness/2.))*sin(phirot2)+offset_phi*cos(phirot2),
@@ -365,36 +360,22 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector se
 	// 			0);
 	       
 	supp_assembly.placeVolume( FoamSpacerLogical,
-				   Transform3D(  rot, Position((layer_radius + flex_cable_thickness + metal_traces_thickness + foam_spacer_thickness/2.)*sin(phirot2)+offset_phi*cos(phirot2),
-							       -(layer_radius + flex_cable_thickness + metal_traces_thickness +  foam_spacer_thickness/2.)*cos(phirot2)+offset_phi*sin(phirot2),
-							       0.))  );
+				   ladders.transform( int(ladder_loop), layer_radius + flex_cable_thickness + metal_traces_thickness + foam_spacer_thickness/2., offset_phi )  );
 
-	supp_assembly.placeVolume( MetalTracesLogical,  Transform3D( rot,Position((layer_radius + (metal_traces_thickness/2))*sin(phirot2)+offset_phi*cos(phirot2),
-										  -(layer_radius + (metal_traces_thickness/2.))*cos(phirot2)+offset_phi*sin(phirot2),
- 										  0.))  );
+	supp_assembly.placeVolume( MetalTracesLogical,  ladders.transform( int(ladder_loop), layer_radius + (metal_traces_thickness/2), offset_phi )  );
       }
       
     } else if (LayerId==1||LayerId==3||LayerId==5) { //------------------------------------------------------------------------
       
       for (double ladder_loop=0;ladder_loop<nb_ladder;ladder_loop++) {
 	
-	double phirot2 = ladder_loop*phirot;
-	
-	RotationZYX rot( 0, phirot2 , (M_PI*0.5) ) ;
-	
 	supp_assembly.placeVolume( FlexCableLogical,
-				   Transform3D( rot, Position((layer_radius-(metal_traces_thickness + flex_cable_thickness/2.)+layer_gap)*sin(phirot2)+offset_phi*cos(phirot2),
-							      -(layer_radius-(metal_traces_thickness + flex_cable_thickness/2.)+layer_gap)*cos(phirot2)+offset_phi*sin(phirot2),
-							      0.))  ) ;
+				   ladders.transform( int(ladder_loop), layer_radius-(metal_traces_thickness + flex_cable_thickness/2.)+layer_gap, offset_phi )  ) ;
 
 	supp_assembly.placeVolume( FoamSpacerLogical,
-				   Transform3D( rot, Position((layer_radius + layer_gap - flex_cable_thickness -  metal_traces_thickness - foam_spacer_thickness/2.)*sin(phirot2)+offset_phi*cos(phirot2),
-							      -(layer_radius + layer_gap - flex_cable_thickness - metal_traces_thickness - foam_spacer_thickness/2.)*cos(phirot2)+offset_phi*sin(phirot2),
-							      0.))  );
+				   ladders.transform( int(ladder_loop), layer_radius + layer_gap - flex_cable_thickness - metal_traces_thickness - foam_spacer_thickness/2., offset_phi )  );
 	
-	supp_assembly.placeVolume( MetalTracesLogical,  Transform3D( rot,Position((layer_radius-(metal_traces_thickness/2)+layer_gap)*sin(phirot2)+offset_phi*cos(phirot2),
-										  -(layer_radius-(metal_traces_thickness/2.)+layer_gap)*cos(phirot2)+offset_phi*sin(phirot2),
-										  0.))  );
+	supp_assembly.placeVolume( MetalTracesLogical,  ladders.transform( int(ladder_loop), layer_radius-(metal_traces_thickness/2)+layer_gap, offset_phi )  );
       }
     }
 
@@ -555,22 +536,14 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector se
 	std::string annBlockNameP =  _toString( LayerId , "BerylliumAnnulusBlock_%02d_posZ") + _toString( (int)AnnulusBlock_loop, "_%02d" ) ;
 	std::string annBlockNameN =  _toString( LayerId , "BerylliumAnnulusBlock_%02d_negZ") + _toString( (int)AnnulusBlock_loop, "_%02d" ) ;
 	
-	double phirot2 = phirot*AnnulusBlock_loop;
-
-	RotationZYX rot( 0, phirot2 ,  M_PI*0.5 ) ;
-	
 	double ZAnnulusBlock = ladder_length + end_electronics_half_z + (beryllium_ladder_block_length*2.);
 	    
-	PlacedVolume pv_ann_pos = supp_assembly.placeVolume( BerylliumAnnulusBlockLogical,  Transform3D( rot, Position((layer_radius+beryllium_ladder_block_thickness+layer_gap)*sin(phirot2)+offset_phi*cos(phirot2),
-											     -(layer_radius+beryllium_ladder_block_thickness+layer_gap)*cos(phirot2)+offset_phi*sin(phirot2),
-											     ZAnnulusBlock))  ) ;
+	PlacedVolume pv_ann_pos = supp_assembly.placeVolume( BerylliumAnnulusBlockLogical,  ladders.transform( int(AnnulusBlock_loop), layer_radius+beryllium_ladder_block_thickness+layer_gap, offset_phi, ZAnnulusBlock )  ) ;
 	DetElement  annBlockPosZ( vxd , annBlockNameP  , x_det.id() );
 	annBlockPosZ.setPlacement( pv_ann_pos ) ;
 	volSurfaceList( annBlockPosZ )->push_back( surfAnnBlock ) ;
 	
-	PlacedVolume pv_ann_neg = supp_assembly.placeVolume( BerylliumAnnulusBlockLogical,  Transform3D( rot, Position((layer_radius+beryllium_ladder_block_thickness+layer_gap)*sin(phirot2)+offset_phi*cos(phirot2),
-											     -(layer_radius+beryllium_ladder_block_thickness+layer_gap)*cos(phirot2)+offset_phi*sin(phirot2),
-											     -ZAnnulusBlock))  );
+	PlacedVolume pv_ann_neg = supp_assembly.placeVolume( BerylliumAnnulusBlockLogical,  ladders.transform( int(AnnulusBlock_loop), layer_radius+beryllium_ladder_block_thickness+layer_gap, offset_phi, -ZAnnulusBlock )  );
 	DetElement  annBlockNegZ( vxd , annBlockNameN  , x_det.id() );
 	annBlockNegZ.setPlacement( pv_ann_neg ) ;
 	volSurfaceList( annBlockNegZ )->push_back( surfAnnBlock ) ;
@@ -603,22 +576,14 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector se
 	
 	vxd.setVisAttributes(theDetector,  "CyanVis" , BerylliumAnnulusBlockLogical) ;
 	
-	double phirot2 = phirot*AnnulusBlock_loop;
-	
-	RotationZYX rot( 0, phirot2 , (M_PI*0.5) ) ;
-	
 	double ZAnnulusBlock2=shell_half_z -(beryllium_ladder_block_length2/2.);// - (shell_thickess/2.); 
 	
-	PlacedVolume pv_ann_pos = supp_assembly.placeVolume( BerylliumAnnulusBlockLogical,  Transform3D( rot, Position((layer_radius+beryllium_ladder_block_thickness+layer_gap)*sin(phirot2)+offset_phi*cos(phirot2),
-											     -(layer_radius+beryllium_ladder_block_thickness+layer_gap)*cos(phirot2)+offset_phi*sin(phirot2),
-											     ZAnnulusBlock2))  );
+	PlacedVolume pv_ann_pos = supp_assembly.placeVolume( BerylliumAnnulusBlockLogical,  ladders.transform( int(AnnulusBlock_loop), layer_radius+beryllium_ladder_block_thickness+layer_gap, offset_phi, ZAnnulusBlock2 )  );
 	DetElement  annBlockPosZ( vxd , annBlockNameP  , x_det.id() );
 	annBlockPosZ.setPlacement( pv_ann_pos ) ;
 	volSurfaceList( annBlockPosZ )->push_back( surfAnnBlock ) ;
 
-	PlacedVolume pv_ann_neg = supp_assembly.placeVolume( BerylliumAnnulusBlockLogical,  Transform3D( rot, Position((layer_radius+beryllium_ladder_block_thickness+layer_gap)*sin(phirot2)+offset_phi*cos(phirot2),
-											     -(layer_radius+beryllium_ladder_block_thickness+layer_gap)*cos(phirot2)+offset_phi*sin(phirot2),
-											     -ZAnnulusBlock2)) ) ;
+	PlacedVolume pv_ann_neg = supp_assembly.placeVolume( BerylliumAnnulusBlockLogical,  ladders.transform( int(AnnulusBlock_loop), layer_radius+beryllium_ladder_block_thickness+layer_gap, offset_phi, -ZAnnulusBlock2 ) ) ;
 	DetElement  annBlockNegZ( vxd , annBlockNameN  , x_det.id() );
 	annBlockNegZ.setPlacement( pv_ann_neg ) ;
 	volSurfaceList( annBlockNegZ )->push_back( surfAnnBlock ) ;
@@ -660,24 +625,17 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector se
 	  std::string elecEndLadNameP =  _toString( LayerId , "ElectronicsEnd_%02d_posZ") + _toString( (int)elec_loop, "_%02d" ) ;
 	  std::string elecEndLadNameN =  _toString( LayerId , "ElectronicsEnd_%02d_negZ") + _toString( (int)elec_loop, "_%02d" ) ;
 	  
-	  double phirot2 = phirot*elec_loop;
-	  RotationZYX rot( 0, phirot2 , (M_PI*0.5) ) ;    
-	  
 	  double Z = ladder_length +end_electronics_half_z + (ladder_gap/2.);
 	  
 	  PlacedVolume pv_el_end_pos = layer_assembly.placeVolume( ElectronicsEndLogical,
-				     Transform3D( rot, Position((layer_radius+(electronics_structure_thickness/2.)+layer_gap)*sin(phirot2)+ end_ladd_electronic_offset_phi*cos(phirot2),
-								-(layer_radius+(electronics_structure_thickness/2.)+layer_gap)*cos(phirot2)+ end_ladd_electronic_offset_phi*sin(phirot2),
-								Z))  );
+				     ladders.transform( int(elec_loop), layer_radius+(electronics_structure_thickness/2.)+layer_gap, end_ladd_electronic_offset_phi, Z )  );
 
 	  DetElement  elecEndLadDEposZ( vxd ,  elecEndLadNameP , x_det.id() );
 	  elecEndLadDEposZ.setPlacement( pv_el_end_pos ) ;
 	  volSurfaceList( elecEndLadDEposZ )->push_back( surfEndElec ) ;
 	  
 	  PlacedVolume pv_el_end_neg = layer_assembly.placeVolume( ElectronicsEndLogical,
-				     Transform3D( rot, Position((layer_radius+(electronics_structure_thickness/2.)+layer_gap)*sin(phirot2)+ end_ladd_electronic_offset_phi*cos(phirot2),
-								-(layer_radius+(electronics_structure_thickness/2.)+layer_gap)*cos(phirot2)+ end_ladd_electronic_offset_phi*sin(phirot2),
-								-Z))  );
+				     ladders.transform( int(elec_loop), layer_radius+(electronics_structure_thickness/2.)+layer_gap, end_ladd_electronic_offset_phi, -Z )  );
 
 	  DetElement  elecEndLadDEnegZ( vxd ,  elecEndLadNameN , x_det.id() );
 	  elecEndLadDEnegZ.setPlacement( pv_el_end_neg ) ;
@@ -691,24 +649,17 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector se
 	  std::string elecEndLadNameP =  _toString( LayerId , "ElectronicsEnd_%02d_posZ") + _toString( (int)elec_loop, "_%02d" ) ;
 	  std::string elecEndLadNameN =  _toString( LayerId , "ElectronicsEnd_%02d_negZ") + _toString( (int)elec_loop, "_%02d" ) ;
 	  
-	  double phirot2 = phirot*elec_loop;
-	  RotationZYX rot( 0, phirot2 , (M_PI*0.5) ) ;    
-	  
 	  double Z = ladder_length +end_electronics_half_z + (ladder_gap/2.);
 	  
 	  PlacedVolume pv_el_end_pos = layer_assembly.placeVolume( ElectronicsEndLogical,
-				     Transform3D( rot, Position((layer_radius-(electronics_structure_thickness/2.))*sin(phirot2)+ end_ladd_electronic_offset_phi*cos(phirot2),
-								-(layer_radius-(electronics_structure_thickness/2.))*cos(phirot2)+ end_ladd_electronic_offset_phi*sin(phirot2),
-								Z))  );
+				     ladders.transform( int(elec_loop), layer_radius-(electronics_structure_thickness/2.), end_ladd_electronic_offset_phi, Z )  );
 
 	  DetElement  elecEndLadDEposZ( vxd ,  elecEndLadNameP , x_det.id() );
 	  elecEndLadDEposZ.setPlacement( pv_el_end_pos ) ;
 	  volSurfaceList( elecEndLadDEposZ )->push_back( surfEndElec ) ;
 	  
 	  PlacedVolume pv_el_end_neg = layer_assembly.placeVolume( ElectronicsEndLogical,
-				     Transform3D( rot, Position((layer_radius-(electronics_structure_thickness/2.))*sin(phirot2)+ end_ladd_electronic_offset_phi*cos(phirot2),
-								-(layer_radius-(electronics_structure_thickness/2.))*cos(phirot2)+ end_ladd_electronic_offset_phi*sin(phirot2),
-								-Z))  );
+				     ladders.transform( int(elec_loop), layer_radius-(electronics_structure_thickness/2.), end_ladd_electronic_offset_phi, -Z )  );
 
 	  DetElement  elecEndLadDEnegZ( vxd ,  elecEndLadNameN , x_det.id() );
 	  elecEndLadDEnegZ.setPlacement( pv_el_end_neg ) ;
@@ -739,8 +690,6 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector se
 	
 	for (double elec_loop=0; elec_loop<nb_ladder;elec_loop++) {   
 	  
-	  double phirot2 = phirot*elec_loop;
-	  RotationZYX rot( 0, phirot2 , (M_PI*0.5) ) ;   
 	  
 	  double Z = (ladder_length* (1-side_band_electronics_option/2.)) + ladder_gap/2.;
 	  
@@ -749,18 +698,14 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector se
 	  // cellID0 = encoder.lowWord() ;  
 	  
 	  PlacedVolume pv_el_band_pos = layer_assembly.placeVolume( ElectronicsBandLogical,
-				     Transform3D( rot, Position((layer_radius+(side_band_electronics_thickness/2.)+layer_gap)*sin(phirot2)+side_band_electronic_offset_phi*cos(phirot2),
-								-(layer_radius+(side_band_electronics_thickness/2.)+layer_gap)*cos(phirot2)+side_band_electronic_offset_phi*sin(phirot2),
-								Z))  ) ;
+				     ladders.transform( int(elec_loop), layer_radius+(side_band_electronics_thickness/2.)+layer_gap, side_band_electronic_offset_phi, Z )  ) ;
 	  
 	  //**fg: choose sensor 1 for sensitive electronics side band
 	  if(active_side_band_electronics_option==1)
 	    pv_el_band_pos.addPhysVolID("layer", LayerId ).addPhysVolID( "module" , int(elec_loop)  ).addPhysVolID("sensor", 1 ).addPhysVolID("side", 1 )   ;
 
 	  PlacedVolume pv_el_band_neg = layer_assembly.placeVolume( ElectronicsBandLogical,
-				     Transform3D( rot, Position((layer_radius+(side_band_electronics_thickness/2.)+layer_gap)*sin(phirot2)+side_band_electronic_offset_phi*cos(phirot2),
-								-(layer_radius+(side_band_electronics_thickness/2.)+layer_gap)*cos(phirot2)+side_band_electronic_offset_phi*sin(phirot2),
-								-Z))  );
+				     ladders.transform( int(elec_loop), layer_radius+(side_band_electronics_thickness/2.)+layer_gap, side_band_electronic_offset_phi, -Z )  );
 
 	  if(active_side_band_electronics_option==1)
 	    pv_el_band_neg.addPhysVolID("layer", LayerId ).addPhysVolID( "module" , int(elec_loop)  ).addPhysVolID("sensor", 1 ).addPhysVolID("side", -1 )   ;
@@ -771,8 +716,6 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector se
 	    
 	for (double elec_loop=0; elec_loop<nb_ladder;elec_loop++) { 
 	  
-	  double phirot2 = phirot*elec_loop;
-	  RotationZYX rot( 0, phirot2 , (M_PI*0.5) ) ;   
 
 	  double Z = (ladder_length* (1-side_band_electronics_option/2.)) + ladder_gap/2.;
 	      
@@ -781,17 +724,13 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector se
 	  // cellID0 = encoder.lowWord() ;  
 
 	  PlacedVolume pv_el_band_pos = layer_assembly.placeVolume( ElectronicsBandLogical,
-				     Transform3D( rot, Position((layer_radius-(side_band_electronics_thickness/2.))*sin(phirot2)+side_band_electronic_offset_phi*cos(phirot2),
-								-(layer_radius-(side_band_electronics_thickness/2.))*cos(phirot2)+side_band_electronic_offset_phi*sin(phirot2),
-								Z))  );
+				     ladders.transform( int(elec_loop), layer_radius-(side_band_electronics_thickness/2.), side_band_electronic_offset_phi, Z )  );
 
 	  if(active_side_band_electronics_option==1)
 	    pv_el_band_pos.addPhysVolID("layer", LayerId ).addPhysVolID( "module" , int(elec_loop)  ).addPhysVolID("sensor", 1 ).addPhysVolID("side", 1 )   ;
 
 	  PlacedVolume pv_el_band_neg = layer_assembly.placeVolume( ElectronicsBandLogical,
-				     Transform3D( rot, Position((layer_radius-(side_band_electronics_thickness/2.))*sin(phirot2)+side_band_electronic_offset_phi*cos(phirot2),
-								-(layer_radius-(side_band_electronics_thickness/2.))*cos(phirot2)+side_band_electronic_offset_phi*sin(phirot2),
-								-Z))  );
+				     ladders.transform( int(elec_loop), layer_radius-(side_band_electronics_thickness/2.), side_band_electronic_offset_phi, -Z )  );
 	  if(active_side_band_electronics_option==1)
 	    pv_el_band_neg.addPhysVolID("layer", LayerId ).addPhysVolID( "module" , int(elec_loop)  ).addPhysVolID("sensor", 1 ).addPhysVolID("side", -1 )   ;
 	}
@@ -1085,8 +1024,6 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector se
       
     for (double active_loop=0;active_loop<nb_ladder;active_loop++){
 	
-      double phirot2 =  phirot*active_loop;
-      RotationZYX rot( 0. , phirot2, (M_PI*0.5) ) ;
 	
       double Z = ladder_length/2.+ ladder_gap;
 	
@@ -1105,9 +1042,7 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector se
 
       if (LayerId==1||LayerId==3||LayerId==5) {
 	
-	PlacedVolume pv_layer_pos = layer_assembly.placeVolume( SiActiveLayerLogical,  Transform3D( rot, Position((layer_radius+(active_silicon_thickness/2.)+layer_gap)*sin(phirot2)+active_offset_phi*cos(phirot2),
-										     -(layer_radius+(active_silicon_thickness/2.)+layer_gap)*cos(phirot2)+active_offset_phi*sin(phirot2),
-										     Z)) ) ;
+	PlacedVolume pv_layer_pos = layer_assembly.placeVolume( SiActiveLayerLogical,  ladders.transform( int(active_loop), layer_radius+(active_silicon_thickness/2.)+layer_gap, active_offset_phi, Z ) ) ;
 	
 	pv_layer_pos.addPhysVolID("layer", LayerId ).addPhysVolID( "module" , int(active_loop)  ).addPhysVolID("sensor", 0 ).addPhysVolID("side", 1 )   ;
 
@@ -1116,9 +1051,7 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector se
 	volSurfaceList( ladderDEposZ )->push_back( surf ) ;
 
 
-	PlacedVolume pv_layer_neg = layer_assembly.placeVolume( SiActiveLayerLogical,  Transform3D( rot, Position((layer_radius+(active_silicon_thickness/2.)+layer_gap)*sin(phirot2)+active_offset_phi*cos(phirot2),
-										     -(layer_radius+(active_silicon_thickness/2.)+layer_gap)*cos(phirot2)+active_offset_phi*sin(phirot2),
-										     -Z)) );
+	PlacedVolume pv_layer_neg = layer_assembly.placeVolume( SiActiveLayerLogical,  ladders.transform( int(active_loop), layer_radius+(active_silicon_thickness/2.)+layer_gap, active_offset_phi, -Z ) );
 	
 	pv_layer_neg.addPhysVolID("layer", LayerId ).addPhysVolID( "module" , int(active_loop)  ).addPhysVolID("sensor", 0 ).addPhysVolID("side", -1 )   ;
 
@@ -1129,9 +1062,7 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector se
 
       } else if (LayerId==0||LayerId==2||LayerId==4) { 
 
-	PlacedVolume pv_layer_pos = layer_assembly.placeVolume( SiActiveLayerLogical,  Transform3D( rot, Position((layer_radius-(active_silicon_thickness/2.))*sin(phirot2)+active_offset_phi*cos(phirot2),
-										     -(layer_radius-(active_silicon_thickness/2.))*cos(phirot2)+active_offset_phi*sin(phirot2),
-										     Z)) ) ;
+	PlacedVolume pv_layer_pos = layer_assembly.placeVolume( SiActiveLayerLogical,  ladders.transform( int(active_loop), layer_radius-(active_silicon_thickness/2.), active_offset_phi, Z ) ) ;
 	
 	pv_layer_pos.addPhysVolID("layer", LayerId ).addPhysVolID( "module" , int(active_loop)  ).addPhysVolID("sensor", 0 ).addPhysVolID("side", 1 )   ;
 	
@@ -1140,9 +1071,7 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector se
 	volSurfaceList( ladderDEposZ )->push_back( surf ) ;
 
 	
-	PlacedVolume pv_layer_neg = layer_assembly.placeVolume( SiActiveLayerLogical,  Transform3D( rot, Position((layer_radius-(active_silicon_thickness/2.))*sin(phirot2)+active_offset_phi*cos(phirot2),
-	 									     -(layer_radius-(active_silicon_thickness/2.))*cos(phirot2)+active_offset_phi*sin(phirot2),
-	 									     -Z)) );
+	PlacedVolume pv_layer_neg = layer_assembly.placeVolume( SiActiveLayerLogical,  ladders.transform( int(active_loop), layer_radius-(active_silicon_thickness/2.), active_offset_phi, -Z ) );
 	DetElement   ladderDEnegZ( vxd ,  ladderNameN , x_det.id() );
 	ladderDEnegZ.setPlacement( pv_layer_neg ) ;
 	volSurfaceList( ladderDEnegZ )->push_back( surf ) ;
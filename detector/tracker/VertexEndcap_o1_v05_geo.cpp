@@ -18,6 +18,7 @@
 #include "XML/Utilities.h"
 #include "DD4hep/Printout.h"
 #include "DDRec/DetectorData.h"
+#include "NeighbourTable.h"
 
 #include <UTIL/BitField64.h>
 #include <UTIL/BitSet32.h>
@@ -279,6 +280,7 @@ static Ref_t create_detector(Detector& theDetector, xml_h e, SensitiveDetector s
     //attach data to detector
     sdet.addExtension< ZDiskPetalsData >( zDiskPetalsData ) ;
     sdet.addExtension< NeighbourSurfacesData >( neighbourSurfacesData ) ;
+    sdet.addExtension< lcgeo::NeighbourTable >( new lcgeo::NeighbourTable( neighbourSurfacesData->sameLayer ) ) ;
 
     std::cout<<"XXX Vertex endcap layers: "<<zDiskPetalsData->layers.size()<<std::endl;
 
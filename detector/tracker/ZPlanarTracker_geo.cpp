@@ -13,6 +13,8 @@
 
 #include "DDRec/Surface.h"
 #include "DDRec/DetectorData.h"
+#include "PhiSymmetricArray.h"
+#include "NeighbourTable.h"
 #include <exception>
 
 #include <UTIL/BitField64.h>
@@ -206,32 +208,17 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector se
 
     //--------- loop over ladders ---------------------------
 
-    for(int j=0; j<nLadders; ++j) {
+    const lcgeo::PhiSymmetricArray ladders( nLadders, dphi, phi0, []( double phi ){ return RotationZYX( phi , 0, 0  ) ; } ) ;
 
-      double phi = phi0 + j * dphi  ;
+    for(int j=0; j<nLadders; ++j) {
 
       std::string laddername = layername + _toString(j,"_ladder%d");
 
-      RotationZYX rot( phi , 0, 0  ) ;
-
-
       // --- place support -----
-      double lthick = supp_thickness ;
-      double radius = supp_distance ;
-      double offset = supp_offset ;
-      
-      pv = layer_assembly.placeVolume( supp_vol,Transform3D( rot, Position( ( radius + lthick/2. ) * cos(phi)  - offset * sin( phi ) ,
-									    ( radius + lthick/2. ) * sin(phi)  + offset * cos( phi ) ,
-									    0. ) ));
+      pv = layer_assembly.placeVolume( supp_vol, ladders.transform( j, supp_distance + supp_thickness/2., supp_offset ) );
 
       // --- place sensitive -----
-      lthick = sens_thickness ;
-      radius = sens_distance ;
-      offset = sens_offset ;
-      
-      pv = layer_assembly.placeVolume( sens_vol,Transform3D( rot, Position( ( radius + lthick/2. ) * cos(phi)  - offset * sin( phi ) ,
-									    ( radius + lthick/2. ) * sin(phi)  + offset * cos( phi ) ,
-									    0. ) ));
+      pv = layer_assembly.placeVolume( sens_vol, ladders.transform( j, sens_distance + sens_thickness/2., sens_offset ) );
 
 
 
@@ -320,6 +307,7 @@ static Ref_t create_element(Detector& theDetector, xml_h e, SensitiveDetector se
 
   tracker.addExtension< ZPlanarData >( zPlanarData ) ;
   tracker.addExtension< NeighbourSurfacesData >( neighbourSurfacesData ) ;
+  tracker.addExtension< lcgeo::NeighbourTable >( new lcgeo::NeighbourTable( neighbourSurfacesData->sameLayer ) ) ;
 
 
   Volume mother =  theDetector.pickMotherVolume( tracker ) ;
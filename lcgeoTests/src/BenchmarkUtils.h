@@ -0,0 +1,59 @@
+//====================================================================
+//  lcgeo - LC detector models in DD4hep
+//--------------------------------------------------------------------
+//  Timing, random sampling and the report line shared by the
+//  benchmarks in lcgeoTests
+//====================================================================
+#ifndef BenchmarkUtils_h
+#define BenchmarkUtils_h
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lcgeo {
+  namespace benchmark {
+
+    typedef std::chrono::steady_clock clock_type ;
+
+    /// time since start per call for n calls in ns
+    inline double nanoSeconds( clock_type::time_point start, int n ){
+      return std::chrono::duration<double, std::nano>( clock_type::now() - start ).count() / n ;
+    }
+
+    /// time since start per call for n calls in us
+    inline double microSeconds( clock_type::time_point start, int n ){
+      return std::chrono::duration<double, std::micro>( clock_type::now() - start ).count() / n ;
+    }
+
+    /// random number engine with the fixed seed of all benchmarks, so that the queries are reproducible
+    inline std::mt19937 randomEngine(){
+      return std::mt19937( 4711 ) ;
+    }
+
+    /// n elements drawn at random (with repetition) from values
+    template <class T>
+    std::vector<T> sample( const std::vector<T>& values, int n, std::mt19937& rng ){
+      std::uniform_int_distribution<std::size_t> pick( 0, values.size() - 1 ) ;
+      std::vector<T> samples( n ) ;
+      for( auto& s : samples ) s = values[ pick( rng ) ] ;
+      return samples ;
+    }
+
+    /** print one line with the times of the compared implementations:
+     *  " <what> [<unit>] - <name>: <time> <name>: <time> <note>"
+     */
+    inline void report( const std::string& what, const std::string& unit,
+			const std::vector< std::pair<std::string, double> >& times, const std::string& note = "" ){
+      std::cout << " " << what << " [" << unit << "] -" ;
+      for( const auto& t : times ) std::cout << " " << t.first << ": " << t.second ;
+      if( ! note.empty() ) std::cout << " " << note ;
+      std::cout << std::endl ;
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,124 @@
+// Benchmark of the cell accumulation and output of ForwardCaloSDAction for pair background events, without Geant4:
+//  - for the subdetectors with a lcgeo::DenseCellIndex of a polar (r, phi) readout (BeamCal_o1_v02, LumiCal_o1_v03)
+//    nSteps deposits are drawn in nCells random valid cells, as the steps of the pairs of one bunch crossing
+//  - the time per step is printed for adding the deposits to their cell with the dense index (ForwardCaloSDAction)
+//    and with a linear search through the hits of the event by cellID (CellIDCompare, as Geant4Calorimeter)
+//  - both have to give the same cells and energies
+//  - the bytes per event are printed for the occupancy map record (OutputMode map: 8 + 8 per cell) and for the hits
+//    (OutputMode hits), estimated as 40 bytes per uncompressed SimCalorimeterHit with one contribution
+//
+// usage: ForwardCaloBenchmark compact.xml [nSteps] [nCells]
+
+#include "BenchmarkUtils.h"
+#include "DenseCellIndex.h"
+
+#include <DD4hep/DDTest.h>
+#include <DD4hep/Detector.h>
+#include <DD4hep/Readout.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static dd4hep::DDTest test( "ForwardCalo" ) ;
+
+using lcgeo::benchmark::clock_type ;
+using lcgeo::benchmark::nanoSeconds ;
+
+namespace {
+
+  /// a cell hit in the event
+  struct Cell {
+    dd4hep::CellID cellID ;
+    double energy ;
+  };
+}
+
+int main( int argc, char** argv ){
+
+  if( argc < 2 ){
+    std::cout << " usage: ForwardCaloBenchmark compact.xml [nSteps] [nCells]" << std::endl ;
+    return 1 ;
+  }
+  const int nSteps = argc > 2 ? std::atoi( argv[2] ) : 1000000 ;
+  const int nCells = argc > 3 ? std::atoi( argv[3] ) : 10000 ;
+  // bytes of a SimCalorimeterHit with cellID0/1, energy, position and one contribution (particle, energy, time, pdg)
+  const double hitBytes = 40. ;
+
+  try{
+    dd4hep::Detector& theDetector = dd4hep::Detector::getInstance() ;
+    theDetector.fromCompact( argv[1] ) ;
+
+    int nDetectors = 0 ;
+    for( const auto& c : theDetector.world().children() ){
+
+      const lcgeo::DenseCellIndex* index = c.second.extension<lcgeo::DenseCellIndex>( false ) ;
+      if( ! index || index->numberOfChannels() == 0 ) continue ;
+      dd4hep::SensitiveDetector sd = theDetector.sensitiveDetector( c.first ) ;
+      if( ! sd.isValid() || sd.readout().segmentation().type().find( "PolarGridRPhi" ) == std::string::npos ) continue ;
+      ++nDetectors ;
+
+      //--- the cells hit in the event and the steps
+      std::mt19937 rng = lcgeo::benchmark::randomEngine() ;
+      std::uniform_int_distribution<long> pick( 0, index->size() - 1 ) ;
+      std::vector<dd4hep::CellID> cells ;
+      for( long tries = 0 ; int( cells.size() ) < nCells && tries < 100L * index->size() ; ++tries ){
+	const long idx = pick( rng ) ;
+	if( index->isValidIndex( idx ) ) cells.push_back( index->cellID( idx ) ) ;
+      }
+      const std::vector<dd4hep::CellID> steps = lcgeo::benchmark::sample( cells, nSteps, rng ) ;
+      std::exponential_distribution<double> depositOf( 1. / 1e-4 ) ;
+      std::vector<double> deposits( nSteps ) ;
+      for( double& e : deposits ) e = depositOf( rng ) ;
+
+      //--- dense index, as ForwardCaloSDAction
+      std::vector<int> cellOfIndex( index->size(), -1 ) ;
+      std::vector<Cell> dense ;
+      auto start = clock_type::now() ;
+      for( int i = 0 ; i < nSteps ; ++i ){
+	int& slot = cellOfIndex[ index->index( steps[i] ) ] ;
+	if( slot < 0 ){
+	  slot = dense.size() ;
+	  dense.push_back( Cell{ steps[i], 0. } ) ;
+	}
+	dense[ slot ].energy += deposits[i] ;
+      }
+      const double tDense = nanoSeconds( start, nSteps ) ;
+
+      //--- linear search by cellID, as Geant4Calorimeter
+      std::vector<Cell> linear ;
+      start = clock_type::now() ;
+      for( int i = 0 ; i < nSteps ; ++i ){
+	std::size_t k = 0 ;
+	while( k < linear.size() && linear[k].cellID != steps[i] ) ++k ;
+	if( k == linear.size() ) linear.push_back( Cell{ steps[i], 0. } ) ;
+	linear[k].energy += deposits[i] ;
+      }
+      const double tLinear = nanoSeconds( start, nSteps ) ;
+
+      int nDiffer = dense.size() != linear.size() ;
+      for( std::size_t k = 0 ; ! nDiffer && k < dense.size() ; ++k )
+	nDiffer += dense[k].cellID != linear[k].cellID || std::fabs( dense[k].energy - linear[k].energy ) > 1e-12 * linear[k].energy ;
+      test( nDiffer, 0, c.first + ": same cells and energies with the dense index and the linear search" ) ;
+
+      std::stringstream what ;
+      what << c.first << " (" << nSteps << " steps in " << dense.size() << " cells of " << index->numberOfChannels() << ")" ;
+      lcgeo::benchmark::report( what.str(), "ns/step", { { "linear search", tLinear }, { "dense index", tDense } } ) ;
+      lcgeo::benchmark::report( what.str(), "kB/event", { { "hits (estimate)", 1e-3 * hitBytes * dense.size() },
+							  { "map", 1e-3 * ( 8. + 8. * dense.size() ) } } ) ;
+    }
+
+    test( nDetectors > 0, "subdetectors with a dense cell index of a polar readout" ) ;
+
+  } catch( std::exception &e ){
+    test.log( e.what() );
+    test.error( "exception occurred" );
+  }
+
+  return 0;
+}
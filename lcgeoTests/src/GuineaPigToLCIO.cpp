@@ -0,0 +1,197 @@
+// Conversion of GuineaPig pair background files (.pair) to LCIO MCParticles.
+//
+// Every pair file is one bunch crossing. The files are memory mapped and parsed in chunks of lines on
+// several threads (see GuineaPigPairs.h), the MCParticles of a chunk are created on the same threads and
+// the events are written as soon as they are complete, so that only one event is kept in memory.
+// By default one event is written per bunch crossing, --bx-per-event n overlays n crossings in one event
+// and --max-particles n splits the particles into events of at most n particles.
+//
+// As in example/guineapig_to_lcio.py the particles are electrons and positrons (sign of the energy) with
+// momentum beta * energy and the creation point in the vertex. Optionally the vertices are shifted in z
+// and particles and vertices are boosted for a crossing angle, as ddsim --crossingAngleBoost does
+// (the angle is half the full crossing angle).
+//
+// usage: GuineaPigToLCIO [--output pairs.slcio] [--bx-per-event n] [--max-particles n] [--threads n]
+//                        [--z-offset mm] [--crossing-angle-boost rad] file.pair [file.pair ...]
+
+#include "GuineaPigPairs.h"
+
+#include <EVENT/LCIO.h>
+#include <IMPL/LCCollectionVec.h>
+#include <IMPL/LCEventImpl.h>
+#include <IMPL/MCParticleImpl.h>
+#include <IO/LCWriter.h>
+#include <IOIMPL/LCFactory.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+  struct ConvertConfig {
+    int bxPerEvent = 1 ;
+    std::size_t maxParticles = 0 ;      // per event, 0: no limit
+    double zOffset = 0. ;               // [mm]
+    double crossingAngleBoost = 0. ;    // [rad]
+    unsigned nThreads = 1 ;
+  };
+
+  const double electronMass = 0.0005109989461 ; // [GeV]
+  const double nm2mm = 1e-6 ;
+  const double cLight = 299.792458 ;            // [mm/ns]
+
+  IMPL::MCParticleImpl* createParticle( const lcgeo::GuineaPigParticle& gp, const ConvertConfig& cfg ){
+
+    const double energy = std::fabs( gp.energy ) ;
+    double p[3] = { gp.betaX * energy, gp.betaY * energy, gp.betaZ * energy } ;
+    double v[3] = { gp.x * nm2mm, gp.y * nm2mm, gp.z * nm2mm + cfg.zOffset } ;
+    double t = 0. ;
+
+    if( cfg.crossingAngleBoost != 0. ){
+      const double betaGamma = std::tan( cfg.crossingAngleBoost ) ;
+      const double gamma = std::sqrt( 1. + betaGamma * betaGamma ) ;
+      const double e = std::sqrt( p[0] * p[0] + p[1] * p[1] + p[2] * p[2] + electronMass * electronMass ) ;
+      p[0] = gamma * p[0] + betaGamma * e ;
+      t = betaGamma * v[0] / cLight ;
+      v[0] = gamma * v[0] ;
+    }
+
+    IMPL::MCParticleImpl* mcp = new IMPL::MCParticleImpl ;
+    mcp->setGeneratorStatus( 1 ) ;
+    mcp->setMass( electronMass ) ;
+    mcp->setPDG( gp.pdg() ) ;
+    mcp->setCharge( gp.charge() ) ;
+    mcp->setMomentum( p ) ;
+    mcp->setVertex( v ) ;
+    mcp->setTime( t ) ;
+    return mcp ;
+  }
+
+  /// create the MCParticles of a chunk on the threads, in the order of the file
+  void addParticles( const std::vector<lcgeo::GuineaPigParticle>& particles, std::size_t begin, std::size_t end,
+		     const ConvertConfig& cfg, IMPL::LCCollectionVec* col ){
+    std::vector<IMPL::MCParticleImpl*> mcps( end - begin ) ;
+    const unsigned nThreads = std::max<std::size_t>( 1, std::min<std::size_t>( cfg.nThreads, mcps.size() / 10000 ) ) ;
+    std::vector<std::thread> threads ;
+    for( unsigned t = 0 ; t < nThreads ; ++t )
+      threads.emplace_back( [&, t](){
+	  for( std::size_t i = mcps.size() * t / nThreads ; i < mcps.size() * ( t + 1 ) / nThreads ; ++i )
+	    mcps[i] = createParticle( particles[ begin + i ], cfg ) ;
+	} ) ;
+    for( std::thread& t : threads ) t.join() ;
+    col->reserve( col->size() + mcps.size() ) ;
+    for( IMPL::MCParticleImpl* mcp : mcps ) col->push_back( mcp ) ;
+  }
+
+  /// the event that is filled, written when it is complete
+  class EventWriter {
+  public:
+    explicit EventWriter( IO::LCWriter* writer ) : _writer( writer ) {}
+
+    IMPL::LCCollectionVec* collection( int bunchCrossing ){
+      if( ! _event ){
+	_event.reset( new IMPL::LCEventImpl ) ;
+	_event->setRunNumber( 0 ) ;
+	_event->setEventNumber( _nEvents ) ;
+	_event->parameters().setValue( "BunchCrossing", bunchCrossing ) ;
+	_collection = new IMPL::LCCollectionVec( EVENT::LCIO::MCPARTICLE ) ;
+	_event->addCollection( _collection, "MCParticle" ) ;
+      }
+      return _collection ;
+    }
+
+    void write(){
+      if( ! _event ) return ;
+      _nParticles += _collection->size() ;
+      _writer->writeEvent( _event.get() ) ;
+      _event.reset() ;
+      _collection = 0 ;
+      ++_nEvents ;
+    }
+
+    int nEvents() const { return _nEvents ; }
+    long nParticles() const { return _nParticles ; }
+
+  private:
+    IO::LCWriter* _writer ;
+    std::unique_ptr<IMPL::LCEventImpl> _event {} ;
+    IMPL::LCCollectionVec* _collection = 0 ;
+    int _nEvents = 0 ;
+    long _nParticles = 0 ;
+  };
+}
+
+
+int main( int argc, char** argv ){
+
+  ConvertConfig cfg ;
+  cfg.nThreads = std::max( 1u, std::thread::hardware_concurrency() ) ;
+  std::string outputFile ;
+  std::vector<std::string> inputFiles ;
+
+  for( int i = 1 ; i < argc ; ++i ){
+    std::string arg( argv[i] ) ;
+    if     ( arg == "--output"               && i + 1 < argc ) outputFile = argv[++i] ;
+    else if( arg == "--bx-per-event"         && i + 1 < argc ) cfg.bxPerEvent = std::atoi( argv[++i] ) ;
+    else if( arg == "--max-particles"        && i + 1 < argc ) cfg.maxParticles = std::max( 0L, std::atol( argv[++i] ) ) ;
+    else if( arg == "--threads"              && i + 1 < argc ) cfg.nThreads = std::max( 1, std::atoi( argv[++i] ) ) ;
+    else if( arg == "--z-offset"             && i + 1 < argc ) cfg.zOffset = std::atof( argv[++i] ) ;
+    else if( arg == "--crossing-angle-boost" && i + 1 < argc ) cfg.crossingAngleBoost = std::atof( argv[++i] ) ;
+    else inputFiles.push_back( arg ) ;
+  }
+
+  if( inputFiles.empty() || cfg.bxPerEvent <= 0 ){
+    std::cout << " usage: GuineaPigToLCIO [--output pairs.slcio] [--bx-per-event n] [--max-particles n] [--threads n]\n"
+	      << "                        [--z-offset mm] [--crossing-angle-boost rad] file.pair [file.pair ...]" << std::endl ;
+    return 1 ;
+  }
+  if( outputFile.empty() ) outputFile = inputFiles.front() + ".slcio" ;
+
+  // particles parsed at a time - bounds the memory if the events are not limited
+  const std::size_t chunkSize = cfg.maxParticles > 0 ? cfg.maxParticles : 1000000 ;
+
+  try{
+    std::unique_ptr<IO::LCWriter> writer( IOIMPL::LCFactory::getInstance()->createLCWriter() ) ;
+    writer->open( outputFile, EVENT::LCIO::WRITE_NEW ) ;
+    EventWriter events( writer.get() ) ;
+
+    auto start = std::chrono::steady_clock::now() ;
+    std::vector<lcgeo::GuineaPigParticle> particles ;
+
+    for( std::size_t bx = 0 ; bx < inputFiles.size() ; ++bx ){
+
+      lcgeo::GuineaPigPairFile file( inputFiles[bx] ) ;
+      while( file.read( particles, chunkSize, cfg.nThreads ) ){
+	for( std::size_t first = 0 ; first < particles.size() ; ){
+	  IMPL::LCCollectionVec* col = events.collection( bx ) ;
+	  const std::size_t n = cfg.maxParticles > 0 ? std::min( particles.size() - first, cfg.maxParticles - col->size() ) : particles.size() ;
+	  addParticles( particles, first, first + n, cfg, col ) ;
+	  first += n ;
+	  if( cfg.maxParticles > 0 && std::size_t( col->size() ) >= cfg.maxParticles ) events.write() ;
+	}
+      }
+      if( ( bx + 1 ) % cfg.bxPerEvent == 0 ) events.write() ;
+    }
+    events.write() ;
+    writer->close() ;
+
+    const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count() ;
+    std::cout << " GuineaPigToLCIO: " << events.nParticles() << " particles of " << inputFiles.size()
+	      << " bunch crossings in " << events.nEvents() << " events written to " << outputFile
+	      << " in " << seconds << " s" << std::endl ;
+
+  } catch( std::exception& e ){
+    std::cerr << " GuineaPigToLCIO: ERROR " << e.what() << std::endl ;
+    return 1 ;
+  }
+
+  return 0 ;
+}
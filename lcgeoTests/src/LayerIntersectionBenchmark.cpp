@@ -0,0 +1,257 @@
+// Test and benchmark of the layer tables of lcgeoIntersection against the DDRec surfaces:
+//  - for random straight tracks from the IP the ladder (ZPlanarData) or petal (ZDiskPetalsData) that the tables
+//    report as hit has to be crossed by the track in the DDRec surfaces of the same layer, side and module, and
+//    layers (and sides) without hit must not be crossed. Crossings within 1e-6 mm of an edge of the ladder or
+//    petal are not counted, there the rounding decides. Up to the fraction of the track-layer pairs given may
+//    differ (default 0).
+//  - only subdetectors whose module IDs are the ladders or petals in phi of the extension are checked: one module
+//    per ladder or petal and layer (and side), at phi0 + module * 2pi / n, with the sensitive surfaces in the plane
+//    the extension gives for it. The others cannot be described by the tables and are skipped: TrackerEndcap_o2_v06
+//    stores the number of rings in petalNumber and an average z in zPosition, TrackerBarrel_o1_v05 places every
+//    other module in phi 'dr' further out while ZPlanarData has a single distance per layer.
+//  - the time per track is printed for the tables and for the intersection with lcgeo::SurfaceIndex
+//
+// usage: LayerIntersectionBenchmark compact.xml [nTracks] [maxMismatchFraction]
+
+#include "BenchmarkUtils.h"
+#include "LayerIntersection.h"
+#include "SurfaceIndex.h"
+
+#include <DD4hep/DD4hepUnits.h>
+#include <DD4hep/DDTest.h>
+#include <DD4hep/Detector.h>
+#include <DDRec/DetectorData.h>
+#include <DDRec/SurfaceHelper.h>
+#include <DDSegmentation/BitFieldCoder.h>
+
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+static dd4hep::DDTest test( "LayerIntersection" ) ;
+
+using dd4hep::rec::ISurface ;
+using dd4hep::rec::Vector3D ;
+using lcgeo::benchmark::clock_type ;
+using lcgeo::benchmark::nanoSeconds ;
+
+namespace {
+
+  int fieldIndex( const dd4hep::DDSegmentation::BitFieldCoder& decoder, const std::string& name ){
+    for( std::size_t i = 0 ; i < decoder.size() ; ++i )
+      if( decoder[i].name() == name ) return i ;
+    return -1 ;
+  }
+
+  /// (layer, side, module) of a surface - the side is 0 for the barrel
+  typedef std::array<int,3> SurfaceKey ;
+
+  struct SurfaceFields {
+    int layer, side, module ;
+    bool disks ;
+
+    SurfaceFields( const dd4hep::DDSegmentation::BitFieldCoder& decoder, bool isDisk ) :
+      layer( fieldIndex( decoder, "layer" ) ), side( fieldIndex( decoder, "side" ) ), module( fieldIndex( decoder, "module" ) ),
+      disks( isDisk ) {}
+
+    SurfaceKey key( const dd4hep::DDSegmentation::BitFieldCoder& decoder, const ISurface* surface ) const {
+      const dd4hep::CellID id = surface->id() ;
+      const int l = layer >= 0 ? decoder[layer].value( id ) : 0 ;
+      const int s = side >= 0 ? decoder[side].value( id ) : ( surface->origin().z() < 0. ? -1 : 1 ) ;
+      return SurfaceKey{ { l, disks ? ( s < 0 ? -1 : 1 ) : 0, module >= 0 ? int( decoder[module].value( id ) ) : -1 } } ;
+    }
+  };
+
+  /// number, direction and plane of the ladders or petals of a layer as given by the extension
+  struct LayerPlanes {
+    int nPhi ;
+    double phi0 ;
+    double distance ;   // distance of the ladder planes from the axis, z of the even petals
+    double zOffset ;    // offset in z of the odd petals
+    double tolerance ;  // the sensitive thickness
+  };
+
+  /** true if the modules of the surfaces are the ladders or petals of the layers: nPhi modules per layer
+   *  (and side), module m in the direction phi0 + m * 2pi / nPhi - the normal of the ladders or the centre
+   *  of the petals within a quarter of the step in phi - and the surfaces within the sensitive thickness
+   *  of the plane of their ladder or petal
+   */
+  bool modulesArePhiSegments( const std::vector<ISurface*>& surfaces, const dd4hep::DDSegmentation::BitFieldCoder& decoder,
+			      const SurfaceFields& fields, const std::vector<LayerPlanes>& layers ){
+    if( fields.module < 0 ) return false ;
+    std::map< std::pair<int,int>, std::set<int> > modules ;
+    for( const ISurface* surface : surfaces ){
+      const SurfaceKey key = fields.key( decoder, surface ) ;
+      if( key[0] < 0 || key[0] >= int( layers.size() ) || key[2] < 0 || key[2] >= layers[ key[0] ].nPhi ) return false ;
+      modules[ std::make_pair( key[0], key[1] ) ].insert( key[2] ) ;
+
+      const LayerPlanes& layer = layers[ key[0] ] ;
+      const double dphi = 2. * M_PI / layer.nPhi ;
+      const double phi = layer.phi0 + key[2] * dphi ;
+      const Vector3D dir = fields.disks ? surface->origin() : surface->normal() ;
+      const double along = dir.x() * std::cos( phi ) + dir.y() * std::sin( phi ) ;
+      const double rho = std::sqrt( dir.x() * dir.x() + dir.y() * dir.y() ) ;
+      // the normals of the ladders may point inwards
+      if( ( fields.disks ? along : std::fabs( along ) ) < rho * std::cos( 0.25 * dphi ) ) return false ;
+
+      const Vector3D o = surface->origin() ;
+      const double offPlane = fields.disks ?
+	o.z() - key[1] * ( layer.distance + ( key[2] % 2 ? -1. : 1. ) * layer.zOffset ) :
+	o.x() * std::cos( phi ) + o.y() * std::sin( phi ) - layer.distance ;
+      if( std::fabs( offPlane ) > layer.tolerance ) return false ;
+    }
+    for( const auto& m : modules )
+      if( int( m.second.size() ) != layers[ m.first.first ].nPhi ) return false ;
+    return ! modules.empty() ;
+  }
+
+  /// the surfaces crossed by each track
+  std::vector< std::set<SurfaceKey> > crossedSurfaces( const lcgeo::SurfaceIndex& index, const lcgeo::RayBatch& rays,
+						       const dd4hep::DDSegmentation::BitFieldCoder& decoder, const SurfaceFields& fields ){
+    const double sMax = 100. * dd4hep::m ;
+    std::vector< std::set<SurfaceKey> > crossed( rays.size() ) ;
+    for( std::size_t i = 0 ; i < rays.size() ; ++i ){
+      const Vector3D p( rays.x[i], rays.y[i], rays.z[i] ), d( rays.dx[i], rays.dy[i], rays.dz[i] ) ;
+      for( const auto& hit : index.intersections( p, d, sMax ) )
+	crossed[i].insert( fields.key( decoder, hit.surface ) ) ;
+    }
+    return crossed ;
+  }
+
+  /// true if any surface of the layer and side is crossed
+  bool crossesLayer( const std::set<SurfaceKey>& crossed, int layer, int side ){
+    auto it = crossed.lower_bound( SurfaceKey{ { layer, side, std::numeric_limits<int>::min() } } ) ;
+    return it != crossed.end() && (*it)[0] == layer && (*it)[1] == side ;
+  }
+}
+
+int main( int argc, char** argv ){
+
+  if( argc < 2 ){
+    std::cout << " usage: LayerIntersectionBenchmark compact.xml [nTracks] [maxMismatchFraction]" << std::endl ;
+    return 1 ;
+  }
+  const int nTracks = argc > 2 ? std::atoi( argv[2] ) : 10000 ;
+  const double maxMismatch = argc > 3 ? std::atof( argv[3] ) : 0. ;
+  // crossings closer to an edge of a ladder or petal are not compared
+  const double edgeBand = 1e-6 * dd4hep::mm ;
+
+  try{
+    dd4hep::Detector& theDetector = dd4hep::Detector::getInstance() ;
+    theDetector.fromCompact( argv[1] ) ;
+
+    //--- random tracks from the IP
+    std::mt19937 rng = lcgeo::benchmark::randomEngine() ;
+    std::uniform_real_distribution<double> cosTheta( -0.995, 0.995 ), phi( -M_PI, M_PI ), vertex( -0.1 * dd4hep::mm, 0.1 * dd4hep::mm ) ;
+    lcgeo::RayBatch rays ;
+    rays.reserve( nTracks ) ;
+    for( int i = 0 ; i < nTracks ; ++i ){
+      const double c = cosTheta( rng ), s = std::sqrt( 1. - c * c ), p = phi( rng ) ;
+      rays.add( vertex( rng ), vertex( rng ), vertex( rng ), s * std::cos( p ), s * std::sin( p ), c ) ;
+    }
+
+    int nDetectors = 0 ;
+    for( const auto& c : theDetector.world().children() ){
+
+      const dd4hep::DetElement& det = c.second ;
+      const dd4hep::rec::ZPlanarData* planar = det.extension<dd4hep::rec::ZPlanarData>( false ) ;
+      const dd4hep::rec::ZDiskPetalsData* disks = det.extension<dd4hep::rec::ZDiskPetalsData>( false ) ;
+      if( ( ! planar || planar->layers.empty() ) && ( ! disks || disks->layers.empty() ) ) continue ;
+
+      dd4hep::SensitiveDetector sd = theDetector.sensitiveDetector( c.first ) ;
+      if( ! sd.isValid() ) continue ;
+      const dd4hep::DDSegmentation::BitFieldCoder& decoder = *sd.readout().idSpec().decoder() ;
+
+      dd4hep::rec::SurfaceHelper ds( det ) ;
+      std::vector<ISurface*> surfaces ;
+      for( ISurface* s : ds.surfaceList() )
+	if( s->type().isSensitive() ) surfaces.push_back( s ) ;
+      if( surfaces.empty() ) continue ;
+
+      const SurfaceFields fields( decoder, ! planar ) ;
+      std::vector<LayerPlanes> layers ;
+      if( planar )
+	for( const auto& l : planar->layers )
+	  layers.push_back( { l.ladderNumber, l.phi0, l.distanceSensitive + 0.5 * l.thicknessSensitive, 0., l.thicknessSensitive } ) ;
+      else
+	for( const auto& l : disks->layers )
+	  layers.push_back( { l.petalNumber, l.phi0, l.zPosition, l.zOffsetSensitive, l.thicknessSensitive } ) ;
+      if( ! modulesArePhiSegments( surfaces, decoder, fields, layers ) ){
+	std::cout << " " << c.first << ": modules are not the " << ( planar ? "ladders" : "petals" )
+		  << " in phi of the extension - skipped" << std::endl ;
+	continue ;
+      }
+
+      ++nDetectors ;
+      const lcgeo::SurfaceIndex index( surfaces ) ;
+
+      auto start = clock_type::now() ;
+      const auto crossed = crossedSurfaces( index, rays, decoder, fields ) ;
+      const double tSurfaces = nanoSeconds( start, nTracks ) ;
+
+      lcgeo::LayerHits hits ;
+      long nChecked = 0, nHits = 0, nMismatch = 0, nEdge = 0 ;
+      double tTable = 0. ;
+      std::size_t nLayers = 0 ;
+
+      auto compare = [&]( std::size_t l, int i, int layer, int side ){
+	const std::size_t e = hits.entry( l, i ) ;
+	const int k = hits.index[e] ;
+	const bool ok = k >= 0 ? crossed[i].count( SurfaceKey{ { layer, side, k } } ) > 0 : ! crossesLayer( crossed[i], layer, side ) ;
+	const bool edge = std::fabs( hits.edge[e] ) <= edgeBand ;
+	++nChecked ;
+	nHits += k >= 0 ;
+	nEdge += ! ok && edge ;
+	nMismatch += ! ok && ! edge ;
+      } ;
+
+      if( planar ){
+	const lcgeo::PlanarLayerTable table( *planar ) ;
+	start = clock_type::now() ;
+	table.intersect( rays, hits ) ;
+	tTable = nanoSeconds( start, nTracks ) ;
+	nLayers = table.size() ;
+
+	for( std::size_t l = 0 ; l < table.size() ; ++l )
+	  for( int i = 0 ; i < nTracks ; ++i )
+	    compare( l, i, int( l ), 0 ) ;
+      } else {
+	const lcgeo::DiskLayerTable table( *disks ) ;
+	start = clock_type::now() ;
+	table.intersect( rays, hits ) ;
+	tTable = nanoSeconds( start, nTracks ) ;
+	nLayers = table.size() ;
+
+	for( std::size_t l = 0 ; l < table.size() ; ++l )
+	  for( int i = 0 ; i < nTracks ; ++i )
+	    compare( l, i, table.layer( l ), table.side( l ) ) ;
+      }
+
+      std::stringstream msg ;
+      msg << c.first << ": " << nMismatch << " of " << nChecked << " track-layer pairs differ from the surfaces ("
+	  << nHits << " hits, " << nEdge << " at an edge not counted)" ;
+      test( nMismatch <= maxMismatch * nChecked, msg.str() ) ;
+      std::stringstream what ;
+      what << c.first << " (" << nLayers << " layers, " << surfaces.size() << " surfaces)" ;
+      lcgeo::benchmark::report( what.str(), "ns/track", { { "surfaces", tSurfaces }, { "table", tTable } } ) ;
+    }
+
+    test( nDetectors > 0, "subdetectors with ladders or petals in phi in ZPlanarData or ZDiskPetalsData" ) ;
+
+  } catch( std::exception &e ){
+    test.log( e.what() );
+    test.error( "exception occurred" );
+  }
+
+  return 0;
+}
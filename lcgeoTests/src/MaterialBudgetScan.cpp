@@ -0,0 +1,264 @@
+// Material budget scan for the lcgeo detector models.
+//
+// Straight rays from the origin are traced through the TGeo geometry (no Geant4) on a grid in
+// (theta, phi). The material is accumulated in units of radiation lengths (X0) and nuclear
+// interaction lengths (lambda_I) per subdetector (child of the world DetElement) and per material.
+// The rows of the grid are distributed over a pool of threads with one TGeoNavigator each.
+//
+// The output ROOT file contains for the total and for every subdetector the 2D maps
+// X0_<name>(theta,phi) and lambda_<name>(theta,phi) and for every material the profiles
+// X0_material_<name>(theta) and lambda_material_<name>(theta), averaged over phi.
+//
+// usage: MaterialBudgetScan [--output scan.root] [--theta-bins n] [--phi-bins n] [--theta-min deg]
+//                           [--theta-max deg] [--rmax mm] [--zmax mm] [--threads n] compact.xml
+
+#include <DD4hep/DD4hepUnits.h>
+#include <DD4hep/DetElement.h>
+#include <DD4hep/Detector.h>
+#include <DD4hep/Printout.h>
+
+#include <TFile.h>
+#include <TGeoManager.h>
+#include <TGeoMaterial.h>
+#include <TGeoMedium.h>
+#include <TGeoNavigator.h>
+#include <TGeoNode.h>
+#include <TH1D.h>
+#include <TH2F.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+  struct ScanConfig {
+    int nTheta = 1000 ;
+    int nPhi = 360 ;
+    double thetaMin = 0. ;   // [deg]
+    double thetaMax = 180. ; // [deg]
+    double rMax = 0. ;       // [cm] stop the rays at this radius, 0: world volume
+    double zMax = 0. ;       // [cm] stop the rays at this |z|, 0: world volume
+  };
+
+  /// material per (theta,phi) bin for every subdetector and per theta bin for every material
+  struct ScanResult {
+    std::vector<std::string> subdetectors {} ;
+    std::vector<std::string> materials {} ;
+    std::vector<std::vector<float> > x0 {} ;      // [subdetector][theta*nPhi+phi]
+    std::vector<std::vector<float> > lambda {} ;  // [subdetector][theta*nPhi+phi]
+    std::vector<std::vector<double> > matX0 {} ;     // [material][theta] summed over phi
+    std::vector<std::vector<double> > matLambda {} ; // [material][theta] summed over phi
+  };
+
+  /// distance along the unit direction dir from the origin to the cylinder r<rMax, |z|<zMax
+  double maxPathLength( const double* dir, const ScanConfig& cfg ){
+    double s = 1e300 ;
+    const double rt = std::sqrt( dir[0]*dir[0] + dir[1]*dir[1] ) ;
+    if( cfg.rMax > 0. && rt > 0. ) s = std::min( s, cfg.rMax / rt ) ;
+    if( cfg.zMax > 0. && dir[2] != 0. ) s = std::min( s, cfg.zMax / std::fabs( dir[2] ) ) ;
+    return s ;
+  }
+
+  /// trace all rays of one theta row with the navigator of this thread
+  void scanRow( TGeoNavigator* nav, int iTheta, const ScanConfig& cfg,
+		const std::map<const TGeoNode*, int>& subdetectorOfNode,
+		const std::map<const TGeoMaterial*, int>& materialIndex, ScanResult& res ){
+
+    const int nSub = res.subdetectors.size() ;
+    const double theta = ( cfg.thetaMin + ( iTheta + 0.5 ) * ( cfg.thetaMax - cfg.thetaMin ) / cfg.nTheta ) * M_PI / 180. ;
+
+    for( int iPhi = 0 ; iPhi < cfg.nPhi ; ++iPhi ){
+
+      const double phi = ( iPhi + 0.5 ) * 2. * M_PI / cfg.nPhi ;
+      const double dir[3] = { std::sin( theta ) * std::cos( phi ), std::sin( theta ) * std::sin( phi ), std::cos( theta ) } ;
+      const double origin[3] = { 0., 0., 0. } ;
+      const double sMax = maxPathLength( dir, cfg ) ;
+      const int bin = iTheta * cfg.nPhi + iPhi ;
+
+      nav->InitTrack( origin, dir ) ;
+      double s = 0. ;
+
+      // guard against rays that get stuck on a surface
+      for( int nSteps = 0 ; nSteps < 1000000 && ! nav->IsOutside() && s < sMax ; ++nSteps ){
+
+	const TGeoNode* node = nav->GetCurrentNode() ;
+	const int level = nav->GetLevel() ;
+	// the placement of the subdetector in the world volume
+	const TGeoNode* top = level > 0 ? nav->GetMother( level - 1 ) : nullptr ;
+
+	nav->FindNextBoundaryAndStep() ;
+	const double step = std::min( nav->GetStep(), sMax - s ) ;
+	s += step ;
+
+	const TGeoMaterial* mat = node->GetMedium()->GetMaterial() ;
+	if( step <= 0. || mat->GetDensity() <= 0. ) continue ;
+
+	const double dx0 = step / mat->GetRadLen() ;
+	const double dlambda = step / mat->GetIntLen() ;
+
+	auto sub = subdetectorOfNode.find( top ) ;
+	const int iSub = ( sub == subdetectorOfNode.end() ? nSub - 1 : sub->second ) ;
+	res.x0[ iSub ][ bin ] += dx0 ;
+	res.lambda[ iSub ][ bin ] += dlambda ;
+
+	const int iMat = materialIndex.at( mat ) ;
+	res.matX0[ iMat ][ iTheta ] += dx0 ;
+	res.matLambda[ iMat ][ iTheta ] += dlambda ;
+      }
+    }
+  }
+
+  void writeResult( const std::string& fileName, const ScanConfig& cfg, const ScanResult& res ){
+
+    // the histograms are owned here, not by the file
+    TH1::AddDirectory( kFALSE ) ;
+
+    TFile file( fileName.c_str(), "RECREATE" ) ;
+    if( file.IsZombie() )
+      throw std::runtime_error( "MaterialBudgetScan: cannot write " + fileName ) ;
+
+    const int nTheta = cfg.nTheta, nPhi = cfg.nPhi ;
+    TH2F totalX0( "X0_total", "total material;#theta [deg];#phi [deg];X_{0}", nTheta, cfg.thetaMin, cfg.thetaMax, nPhi, 0., 360. ) ;
+    TH2F totalLambda( "lambda_total", "total material;#theta [deg];#phi [deg];#lambda_{I}", nTheta, cfg.thetaMin, cfg.thetaMax, nPhi, 0., 360. ) ;
+
+    for( unsigned i = 0 ; i < res.subdetectors.size() ; ++i ){
+      const std::string& name = res.subdetectors[i] ;
+      TH2F hX0( ( "X0_" + name ).c_str(), ( name + ";#theta [deg];#phi [deg];X_{0}" ).c_str(),
+		nTheta, cfg.thetaMin, cfg.thetaMax, nPhi, 0., 360. ) ;
+      TH2F hLambda( ( "lambda_" + name ).c_str(), ( name + ";#theta [deg];#phi [deg];#lambda_{I}" ).c_str(),
+		    nTheta, cfg.thetaMin, cfg.thetaMax, nPhi, 0., 360. ) ;
+      for( int t = 0 ; t < nTheta ; ++t ){
+	for( int p = 0 ; p < nPhi ; ++p ){
+	  hX0.SetBinContent( t + 1, p + 1, res.x0[i][ t * nPhi + p ] ) ;
+	  hLambda.SetBinContent( t + 1, p + 1, res.lambda[i][ t * nPhi + p ] ) ;
+	}
+      }
+      totalX0.Add( &hX0 ) ;
+      totalLambda.Add( &hLambda ) ;
+      hX0.Write() ;
+      hLambda.Write() ;
+    }
+    totalX0.Write() ;
+    totalLambda.Write() ;
+
+    for( unsigned i = 0 ; i < res.materials.size() ; ++i ){
+      const std::string& name = res.materials[i] ;
+      TH1D hX0( ( "X0_material_" + name ).c_str(), ( name + ";#theta [deg];X_{0}" ).c_str(), nTheta, cfg.thetaMin, cfg.thetaMax ) ;
+      TH1D hLambda( ( "lambda_material_" + name ).c_str(), ( name + ";#theta [deg];#lambda_{I}" ).c_str(), nTheta, cfg.thetaMin, cfg.thetaMax ) ;
+      double sum = 0. ;
+      for( int t = 0 ; t < nTheta ; ++t ){
+	hX0.SetBinContent( t + 1, res.matX0[i][t] / nPhi ) ;
+	hLambda.SetBinContent( t + 1, res.matLambda[i][t] / nPhi ) ;
+	sum += res.matX0[i][t] ;
+      }
+      // materials that were never traversed are not written
+      if( sum <= 0. ) continue ;
+      hX0.Write() ;
+      hLambda.Write() ;
+    }
+    file.Close() ;
+  }
+}
+
+int main( int argc, char** argv ){
+
+  ScanConfig cfg ;
+  std::string outputFile( "MaterialBudgetScan.root" ), compactFile ;
+  unsigned nThreads = std::max( 1u, std::thread::hardware_concurrency() ) ;
+
+  for( int i = 1 ; i < argc ; ++i ){
+    std::string arg( argv[i] ) ;
+    if     ( arg == "--output"     && i + 1 < argc ) outputFile = argv[++i] ;
+    else if( arg == "--theta-bins" && i + 1 < argc ) cfg.nTheta = std::atoi( argv[++i] ) ;
+    else if( arg == "--phi-bins"   && i + 1 < argc ) cfg.nPhi = std::atoi( argv[++i] ) ;
+    else if( arg == "--theta-min"  && i + 1 < argc ) cfg.thetaMin = std::atof( argv[++i] ) ;
+    else if( arg == "--theta-max"  && i + 1 < argc ) cfg.thetaMax = std::atof( argv[++i] ) ;
+    else if( arg == "--rmax"       && i + 1 < argc ) cfg.rMax = std::atof( argv[++i] ) * dd4hep::mm ;
+    else if( arg == "--zmax"       && i + 1 < argc ) cfg.zMax = std::atof( argv[++i] ) * dd4hep::mm ;
+    else if( arg == "--threads"    && i + 1 < argc ) nThreads = std::max( 1, std::atoi( argv[++i] ) ) ;
+    else compactFile = arg ;
+  }
+
+  if( compactFile.empty() || cfg.nTheta <= 0 || cfg.nPhi <= 0 ){
+    std::cout << " usage: MaterialBudgetScan [--output scan.root] [--theta-bins n] [--phi-bins n] [--theta-min deg]\n"
+	      << "                           [--theta-max deg] [--rmax mm] [--zmax mm] [--threads n] compact.xml" << std::endl ;
+    return 1 ;
+  }
+
+  dd4hep::Detector& theDetector = dd4hep::Detector::getInstance() ;
+  theDetector.fromCompact( compactFile ) ;
+
+  TGeoManager* mgr = &theDetector.manager() ;
+
+  ScanResult res ;
+  std::map<const TGeoNode*, int> subdetectorOfNode ;
+  for( const auto& child : theDetector.world().children() ){
+    dd4hep::PlacedVolume pv = child.second.placement() ;
+    if( ! pv.isValid() ) continue ;
+    subdetectorOfNode[ pv.ptr() ] = res.subdetectors.size() ;
+    res.subdetectors.push_back( child.first ) ;
+  }
+  // material that does not belong to any subdetector (world, envelopes without DetElement)
+  res.subdetectors.push_back( "other" ) ;
+
+  std::map<const TGeoMaterial*, int> materialIndex ;
+  TIter next( mgr->GetListOfMaterials() ) ;
+  while( TGeoMaterial* mat = static_cast<TGeoMaterial*>( next() ) ){
+    materialIndex[ mat ] = res.materials.size() ;
+    res.materials.push_back( mat->GetName() ) ;
+  }
+
+  const std::size_t nBins = std::size_t( cfg.nTheta ) * cfg.nPhi ;
+  res.x0.assign( res.subdetectors.size(), std::vector<float>( nBins, 0.f ) ) ;
+  res.lambda.assign( res.subdetectors.size(), std::vector<float>( nBins, 0.f ) ) ;
+  res.matX0.assign( res.materials.size(), std::vector<double>( cfg.nTheta, 0. ) ) ;
+  res.matLambda.assign( res.materials.size(), std::vector<double>( cfg.nTheta, 0. ) ) ;
+
+  std::cout << " MaterialBudgetScan: " << cfg.nTheta << " x " << cfg.nPhi << " rays through "
+	    << res.subdetectors.size() - 1 << " subdetectors with " << nThreads << " threads" << std::endl ;
+
+  // every row of the grid is written by exactly one thread - no locking needed
+  mgr->SetMaxThreads( nThreads ) ;
+  std::atomic<int> nextRow( 0 ) ;
+  auto start = std::chrono::steady_clock::now() ;
+
+  auto worker = [&](){
+    TGeoNavigator* nav = mgr->GetCurrentNavigator() ;
+    if( nav == nullptr ) nav = mgr->AddNavigator() ;
+    for( int row = nextRow++ ; row < cfg.nTheta ; row = nextRow++ )
+      scanRow( nav, row, cfg, subdetectorOfNode, materialIndex, res ) ;
+  } ;
+
+  std::vector<std::thread> threads ;
+  for( unsigned i = 1 ; i < nThreads ; ++i ) threads.emplace_back( worker ) ;
+  worker() ;
+  for( auto& t : threads ) t.join() ;
+  mgr->ClearThreadsMap() ;
+
+  const double elapsed = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count() ;
+
+  // average over the full grid
+  std::cout << std::left << std::setw(30) << " subdetector" << std::right << std::setw(12) << "<X0>" << std::setw(12) << "<lambda>" << std::endl ;
+  for( unsigned i = 0 ; i < res.subdetectors.size() ; ++i ){
+    double sumX0 = 0., sumLambda = 0. ;
+    for( std::size_t b = 0 ; b < nBins ; ++b ){ sumX0 += res.x0[i][b] ; sumLambda += res.lambda[i][b] ; }
+    std::cout << " " << std::left << std::setw(29) << res.subdetectors[i] << std::right << std::fixed << std::setprecision(4)
+	      << std::setw(12) << sumX0 / nBins << std::setw(12) << sumLambda / nBins << std::endl ;
+  }
+  std::cout << " MaterialBudgetScan: " << nBins << " rays in " << std::setprecision(1) << elapsed << " s" << std::endl ;
+
+  writeResult( outputFile, cfg, res ) ;
+  std::cout << " MaterialBudgetScan: written " << outputFile << std::endl ;
+
+  return 0 ;
+}
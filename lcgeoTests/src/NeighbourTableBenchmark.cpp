@@ -0,0 +1,90 @@
+// Test and benchmark of lcgeo::NeighbourTable against NeighbourSurfacesData::sameLayer:
+//  - both have to give the same neighbours for all sensors of all subdetectors
+//  - the time per lookup of random sensors is printed for both
+//
+// usage: NeighbourTableBenchmark compact.xml [nQueries]
+
+#include "BenchmarkUtils.h"
+#include "NeighbourTable.h"
+
+#include <DD4hep/DDTest.h>
+#include <DD4hep/Detector.h>
+#include <DDRec/DetectorData.h>
+
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static dd4hep::DDTest test( "NeighbourTable" ) ;
+
+using lcgeo::benchmark::clock_type ;
+using lcgeo::benchmark::nanoSeconds ;
+
+int main( int argc, char** argv ){
+
+  if( argc < 2 ){
+    std::cout << " usage: NeighbourTableBenchmark compact.xml [nQueries]" << std::endl ;
+    return 1 ;
+  }
+  const int nQueries = argc > 2 ? std::atoi( argv[2] ) : 1000000 ;
+
+  try{
+    dd4hep::Detector& theDetector = dd4hep::Detector::getInstance() ;
+    theDetector.fromCompact( argv[1] ) ;
+
+    int nDetectors = 0 ;
+    for( const auto& c : theDetector.world().children() ){
+
+      const dd4hep::rec::NeighbourSurfacesData* data = c.second.extension<dd4hep::rec::NeighbourSurfacesData>( false ) ;
+      const lcgeo::NeighbourTable* table = c.second.extension<lcgeo::NeighbourTable>( false ) ;
+      if( ! data || ! table || data->sameLayer.empty() ) continue ;
+      ++nDetectors ;
+
+      //--- same content
+      int nDiff = 0 ;
+      std::vector<dd4hep::CellID> keys ;
+      for( const auto& entry : data->sameLayer ){
+	keys.push_back( entry.first ) ;
+	lcgeo::NeighbourTable::Range r = table->sameLayer( entry.first ) ;
+	if( std::vector<dd4hep::CellID>( r.begin, r.end ) != std::vector<dd4hep::CellID>( entry.second.begin(), entry.second.end() ) ) ++nDiff ;
+      }
+      std::stringstream msg ;
+      msg << c.first << ": different neighbours for " << nDiff << " of " << keys.size() << " sensors" ;
+      test( nDiff, 0, msg.str() ) ;
+      test( table->size(), data->sameLayer.size(), c.first + ": number of sensors" ) ;
+
+      //--- random lookups
+      std::mt19937 rng = lcgeo::benchmark::randomEngine() ;
+      const std::vector<dd4hep::CellID> queries = lcgeo::benchmark::sample( keys, nQueries, rng ) ;
+
+      std::size_t nMap = 0, nTable = 0 ;
+      auto start = clock_type::now() ;
+      for( dd4hep::CellID q : queries ){
+	auto it = data->sameLayer.find( q ) ;
+	if( it != data->sameLayer.end() ) nMap += it->second.size() ;
+      }
+      const double tMap = nanoSeconds( start, nQueries ) ;
+
+      start = clock_type::now() ;
+      for( dd4hep::CellID q : queries ) nTable += table->sameLayer( q ).size() ;
+      const double tTable = nanoSeconds( start, nQueries ) ;
+
+      test( nTable, nMap, c.first + ": neighbours of the random sensors" ) ;
+      std::stringstream what ;
+      what << c.first << " (" << keys.size() << " sensors, " << table->numberOfNeighbours() << " neighbours)" ;
+      lcgeo::benchmark::report( what.str(), "ns/lookup", { { "map", tMap }, { "table", tTable } } ) ;
+    }
+
+    test( nDetectors > 0, "subdetectors with neighbour tables" ) ;
+
+  } catch( std::exception &e ){
+    test.log( e.what() );
+    test.error( "exception occurred" );
+  }
+
+  return 0;
+}
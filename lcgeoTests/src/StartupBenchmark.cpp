@@ -0,0 +1,298 @@
+// Startup benchmark for the lcgeo detector models.
+//
+// Every compact file given on the command line is loaded with Detector::fromCompact (no Geant4)
+// in a separate process, so that the peak RSS and the timings of one model are not affected by
+// the others. For every model the time to build the geometry, the time to populate the
+// VolumeManager, the peak RSS and the number of volumes, placements and DetElements are reported
+// and optionally written to a JSON file.
+// If a baseline JSON file (written by a previous run) is given, the program fails if the build
+// time, VolumeManager time or peak RSS of a model increased by more than the given tolerance.
+// Models are identified by the path of the compact file relative to the --root directory (or by
+// the full path if not below it), as many compact files in different directories have the same name.
+//
+// usage: StartupBenchmark [--json out.json] [--baseline baseline.json] [--tolerance percent]
+//                         [--min-time seconds] [--root dir] [--verbose] compact.xml [compact.xml ...]
+
+#include <DD4hep/DetElement.h>
+#include <DD4hep/Detector.h>
+#include <DD4hep/Printout.h>
+#include <DD4hep/VolumeManager.h>
+
+#include <TGeoManager.h>
+#include <TGeoVolume.h>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+  struct ModelResult {
+    std::string model {} ;
+    std::string compactFile {} ;
+    bool   ok = false ;
+    double buildTime = 0. ;      // [s]
+    double volMgrTime = 0. ;     // [s]
+    long   peakRSS = 0 ;         // [kB]
+    long   nVolumes = 0 ;
+    long   nPlacements = 0 ;
+    long   nDetElements = 0 ;
+  };
+
+  /// path of the compact file relative to root, e.g. ILD/compact/ILD_sl5_v02/ILD_l5_v02.xml
+  std::string modelName( const std::string& compactFile, std::string root ){
+    if( root.empty() ) return compactFile ;
+    if( root.back() != '/' ) root += '/' ;
+    return compactFile.compare( 0, root.size(), root ) == 0 ? compactFile.substr( root.size() ) : compactFile ;
+  }
+
+  long peakRSS(){
+    struct rusage usage ;
+    getrusage( RUSAGE_SELF, &usage ) ;
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024 ; // bytes on macOS
+#else
+    return usage.ru_maxrss ;        // kB on linux
+#endif
+  }
+
+  long countDetElements( const dd4hep::DetElement& de ){
+    long n = 1 ;
+    for( const auto& child : de.children() )
+      n += countDetElements( child.second ) ;
+    return n ;
+  }
+
+  /// build the model in this process and write the result as one line to fd
+  void measureModel( const std::string& compactFile, int fd ){
+
+    typedef std::chrono::steady_clock clock ;
+    std::ostringstream out ;
+
+    try{
+      dd4hep::Detector& theDetector = dd4hep::Detector::getInstance() ;
+
+      auto start = clock::now() ;
+      theDetector.fromCompact( compactFile ) ;
+      auto built = clock::now() ;
+      dd4hep::VolumeManager::getVolumeManager( theDetector ) ;
+      auto volMgr = clock::now() ;
+
+      long nVolumes = 0, nPlacements = 0 ;
+      TIter next( gGeoManager->GetListOfVolumes() ) ;
+      while( TGeoVolume* vol = static_cast<TGeoVolume*>( next() ) ){
+	++nVolumes ;
+	nPlacements += vol->GetNdaughters() ;
+      }
+
+      out << "ok "
+	  << std::chrono::duration<double>( built - start ).count() << " "
+	  << std::chrono::duration<double>( volMgr - built ).count() << " "
+	  << peakRSS() << " " << nVolumes << " " << nPlacements << " "
+	  << countDetElements( theDetector.world() ) << "\n" ;
+
+    } catch( const std::exception& e ){
+      std::cerr << " StartupBenchmark: failed to load " << compactFile << " : " << e.what() << std::endl ;
+      out << "failed\n" ;
+    }
+
+    const std::string line = out.str() ;
+    if( write( fd, line.c_str(), line.size() ) != (ssize_t) line.size() )
+      std::cerr << " StartupBenchmark: could not report result for " << compactFile << std::endl ;
+  }
+
+  /// load the model in a child process and collect its result
+  ModelResult runModel( const std::string& compactFile, const std::string& root, bool verbose ){
+
+    ModelResult res ;
+    res.model = modelName( compactFile, root ) ;
+    res.compactFile = compactFile ;
+
+    int fds[2] ;
+    if( pipe( fds ) != 0 )
+      throw std::runtime_error( "StartupBenchmark: cannot create pipe" ) ;
+
+    pid_t pid = fork() ;
+    if( pid < 0 )
+      throw std::runtime_error( "StartupBenchmark: cannot fork" ) ;
+
+    if( pid == 0 ){
+      close( fds[0] ) ;
+      if( ! verbose ){ // the drivers are rather chatty
+	int devNull = open( "/dev/null", O_WRONLY ) ;
+	if( devNull >= 0 ) dup2( devNull, STDOUT_FILENO ) ;
+	dd4hep::setPrintLevel( dd4hep::WARNING ) ;
+      }
+      measureModel( compactFile, fds[1] ) ;
+      close( fds[1] ) ;
+      _exit( 0 ) ;
+    }
+
+    close( fds[1] ) ;
+    std::string line ;
+    char buf[256] ;
+    ssize_t n ;
+    while( ( n = read( fds[0], buf, sizeof(buf) ) ) > 0 )
+      line.append( buf, n ) ;
+    close( fds[0] ) ;
+
+    int status = 0 ;
+    waitpid( pid, &status, 0 ) ;
+
+    std::istringstream in( line ) ;
+    std::string ok ;
+    in >> ok ;
+    if( ok == "ok" && WIFEXITED( status ) ){
+      in >> res.buildTime >> res.volMgrTime >> res.peakRSS >> res.nVolumes >> res.nPlacements >> res.nDetElements ;
+      res.ok = ! in.fail() ;
+    }
+    return res ;
+  }
+
+  void writeJSON( const std::string& fileName, const std::vector<ModelResult>& results ){
+
+    std::ofstream out( fileName ) ;
+    if( ! out )
+      throw std::runtime_error( "StartupBenchmark: cannot write " + fileName ) ;
+
+    // one model per line - this is what readBaseline() expects
+    out << "{\n  \"models\": [\n" ;
+    for( unsigned i = 0 ; i < results.size() ; ++i ){
+      const ModelResult& r = results[i] ;
+      out << "    { \"model\": \"" << r.model << "\", \"compact\": \"" << r.compactFile << "\", "
+	  << "\"status\": \"" << ( r.ok ? "ok" : "failed" ) << "\", "
+	  << "\"build_time_s\": " << r.buildTime << ", "
+	  << "\"volume_manager_time_s\": " << r.volMgrTime << ", "
+	  << "\"peak_rss_kB\": " << r.peakRSS << ", "
+	  << "\"volumes\": " << r.nVolumes << ", "
+	  << "\"placements\": " << r.nPlacements << ", "
+	  << "\"detelements\": " << r.nDetElements << " }"
+	  << ( i + 1 < results.size() ? "," : "" ) << "\n" ;
+    }
+    out << "  ]\n}\n" ;
+  }
+
+  /// value of "key": in a single line of the JSON file written by writeJSON
+  std::string jsonValue( const std::string& line, const std::string& key ){
+    std::string::size_type pos = line.find( "\"" + key + "\":" ) ;
+    if( pos == std::string::npos ) return "" ;
+    pos = line.find_first_not_of( " \"", pos + key.size() + 3 ) ;
+    std::string::size_type end = line.find_first_of( "\",}", pos ) ;
+    return line.substr( pos, end - pos ) ;
+  }
+
+  std::map<std::string, ModelResult> readBaseline( const std::string& fileName ){
+
+    std::ifstream in( fileName ) ;
+    if( ! in )
+      throw std::runtime_error( "StartupBenchmark: cannot read baseline " + fileName ) ;
+
+    std::map<std::string, ModelResult> baseline ;
+    std::string line ;
+    while( std::getline( in, line ) ){
+      if( line.find( "\"model\":" ) == std::string::npos ) continue ;
+      ModelResult r ;
+      r.model      = jsonValue( line, "model" ) ;
+      r.ok         = jsonValue( line, "status" ) == "ok" ;
+      r.buildTime  = std::atof( jsonValue( line, "build_time_s" ).c_str() ) ;
+      r.volMgrTime = std::atof( jsonValue( line, "volume_manager_time_s" ).c_str() ) ;
+      r.peakRSS    = std::atol( jsonValue( line, "peak_rss_kB" ).c_str() ) ;
+      baseline[ r.model ] = r ;
+    }
+    return baseline ;
+  }
+
+  /// true if value is more than tolerance [%] above reference (and above minimum)
+  bool regressed( const std::string& model, const std::string& what, double value, double reference,
+		  double tolerance, double minimum ){
+    if( value <= minimum || value <= reference * ( 1. + tolerance / 100. ) ) return false ;
+    std::cout << " REGRESSION " << model << " : " << what << " " << value << " (baseline " << reference
+	      << ", +" << std::setprecision(3) << 100. * ( value / reference - 1. ) << "%)" << std::endl ;
+    return true ;
+  }
+}
+
+int main( int argc, char** argv ){
+
+  std::string jsonFile, baselineFile, root ;
+  double tolerance = 20. ; // [%]
+  double minTime = 0.1 ;   // [s] - ignore time regressions below this
+  bool verbose = false ;
+  std::vector<std::string> compactFiles ;
+
+  for( int i = 1 ; i < argc ; ++i ){
+    std::string arg( argv[i] ) ;
+    if     ( arg == "--json"      && i + 1 < argc ) jsonFile = argv[++i] ;
+    else if( arg == "--baseline"  && i + 1 < argc ) baselineFile = argv[++i] ;
+    else if( arg == "--tolerance" && i + 1 < argc ) tolerance = std::atof( argv[++i] ) ;
+    else if( arg == "--min-time"  && i + 1 < argc ) minTime = std::atof( argv[++i] ) ;
+    else if( arg == "--root"      && i + 1 < argc ) root = argv[++i] ;
+    else if( arg == "--verbose" ) verbose = true ;
+    else compactFiles.push_back( arg ) ;
+  }
+
+  if( compactFiles.empty() ){
+    std::cout << " usage: StartupBenchmark [--json out.json] [--baseline baseline.json] [--tolerance percent]\n"
+	      << "                         [--min-time seconds] [--root dir] [--verbose] compact.xml [compact.xml ...]" << std::endl ;
+    return 1 ;
+  }
+
+  std::vector<ModelResult> results ;
+  int nFailed = 0 ;
+
+  std::cout << std::left << std::setw(50) << " model" << std::right
+	    << std::setw(10) << "build[s]" << std::setw(10) << "volMgr[s]" << std::setw(12) << "RSS[MB]"
+	    << std::setw(10) << "volumes" << std::setw(12) << "placements" << std::setw(12) << "detElements" << std::endl ;
+
+  for( const auto& compactFile : compactFiles ){
+
+    ModelResult r = runModel( compactFile, root, verbose ) ;
+    results.push_back( r ) ;
+
+    std::cout << " " << std::left << std::setw(49) << r.model << std::right ;
+    if( ! r.ok ){
+      std::cout << " FAILED" << std::endl ;
+      ++nFailed ;
+      continue ;
+    }
+    std::cout << std::fixed << std::setprecision(2)
+	      << std::setw(10) << r.buildTime << std::setw(10) << r.volMgrTime
+	      << std::setw(12) << r.peakRSS / 1024. << std::setw(10) << r.nVolumes
+	      << std::setw(12) << r.nPlacements << std::setw(12) << r.nDetElements << std::endl ;
+  }
+
+  if( ! jsonFile.empty() )
+    writeJSON( jsonFile, results ) ;
+
+  int nRegressions = 0 ;
+  if( ! baselineFile.empty() ){
+
+    std::map<std::string, ModelResult> baseline = readBaseline( baselineFile ) ;
+
+    for( const auto& r : results ){
+      auto it = baseline.find( r.model ) ;
+      if( it == baseline.end() || ! it->second.ok || ! r.ok ) continue ;
+      const ModelResult& b = it->second ;
+      nRegressions += regressed( r.model, "build time [s]",         r.buildTime,  b.buildTime,  tolerance, minTime ) ;
+      nRegressions += regressed( r.model, "VolumeManager time [s]", r.volMgrTime, b.volMgrTime, tolerance, minTime ) ;
+      nRegressions += regressed( r.model, "peak RSS [kB]",          r.peakRSS,    b.peakRSS,    tolerance, 0. ) ;
+    }
+    std::cout << " " << nRegressions << " regression(s) w.r.t. " << baselineFile
+	      << " (tolerance " << tolerance << "%)" << std::endl ;
+  }
+
+  return ( nFailed || nRegressions ) ? 1 : 0 ;
+}
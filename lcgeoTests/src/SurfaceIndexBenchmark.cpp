@@ -0,0 +1,152 @@
+// Test and benchmark of lcgeo::SurfaceIndex against the linear walk over all surfaces:
+//  - nearest surface to random points in the tracking region
+//  - surfaces in random boxes
+//  - surfaces hit by random rays from the IP
+// The results of both have to agree, the time per query is printed for both.
+//
+// usage: SurfaceIndexBenchmark compact.xml [nQueries]
+
+#include "BenchmarkUtils.h"
+#include "SurfaceIndex.h"
+
+#include <DD4hep/DDTest.h>
+#include <DD4hep/Detector.h>
+#include <DDRec/SurfaceHelper.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static dd4hep::DDTest test( "SurfaceIndex" ) ;
+
+using dd4hep::rec::ISurface ;
+using dd4hep::rec::Vector3D ;
+using lcgeo::benchmark::clock_type ;
+using lcgeo::benchmark::microSeconds ;
+
+namespace {
+
+  bool overlaps( const std::vector<double>& box, const Vector3D& lo, const Vector3D& hi ){
+    for( int k = 0 ; k < 3 ; ++k )
+      if( box[k] > hi[k] || lo[k] > box[k+3] ) return false ;
+    return true ;
+  }
+}
+
+int main( int argc, char** argv ){
+
+  if( argc < 2 ){
+    std::cout << " usage: SurfaceIndexBenchmark compact.xml [nQueries]" << std::endl ;
+    return 1 ;
+  }
+  const int nQueries = argc > 2 ? std::atoi( argv[2] ) : 1000 ;
+
+  try{
+    dd4hep::Detector& theDetector = dd4hep::Detector::getInstance() ;
+    theDetector.fromCompact( argv[1] ) ;
+
+    dd4hep::rec::SurfaceHelper ds( theDetector.world() ) ;
+    const dd4hep::rec::SurfaceList& surfaceList = ds.surfaceList() ;
+    std::vector<ISurface*> surfaces( surfaceList.begin(), surfaceList.end() ) ;
+
+    auto start = clock_type::now() ;
+    lcgeo::SurfaceIndex index( surfaces ) ;
+    std::cout << " indexed " << index.size() << " surfaces in " << microSeconds( start, 1 ) / 1000. << " ms" << std::endl ;
+
+    const double rMax = theDetector.constantAsDouble( "tracker_region_rmax" ) ;
+    const double zMax = theDetector.constantAsDouble( "tracker_region_zmax" ) ;
+
+    std::mt19937 rng = lcgeo::benchmark::randomEngine() ;
+    std::uniform_real_distribution<double> uniform( -1., 1. ) ;
+
+    std::vector<Vector3D> points, directions ;
+    for( int i = 0 ; i < nQueries ; ++i ){
+      points.push_back( Vector3D( uniform( rng ) * rMax / std::sqrt(2.), uniform( rng ) * rMax / std::sqrt(2.), uniform( rng ) * zMax ) ) ;
+      const double cosTheta = uniform( rng ), phi = M_PI * uniform( rng ) ;
+      const double sinTheta = std::sqrt( 1. - cosTheta * cosTheta ) ;
+      directions.push_back( Vector3D( sinTheta * std::cos( phi ), sinTheta * std::sin( phi ), cosTheta ) ) ;
+    }
+
+    //--- nearest surface
+    std::vector<double> linearNearest, indexNearest ;
+    start = clock_type::now() ;
+    for( const auto& p : points ){
+      double best = std::numeric_limits<double>::max() ;
+      for( ISurface* s : surfaces ) best = std::min( best, lcgeo::SurfaceIndex::surfaceDistance( s, p ) ) ;
+      linearNearest.push_back( best ) ;
+    }
+    const double tLinearNearest = microSeconds( start, nQueries ) ;
+
+    start = clock_type::now() ;
+    for( const auto& p : points ){
+      const ISurface* s = index.nearestSurface( p ) ;
+      indexNearest.push_back( s ? lcgeo::SurfaceIndex::surfaceDistance( s, p ) : std::numeric_limits<double>::max() ) ;
+    }
+    const double tIndexNearest = microSeconds( start, nQueries ) ;
+
+    int nDiff = 0 ;
+    for( int i = 0 ; i < nQueries ; ++i ) nDiff += ( linearNearest[i] != indexNearest[i] ) ;
+    std::stringstream msg ;
+    msg << " nearest surface: different results for " << nDiff << " of " << nQueries << " points" ;
+    test( nDiff, 0, msg.str() ) ;
+    lcgeo::benchmark::report( "nearest surface  ", "us/query", { { "linear", tLinearNearest }, { "index", tIndexNearest } } ) ;
+
+    //--- surfaces in box: the linear walk uses the same (precomputed) bounding boxes as the index
+    std::vector<std::vector<double> > boxes ;
+    for( ISurface* s : surfaces ){
+      std::vector<double> box( 6 ) ;
+      lcgeo::SurfaceIndex::boundingBox( s, &box[0], &box[3] ) ;
+      boxes.push_back( box ) ;
+    }
+    const double halfSize = 0.05 * rMax ;
+    const Vector3D half( halfSize, halfSize, halfSize ) ;
+    std::size_t nLinear = 0, nIndex = 0 ;
+    start = clock_type::now() ;
+    for( const auto& p : points )
+      for( const auto& box : boxes ) nLinear += overlaps( box, p - half, p + half ) ;
+    const double tLinearBox = microSeconds( start, nQueries ) ;
+
+    start = clock_type::now() ;
+    for( const auto& p : points ) nIndex += index.surfacesInBox( p - half, p + half ).size() ;
+    const double tIndexBox = microSeconds( start, nQueries ) ;
+
+    msg.str("") ;
+    msg << " surfaces in box: linear " << nLinear << " index " << nIndex ;
+    test( nIndex, nLinear, msg.str() ) ;
+    lcgeo::benchmark::report( "surfaces in box  ", "us/query", { { "linear", tLinearBox }, { "index", tIndexBox } } ) ;
+
+    //--- ray intersections from the IP
+    const double sMax = std::sqrt( rMax * rMax + zMax * zMax ) ;
+    const Vector3D ip ;
+    nLinear = nIndex = 0 ;
+    start = clock_type::now() ;
+    for( const auto& d : directions ){
+      std::vector<lcgeo::SurfaceIndex::Intersection> hits ;
+      for( ISurface* s : surfaces ) lcgeo::SurfaceIndex::intersect( s, ip, d, sMax, 1e-4, hits ) ;
+      nLinear += hits.size() ;
+    }
+    const double tLinearRay = microSeconds( start, nQueries ) ;
+
+    start = clock_type::now() ;
+    for( const auto& d : directions ) nIndex += index.intersections( ip, d, sMax ).size() ;
+    const double tIndexRay = microSeconds( start, nQueries ) ;
+
+    msg.str("") ;
+    msg << " ray intersections: linear " << nLinear << " index " << nIndex ;
+    test( nIndex, nLinear, msg.str() ) ;
+    lcgeo::benchmark::report( "ray intersections", "us/query", { { "linear", tLinearRay }, { "index", tIndexRay } } ) ;
+
+  } catch( std::exception &e ){
+    test.log( e.what() );
+    test.error( "exception occurred" );
+  }
+
+  return 0;
+}
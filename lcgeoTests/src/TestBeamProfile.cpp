@@ -0,0 +1,137 @@
+// Test of lcgeo::BeamProfile and the energy points of TestBeamScan:
+//  - Gaussian and flat beam spots, divergence and energy spread have to have the configured moments
+//  - the beam of an event only depends on the seed, the energy point and the event, not on the order
+//  - energy lists and ranges are parsed, anything else is rejected, point file names carry the energy
+//
+// usage: TestBeamProfile
+
+#include "BeamProfile.h"
+
+#include <DD4hep/DDTest.h>
+
+#include <cmath>
+#include <exception>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static dd4hep::DDTest test( "BeamProfile" ) ;
+
+namespace {
+
+  struct Moments {
+    double mean = 0., rms = 0., min = 1e300, max = -1e300 ;
+  };
+
+  template <typename F>
+  Moments moments( int n, F value ){
+    Moments m ;
+    double sum = 0., sum2 = 0. ;
+    for( int i = 0 ; i < n ; ++i ){
+      const double v = value( i ) ;
+      sum += v ;
+      sum2 += v * v ;
+      m.min = std::min( m.min, v ) ;
+      m.max = std::max( m.max, v ) ;
+    }
+    m.mean = sum / n ;
+    m.rms = std::sqrt( sum2 / n - m.mean * m.mean ) ;
+    return m ;
+  }
+
+  void testProfile(){
+
+    const int n = 100000 ;
+    lcgeo::BeamProfile beam ;
+    beam.meanX = 5. ;
+    beam.meanY = -3. ;
+    beam.widthX = 10. ;
+    beam.widthY = 2. ;
+    beam.z = -1000. ;
+    beam.divergenceX = 1e-3 ;
+    beam.energySpread = 0.01 ;
+    beam.seed = 42 ;
+
+    const Moments x = moments( n, [&]( int i ){ return beam.sample( 10., 0, i ).x ; } ) ;
+    const Moments y = moments( n, [&]( int i ){ return beam.sample( 10., 0, i ).y ; } ) ;
+    const Moments dx = moments( n, [&]( int i ){ return beam.sample( 10., 0, i ).dx ; } ) ;
+    const Moments e = moments( n, [&]( int i ){ return beam.sample( 10., 0, i ).energy ; } ) ;
+    std::stringstream msg ;
+    msg << "gaussian spot x " << x.mean << " +- " << x.rms << ", y " << y.mean << " +- " << y.rms ;
+    test( std::fabs( x.mean - 5. ) < 0.1 && std::fabs( x.rms - 10. ) < 0.1
+	  && std::fabs( y.mean + 3. ) < 0.02 && std::fabs( y.rms - 2. ) < 0.02, msg.str() ) ;
+    test( std::fabs( dx.rms - 1e-3 ) < 2e-5, "divergence in x" ) ;
+    test( std::fabs( e.mean - 10. ) < 0.002 && std::fabs( e.rms - 0.1 ) < 0.002, "energy spread" ) ;
+
+    const lcgeo::BeamParticle p = beam.sample( 10., 0, 7 ) ;
+    test( p.z, -1000., "start in z" ) ;
+    test( std::fabs( p.dx * p.dx + p.dy * p.dy + p.dz * p.dz - 1. ) < 1e-12, "unit direction" ) ;
+
+    beam.shape = lcgeo::BeamProfile::shapeOf( "flat" ) ;
+    const Moments fx = moments( n, [&]( int i ){ return beam.sample( 10., 1, i ).x ; } ) ;
+    test( fx.min >= -5. && fx.max <= 15. && std::fabs( fx.rms - 10. / std::sqrt( 3. ) ) < 0.1, "flat spot in x" ) ;
+
+    bool rejected = false ;
+    try{
+      lcgeo::BeamProfile::shapeOf( "triangle" ) ;
+    } catch( const std::exception& ){
+      rejected = true ;
+    }
+    test( rejected, "unknown profile is rejected" ) ;
+  }
+
+  void testReproducible(){
+
+    lcgeo::BeamProfile beam ;
+    beam.widthX = beam.widthY = 10. ;
+    beam.energySpread = 0.05 ;
+    beam.seed = 4711 ;
+
+    // events in reverse order, as on another thread
+    std::vector<lcgeo::BeamParticle> forward, backward( 100 ) ;
+    for( int i = 0 ; i < 100 ; ++i ) forward.push_back( beam.sample( 20., 3, i ) ) ;
+    for( int i = 99 ; i >= 0 ; --i ) backward[i] = beam.sample( 20., 3, i ) ;
+    int nSame = 0 ;
+    for( int i = 0 ; i < 100 ; ++i )
+      nSame += forward[i].x == backward[i].x && forward[i].y == backward[i].y && forward[i].energy == backward[i].energy ;
+    test( nSame, 100, "beam independent of the order of the events" ) ;
+
+    const lcgeo::BeamParticle other = beam.sample( 20., 4, 0 ) ;
+    test( other.x != forward[0].x && other.energy != forward[0].energy, "different points give different beams" ) ;
+  }
+
+  void testEnergyPoints(){
+
+    const std::vector<double> energies = lcgeo::parseEnergyPoints( "1,2,10:50:10,0.5" ) ;
+    const std::vector<double> expected = { 1., 2., 10., 20., 30., 40., 50., 0.5 } ;
+    test( energies == expected, "energy list with range" ) ;
+    test( lcgeo::parseEnergyPoints( "0.1:0.3:0.1" ).size(), std::size_t( 3 ), "range includes the last energy" ) ;
+
+    int nRejected = 0 ;
+    for( const char* text : { "", "10,", "a", "-5", "10:5:1", "1:2", "1:2:3:4", "1:10:0" } ){
+      try{
+	lcgeo::parseEnergyPoints( text ) ;
+      } catch( const std::exception& ){
+	++nRejected ;
+      }
+    }
+    test( nRejected, 8, "invalid energy points are rejected" ) ;
+
+    test( lcgeo::energyPointFileName( "scan.txt", 10. ), std::string( "scan_10GeV.txt" ), "file name with extension" ) ;
+    test( lcgeo::energyPointFileName( "out.d/scan", 0.5 ), std::string( "out.d/scan_0.5GeV" ), "file name without extension" ) ;
+  }
+}
+
+int main( int, char** ){
+
+  try{
+    testProfile() ;
+    testReproducible() ;
+    testEnergyPoints() ;
+  } catch( std::exception &e ){
+    test.log( e.what() );
+    test.error( "exception occurred" );
+  }
+
+  return 0;
+}
@@ -0,0 +1,204 @@
+// Test beam scans of the CaloTB and FCalTB setups in one process.
+//
+// The compact file is loaded and the geometry and the physics list are initialised once, then every
+// energy point is simulated as one Geant4 run (run n is the n-th energy) - instead of one ddsim job with
+// its full initialisation per point as in CaloTB/run_sim. The beam particles are drawn from a Gaussian or
+// flat beam profile with divergence and energy spread (see lcgeo::BeamProfile and the action TestBeamGun),
+// the events are simulated on --threads worker threads (G4MTRunManager for more than one) and for each
+// point a text file with one line per event is written: the beam particle and, for each hit collection,
+// the deposited energy and the number of hits (see TestBeamScanOutput), e.g. scan_10GeV.txt.
+//
+// usage: TestBeamScan [--energies 10,20,50:100:10] [--events n] [--particle pi+] [--profile gaussian|flat]
+//                     [--mean-x mm] [--mean-y mm] [--width-x mm] [--width-y mm] [--z mm]
+//                     [--divergence-x rad] [--divergence-y rad] [--energy-spread rel] [--seed n]
+//                     [--threads n] [--physics QGSP_BERT] [--calo-action Geant4ScintillatorCalorimeterAction]
+//                     [--tracker-action Geant4TrackerWeightedAction] [--output scan.txt] compact.xml
+
+#include "BeamProfile.h"
+
+#include <DD4hep/Detector.h>
+#include <DDG4/Geant4DetectorConstruction.h>
+#include <DDG4/Geant4EventAction.h>
+#include <DDG4/Geant4GeneratorAction.h>
+#include <DDG4/Geant4Handle.h>
+#include <DDG4/Geant4Kernel.h>
+#include <DDG4/Geant4PhysicsList.h>
+#include <DDG4/Geant4SensDetAction.h>
+#include <DDG4/Geant4UserInitialization.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace dd4hep::sim ;
+
+namespace {
+
+  struct ScanConfig {
+    std::vector<double> energies { 10. } ;  // GeV
+    int nEvents = 10 ;                      // per energy point
+    std::string particle = "pi+" ;
+    std::string profile = "gaussian" ;
+    lcgeo::BeamProfile beam {} ;
+    std::string caloAction = "Geant4ScintillatorCalorimeterAction" ;
+    std::string trackerAction = "Geant4TrackerWeightedAction" ;
+    std::string output = "TestBeamScan.txt" ;
+  };
+
+  /// generator, sensitive and output actions of a kernel - the master without threads, else each worker
+  void setupActions( Geant4Kernel& kernel, const ScanConfig& cfg ){
+
+    Geant4GeneratorActionSequence& gen = kernel.generatorAction() ;
+    Geant4Handle<Geant4GeneratorAction> init( kernel, "Geant4GeneratorActionInit/GenerationInit" ) ;
+    gen.adopt( init ) ;
+
+    Geant4Handle<Geant4GeneratorAction> gun( kernel, "TestBeamGun/Gun" ) ;
+    gun["Particle"] = cfg.particle ;
+    gun["Energies"] = cfg.energies ;
+    gun["Profile"] = cfg.profile ;
+    gun["MeanX"] = cfg.beam.meanX ;
+    gun["MeanY"] = cfg.beam.meanY ;
+    gun["WidthX"] = cfg.beam.widthX ;
+    gun["WidthY"] = cfg.beam.widthY ;
+    gun["Z"] = cfg.beam.z ;
+    gun["DivergenceX"] = cfg.beam.divergenceX ;
+    gun["DivergenceY"] = cfg.beam.divergenceY ;
+    gun["EnergySpread"] = cfg.beam.energySpread ;
+    gun["Seed"] = int( cfg.beam.seed ) ;
+    gen.adopt( gun ) ;
+
+    Geant4Handle<Geant4GeneratorAction> merger( kernel, "Geant4InteractionMerger/InteractionMerger" ) ;
+    gen.adopt( merger ) ;
+    Geant4Handle<Geant4GeneratorAction> primaries( kernel, "Geant4PrimaryHandler/PrimaryHandler" ) ;
+    gen.adopt( primaries ) ;
+
+    dd4hep::Detector& description = kernel.detectorDescription() ;
+    for( const auto& sd : description.sensitiveDetectors() ){
+      const std::string& name = sd.first ;
+      const std::string action = dd4hep::SensitiveDetector( sd.second ).type() == "tracker" ? cfg.trackerAction : cfg.caloAction ;
+      Geant4Handle<Geant4Sensitive> sens( kernel, action + "/" + name + "Handler", name ) ;
+      kernel.sensitiveAction( name )->adopt( sens ) ;
+    }
+
+    Geant4Handle<Geant4EventAction> out( kernel, "TestBeamScanOutput/ScanOutput" ) ;
+    out["Output"] = cfg.output ;
+    out["Energies"] = cfg.energies ;
+    kernel.eventAction().adopt( out ) ;
+  }
+
+  /// the actions of the worker threads
+  class ScanWorkerInitialization : public Geant4UserInitialization {
+  public:
+    ScanWorkerInitialization( Geant4Context* ctxt, const ScanConfig& cfg )
+      : Geant4UserInitialization( ctxt, "ScanWorkerInitialization" ), _cfg( cfg ) {}
+
+    virtual void build() const override {
+      setupActions( context()->kernel().worker( Geant4Kernel::thread_self() ), _cfg ) ;
+    }
+
+  private:
+    ScanConfig _cfg ;
+  };
+}
+
+
+int main( int argc, char** argv ){
+
+  ScanConfig cfg ;
+  cfg.beam.z = -1000. ;
+  int nThreads = 1 ;
+  std::string physics = "QGSP_BERT" ;
+  std::string compactFile ;
+
+  try{
+    for( int i = 1 ; i < argc ; ++i ){
+      std::string arg( argv[i] ) ;
+      if     ( arg == "--energies"       && i + 1 < argc ) cfg.energies = lcgeo::parseEnergyPoints( argv[++i] ) ;
+      else if( arg == "--events"         && i + 1 < argc ) cfg.nEvents = std::atoi( argv[++i] ) ;
+      else if( arg == "--particle"       && i + 1 < argc ) cfg.particle = argv[++i] ;
+      else if( arg == "--profile"        && i + 1 < argc ) cfg.beam.shape = lcgeo::BeamProfile::shapeOf( cfg.profile = argv[++i] ) ;
+      else if( arg == "--mean-x"         && i + 1 < argc ) cfg.beam.meanX = std::atof( argv[++i] ) ;
+      else if( arg == "--mean-y"         && i + 1 < argc ) cfg.beam.meanY = std::atof( argv[++i] ) ;
+      else if( arg == "--width-x"        && i + 1 < argc ) cfg.beam.widthX = std::atof( argv[++i] ) ;
+      else if( arg == "--width-y"        && i + 1 < argc ) cfg.beam.widthY = std::atof( argv[++i] ) ;
+      else if( arg == "--z"              && i + 1 < argc ) cfg.beam.z = std::atof( argv[++i] ) ;
+      else if( arg == "--divergence-x"   && i + 1 < argc ) cfg.beam.divergenceX = std::atof( argv[++i] ) ;
+      else if( arg == "--divergence-y"   && i + 1 < argc ) cfg.beam.divergenceY = std::atof( argv[++i] ) ;
+      else if( arg == "--energy-spread"  && i + 1 < argc ) cfg.beam.energySpread = std::atof( argv[++i] ) ;
+      else if( arg == "--seed"           && i + 1 < argc ) cfg.beam.seed = std::atoi( argv[++i] ) ;
+      else if( arg == "--threads"        && i + 1 < argc ) nThreads = std::max( 1, std::atoi( argv[++i] ) ) ;
+      else if( arg == "--physics"        && i + 1 < argc ) physics = argv[++i] ;
+      else if( arg == "--calo-action"    && i + 1 < argc ) cfg.caloAction = argv[++i] ;
+      else if( arg == "--tracker-action" && i + 1 < argc ) cfg.trackerAction = argv[++i] ;
+      else if( arg == "--output"         && i + 1 < argc ) cfg.output = argv[++i] ;
+      else compactFile = arg ;
+    }
+  } catch( std::exception& e ){
+    std::cerr << " TestBeamScan: ERROR " << e.what() << std::endl ;
+    return 1 ;
+  }
+
+  if( compactFile.empty() || cfg.nEvents <= 0 ){
+    std::cout << " usage: TestBeamScan [--energies 10,20,50:100:10] [--events n] [--particle pi+] [--profile gaussian|flat]\n"
+	      << "                     [--mean-x mm] [--mean-y mm] [--width-x mm] [--width-y mm] [--z mm]\n"
+	      << "                     [--divergence-x rad] [--divergence-y rad] [--energy-spread rel] [--seed n]\n"
+	      << "                     [--threads n] [--physics QGSP_BERT] [--calo-action Geant4ScintillatorCalorimeterAction]\n"
+	      << "                     [--tracker-action Geant4TrackerWeightedAction] [--output scan.txt] compact.xml" << std::endl ;
+    return 1 ;
+  }
+
+  try{
+    auto start = std::chrono::steady_clock::now() ;
+
+    Geant4Kernel& kernel = Geant4Kernel::instance( dd4hep::Detector::getInstance() ) ;
+    kernel.loadGeometry( "file:" + compactFile ) ;
+    if( nThreads > 1 ){
+      kernel.property( "RunManagerType" ).set( std::string( "G4MTRunManager" ) ) ;
+      kernel.property( "NumberOfThreads" ).set( nThreads ) ;
+    }
+
+    Geant4DetectorConstructionSequence* construction = kernel.detectorConstruction( true ) ;
+    Geant4Handle<Geant4DetectorConstruction> geometry( kernel, "Geant4DetectorGeometryConstruction/ConstructGeo" ) ;
+    construction->adopt( geometry ) ;
+    Geant4Handle<Geant4DetectorConstruction> sensitives( kernel, "Geant4DetectorSensitivesConstruction/ConstructSD" ) ;
+    construction->adopt( sensitives ) ;
+
+    kernel.physicsList().property( "extends" ).set( physics ) ;
+
+    if( nThreads > 1 ){
+      ScanWorkerInitialization* init = new ScanWorkerInitialization( kernel.workerContext(), cfg ) ;
+      kernel.userInitialization( true )->adopt( init ) ;
+      init->release() ;
+    } else {
+      setupActions( kernel, cfg ) ;
+    }
+
+    kernel.configure() ;
+    kernel.initialize() ;
+    const double initSeconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count() ;
+
+    for( std::size_t point = 0 ; point < cfg.energies.size() ; ++point ){
+      auto pointStart = std::chrono::steady_clock::now() ;
+      kernel.runEvents( cfg.nEvents ) ;
+      const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - pointStart ).count() ;
+      std::cout << " TestBeamScan: " << cfg.nEvents << " events of " << cfg.particle << " at " << cfg.energies[point]
+		<< " GeV written to " << lcgeo::energyPointFileName( cfg.output, cfg.energies[point] )
+		<< " in " << seconds << " s" << std::endl ;
+    }
+    kernel.terminate() ;
+
+    const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count() ;
+    std::cout << " TestBeamScan: " << cfg.energies.size() << " energy points of " << compactFile << " on " << nThreads
+	      << " threads in " << seconds << " s, of which " << initSeconds << " s initialisation" << std::endl ;
+
+  } catch( std::exception& e ){
+    std::cerr << " TestBeamScan: ERROR " << e.what() << std::endl ;
+    return 1 ;
+  }
+
+  return 0 ;
+}
@@ -0,0 +1,125 @@
+// Test lcgeo::CellPositionCache, the per thread cache of the cell positions in CaloPreShowerSDAction:
+//  - positions are computed once per cell, in any order and across pages, and read back unchanged afterwards;
+//    cells with a negative index are computed every time and do not allocate pages
+//  - with a compact file, for random valid cells of the subdetectors with a lcgeo::DenseCellIndex, hit several
+//    times in random order, the cached positions have to be identical to the uncached ones from the cellID
+//
+// usage: TestCellPositionCache [compact.xml] [nHits]
+
+#include "CellPositionCache.h"
+#include "DenseCellIndex.h"
+
+#include <DD4hep/DD4hepUnits.h>
+#include <DD4hep/DDTest.h>
+#include <DD4hep/Detector.h>
+#include <DD4hep/Objects.h>
+#include <DDRec/CellIDPositionConverter.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <numeric>
+#include <random>
+#include <set>
+#include <sstream>
+#include <vector>
+
+static dd4hep::DDTest test( "CellPositionCache" ) ;
+
+namespace {
+
+  void testCache(){
+
+    const long nCells = 3 * lcgeo::CellPositionCache::pageSize + 17 ;
+    lcgeo::CellPositionCache cache ;
+    cache.resize( nCells ) ;
+    test( cache.numberOfPages(), 0L, "no pages before the first hit" ) ;
+
+    auto uncached = []( long i ){ return dd4hep::Position( i, -0.5 * i, 1e-3 * i ) ; } ;
+
+    // every cell of the first and the last page, in random order
+    std::vector<long> cells( lcgeo::CellPositionCache::pageSize ) ;
+    std::iota( cells.begin(), cells.end(), 0L ) ;
+    for( long i = 3 * lcgeo::CellPositionCache::pageSize ; i < nCells ; ++i ) cells.push_back( i ) ;
+    std::mt19937 rng( 4711 ) ;
+    std::shuffle( cells.begin(), cells.end(), rng ) ;
+
+    long nComputed = 0, nDiffer = 0 ;
+    for( int pass = 0 ; pass < 2 ; ++pass ){
+      for( long i : cells ){
+	const dd4hep::Position p = cache.position<dd4hep::Position>( i, [&](){ ++nComputed ; return uncached( i ) ; } ) ;
+	nDiffer += p != uncached( i ) ;
+      }
+    }
+    test( nComputed, long( cells.size() ), "positions computed once per cell" ) ;
+    test( nDiffer, 0L, "cached positions equal the computed ones" ) ;
+    test( cache.numberOfPages(), 2L, "pages only for the cells that have been hit" ) ;
+
+    nComputed = 0 ;
+    cache.position<dd4hep::Position>( -1, [&](){ ++nComputed ; return uncached( 1 ) ; } ) ;
+    cache.position<dd4hep::Position>( -1, [&](){ ++nComputed ; return uncached( 1 ) ; } ) ;
+    test( nComputed, 2L, "cells outside of the index are not cached" ) ;
+    test( cache.numberOfPages(), 2L, "cells outside of the index do not allocate pages" ) ;
+  }
+
+  void testDetector( const char* compactFile, int nHits ){
+
+    dd4hep::Detector& theDetector = dd4hep::Detector::getInstance() ;
+    theDetector.fromCompact( compactFile ) ;
+    dd4hep::rec::CellIDPositionConverter converter( theDetector ) ;
+
+    std::mt19937 rng( 4711 ) ;
+    int nDetectors = 0 ;
+    for( const auto& d : theDetector.world().children() ){
+      const dd4hep::DetElement& det = d.second ;
+      const lcgeo::DenseCellIndex* index = det.extension<lcgeo::DenseCellIndex>( false ) ;
+      if( ! index || index->numberOfChannels() == 0 ) continue ;
+      ++nDetectors ;
+
+      // a few hundred random valid cells, hit nHits times in total
+      std::uniform_int_distribution<long> pick( 0, index->size() - 1 ) ;
+      std::vector<long> cells ;
+      for( long tries = 0 ; cells.size() < 500 && tries < 100000000L ; ++tries ){
+	const long idx = pick( rng ) ;
+	if( index->isValidIndex( idx ) ) cells.push_back( idx ) ;
+      }
+      std::uniform_int_distribution<std::size_t> hit( 0, cells.size() - 1 ) ;
+
+      lcgeo::CellPositionCache cache ;
+      cache.resize( index->size() ) ;
+      std::set<long> computed ;
+      long nCompared = 0, nDiffer = 0, nComputed = 0 ;
+      for( int i = 0 ; i < nHits && ! cells.empty() ; ++i ){
+	const long idx = cells[ hit( rng ) ] ;
+	const dd4hep::CellID cellID = index->cellID( idx ) ;
+	const dd4hep::Position cached = cache.position<dd4hep::Position>( idx, [&](){
+	    ++nComputed ;
+	    computed.insert( idx ) ;
+	    return converter.position( cellID ) ;
+	  } ) ;
+	nDiffer += cached != converter.position( cellID ) ;
+	++nCompared ;
+      }
+      std::stringstream msg ;
+      msg << det.name() << ": " << nDiffer << " of " << nCompared << " cached positions differ from the uncached ones" ;
+      test( nCompared > 0 && nDiffer == 0, msg.str() ) ;
+      test( nComputed, long( computed.size() ), det.name() + std::string( ": positions computed once per cell" ) ) ;
+    }
+    test( nDetectors > 0, "subdetectors with a dense cell index" ) ;
+  }
+}
+
+
+int main( int argc, char** argv ) {
+
+  try{
+    testCache() ;
+    if( argc > 1 ) testDetector( argv[1], argc > 2 ? std::atoi( argv[2] ) : 10000 ) ;
+
+  } catch( std::exception &e ){
+    test.log( e.what() );
+    test.error( "exception occurred" );
+  }
+
+  return 0;
+}
@@ -0,0 +1,91 @@
+// Test lcgeo::CellTimeOfFlight:
+//  - the time of flight from the placement of a rotated and shifted layer is |global position| / c for all cells
+//  - the table per cell gives the same times, cells outside of the placements give NaN
+
+#include "CellTimeOfFlight.h"
+#include "DenseCellIndex.h"
+
+#include <DD4hep/DD4hepUnits.h>
+#include <DD4hep/DDTest.h>
+#include <DDSegmentation/BitFieldCoder.h>
+#include <DDSegmentation/CartesianGridXY.h>
+
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+static dd4hep::DDTest test( "CellTimeOfFlight" ) ;
+
+
+int main() {
+
+  try{
+
+    dd4hep::DDSegmentation::CartesianGridXY seg( "system:5,layer:6,x:32:-16,y:-16" ) ;
+    seg.setGridSizeX( 0.5 ) ;
+    seg.setGridSizeY( 0.5 ) ;
+    const dd4hep::DDSegmentation::BitFieldCoder& decoder = *seg.decoder() ;
+
+    // one layer of 9 x 5 cells
+    std::vector<lcgeo::DenseCellIndex::SensitiveArea> areas( 1 ) ;
+    lcgeo::DenseCellIndex::setField( decoder, areas[0].volumeID, "layer", 1 ) ;
+    areas[0].dx = 2.0 ;
+    areas[0].dy = 1.0 ;
+    lcgeo::DenseCellIndex::FieldValues replicated ;
+    lcgeo::DenseCellIndex::extend( replicated, "system", 3 ) ;
+    lcgeo::DenseCellIndex* index = lcgeo::DenseCellIndex::create( decoder, seg, areas, replicated ) ;
+
+    dd4hep::CellID volumeMask = 0 ;
+    for( std::size_t i = 0 ; i < decoder.size() ; ++i )
+      if( decoder[i].name() == "system" || decoder[i].name() == "layer" ) volumeMask |= decoder[i].mask() ;
+
+    // the layer is rotated by 90 deg around z and shifted to (100,0,50)
+    const double rotation[9] = { 0., -1., 0.,
+				 1.,  0., 0.,
+				 0.,  0., 1. } ;
+    const double translation[3] = { 100., 0., 50. } ;
+
+    lcgeo::CellTimeOfFlight tof( *index, seg, volumeMask ) ;
+    dd4hep::CellID volumeID = 0 ;
+    decoder.set( volumeID, "system", 3 ) ;
+    decoder.set( volumeID, "layer", 1 ) ;
+    tof.addPlacement( volumeID, rotation, translation ) ;
+
+    int nWrong = 0 ;
+    for( long idx = 0 ; idx < index->size() ; ++idx ){
+      const dd4hep::CellID cell = index->cellID( idx ) ;
+      const dd4hep::DDSegmentation::Vector3D l = seg.position( cell ) ;
+      const double g[3] = { -l.Y + translation[0], l.X + translation[1], l.Z + translation[2] } ;
+      const double expected = std::sqrt( g[0]*g[0] + g[1]*g[1] + g[2]*g[2] ) / dd4hep::c_light ;
+      if( std::fabs( tof.timeOfFlight( cell ) - expected ) > 1e-9 * expected ) ++nWrong ;
+    }
+    test( nWrong, 0, "time of flight from the placement" ) ;
+
+    tof.fillCells() ;
+    test( tof.hasCellTable(), "table per cell" ) ;
+
+    nWrong = 0 ;
+    for( long idx = 0 ; idx < index->size() ; ++idx ){
+      const dd4hep::CellID cell = index->cellID( idx ) ;
+      const dd4hep::DDSegmentation::Vector3D l = seg.position( cell ) ;
+      const double g[3] = { -l.Y + translation[0], l.X + translation[1], l.Z + translation[2] } ;
+      const double expected = std::sqrt( g[0]*g[0] + g[1]*g[1] + g[2]*g[2] ) / dd4hep::c_light ;
+      // stored as float
+      if( std::fabs( tof.timeOfFlight( cell ) - expected ) > 1e-6 * expected ) ++nWrong ;
+    }
+    test( nWrong, 0, "time of flight from the table" ) ;
+
+    dd4hep::CellID other = volumeID ;
+    decoder.set( other, "layer", 2 ) ;
+    test( std::isnan( tof.timeOfFlight( other ) ), "cell of a layer without placement" ) ;
+
+    delete index ;
+
+  } catch( std::exception &e ){
+    test.log( e.what() );
+    test.error( "exception occurred" );
+  }
+
+  return 0;
+}
@@ -0,0 +1,221 @@
+// Test lcgeo::DenseCellIndex:
+//  - with the cellID layout of the ILD Ecal, index() and cellID() have to be inverse to each other for all indices
+//  - cellIDs with a value that is not in the index or a non-zero field without values give -1
+//  - the valid cells and the number of channels of sensitive areas with a CartesianGridXY segmentation
+//  - the same for a ring with a PolarGridRPhi segmentation, as in the BeamCal and LumiCal, with and without cutout
+//  - with a compact file, the cellIDs of points in the sensors of the subdetectors with an index, computed from the
+//    placements as in the simulation, have to be in the index
+//
+// usage: TestDenseCellIndex [compact.xml]
+
+#include "DenseCellIndex.h"
+
+#include <DD4hep/DDTest.h>
+#include <DD4hep/Detector.h>
+#include <DDRec/CellIDPositionConverter.h>
+#include <DDSegmentation/BitFieldCoder.h>
+#include <DDSegmentation/CartesianGridXY.h>
+#include <DDSegmentation/PolarGridRPhi.h>
+
+#include <TGeoBBox.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+static dd4hep::DDTest test( "DenseCellIndex" ) ;
+
+namespace {
+
+  void testIndex(){
+
+    dd4hep::DDSegmentation::BitFieldCoder decoder( "system:5,module:3,stave:4,tower:5,layer:6,wafer:6,slice:4,cellX:32:-16,cellY:-16" ) ;
+
+    lcgeo::DenseCellIndex::FieldValues values ;
+    lcgeo::DenseCellIndex::extend( values, "system", 20 ) ;
+    lcgeo::DenseCellIndex::extend( values, "module", 0 ) ;
+    lcgeo::DenseCellIndex::extend( values, "module", 6 ) ;
+    lcgeo::DenseCellIndex::extend( values, "stave", 1, 8 ) ;
+    for( int l = 0 ; l < 30 ; ++l ) lcgeo::DenseCellIndex::extend( values, "layer", l ) ;
+    lcgeo::DenseCellIndex::extend( values, "tower", 0, 7 ) ;
+    lcgeo::DenseCellIndex::extend( values, "wafer", 1, 12 ) ;
+    lcgeo::DenseCellIndex::extend( values, "cellX", -3, 4 ) ;
+    lcgeo::DenseCellIndex::extend( values, "cellY", -3, 4 ) ;
+    // no values for the slice: has to be zero
+
+    lcgeo::DenseCellIndex index( decoder, values ) ;
+
+    // system 1 x module 2 x stave 8 x tower 8 x layer 30 x wafer 12 x cellX 8 x cellY 8
+    test( index.size(), 1L * 2 * 8 * 8 * 30 * 12 * 8 * 8, "size of the index" ) ;
+
+    long nMismatch = 0 ;
+    for( long i = 0 ; i < index.size() ; ++i )
+      if( index.index( index.cellID( i ) ) != i ) ++nMismatch ;
+    test( nMismatch, 0L, "index( cellID( i ) ) == i" ) ;
+
+    dd4hep::DDSegmentation::CellID id = 0 ;
+    decoder.set( id, "system", 20 ) ;
+    decoder.set( id, "module", 6 ) ;
+    decoder.set( id, "stave", 7 ) ;
+    decoder.set( id, "tower", 2 ) ;
+    decoder.set( id, "layer", 29 ) ;
+    decoder.set( id, "wafer", 4 ) ;
+    decoder.set( id, "cellX", -3 ) ;
+    decoder.set( id, "cellY", 4 ) ;
+
+    const long i = index.index( id ) ;
+    test( i >= 0 && i < index.size(), "cellID with values in the index has an index" ) ;
+    test( index.cellID( i ) == id, "cellID( index( id ) ) == id" ) ;
+
+    dd4hep::DDSegmentation::CellID outside = id ;
+    decoder.set( outside, "cellY", 5 ) ;
+    test( index.index( outside ), -1L, "cellY outside of its values" ) ;
+
+    outside = id ;
+    decoder.set( outside, "module", 3 ) ;
+    test( index.index( outside ), -1L, "module between its values" ) ;
+
+    outside = id ;
+    decoder.set( outside, "system", 21 ) ;
+    test( index.index( outside ), -1L, "other system" ) ;
+
+    outside = id ;
+    decoder.set( outside, "slice", 1 ) ;
+    test( index.index( outside ), -1L, "field without values is not zero" ) ;
+  }
+
+  void testValidCells(){
+
+    dd4hep::DDSegmentation::CartesianGridXY seg( "system:5,module:3,layer:6,x:32:-16,y:-16" ) ;
+    seg.setGridSizeX( 0.5 ) ;
+    seg.setGridSizeY( 0.5 ) ;
+    const dd4hep::DDSegmentation::BitFieldCoder& decoder = *seg.decoder() ;
+
+    // two layers of 9 x 5 and 5 x 5 cells, in the two modules 0 and 6
+    std::vector<lcgeo::DenseCellIndex::SensitiveArea> areas( 2 ) ;
+    lcgeo::DenseCellIndex::setField( decoder, areas[0].volumeID, "layer", 1 ) ;
+    areas[0].dx = 2.0 ;
+    areas[0].dy = 1.0 ;
+    lcgeo::DenseCellIndex::setField( decoder, areas[1].volumeID, "layer", 2 ) ;
+    areas[1].dx = 1.0 ;
+    areas[1].dy = 1.0 ;
+
+    lcgeo::DenseCellIndex::FieldValues replicated ;
+    lcgeo::DenseCellIndex::extend( replicated, "system", 3 ) ;
+    lcgeo::DenseCellIndex::extend( replicated, "module", 0 ) ;
+    lcgeo::DenseCellIndex::extend( replicated, "module", 6 ) ;
+
+    lcgeo::DenseCellIndex* index = lcgeo::DenseCellIndex::create( decoder, seg, areas, replicated ) ;
+
+    test( index->size(), 2L * 2 * 9 * 5, "size of the index for the areas" ) ;
+    test( index->numberOfChannels(), 2L * ( 9 * 5 + 5 * 5 ), "number of channels" ) ;
+
+    dd4hep::DDSegmentation::CellID id = 0 ;
+    decoder.set( id, "system", 3 ) ;
+    decoder.set( id, "module", 6 ) ;
+    decoder.set( id, "layer", 1 ) ;
+    decoder.set( id, "x", 4 ) ;
+    decoder.set( id, "y", -2 ) ;
+    test( index->isValid( id ), "corner cell of layer 1 is valid" ) ;
+
+    decoder.set( id, "layer", 2 ) ;
+    test( ! index->isValid( id ) && index->index( id ) >= 0, "cell outside of layer 2 is in the index but not valid" ) ;
+
+    decoder.set( id, "x", 2 ) ;
+    test( index->isValid( id ), "corner cell of layer 2 is valid" ) ;
+
+    delete index ;
+  }
+
+  void testValidRing(){
+
+    dd4hep::DDSegmentation::PolarGridRPhi seg( "system:8,barrel:3,layer:8,slice:8,r:32:-16,phi:-16" ) ;
+    seg.setGridSizeR( 1.0 ) ;
+    seg.setOffsetR( 10.5 ) ;
+    seg.setGridSizePhi( 2. * M_PI / 16 ) ;
+    seg.setOffsetPhi( 0. ) ;
+    const dd4hep::DDSegmentation::BitFieldCoder& decoder = *seg.decoder() ;
+
+    // 10 rings of 16 cells at both sides in layers 1 and 2
+    lcgeo::DenseCellIndex::SensitiveRing ring ;
+    ring.rMin = 10.0 ;
+    ring.rMax = 20.0 ;
+    lcgeo::DenseCellIndex::FieldValues values ;
+    lcgeo::DenseCellIndex::extend( values, "system", 17 ) ;
+    lcgeo::DenseCellIndex::extend( values, "barrel", 1, 2 ) ;
+    lcgeo::DenseCellIndex::extend( values, "layer", 1, 2 ) ;
+    lcgeo::DenseCellIndex::extend( values, decoder, seg, ring ) ;
+
+    test( values["r"].size(), std::size_t( 10 ), "r values of the ring" ) ;
+    // the cell at phi = +-pi has two phi values
+    test( values["phi"].size(), std::size_t( 17 ), "phi values of the ring" ) ;
+
+    lcgeo::DenseCellIndex index( decoder, values ) ;
+    index.setValid( seg, ring ) ;
+    test( index.numberOfChannels(), 2L * 2 * 10 * 16, "number of channels of the ring" ) ;
+
+    // no cells with the centre at x < 0 - the phi values +-5 to +-8
+    lcgeo::DenseCellIndex cutout( decoder, values ) ;
+    cutout.setValid( seg, ring, []( double x, double ){ return x < 0. ; } ) ;
+    test( cutout.numberOfChannels(), 2L * 2 * 10 * 9, "number of channels of the ring with cutout" ) ;
+  }
+
+  void testDetector( const char* compactFile ){
+
+    dd4hep::Detector& theDetector = dd4hep::Detector::getInstance() ;
+    theDetector.fromCompact( compactFile ) ;
+    dd4hep::rec::CellIDPositionConverter converter( theDetector ) ;
+
+    int nDetectors = 0 ;
+    for( const auto& d : theDetector.world().children() ){
+      const dd4hep::DetElement& det = d.second ;
+      const lcgeo::DenseCellIndex* index = det.extension<lcgeo::DenseCellIndex>( false ) ;
+      if( ! index ) continue ;
+      ++nDetectors ;
+
+      // lines along z through each side (child) of the detector, at several r and phi in its local frame
+      long nCells = 0, nIndexed = 0 ;
+      for( const auto& c : det.children() ){
+	const dd4hep::DetElement& side = c.second ;
+	const TGeoBBox* box = static_cast<const TGeoBBox*>( side.volume()->GetShape() ) ;
+	const double rMax = std::min( box->GetDX(), box->GetDY() ) ;
+	const double dz = box->GetDZ(), z0 = box->GetOrigin()[2] ;
+	for( int ir = 1 ; ir < 10 ; ++ir ){
+	  for( int iphi = 0 ; iphi < 8 ; ++iphi ){
+	    const double r = rMax * ir / 10., phi = ( iphi + 0.5 ) * M_PI / 4. ;
+	    for( double z = z0 - dz ; z < z0 + dz ; z += 0.05 * dd4hep::mm ){
+	      const dd4hep::Position global = side.nominal().localToWorld( dd4hep::Position( r * std::cos( phi ), r * std::sin( phi ), z ) ) ;
+	      const dd4hep::CellID cellID = converter.cellID( global ) ;
+	      if( cellID == 0 ) continue ;
+	      ++nCells ;
+	      nIndexed += index->index( cellID ) >= 0 ;
+	    }
+	  }
+	}
+      }
+      std::stringstream msg ;
+      msg << det.name() << ": " << nIndexed << " of " << nCells << " cellIDs in the sensors are in the index" ;
+      test( nCells > 0 && nIndexed == nCells, msg.str() ) ;
+    }
+    test( nDetectors > 0, "subdetectors with a dense cell index" ) ;
+  }
+}
+
+
+int main( int argc, char** argv ) {
+
+  try{
+    testIndex() ;
+    testValidCells() ;
+    testValidRing() ;
+    if( argc > 1 ) testDetector( argv[1] ) ;
+
+  } catch( std::exception &e ){
+    test.log( e.what() );
+    test.error( "exception occurred" );
+  }
+
+  return 0;
+}
@@ -0,0 +1,103 @@
+// Test of lcgeo::FastSimGeometry and the plugin lcgeo_FastSimGeometry:
+//  - layers written and read back have to be identical, files that are not fast simulation geometries are rejected
+//  - with a compact file, the plugin has to write tracker and calorimeter layers with material that can be read back
+//
+// usage: TestFastSimGeometry [compact.xml]
+
+#include "FastSimGeometry.h"
+
+#include <DD4hep/DDTest.h>
+#include <DD4hep/Detector.h>
+
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static dd4hep::DDTest test( "FastSimGeometry" ) ;
+
+namespace {
+
+  void testRoundTrip(){
+
+    lcgeo::FastSimGeometry geo ;
+    for( int i = 0 ; i < 3 ; ++i ){
+      lcgeo::FastSimGeometry::Layer l ;
+      l.type = lcgeo::FastSimGeometry::TrackerBarrel ;
+      l.layer = i ;
+      l.rMin = 100. + 50. * i ;
+      l.rMax = l.rMin + 0.2 ;
+      l.zMin = -500. ;
+      l.zMax = 500. ;
+      l.radiationLengths = 0.01 ;
+      l.symmetry = 20 + 10 * i ;
+      geo.add( "Tracker", l ) ;
+    }
+    lcgeo::FastSimGeometry::Layer c ;
+    c.type = lcgeo::FastSimGeometry::CalorimeterEndcap ;
+    c.zMin = 2300. ;
+    c.zMax = 2305. ;
+    c.radiationLengths = 0.6 ;
+    c.cellSize0 = c.cellSize1 = 5. ;
+    geo.add( "Ecal", c ) ;
+
+    geo.write( "TestFastSimGeometry.fsgeo" ) ;
+    const lcgeo::FastSimGeometry read = lcgeo::FastSimGeometry::read( "TestFastSimGeometry.fsgeo" ) ;
+
+    test( read.detectors().size(), std::size_t( 2 ), "number of detectors read back" ) ;
+    test( read.layers().size(), geo.layers().size(), "number of layers read back" ) ;
+    bool same = read.layers().size() == geo.layers().size() ;
+    for( std::size_t i = 0 ; same && i < geo.layers().size() ; ++i )
+      same = std::memcmp( &read.layers()[i], &geo.layers()[i], sizeof(lcgeo::FastSimGeometry::Layer) ) == 0
+	&& read.detectorName( read.layers()[i] ) == geo.detectorName( geo.layers()[i] ) ;
+    test( same, "layers read back are identical" ) ;
+
+    std::ofstream( "TestFastSimGeometry.txt" ) << "not a geometry" ;
+    bool rejected = false ;
+    try{
+      lcgeo::FastSimGeometry::read( "TestFastSimGeometry.txt" ) ;
+    } catch( const std::exception& ){
+      rejected = true ;
+    }
+    test( rejected, "file without magic is rejected" ) ;
+  }
+
+  void testPlugin( const char* compactFile ){
+
+    dd4hep::Detector& theDetector = dd4hep::Detector::getInstance() ;
+    theDetector.fromCompact( compactFile ) ;
+
+    const char* args[] = { "-output", "TestFastSimGeometry_model.fsgeo" } ;
+    const long ok = theDetector.apply( "lcgeo_FastSimGeometry", 2, const_cast<char**>( args ) ) ;
+    test( ok == 1, "plugin lcgeo_FastSimGeometry" ) ;
+
+    const lcgeo::FastSimGeometry geo = lcgeo::FastSimGeometry::read( "TestFastSimGeometry_model.fsgeo" ) ;
+    int nTracker = 0, nCalo = 0, nTrackerMaterial = 0 ;
+    for( const lcgeo::FastSimGeometry::Layer& l : geo.layers() ){
+      const bool tracker = l.type == lcgeo::FastSimGeometry::TrackerBarrel || l.type == lcgeo::FastSimGeometry::TrackerEndcap ;
+      nTracker += tracker ;
+      nCalo += ! tracker ;
+      nTrackerMaterial += tracker && l.radiationLengths > 0. ;
+    }
+    std::stringstream msg ;
+    msg << geo.detectors().size() << " subdetectors, " << nTracker << " tracker layers, " << nCalo << " calorimeter layers" ;
+    test( nTracker > 0 && nCalo > 0, msg.str() ) ;
+    test( nTrackerMaterial, nTracker, "tracker layers with material from the surfaces" ) ;
+  }
+}
+
+int main( int argc, char** argv ){
+
+  try{
+    testRoundTrip() ;
+    if( argc > 1 ) testPlugin( argv[1] ) ;
+  } catch( std::exception &e ){
+    test.log( e.what() );
+    test.error( "exception occurred" );
+  }
+
+  return 0;
+}
@@ -0,0 +1,101 @@
+// Test of lcgeo::GuineaPigPairFile:
+//  - numbers have to be parsed to the same doubles as with strtod
+//  - a pair file read in chunks and on several threads has to give the particles of the file in order,
+//    empty lines are skipped and lines that are not seven numbers are rejected
+//
+// usage: TestGuineaPigPairs
+
+#include "GuineaPigPairs.h"
+
+#include <DD4hep/DDTest.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static dd4hep::DDTest test( "GuineaPigPairs" ) ;
+
+namespace {
+
+  void testParseDouble(){
+    const char* numbers[] = { "0", "-1", "+2.5", "0.000123456789", "-1.234567890123e-05", "6.02214076E23", ".5",
+			      "123456789012345678901234", "1.00000000000000000001", "-7.5e-310", "4.9406564584124654e-324" } ;
+    int nSame = 0 ;
+    for( const char* s : numbers ){
+      double value = 0. ;
+      const char* end = lcgeo::GuineaPigPairFile::parseDouble( s, s + std::strlen( s ), value ) ;
+      nSame += ( end == s + std::strlen( s ) && value == std::strtod( s, 0 ) ) ;
+    }
+    test( nSame, int( sizeof(numbers) / sizeof(numbers[0]) ), "numbers parsed as with strtod" ) ;
+
+    double value = 0. ;
+    const char* text = "  x" ;
+    test( lcgeo::GuineaPigPairFile::parseDouble( text, text + 3, value ) == 0, "no number" ) ;
+  }
+
+  void testFile(){
+
+    const int nParticles = 20000 ;
+    std::vector<lcgeo::GuineaPigParticle> written ;
+    {
+      std::mt19937 rng( 4711 ) ;
+      std::uniform_real_distribution<double> u( -1., 1. ) ;
+      std::ofstream out( "TestGuineaPigPairs.pair" ) ;
+      out << std::setprecision( 10 ) ;
+      for( int i = 0 ; i < nParticles ; ++i ){
+	std::stringstream line ;
+	line << std::setprecision( 10 ) << 10. * u( rng ) << " " << u( rng ) << " " << u( rng ) << " " << u( rng ) << " "
+	     << 1e4 * u( rng ) << " " << 1e3 * u( rng ) << " " << std::scientific << 1e6 * u( rng ) ;
+	lcgeo::GuineaPigParticle p ;
+	std::stringstream( line.str() ) >> p.energy >> p.betaX >> p.betaY >> p.betaZ >> p.x >> p.y >> p.z ;
+	written.push_back( p ) ;
+	out << "  " << line.str() << ( i % 1000 == 0 ? "\n\n" : "\n" ) ;
+      }
+    }
+
+    for( unsigned nThreads : { 1u, 4u } ){
+      for( std::size_t chunk : { std::size_t( 0 ), std::size_t( 777 ) } ){
+	lcgeo::GuineaPigPairFile file( "TestGuineaPigPairs.pair" ) ;
+	std::vector<lcgeo::GuineaPigParticle> particles, read ;
+	while( file.read( particles, chunk, nThreads ) ) read.insert( read.end(), particles.begin(), particles.end() ) ;
+
+	bool same = read.size() == written.size() ;
+	for( std::size_t i = 0 ; same && i < read.size() ; ++i )
+	  same = std::memcmp( &read[i], &written[i], sizeof(lcgeo::GuineaPigParticle) ) == 0 ;
+	std::stringstream msg ;
+	msg << read.size() << " particles read in chunks of " << chunk << " lines with " << nThreads << " threads" ;
+	test( same, msg.str() ) ;
+      }
+    }
+
+    std::ofstream( "TestGuineaPigPairs_bad.pair" ) << "1 0 0 1 0 0 0\n1 0 0 1 0 0\n" ;
+    bool rejected = false ;
+    try{
+      lcgeo::GuineaPigPairFile file( "TestGuineaPigPairs_bad.pair" ) ;
+      std::vector<lcgeo::GuineaPigParticle> particles ;
+      file.read( particles ) ;
+    } catch( const std::exception& ){
+      rejected = true ;
+    }
+    test( rejected, "line with six numbers is rejected" ) ;
+  }
+}
+
+int main(){
+
+  try{
+    testParseDouble() ;
+    testFile() ;
+  } catch( std::exception &e ){
+    test.log( e.what() );
+    test.error( "exception occurred" );
+  }
+
+  return 0;
+}
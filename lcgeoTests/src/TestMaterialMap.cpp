@@ -0,0 +1,173 @@
+// Test of lcgeo::MaterialMap and the plugin lcgeo_MaterialMap:
+//  - a map written and read back has to be identical, files with a wrong magic, format version or size are rejected
+//  - with the compact file lcgeoTests/compact/MaterialMapTest.xml (tubes on the cell boundaries, so that every cell
+//    has a single material) the material of the map has to be the material found by the navigation at random points
+//
+// usage: TestMaterialMap [MaterialMapTest.xml]
+
+#include "MaterialMap.h"
+
+#include <DD4hep/DD4hepUnits.h>
+#include <DD4hep/DDTest.h>
+#include <DD4hep/DetElement.h>
+#include <DD4hep/Detector.h>
+
+#include <TGeoManager.h>
+#include <TGeoMaterial.h>
+#include <TGeoMedium.h>
+#include <TGeoNavigator.h>
+#include <TGeoNode.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+
+static dd4hep::DDTest test( "MaterialMap" ) ;
+
+namespace {
+
+  bool sameCells( const lcgeo::MaterialMap& a, const lcgeo::MaterialMap& b ){
+    if( a.nR() != b.nR() || a.nZ() != b.nZ() ) return false ;
+    for( int iz = 0 ; iz < a.nZ() ; ++iz )
+      for( int ir = 0 ; ir < a.nR() ; ++ir )
+	if( std::memcmp( &a.cell( ir, iz ), &b.cell( ir, iz ), sizeof(lcgeo::MaterialMap::Cell) ) != 0 ) return false ;
+    return true ;
+  }
+
+  bool rejected( const std::string& fileName ){
+    try{
+      lcgeo::MaterialMap::read( fileName ) ;
+    } catch( const lcgeo::GeometryException& ){
+      return true ;
+    }
+    return false ;
+  }
+
+  /// copy of the file with the bytes from position pos replaced by bytes (or cut at pos if bytes is empty)
+  void writeModified( const std::string& in, const std::string& out, std::size_t pos, const std::string& bytes ){
+    std::ifstream input( in, std::ios::binary ) ;
+    std::string content( ( std::istreambuf_iterator<char>( input ) ), std::istreambuf_iterator<char>() ) ;
+    if( bytes.empty() ) content.resize( pos ) ;
+    else content.replace( pos, bytes.size(), bytes ) ;
+    std::ofstream( out, std::ios::binary ) << content ;
+  }
+
+  void testRoundTrip(){
+
+    lcgeo::MaterialMap map( 20, 100. * dd4hep::cm, 30, 200. * dd4hep::cm ) ;
+    map.setModel( "TestModel" ) ;
+    map.setValidation( 0.01, 0.05 ) ;
+    for( int iz = 0 ; iz < map.nZ() ; ++iz ){
+      for( int ir = 0 ; ir < map.nR() ; ++ir ){
+	lcgeo::MaterialMap::Cell& c = map.cell( ir, iz ) ;
+	c.density = 0.1f * ir + 0.01f * iz ;
+	c.invX0 = 1.f / ( 1.f + ir + iz ) ;
+	c.invLambda = 0.5f * c.invX0 ;
+	c.ZoverA = 0.5f ;
+      }
+    }
+
+    map.write( "TestMaterialMap.bin" ) ;
+    const lcgeo::MaterialMap read = lcgeo::MaterialMap::read( "TestMaterialMap.bin" ) ;
+
+    test( read.nR() == map.nR() && read.nZ() == map.nZ() && read.rMax() == map.rMax() && read.zMax() == map.zMax(),
+	  "binning read back" ) ;
+    test( read.model(), map.model(), "model read back" ) ;
+    test( read.meanRelativeError() == map.meanRelativeError() && read.maxRelativeError() == map.maxRelativeError(),
+	  "validation read back" ) ;
+    test( sameCells( read, map ), "cells read back are identical" ) ;
+
+    std::string reason ;
+    test( read.isCompatible( "TestModel", 100. * dd4hep::cm, 200. * dd4hep::cm, 20, 30, reason ), "compatible map" ) ;
+    test( ! read.isCompatible( "OtherModel", 100. * dd4hep::cm, 200. * dd4hep::cm, 0, 0, reason ), "map of another model" ) ;
+    test( ! read.isCompatible( "TestModel", 120. * dd4hep::cm, 200. * dd4hep::cm, 0, 0, reason ), "map with another extent" ) ;
+    test( ! read.isCompatible( "TestModel", 100. * dd4hep::cm, 200. * dd4hep::cm, 40, 30, reason ), "map with another binning" ) ;
+
+    std::ofstream( "TestMaterialMap.txt" ) << "not a material map" ;
+    test( rejected( "TestMaterialMap.txt" ), "file without magic is rejected" ) ;
+
+    const std::uint32_t version = 1 ;
+    writeModified( "TestMaterialMap.bin", "TestMaterialMap_version.bin", 8,
+		   std::string( reinterpret_cast<const char*>( &version ), sizeof(version) ) ) ;
+    test( rejected( "TestMaterialMap_version.bin" ), "file with another format version is rejected" ) ;
+
+    const int nR = 40 ;
+    writeModified( "TestMaterialMap.bin", "TestMaterialMap_binning.bin", 16,
+		   std::string( reinterpret_cast<const char*>( &nR ), sizeof(nR) ) ) ;
+    test( rejected( "TestMaterialMap_binning.bin" ), "file shorter than its binning is rejected" ) ;
+
+    writeModified( "TestMaterialMap.bin", "TestMaterialMap_truncated.bin", 100, "" ) ;
+    test( rejected( "TestMaterialMap_truncated.bin" ), "truncated file is rejected" ) ;
+
+    std::ofstream( "TestMaterialMap_long.bin", std::ios::binary )
+      << std::ifstream( "TestMaterialMap.bin", std::ios::binary ).rdbuf() << "x" ;
+    test( rejected( "TestMaterialMap_long.bin" ), "file longer than its binning is rejected" ) ;
+  }
+
+  void testNavigation( const char* compactFile ){
+
+    dd4hep::Detector& theDetector = dd4hep::Detector::getInstance() ;
+    theDetector.fromCompact( compactFile ) ;
+
+    const char* args[] = { "-nr", "50", "-nz", "50", "-rmax", "500*mm", "-zmax", "500*mm", "-validate", "0",
+			   "-write", "TestMaterialMap_model.bin" } ;
+    const long ok = theDetector.apply( "lcgeo_MaterialMap", 12, const_cast<char**>( args ) ) ;
+    test( ok == 1, "plugin lcgeo_MaterialMap" ) ;
+
+    const lcgeo::MaterialMap* map = theDetector.world().extension<lcgeo::MaterialMap>() ;
+    const lcgeo::MaterialMap read = lcgeo::MaterialMap::read( "TestMaterialMap_model.bin" ) ;
+    test( sameCells( read, *map ), "map of the model read back is identical" ) ;
+    std::string reason ;
+    test( read.isCompatible( "MaterialMapTest", 500. * dd4hep::mm, 500. * dd4hep::mm, 50, 50, reason ),
+	  "map of the model is compatible with the model" ) ;
+
+    TGeoNavigator* nav = theDetector.manager().GetCurrentNavigator() ;
+    std::mt19937 rng( 4711 ) ;
+    std::uniform_real_distribution<double> uniform( 0., 1. ) ;
+
+    const int nPoints = 10000 ;
+    int nDifferent = 0, nMaterial = 0 ;
+    for( int i = 0 ; i < nPoints ; ++i ){
+      const double r = map->rMax() * std::sqrt( uniform( rng ) ) ;
+      const double phi = 2. * M_PI * uniform( rng ) ;
+      const double p[3] = { r * std::cos( phi ), r * std::sin( phi ), map->zMax() * ( 2. * uniform( rng ) - 1. ) } ;
+
+      const TGeoMaterial* mat = nav->FindNode( p[0], p[1], p[2] )->GetMedium()->GetMaterial() ;
+      const lcgeo::MaterialMap::Cell& cell = map->cell( p ) ;
+
+      nMaterial += mat->GetDensity() > 1. ;
+      const bool same = std::fabs( cell.density - mat->GetDensity() ) <= 1e-5 * mat->GetDensity()
+	&& std::fabs( cell.invX0 - 1. / mat->GetRadLen() ) <= 1e-5 / mat->GetRadLen() ;
+      if( ! same && nDifferent++ < 10 ){
+	std::stringstream msg ;
+	msg << " at (" << p[0] << ", " << p[1] << ", " << p[2] << ") the navigation finds " << mat->GetName()
+	    << " with density " << mat->GetDensity() << ", X0 " << mat->GetRadLen() << " - the map has density "
+	    << cell.density << ", 1/X0 " << cell.invX0 ;
+	test.log( msg.str() ) ;
+      }
+    }
+    std::stringstream msg ;
+    msg << nDifferent << " of " << nPoints << " random points with a different material in the map and the navigation ("
+	<< nMaterial << " points in the tubes)" ;
+    test( nDifferent == 0 && nMaterial > 0, msg.str() ) ;
+  }
+}
+
+int main( int argc, char** argv ){
+
+  try{
+    testRoundTrip() ;
+    if( argc > 1 ) testNavigation( argv[1] ) ;
+  } catch( std::exception &e ){
+    test.log( e.what() );
+    test.error( "exception occurred" );
+  }
+
+  return 0;
+}
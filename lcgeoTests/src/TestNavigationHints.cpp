@@ -0,0 +1,141 @@
+// Test of the Geant4 navigation hints (lcgeo::NavigationHints and the DDG4 action NavigationHintsAction), and the
+// tool for measuring their effect:
+//  - the geometry of the compact file is converted to Geant4 with NavigationHintsAction, then every volume tagged by
+//    the drivers has to have the smartless value of its hint in its G4LogicalVolume - with --no-hints the action is
+//    not used and the tagged volumes have to keep the Geant4 default
+//  - with --report-voxels the action closes the geometry before and after applying the hints, Geant4 prints the
+//    voxel memory and the action the time for closing
+//  - with --events n the time per event for n isotropic particles from the IP is printed, without sensitive
+//    detectors, i.e. mostly the time for the navigation and the physics. Compare two runs with and without
+//    --no-hints for the effect of the hints on the step time.
+//
+// usage: TestNavigationHints [--no-hints] [--report-voxels] [--events n] [--particle pi+] [--energy GeV]
+//                            [--physics QGSP_BERT] compact.xml
+
+#include "NavigationHints.h"
+
+#include <DD4hep/DDTest.h>
+#include <DD4hep/Detector.h>
+#include <DDG4/Geant4DetectorConstruction.h>
+#include <DDG4/Geant4GeneratorAction.h>
+#include <DDG4/Geant4GeometryInfo.h>
+#include <DDG4/Geant4Handle.h>
+#include <DDG4/Geant4Kernel.h>
+#include <DDG4/Geant4Mapping.h>
+#include <DDG4/Geant4PhysicsList.h>
+
+#include <CLHEP/Units/SystemOfUnits.h>
+#include <G4LogicalVolume.hh>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace dd4hep::sim ;
+
+static dd4hep::DDTest test( "NavigationHints" ) ;
+
+int main( int argc, char** argv ){
+
+  bool applyHints = true, reportVoxels = false ;
+  int nEvents = 0 ;
+  std::string particle = "pi+", physics = "QGSP_BERT", compactFile ;
+  double energy = 10. ;
+
+  for( int i = 1 ; i < argc ; ++i ){
+    std::string arg( argv[i] ) ;
+    if     ( arg == "--no-hints" )                     applyHints = false ;
+    else if( arg == "--report-voxels" )                reportVoxels = true ;
+    else if( arg == "--events"   && i + 1 < argc )     nEvents = std::atoi( argv[++i] ) ;
+    else if( arg == "--particle" && i + 1 < argc )     particle = argv[++i] ;
+    else if( arg == "--energy"   && i + 1 < argc )     energy = std::atof( argv[++i] ) ;
+    else if( arg == "--physics"  && i + 1 < argc )     physics = argv[++i] ;
+    else compactFile = arg ;
+  }
+
+  if( compactFile.empty() ){
+    std::cout << " usage: TestNavigationHints [--no-hints] [--report-voxels] [--events n] [--particle pi+] [--energy GeV]\n"
+	      << "                            [--physics QGSP_BERT] compact.xml" << std::endl ;
+    return 1 ;
+  }
+
+  try{
+    Geant4Kernel& kernel = Geant4Kernel::instance( dd4hep::Detector::getInstance() ) ;
+    kernel.loadGeometry( "file:" + compactFile ) ;
+
+    Geant4DetectorConstructionSequence* construction = kernel.detectorConstruction( true ) ;
+    Geant4Handle<Geant4DetectorConstruction> geometry( kernel, "Geant4DetectorGeometryConstruction/ConstructGeo" ) ;
+    construction->adopt( geometry ) ;
+    if( applyHints ){
+      Geant4Handle<Geant4DetectorConstruction> hints( kernel, "NavigationHintsAction/NavigationHints" ) ;
+      hints["ReportVoxels"] = reportVoxels ;
+      construction->adopt( hints ) ;
+    }
+
+    kernel.physicsList().property( "extends" ).set( physics ) ;
+
+    Geant4GeneratorActionSequence& gen = kernel.generatorAction() ;
+    Geant4Handle<Geant4GeneratorAction> init( kernel, "Geant4GeneratorActionInit/GenerationInit" ) ;
+    gen.adopt( init ) ;
+    Geant4Handle<Geant4GeneratorAction> gun( kernel, "Geant4IsotropeGenerator/Gun" ) ;
+    gun["Particle"] = particle ;
+    gun["Energy"] = energy * CLHEP::GeV ;
+    gun["Multiplicity"] = 1 ;
+    gen.adopt( gun ) ;
+    Geant4Handle<Geant4GeneratorAction> merger( kernel, "Geant4InteractionMerger/InteractionMerger" ) ;
+    gen.adopt( merger ) ;
+    Geant4Handle<Geant4GeneratorAction> primaries( kernel, "Geant4PrimaryHandler/PrimaryHandler" ) ;
+    gen.adopt( primaries ) ;
+
+    kernel.configure() ;
+    kernel.initialize() ;
+
+    //--- the smartless values of the tagged volumes in Geant4
+    const auto& g4Volumes = Geant4Mapping::instance().data().g4Volumes ;
+    const double g4Default = 2. ; // G4LogicalVolume default
+    long nTagged = 0, nMissing = 0, nDiffer = 0 ;
+    for( const auto& c : kernel.detectorDescription().world().children() ){
+      const lcgeo::NavigationHints* hints = c.second.extension<lcgeo::NavigationHints>( false ) ;
+      if( ! hints ) continue ;
+      for( const lcgeo::NavigationHints::Hint& h : hints->hints() ){
+	auto it = g4Volumes.find( h.volume.ptr() ) ;
+	if( it == g4Volumes.end() ){
+	  ++nMissing ;
+	  continue ;
+	}
+	++nTagged ;
+	// G4LogicalVolume stores the value as float
+	const double expected = applyHints ? h.smartless : g4Default ;
+	if( std::fabs( it->second->GetSmartless() - expected ) > 1e-6 * expected ){
+	  ++nDiffer ;
+	  test.log( c.first + ": unexpected smartless value of " + h.volume.name() + " (" + h.kind + ")" ) ;
+	}
+      }
+    }
+    std::stringstream msg ;
+    msg << nDiffer << " of " << nTagged << " tagged G4LogicalVolumes have a smartless value different from "
+	<< ( applyHints ? "their hint" : "the Geant4 default" ) << " (" << nMissing << " tagged volumes not in Geant4)" ;
+    test( nTagged > 0 && nDiffer == 0, msg.str() ) ;
+
+    //--- time per event
+    if( nEvents > 0 ){
+      auto start = std::chrono::steady_clock::now() ;
+      kernel.runEvents( nEvents ) ;
+      const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count() ;
+      std::cout << " TestNavigationHints: " << nEvents << " events of " << particle << " at " << energy << " GeV "
+		<< ( applyHints ? "with" : "without" ) << " navigation hints: " << 1e3 * seconds / nEvents
+		<< " ms/event" << std::endl ;
+    }
+    kernel.terminate() ;
+
+  } catch( std::exception &e ){
+    test.log( e.what() );
+    test.error( "exception occurred" );
+  }
+
+  return 0;
+}
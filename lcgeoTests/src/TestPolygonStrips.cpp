@@ -0,0 +1,152 @@
+// Test the replacement of a layer box with three box shaped cut outs (Boolean subtractions as in
+// SServices00 CutLayer) by extruded polygons from lcgeo::subtractStrips:
+//  - the volumes of both representations have to agree
+//  - random points have to be inside/outside of both representations
+// The time needed for TGeo 'Contains' and 'DistFromInside' queries is printed for both.
+
+#include "PolygonStrips.h"
+
+#include <DD4hep/DDTest.h>
+
+#include <TGeoBBox.h>
+#include <TGeoBoolNode.h>
+#include <TGeoCompositeShape.h>
+#include <TGeoManager.h>
+#include <TGeoMatrix.h>
+#include <TGeoXtru.h>
+#include <TRandom3.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+static dd4hep::DDTest test( "PolygonStrips" ) ;
+
+namespace {
+
+  struct CutLayer {
+    double halfX, halfY, halfZ ;  // layer box
+    double xShift, yShift ;       // position of the side cut outs
+    double halfWidth, halfLength ; // cut out boxes
+  };
+
+  double timeQueries( const std::vector<TGeoShape*>& shapes, const std::vector<std::vector<double> >& points ){
+    auto start = std::chrono::steady_clock::now() ;
+    double dummy = 0. ;
+    const double dir[3] = { 0.6, 0.8, 0. } ;
+    for( const auto& p : points ){
+      for( TGeoShape* s : shapes ){
+	if( s->Contains( p.data() ) ){
+	  dummy += s->DistFromInside( p.data(), dir ) ;
+	  break ;
+	}
+      }
+    }
+    auto end = std::chrono::steady_clock::now() ;
+    if( dummy < 0. ) std::cout << dummy ;
+    return std::chrono::duration<double, std::micro>( end - start ).count() / points.size() ;
+  }
+
+  void checkLayer( const CutLayer& l ){
+
+    const double angle = M_PI/8. ;
+
+    // --- Boolean version as in SServices00 ---
+    TGeoBBox* layerBox = new TGeoBBox( l.halfX, l.halfY, l.halfZ ) ;
+    TGeoBBox* cutBox = new TGeoBBox( l.halfWidth, l.halfLength, 2. * l.halfZ ) ;
+
+    TGeoRotation* rotRight = new TGeoRotation ; rotRight->RotateZ( -angle * 180. / M_PI ) ;
+    TGeoRotation* rotLeft  = new TGeoRotation ; rotLeft->RotateZ(  angle * 180. / M_PI ) ;
+
+    TGeoSubtraction* right = new TGeoSubtraction( layerBox, cutBox, nullptr, new TGeoCombiTrans(  l.xShift, l.yShift, 0., rotRight ) ) ;
+    TGeoCompositeShape* cutRight = new TGeoCompositeShape( "cutRight", right ) ;
+    TGeoSubtraction* left = new TGeoSubtraction( cutRight, cutBox, nullptr, new TGeoCombiTrans( -l.xShift, l.yShift, 0., rotLeft ) ) ;
+    TGeoCompositeShape* cutLeft = new TGeoCompositeShape( "cutLeft", left ) ;
+    TGeoSubtraction* center = new TGeoSubtraction( cutLeft, cutBox, nullptr, new TGeoTranslation( 0., l.yShift, 0. ) ) ;
+    TGeoCompositeShape* booleanLayer = new TGeoCompositeShape( "cutLayer", center ) ;
+
+    // --- extruded polygons ---
+    std::vector<lcgeo::Strip2D> strips = {
+      {  l.xShift, l.yShift, cos(angle), -sin(angle), l.halfWidth },
+      { -l.xShift, l.yShift, cos(angle),  sin(angle), l.halfWidth },
+      {        0., l.yShift, 1., 0., l.halfWidth } } ;
+
+    lcgeo::Polygon2D layer = { {-l.halfX,-l.halfY}, {-l.halfX,l.halfY}, {l.halfX,l.halfY}, {l.halfX,-l.halfY} } ;
+
+    std::vector<lcgeo::Polygon2D> pieces = lcgeo::subtractStrips( layer, strips, 1e-8 ) ;
+
+    std::vector<TGeoShape*> xtrus ;
+    double area = 0. ;
+    for( const auto& piece : pieces ){
+      std::vector<double> px, py ;
+      for( const auto& p : piece ){ px.push_back( p.x ) ; py.push_back( p.y ) ; }
+      TGeoXtru* xtru = new TGeoXtru( 2 ) ;
+      xtru->DefinePolygon( px.size(), px.data(), py.data() ) ;
+      xtru->DefineSection( 0, -l.halfZ ) ;
+      xtru->DefineSection( 1,  l.halfZ ) ;
+      xtrus.push_back( xtru ) ;
+      area += std::fabs( lcgeo::polygonArea( piece ) ) ;
+
+      test( lcgeo::polygonArea( piece ) < 0., "piece is clockwise" ) ;
+    }
+
+    // --- compare with random points ---
+    TRandom3 rnd( 4711 ) ;
+    const int nPoints = 200000 ;
+    int nInside = 0, nMismatch = 0 ;
+    std::vector<std::vector<double> > points ;
+    points.reserve( nPoints ) ;
+
+    for( int i = 0 ; i < nPoints ; ++i ){
+      std::vector<double> p = { rnd.Uniform( -l.halfX, l.halfX ), rnd.Uniform( -l.halfY, l.halfY ), rnd.Uniform( -l.halfZ, l.halfZ ) } ;
+      points.push_back( p ) ;
+
+      bool inBoolean = booleanLayer->Contains( p.data() ) ;
+      bool inXtru = false ;
+      for( TGeoShape* s : xtrus ) inXtru = inXtru || s->Contains( p.data() ) ;
+
+      // ignore points that are (numerically) on a surface
+      if( inBoolean != inXtru && booleanLayer->Safety( p.data(), inBoolean ) > 1e-9 ) ++nMismatch ;
+      nInside += inBoolean ;
+    }
+
+    const double boxVolume = 8. * l.halfX * l.halfY * l.halfZ ;
+    const double mcVolume = boxVolume * nInside / nPoints ;
+    const double xtruVolume = area * 2. * l.halfZ ;
+
+    std::stringstream msg ;
+    msg << " pieces: " << pieces.size() << " volume boolean (MC): " << mcVolume << " extruded: " << xtruVolume ;
+    // MC uncertainty of the volume of the Boolean solid
+    test( std::fabs( mcVolume - xtruVolume ) < 5. * boxVolume / std::sqrt( nPoints ) + 1e-9, msg.str() ) ;
+
+    msg.str("") ;
+    msg << " points inside only one of the two representations: " << nMismatch ;
+    test( nMismatch == 0, msg.str() ) ;
+
+    std::vector<TGeoShape*> booleans( 1, booleanLayer ) ;
+    std::cout << " time per query [us] - boolean: " << timeQueries( booleans, points )
+	      << " extruded polygons: " << timeQueries( xtrus, points ) << std::endl ;
+  }
+}
+
+
+int main() {
+
+  new TGeoManager( "TestPolygonStrips", "TestPolygonStrips" ) ;
+
+  try{
+    // typical layers of the Hcal electronics interface (all cut outs inside the layer)
+    checkLayer( { 1000., 1.0, 10., 900., 40., 12., 1300. } ) ;
+    // cut outs at the edge of the layer and overlapping cut outs
+    checkLayer( {  900., 0.5, 10., 890., 10., 30., 1300. } ) ;
+    checkLayer( {   60., 2.0,  5.,  30.,  0., 25.,  500. } ) ;
+
+  } catch( std::exception &e ){
+    test.log( e.what() );
+    test.error( "exception occurred" );
+  }
+
+  return 0;
+}
@@ -0,0 +1,124 @@
+// Test of lcgeo::SensorLayout against the DDRec surfaces of the trackers:
+//  - the analytic transformation of every sensor has to reproduce origin and normal of its surface
+//  - the time per analytic lookup of random sensors is printed next to a map lookup
+//
+// usage: TestSensorLayout compact.xml [nQueries]
+
+#include "BenchmarkUtils.h"
+#include "SensorLayout.h"
+
+#include <DD4hep/DDTest.h>
+#include <DD4hep/Detector.h>
+#include <DDRec/SurfaceHelper.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static dd4hep::DDTest test( "SensorLayout" ) ;
+
+using lcgeo::benchmark::clock_type ;
+using lcgeo::benchmark::nanoSeconds ;
+
+namespace {
+
+  double distance( const double* a, const dd4hep::rec::Vector3D& b ){
+    return std::sqrt( ( a[0] - b.x() ) * ( a[0] - b.x() ) + ( a[1] - b.y() ) * ( a[1] - b.y() ) + ( a[2] - b.z() ) * ( a[2] - b.z() ) ) ;
+  }
+}
+
+int main( int argc, char** argv ){
+
+  if( argc < 2 ){
+    std::cout << " usage: TestSensorLayout compact.xml [nQueries]" << std::endl ;
+    return 1 ;
+  }
+  const int nQueries = argc > 2 ? std::atoi( argv[2] ) : 1000000 ;
+  const double epsilon = 1.e-6 * dd4hep::mm ;
+
+  try{
+    dd4hep::Detector& theDetector = dd4hep::Detector::getInstance() ;
+    theDetector.fromCompact( argv[1] ) ;
+
+    int nDetectors = 0 ;
+    for( const auto& c : theDetector.world().children() ){
+
+      const dd4hep::DetElement& det = c.second ;
+      const lcgeo::SensorLayout* layout = det.extension<lcgeo::SensorLayout>( false ) ;
+      if( ! layout ) continue ;
+      ++nDetectors ;
+
+      const TGeoHMatrix& world = det.nominal().worldTransformation() ;
+
+      dd4hep::rec::SurfaceHelper ds( det ) ;
+      int nSurfaces = 0, nOutside = 0, nOrigin = 0, nNormal = 0 ;
+      std::map<dd4hep::CellID, dd4hep::rec::Vector3D> origins ;
+      std::vector<dd4hep::CellID> ids ;
+
+      for( const dd4hep::rec::ISurface* s : ds.surfaceList() ){
+	if( ! s->type().isSensitive() ) continue ;
+	++nSurfaces ;
+	const dd4hep::CellID id = s->id() ;
+	if( ! layout->contains( id ) ){
+	  ++nOutside ;
+	  continue ;
+	}
+	ids.push_back( id ) ;
+	origins[id] = s->origin() ;
+
+	const dd4hep::Transform3D t = layout->sensorTransform( id ) ;
+	const dd4hep::Position o = t * dd4hep::Position( 0., 0., 0. ) ;
+	const dd4hep::Position n = t.Rotation() * dd4hep::Position( 0., 0., 1. ) ;
+	const double local[3] = { o.x() / dd4hep::cm, o.y() / dd4hep::cm, o.z() / dd4hep::cm } ;
+	const double localN[3] = { n.x(), n.y(), n.z() } ;
+	double global[3], globalN[3] ;
+	world.LocalToMaster( local, global ) ;
+	world.LocalToMasterVect( localN, globalN ) ;
+	for( double& x : global ) x *= dd4hep::cm ;
+
+	if( distance( global, s->origin() ) > epsilon ) ++nOrigin ;
+	if( distance( globalN, s->normal() ) > 1.e-9 ) ++nNormal ;
+      }
+
+      std::stringstream msg ;
+      msg << c.first << ": " << nSurfaces << " sensitive surfaces, " << ids.size() << " in the layout of "
+	  << layout->numberOfSensors() << " sensors" ;
+      test( nOutside, 0, msg.str() + " - surfaces not in the layout" ) ;
+      test( nOrigin, 0, c.first + ": origins that differ from the surfaces" ) ;
+      test( nNormal, 0, c.first + ": normals that differ from the surfaces" ) ;
+      if( ids.empty() ) continue ;
+
+      //--- random lookups
+      std::mt19937 rng = lcgeo::benchmark::randomEngine() ;
+      const std::vector<dd4hep::CellID> queries = lcgeo::benchmark::sample( ids, nQueries, rng ) ;
+
+      double sumMap = 0., sumLayout = 0. ;
+      auto start = clock_type::now() ;
+      for( dd4hep::CellID q : queries ) sumMap += origins.find( q )->second.z() ;
+      const double tMap = nanoSeconds( start, nQueries ) ;
+
+      start = clock_type::now() ;
+      for( dd4hep::CellID q : queries ) sumLayout += layout->sensorTransform( q ).Translation().Vect().z() ;
+      const double tLayout = nanoSeconds( start, nQueries ) ;
+
+      // the sums are printed so that the lookups are not optimised away
+      std::stringstream sums ;
+      sums << "(" << sumMap << ", " << sumLayout << ")" ;
+      lcgeo::benchmark::report( c.first, "ns/lookup", { { "map", tMap }, { "layout", tLayout } }, sums.str() ) ;
+    }
+
+    test( nDetectors > 0, "subdetectors with sensor layouts" ) ;
+
+  } catch( std::exception &e ){
+    test.log( e.what() );
+    test.error( "exception occurred" );
+  }
+
+  return 0;
+}
@@ -0,0 +1,66 @@
+// Test of XMLHandlerDB, the parameter table of the Mokka ported drivers:
+//  - doubles (with units), ints, bools and strings are read from the attributes, also when fetched again
+//  - copies of the handler share the table, parameters that have not been fetched are reported as unused
+//  - fetching a parameter that does not exist throws a lcgeo::GeometryException
+//
+// usage: TestXMLHandlerDB
+
+#include "XMLHandlerDB.h"
+
+#include <DD4hep/DD4hepUnits.h>
+#include <DD4hep/DDTest.h>
+#include <DD4hep/Detector.h>
+#include <XML/DocumentHandler.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <vector>
+
+static dd4hep::DDTest test( "XMLHandlerDB" ) ;
+
+int main( int, char** ){
+
+  try{
+    // the expression evaluator with the units
+    dd4hep::Detector::getInstance() ;
+
+    const char* xml = "<global TPC_pad_height=\"6*mm\" number_of_rows=\"220\" TPC_pad_row_doublets=\"false\""
+      " chamber_Gas=\"TDR_gas\" dr_InnerWall=\"25*mm\"/>" ;
+    dd4hep::xml::DocumentHolder doc( dd4hep::xml::DocumentHandler().parse( xml, std::strlen( xml ) ) ) ;
+    xml_comp_t x_global( doc.root() ) ;
+
+    XMLHandlerDB db( x_global ) ;
+
+    test( std::fabs( db->fetchDouble( "TPC_pad_height" ) - 6. * dd4hep::mm ) < 1e-12, "double with units" ) ;
+    test( std::fabs( db->fetchDouble( "TPC_pad_height" ) - 6. * dd4hep::mm ) < 1e-12, "double fetched again" ) ;
+    test( db->fetchInt( "number_of_rows" ), 220, "int" ) ;
+    test( db->fetchInt( "number_of_rows" ), 220, "int fetched again" ) ;
+    test( db->fetchBool( "TPC_pad_row_doublets" ), false, "bool" ) ;
+    test( db->hasParameter( "dr_InnerWall" ) && ! db->hasParameter( "dr_OuterWall" ), "hasParameter" ) ;
+
+    // a copy shares the table
+    XMLHandlerDB copy = db ;
+    test( copy->fetchString( "chamber_Gas" ), std::string( "TDR_gas" ), "string from a copy" ) ;
+
+    const std::vector<std::string> unused = db.unusedParameters() ;
+    test( unused.size() == 1 && unused[0] == "dr_InnerWall", "dr_InnerWall is the only unused parameter" ) ;
+
+    bool thrown = false ;
+    try{
+      db->fetchDouble( "dr_OuterWall" ) ;
+    } catch( const lcgeo::GeometryException& e ){
+      thrown = std::string( e.what() ).find( "dr_OuterWall" ) != std::string::npos ;
+    }
+    test( thrown, "unknown parameter throws a GeometryException naming it" ) ;
+    test( db.unusedParameters().size(), std::size_t( 1 ), "unknown parameter is not added to the table" ) ;
+
+  } catch( std::exception &e ){
+    test.log( e.what() );
+    test.error( "exception occurred" );
+  }
+
+  return 0;
+}
@@ -0,0 +1,150 @@
+//==========================================================================
+// iLCSoft - linear collider geometry
+//--------------------------------------------------------------------------
+//
+// For the licensing terms see lcgeo/LICENSE.
+//
+//==========================================================================
+//
+// Boolean Solid Audit
+//
+// Lists all volumes of the geometry that have a Boolean (composite) shape
+// together with the nesting depth of the Boolean tree and the number of
+// logical and physical placements, i.e. the candidates for replacing them
+// with native shapes to speed up the navigation.
+//
+//==========================================================================
+
+#include <DD4hep/Detector.h>
+#include <DD4hep/Factories.h>
+#include <DD4hep/Printout.h>
+
+#include <TGeoBoolNode.h>
+#include <TGeoCompositeShape.h>
+#include <TGeoManager.h>
+#include <TGeoNode.h>
+#include <TGeoVolume.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+  struct BooleanVolume {
+    TGeoVolume* volume = nullptr ;
+    int depth = 0 ;               // nesting depth of the Boolean tree
+    int nSolids = 0 ;             // number of primitive solids in the tree
+    long logicalPlacements = 0 ;  // number of nodes (daughters) using the volume
+    double physicalPlacements = 0 ; // number of instances in the world volume
+  };
+
+  /// nesting depth and number of leaf solids of a (possibly Boolean) shape
+  void booleanDepth( const TGeoShape* shape, int& depth, int& nSolids ){
+    const TGeoCompositeShape* comp = dynamic_cast<const TGeoCompositeShape*>( shape ) ;
+    if( comp == nullptr ){
+      depth = 0 ;
+      nSolids = 1 ;
+      return ;
+    }
+    int dLeft = 0, nLeft = 0, dRight = 0, nRight = 0 ;
+    booleanDepth( comp->GetBoolNode()->GetLeftShape(),  dLeft,  nLeft ) ;
+    booleanDepth( comp->GetBoolNode()->GetRightShape(), dRight, nRight ) ;
+    depth = 1 + std::max( dLeft, dRight ) ;
+    nSolids = nLeft + nRight ;
+  }
+
+  const char* booleanOperation( const TGeoShape* shape ){
+    const TGeoCompositeShape* comp = static_cast<const TGeoCompositeShape*>( shape ) ;
+    switch( comp->GetBoolNode()->GetBooleanOperator() ){
+    case TGeoBoolNode::kGeoUnion:        return "union" ;
+    case TGeoBoolNode::kGeoSubtraction:  return "subtraction" ;
+    case TGeoBoolNode::kGeoIntersection: return "intersection" ;
+    }
+    return "unknown" ;
+  }
+
+  /// post-order traversal of the volume graph - reversed it is a topological order (mothers first)
+  void sortVolumes( TGeoVolume* vol, std::set<TGeoVolume*>& visited, std::vector<TGeoVolume*>& order ){
+    if( ! visited.insert( vol ).second ) return ;
+    for( int i = 0, n = vol->GetNdaughters() ; i < n ; ++i )
+      sortVolumes( vol->GetNode( i )->GetVolume(), visited, order ) ;
+    order.push_back( vol ) ;
+  }
+
+  /** Plugin for listing all Boolean solids of the geometry
+   *
+   * The volumes with a Boolean shape are printed ordered by the number of physical placements
+   * times the nesting depth of the Boolean tree, i.e. roughly by their impact on the navigation.
+   * Arguments are:
+   *  - -n <number>: print only the first number of volumes (default: all)
+   *
+   * Usage: geoPluginRun -input compact.xml -plugin lcgeo_BooleanSolidAudit [-n 50]
+   */
+  static long auditBooleanSolids(dd4hep::Detector& description, int argc, char** argv) {
+    const std::string LOG_SOURCE("BooleanSolidAudit");
+
+    unsigned maxPrint = 0 ;
+    for( int i = 0 ; i < argc ; ++i ){
+      if( std::string( argv[i] ) == "-n" && i + 1 < argc )
+	maxPrint = std::atoi( argv[++i] ) ;
+    }
+
+    TGeoVolume* top = description.manager().GetTopVolume() ;
+
+    std::set<TGeoVolume*> visited ;
+    std::vector<TGeoVolume*> order ;
+    sortVolumes( top, visited, order ) ;
+    std::reverse( order.begin(), order.end() ) ;
+
+    // propagate the number of instances from the world volume to the daughters
+    std::map<TGeoVolume*, double> instances ;
+    std::map<TGeoVolume*, long> nodes ;
+    instances[ top ] = 1. ;
+    for( TGeoVolume* vol : order ){
+      const double nMother = instances[ vol ] ;
+      for( int i = 0, n = vol->GetNdaughters() ; i < n ; ++i ){
+	TGeoVolume* dau = vol->GetNode( i )->GetVolume() ;
+	instances[ dau ] += nMother ;
+	nodes[ dau ] += 1 ;
+      }
+    }
+
+    std::vector<BooleanVolume> booleans ;
+    for( TGeoVolume* vol : order ){
+      if( dynamic_cast<const TGeoCompositeShape*>( vol->GetShape() ) == nullptr ) continue ;
+      BooleanVolume b ;
+      b.volume = vol ;
+      booleanDepth( vol->GetShape(), b.depth, b.nSolids ) ;
+      b.logicalPlacements = nodes[ vol ] ;
+      b.physicalPlacements = instances[ vol ] ;
+      booleans.push_back( b ) ;
+    }
+
+    std::sort( booleans.begin(), booleans.end(), []( const BooleanVolume& a, const BooleanVolume& b ){
+	return a.physicalPlacements * a.depth > b.physicalPlacements * b.depth ; } ) ;
+
+    double totalInstances = 0. ;
+    for( const auto& b : booleans ) totalInstances += b.physicalPlacements ;
+
+    dd4hep::printout( dd4hep::ALWAYS, LOG_SOURCE, "%zu volumes with Boolean shapes, %.0f physical instances",
+		      booleans.size(), totalInstances ) ;
+    dd4hep::printout( dd4hep::ALWAYS, LOG_SOURCE, "%-50s %-13s %6s %7s %10s %12s",
+		      "volume", "operation", "depth", "solids", "logical", "physical" ) ;
+
+    unsigned nPrint = 0 ;
+    for( const auto& b : booleans ){
+      if( maxPrint && nPrint++ >= maxPrint ) break ;
+      dd4hep::printout( dd4hep::ALWAYS, LOG_SOURCE, "%-50s %-13s %6d %7d %10ld %12.0f",
+			b.volume->GetName(), booleanOperation( b.volume->GetShape() ), b.depth, b.nSolids,
+			b.logicalPlacements, b.physicalPlacements ) ;
+    }
+
+    return 1;
+  }
+}
+
+DECLARE_APPLY(lcgeo_BooleanSolidAudit, ::auditBooleanSolids)
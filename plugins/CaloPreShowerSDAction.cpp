@@ -4,6 +4,16 @@
 #include "G4OpticalPhoton.hh"
 #include "G4VProcess.hh"
 
+#include "CellPositionCache.h"
+#include "CellTimeOfFlight.h"
+#include "DenseCellIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
 /// Namespace for the AIDA detector description toolkit
 namespace dd4hep {
   
@@ -24,10 +34,19 @@ namespace dd4hep {
       G4int _preShowerCollectionID ;
       G4int _firstLayerNumber ; 
       Geant4HitCollection *_preShowerCollection;
+      bool _useCellPositionCache ;
+      const lcgeo::DenseCellIndex* _cellIndex ;
+      lcgeo::CellPositionCache _cellPositions ; // per thread, see lcgeo::CellPositionCache
+      double _timeWindow ;
+      const lcgeo::CellTimeOfFlight* _timeOfFlight ;
       CalorimeterWithPreShowerLayer() : Geant4Calorimeter(), 
 					_preShowerCollectionID(0),
 					_firstLayerNumber(1), //fixme: can we make this a parameter ?
-					_preShowerCollection(0)
+					_preShowerCollection(0),
+					_useCellPositionCache(true),
+					_cellIndex(0),
+					_timeWindow(0.),
+					_timeOfFlight(0)
       {}
     };
 
@@ -43,7 +62,7 @@ namespace dd4hep {
     }
 
 
-    /// template specialization for c'tor in order to define property: FirstLayerNumber
+    /// template specialization for c'tor in order to define properties: FirstLayerNumber, UseCellPositionCache, TimeWindow
     template <> 
     Geant4SensitiveAction<CalorimeterWithPreShowerLayer>::Geant4SensitiveAction(Geant4Context* ctxt,
 										const std::string& nam,
@@ -55,6 +74,13 @@ namespace dd4hep {
       defineCollections();
       InstanceCount::increment(this);
       declareProperty("FirstLayerNumber", m_userData._firstLayerNumber = 1 );
+      // cache the cell positions if the driver provides a dense index of the cellIDs
+      declareProperty("UseCellPositionCache", m_userData._useCellPositionCache = true );
+      m_userData._cellIndex = m_detector.extension<lcgeo::DenseCellIndex>( false ) ;
+      if( m_userData._cellIndex ) m_userData._cellPositions.resize( m_userData._cellIndex->size() ) ;
+      // ignore deposits later than TimeWindow after the time of flight to the cell (needs lcgeo_CellTimeOfFlight), 0: no cut
+      declareProperty("TimeWindow", m_userData._timeWindow = 0. );
+      m_userData._timeOfFlight = m_detector.extension<lcgeo::CellTimeOfFlight>( false ) ;
     }
 
     /// Method for generating hit(s) using the information of G4Step object.
@@ -84,6 +110,11 @@ namespace dd4hep {
         return true;
       }
 
+      if( m_userData._timeWindow > 0. && m_userData._timeOfFlight )  {
+        const double tof = m_userData._timeOfFlight->timeOfFlight(cell) ;
+        if( contrib.time - tof > m_userData._timeWindow ) return true ;
+      }
+
       // get the layer number by decoding the cellID
       IDDescriptor idspec = m_sensitive.readout().idSpec() ;
       const DDSegmentation::BitFieldCoder& bc = *idspec.decoder() ;
@@ -97,13 +128,17 @@ namespace dd4hep {
       }
       else if ( !hit ) {
         Geant4TouchableHandler handler(step);
-        DDSegmentation::Vector3D pos = m_segmentation.position(cell);
-        Position global = h.localToGlobal(pos);
+        // the cellID fixes the placement, so the position only has to be computed once per cell
+        long index = ( m_userData._useCellPositionCache && m_userData._cellIndex ) ? m_userData._cellIndex->index(cell) : -1 ;
+        Position global = m_userData._cellPositions.position<Position>( index, [&](){
+            DDSegmentation::Vector3D pos = m_segmentation.position(cell);
+            return h.localToGlobal(pos);
+          } );
         hit = new Hit(global);
         hit->cellID = cell;
         coll->add(hit);
         printM2("%s> CREATE hit with deposit:%e MeV  Pos:%8.2f %8.2f %8.2f  %s",
-                c_name(),contrib.deposit,pos.X,pos.Y,pos.Z,handler.path().c_str());
+                c_name(),contrib.deposit,global.X(),global.Y(),global.Z(),handler.path().c_str());
         if ( 0 == hit->cellID )  { // for debugging only!
           hit->cellID = cellID(step);
           except("+++ Invalid CELL ID for hit!");
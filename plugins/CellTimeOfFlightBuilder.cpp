@@ -0,0 +1,152 @@
+//==========================================================================
+// iLCSoft - linear collider geometry
+//--------------------------------------------------------------------------
+//
+// For the licensing terms see lcgeo/LICENSE.
+//
+//==========================================================================
+//
+// Cell Time of Flight
+//
+// Precomputes the straight line time of flight from the IP to the cells of
+// the calorimeters that publish a dense cell index, see CellTimeOfFlight.h,
+// and attaches it as extension to their DetElements.
+//
+//==========================================================================
+
+#include "CellTimeOfFlight.h"
+#include "DenseCellIndex.h"
+
+#include <DD4hep/DetElement.h>
+#include <DD4hep/Detector.h>
+#include <DD4hep/Factories.h>
+#include <DD4hep/Printout.h>
+#include <DD4hep/VolumeManager.h>
+
+#include <TGeoMatrix.h>
+#include <TGeoNode.h>
+#include <TGeoVolume.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+  const std::string LOG_SOURCE("CellTimeOfFlight");
+
+  /// the names of the volume IDs of the placements below node
+  void collectVolumeFields( TGeoNode* node, std::set<std::string>& names, std::set<const TGeoVolume*>& visited ){
+    dd4hep::PlacedVolume pv( node ) ;
+    if( pv.data() )
+      for( const auto& id : pv.volIDs() ) names.insert( id.first ) ;
+    const TGeoVolume* vol = node->GetVolume() ;
+    if( ! visited.insert( vol ).second ) return ;
+    for( int i = 0 ; i < vol->GetNdaughters() ; ++i )
+      collectVolumeFields( vol->GetNode( i ), names, visited ) ;
+  }
+
+  /// mask of the fields of the cellID that are set by the placements of the detector
+  dd4hep::CellID volumeMask( dd4hep::DetElement det, const dd4hep::DDSegmentation::BitFieldCoder& decoder ){
+    std::set<std::string> names ;
+    std::set<const TGeoVolume*> visited ;
+    collectVolumeFields( det.placement().ptr(), names, visited ) ;
+    dd4hep::CellID mask = 0 ;
+    for( std::size_t i = 0 ; i < decoder.size() ; ++i )
+      if( names.count( decoder[i].name() ) ) mask |= decoder[i].mask() ;
+    return mask ;
+  }
+
+  /** Plugin for attaching the time of flight from the IP to the cells to the calorimeter DetElements
+   *
+   * Arguments are:
+   *  - -detector <name>: only this subdetector, can be repeated (default: all subdetectors with a lcgeo::DenseCellIndex)
+   *  - -maxcells <n>:    store the time of flight per cell if the dense index has at most n cells, otherwise
+   *                      per sensitive volume (default: 10000000, 0 for always per volume)
+   *
+   * Usage: geoPluginRun -input compact.xml -plugin lcgeo_CellTimeOfFlight -maxcells 50000000
+   *
+   * In the digitisation the times are available as det.extension<lcgeo::CellTimeOfFlight>()
+   */
+  static long addCellTimeOfFlight(dd4hep::Detector& description, int argc, char** argv) {
+
+    std::vector<std::string> detectorNames ;
+    long maxCells = 10000000 ;
+
+    for( int i = 0 ; i < argc ; ++i ){
+      const std::string arg( argv[i] ) ;
+      if( i + 1 >= argc ){
+	dd4hep::printout( dd4hep::ERROR, LOG_SOURCE, "missing value for argument %s", arg.c_str() ) ;
+	return 0 ;
+      }
+      if     ( arg == "-detector" ) detectorNames.push_back( argv[++i] ) ;
+      else if( arg == "-maxcells" ) maxCells = std::atol( argv[++i] ) ;
+      else {
+	dd4hep::printout( dd4hep::ERROR, LOG_SOURCE, "unknown argument %s", arg.c_str() ) ;
+	return 0 ;
+      }
+    }
+
+    if( detectorNames.empty() )
+      for( const auto& c : description.world().children() )
+	if( c.second.extension<lcgeo::DenseCellIndex>( false ) ) detectorNames.push_back( c.first ) ;
+
+    dd4hep::VolumeManager volMgr = dd4hep::VolumeManager::getVolumeManager( description ) ;
+
+    for( const std::string& name : detectorNames ){
+
+      auto start = std::chrono::steady_clock::now() ;
+
+      dd4hep::DetElement det = description.detector( name ) ;
+      const lcgeo::DenseCellIndex* index = det.extension<lcgeo::DenseCellIndex>( false ) ;
+      if( ! index ){
+	dd4hep::printout( dd4hep::WARNING, LOG_SOURCE, "%s has no dense cell index - skipped", name.c_str() ) ;
+	continue ;
+      }
+      dd4hep::Readout readout = description.sensitiveDetector( name ).readout() ;
+      const dd4hep::DDSegmentation::BitFieldCoder& decoder = *readout.idSpec().decoder() ;
+      const dd4hep::DDSegmentation::Segmentation& seg = *readout.segmentation().segmentation() ;
+
+      lcgeo::CellTimeOfFlight* tof = new lcgeo::CellTimeOfFlight( *index, seg, volumeMask( det, decoder ) ) ;
+
+      // one lookup in the volume manager per sensitive volume
+      std::set<dd4hep::CellID> missing ;
+      for( long idx = 0 ; idx < index->size() ; ++idx ){
+	if( ! index->isValidIndex( idx ) ) continue ;
+	const dd4hep::CellID cell = index->cellID( idx ) ;
+	if( tof->hasPlacement( cell ) || missing.count( cell & tof->volumeMask() ) ) continue ;
+	const dd4hep::VolumeManagerContext* context = 0 ;
+	try{
+	  context = volMgr.lookupContext( cell ) ;
+	} catch( const std::exception& ){
+	  context = 0 ;
+	}
+	if( ! context ){
+	  missing.insert( cell & tof->volumeMask() ) ;
+	  continue ;
+	}
+	TGeoHMatrix toWorld( context->element.nominal().worldTransformation() ) ;
+	toWorld.Multiply( &context->toElement() ) ;
+	tof->addPlacement( cell, toWorld.GetRotationMatrix(), toWorld.GetTranslation() ) ;
+      }
+
+      if( index->size() <= maxCells ) tof->fillCells() ;
+
+      det.addExtension<lcgeo::CellTimeOfFlight>( tof ) ;
+
+      dd4hep::printout( dd4hep::INFO, LOG_SOURCE, "%s: %ld sensitive volumes, %ld channels%s in %.1f s",
+			name.c_str(), tof->numberOfPlacements(), index->numberOfChannels(),
+			tof->hasCellTable() ? " stored per cell" : "",
+			std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count() ) ;
+      if( ! missing.empty() )
+	dd4hep::printout( dd4hep::WARNING, LOG_SOURCE, "%s: %zu sensitive volumes of valid cells not found in the volume manager",
+			  name.c_str(), missing.size() ) ;
+    }
+
+    return 1;
+  }
+}
+
+DECLARE_APPLY(lcgeo_CellTimeOfFlight, ::addCellTimeOfFlight)
@@ -0,0 +1,249 @@
+//==========================================================================
+// iLCSoft - linear collider geometry
+//--------------------------------------------------------------------------
+//
+// For the licensing terms see lcgeo/LICENSE.
+//
+//==========================================================================
+//
+// Fast Simulation Geometry
+//
+// Writes the layers of the trackers and calorimeters, as described by the
+// drivers in ZPlanarData, ZDiskPetalsData and LayeredCalorimeterData, to
+// a file that parametric fast simulations read without DD4hep, see
+// FastSimGeometry.h. The material of the tracker layers is taken from
+// their DDRec surfaces.
+//
+//==========================================================================
+
+#include "FastSimGeometry.h"
+
+#include <DD4hep/DD4hepUnits.h>
+#include <DD4hep/DetElement.h>
+#include <DD4hep/Detector.h>
+#include <DD4hep/Factories.h>
+#include <DD4hep/Printout.h>
+
+#include <DDRec/DetectorData.h>
+#include <DDRec/SurfaceHelper.h>
+#include <DDSegmentation/BitFieldCoder.h>
+
+#include <algorithm>
+#include <exception>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+  const std::string LOG_SOURCE("FastSimGeometry");
+
+  typedef lcgeo::FastSimGeometry::Layer Layer ;
+
+  /// radiation and interaction lengths of the sensitive surfaces, averaged per (layer, side)
+  class SurfaceMaterial {
+  public:
+    SurfaceMaterial( dd4hep::Detector& description, dd4hep::DetElement det ){
+      dd4hep::SensitiveDetector sd = description.sensitiveDetector( det.name() ) ;
+      if( ! sd.isValid() ) return ;
+      const dd4hep::DDSegmentation::BitFieldCoder& decoder = *sd.readout().idSpec().decoder() ;
+      int layer = -1, side = -1 ;
+      for( std::size_t i = 0 ; i < decoder.size() ; ++i ){
+	if( decoder[i].name() == "layer" ) layer = i ;
+	if( decoder[i].name() == "side" ) side = i ;
+      }
+
+      dd4hep::rec::SurfaceHelper ds( det ) ;
+      for( const dd4hep::rec::ISurface* s : ds.surfaceList() ){
+	if( ! s->type().isSensitive() ) continue ;
+	const dd4hep::CellID id = s->id() ;
+	const int l = layer >= 0 ? decoder[layer].value( id ) : 0 ;
+	const int sign = side >= 0 ? decoder[side].value( id ) : ( s->origin().z() < 0. ? -1 : 0 ) ;
+	const dd4hep::rec::IMaterial& in = s->innerMaterial() ;
+	const dd4hep::rec::IMaterial& out = s->outerMaterial() ;
+	Sum& sum = _sums[ std::make_pair( l, sign < 0 ? -1 : 1 ) ] ;
+	sum.x0 += ( in.radiationLength() > 0. ? s->innerThickness() / in.radiationLength() : 0. )
+	  + ( out.radiationLength() > 0. ? s->outerThickness() / out.radiationLength() : 0. ) ;
+	sum.lambda += ( in.interactionLength() > 0. ? s->innerThickness() / in.interactionLength() : 0. )
+	  + ( out.interactionLength() > 0. ? s->outerThickness() / out.interactionLength() : 0. ) ;
+	++sum.n ;
+      }
+    }
+
+    /// fill the material of the layer at this side (barrels: +1)
+    void fill( Layer& l, int side ) const {
+      auto it = _sums.find( std::make_pair( l.layer, side ) ) ;
+      if( it == _sums.end() || it->second.n == 0 ) return ;
+      l.radiationLengths = it->second.x0 / it->second.n ;
+      l.interactionLengths = it->second.lambda / it->second.n ;
+    }
+
+  private:
+    struct Sum { double x0 = 0., lambda = 0. ; int n = 0 ; } ;
+    std::map< std::pair<int,int>, Sum > _sums {} ;
+  };
+
+  /// the endcap layer mirrored to -z
+  Layer mirrored( const Layer& l ){
+    Layer m( l ) ;
+    m.zMin = -l.zMax ;
+    m.zMax = -l.zMin ;
+    return m ;
+  }
+
+  void addTrackerBarrel( lcgeo::FastSimGeometry& geo, const std::string& name, const dd4hep::rec::ZPlanarData& data,
+			 const SurfaceMaterial& material ){
+    for( std::size_t i = 0 ; i < data.layers.size() ; ++i ){
+      const dd4hep::rec::ZPlanarData::LayerLayout& ll = data.layers[i] ;
+      Layer l ;
+      l.type = lcgeo::FastSimGeometry::TrackerBarrel ;
+      l.layer = i ;
+      l.rMin = ll.distanceSensitive / dd4hep::mm ;
+      l.rMax = ( ll.distanceSensitive + ll.thicknessSensitive ) / dd4hep::mm ;
+      l.zMin = -ll.zHalfSensitive / dd4hep::mm ;
+      l.zMax = ll.zHalfSensitive / dd4hep::mm ;
+      l.thickness = ( ll.thicknessSensitive + ll.thicknessSupport ) / dd4hep::mm ;
+      l.sensitiveThickness = ll.thicknessSensitive / dd4hep::mm ;
+      l.cellSize0 = data.pitchStrip / dd4hep::mm ;
+      l.cellSize1 = data.lengthStrip / dd4hep::mm ;
+      l.phi0 = ll.phi0 ;
+      l.symmetry = ll.ladderNumber ;
+      material.fill( l, 1 ) ;
+      geo.add( name, l ) ;
+    }
+  }
+
+  void addTrackerEndcap( lcgeo::FastSimGeometry& geo, const std::string& name, const dd4hep::rec::ZDiskPetalsData& data,
+			 const SurfaceMaterial& material ){
+    for( std::size_t i = 0 ; i < data.layers.size() ; ++i ){
+      const dd4hep::rec::ZDiskPetalsData::LayerLayout& ll = data.layers[i] ;
+      Layer l ;
+      l.type = lcgeo::FastSimGeometry::TrackerEndcap ;
+      l.layer = i ;
+      l.rMin = ll.distanceSensitive / dd4hep::mm ;
+      l.rMax = ( ll.distanceSensitive + ll.lengthSensitive ) / dd4hep::mm ;
+      l.zMin = ( ll.zPosition - 0.5 * ll.thicknessSensitive ) / dd4hep::mm ;
+      l.zMax = ( ll.zPosition + 0.5 * ll.thicknessSensitive ) / dd4hep::mm ;
+      l.thickness = ( ll.thicknessSensitive + ll.thicknessSupport ) / dd4hep::mm ;
+      l.sensitiveThickness = ll.thicknessSensitive / dd4hep::mm ;
+      l.cellSize0 = data.pitchStrip / dd4hep::mm ;
+      l.cellSize1 = data.lengthStrip / dd4hep::mm ;
+      l.phi0 = ll.phi0 ;
+      l.symmetry = ll.petalNumber ;
+      Layer m = mirrored( l ) ;
+      material.fill( l, 1 ) ;
+      material.fill( m, -1 ) ;
+      geo.add( name, l ) ;
+      geo.add( name, m ) ;
+    }
+  }
+
+  void addCalorimeter( lcgeo::FastSimGeometry& geo, const std::string& name, const dd4hep::rec::LayeredCalorimeterData& data ){
+    const bool barrel = data.layoutType == dd4hep::rec::LayeredCalorimeterData::BarrelLayout ;
+    for( std::size_t i = 0 ; i < data.layers.size() ; ++i ){
+      const dd4hep::rec::LayeredCalorimeterData::Layer& ll = data.layers[i] ;
+      const double thickness = ll.inner_thickness + ll.outer_thickness ;
+      Layer l ;
+      l.type = barrel ? lcgeo::FastSimGeometry::CalorimeterBarrel : lcgeo::FastSimGeometry::CalorimeterEndcap ;
+      l.layer = i ;
+      if( barrel ){
+	l.rMin = ll.distance / dd4hep::mm ;
+	l.rMax = ( ll.distance + thickness ) / dd4hep::mm ;
+	l.zMin = -data.extent[3] / dd4hep::mm ;
+	l.zMax = data.extent[3] / dd4hep::mm ;
+      } else {
+	l.rMin = data.extent[0] / dd4hep::mm ;
+	l.rMax = data.extent[1] / dd4hep::mm ;
+	l.zMin = ll.distance / dd4hep::mm ;
+	l.zMax = ( ll.distance + thickness ) / dd4hep::mm ;
+      }
+      l.thickness = thickness / dd4hep::mm ;
+      l.sensitiveThickness = ll.sensitive_thickness / dd4hep::mm ;
+      l.radiationLengths = ll.inner_nRadiationLengths + ll.outer_nRadiationLengths ;
+      l.interactionLengths = ll.inner_nInteractionLengths + ll.outer_nInteractionLengths ;
+      l.cellSize0 = ll.cellSize0 / dd4hep::mm ;
+      l.cellSize1 = ll.cellSize1 / dd4hep::mm ;
+      l.phi0 = data.inner_phi0 ;
+      l.symmetry = data.inner_symmetry ;
+      geo.add( name, l ) ;
+      if( ! barrel ) geo.add( name, mirrored( l ) ) ;
+    }
+  }
+
+  /** Plugin for writing the layers of the trackers and calorimeters for fast simulations
+   *
+   * Arguments are:
+   *  - -output <file>:   the file to write (required)
+   *  - -detector <name>: only this subdetector, can be given several times (default: all)
+   *
+   * Usage: geoPluginRun -input compact.xml -plugin lcgeo_FastSimGeometry -output CLIC_o3_v14.fsgeo
+   *
+   * The file is read with lcgeo::FastSimGeometry::read(), which only needs FastSimGeometry.h
+   */
+  static long writeFastSimGeometry(dd4hep::Detector& description, int argc, char** argv) {
+
+    std::string outputFile ;
+    std::vector<std::string> selected ;
+
+    for( int i = 0 ; i < argc ; ++i ){
+      const std::string arg( argv[i] ) ;
+      if( i + 1 >= argc ){
+	dd4hep::printout( dd4hep::ERROR, LOG_SOURCE, "missing value for argument %s", arg.c_str() ) ;
+	return 0 ;
+      }
+      if     ( arg == "-output" )   outputFile = argv[++i] ;
+      else if( arg == "-detector" ) selected.push_back( argv[++i] ) ;
+      else {
+	dd4hep::printout( dd4hep::ERROR, LOG_SOURCE, "unknown argument %s", arg.c_str() ) ;
+	return 0 ;
+      }
+    }
+    if( outputFile.empty() ){
+      dd4hep::printout( dd4hep::ERROR, LOG_SOURCE, "no output file given, use -output <file>" ) ;
+      return 0 ;
+    }
+
+    lcgeo::FastSimGeometry geo ;
+
+    for( const auto& c : description.world().children() ){
+
+      const std::string& name = c.first ;
+      dd4hep::DetElement det = c.second ;
+      if( ! selected.empty() && std::find( selected.begin(), selected.end(), name ) == selected.end() ) continue ;
+
+      const std::size_t before = geo.layers().size() ;
+
+      const dd4hep::rec::ZPlanarData* planar = det.extension<dd4hep::rec::ZPlanarData>( false ) ;
+      const dd4hep::rec::ZDiskPetalsData* disks = det.extension<dd4hep::rec::ZDiskPetalsData>( false ) ;
+      const dd4hep::rec::LayeredCalorimeterData* calo = det.extension<dd4hep::rec::LayeredCalorimeterData>( false ) ;
+
+      if( planar || disks ){
+	const SurfaceMaterial material( description, det ) ;
+	if( planar ) addTrackerBarrel( geo, name, *planar, material ) ;
+	if( disks )  addTrackerEndcap( geo, name, *disks, material ) ;
+      }
+      if( calo ){
+	if( calo->layoutType == dd4hep::rec::LayeredCalorimeterData::ConicalLayout )
+	  dd4hep::printout( dd4hep::WARNING, LOG_SOURCE, "%s: conical layout is written as endcap", name.c_str() ) ;
+	addCalorimeter( geo, name, *calo ) ;
+      }
+
+      if( geo.layers().size() > before )
+	dd4hep::printout( dd4hep::DEBUG, LOG_SOURCE, "%s: %zu layers", name.c_str(), geo.layers().size() - before ) ;
+    }
+
+    try{
+      geo.write( outputFile ) ;
+    } catch( const std::exception& e ){
+      dd4hep::printout( dd4hep::ERROR, LOG_SOURCE, "%s", e.what() ) ;
+      return 0 ;
+    }
+
+    dd4hep::printout( dd4hep::INFO, LOG_SOURCE, "written %zu layers of %zu subdetectors to %s",
+		      geo.layers().size(), geo.detectors().size(), outputFile.c_str() ) ;
+    return 1;
+  }
+}
+
+DECLARE_APPLY(lcgeo_FastSimGeometry, ::writeFastSimGeometry)
@@ -0,0 +1,251 @@
+#include "DDG4/Geant4SensDetAction.inl"
+#include "DDG4/Geant4EventAction.h"
+#include "DDG4/Geant4Mapping.h"
+#include "G4EventManager.hh"
+#include "G4Event.hh"
+
+#include "DenseCellIndex.h"
+
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// Namespace for the AIDA detector description toolkit
+namespace dd4hep {
+
+  /// Namespace for the Geant4 based simulation part of the AIDA detector description toolkit
+  namespace sim   {
+
+    /**
+     *  Binary file with the cells above threshold of each bunch crossing (event), shared by all
+     *  sensitive actions writing to the same file name (e.g. the worker threads). The file starts
+     *  with the magic "LCGEOBX1", the length and name of the readout and the size of the dense
+     *  cell index (uint32, uint64), followed by one record per event: event number (int32),
+     *  number of cells (uint32) and for each cell its dense index (uint32) and energy in GeV (float).
+     */
+    class OccupancyMapFile {
+    public:
+      typedef std::pair<std::uint32_t,float> Cell ;
+
+      static std::shared_ptr<OccupancyMapFile> open( const std::string& fileName, const std::string& readout, long nCells ) {
+	static std::mutex mutex ;
+	static std::map< std::string, std::weak_ptr<OccupancyMapFile> > files ;
+	std::lock_guard<std::mutex> lock( mutex ) ;
+	std::shared_ptr<OccupancyMapFile> file = files[ fileName ].lock() ;
+	if( ! file ) {
+	  file.reset( new OccupancyMapFile( fileName, readout, nCells ) ) ;
+	  files[ fileName ] = file ;
+	}
+	return file ;
+      }
+
+      void write( std::int32_t event, const std::vector<Cell>& cells ) {
+	std::lock_guard<std::mutex> lock( _mutex ) ;
+	const std::uint32_t n = cells.size() ;
+	_out.write( reinterpret_cast<const char*>( &event ), sizeof(event) ) ;
+	_out.write( reinterpret_cast<const char*>( &n ), sizeof(n) ) ;
+	for( const Cell& c : cells ) {
+	  _out.write( reinterpret_cast<const char*>( &c.first ), sizeof(c.first) ) ;
+	  _out.write( reinterpret_cast<const char*>( &c.second ), sizeof(c.second) ) ;
+	}
+	_out.flush() ;
+      }
+
+      bool good() const { return _out.good() ; }
+
+    private:
+      OccupancyMapFile( const std::string& fileName, const std::string& readout, long nCells )
+	: _out( fileName, std::ios::binary ) {
+	const std::uint32_t length = readout.size() ;
+	const std::uint64_t size = nCells ;
+	_out.write( "LCGEOBX1", 8 ) ;
+	_out.write( reinterpret_cast<const char*>( &length ), sizeof(length) ) ;
+	_out.write( readout.data(), length ) ;
+	_out.write( reinterpret_cast<const char*>( &size ), sizeof(size) ) ;
+      }
+      std::mutex _mutex {} ;
+      std::ofstream _out ;
+    };
+
+    /**
+     *  Geant4SensitiveAction<ForwardCalorimeter> sensitive detector for the forward calorimeters
+     *  (BeamCal, LumiCal) that see the hits of the beamstrahlung pairs: the deposits of each step are
+     *  added to the cell at its dense index (see lcgeo::DenseCellIndex, published by the drivers), so
+     *  that the cost per step does not depend on the number of cells already hit. At the end of the
+     *  event either one hit per cell above Threshold is created (OutputMode "hits"), with the summed
+     *  deposit as single contribution of the track that hit the cell first and the earliest time, or
+     *  the cells above Threshold are appended to the occupancy map MapFile (OutputMode "map", see
+     *  OccupancyMapFile) and no hits are created. OutputMode is checked and parsed once, at the start of
+     *  the first event, as DDG4 sets the properties after the construction of the action.
+     *
+     *  \version 1.0
+     *  \ingroup DD4HEP_SIMULATION
+     */
+    struct ForwardCalorimeter: public Geant4Calorimeter{
+      /// what is written for the cells above threshold, Unset until the properties are applied
+      enum Output { Unset, Hits, Map } ;
+      static Output outputOf( const std::string& mode ) {
+	if( mode == "hits" ) return Hits ;
+	if( mode == "map" ) return Map ;
+	throw std::runtime_error( "unknown OutputMode " + mode + ", use hits or map" ) ;
+      }
+      /// a cell hit in the current event
+      struct Cell {
+	long index ;
+	long long int cellID ;
+	Position position ;
+	double energy ;
+	double time ;
+	int trackID ;
+	int pdgID ;
+      };
+      const lcgeo::DenseCellIndex* _cellIndex ;
+      std::vector<int> _cellOfIndex ;                       // position in _cells for each dense index, -1 if not hit
+      std::unordered_map<long long int,int> _cellOfCellID ; // the same for cells outside the dense index
+      std::vector<Cell> _cells ;
+      std::string _outputMode ;
+      Output _output ;
+      double _threshold ;
+      std::string _mapFileName ;
+      std::shared_ptr<OccupancyMapFile> _mapFile ;
+      ForwardCalorimeter() : Geant4Calorimeter(),
+			     _cellIndex(0),
+			     _cellOfIndex(),
+			     _cellOfCellID(),
+			     _cells(),
+			     _outputMode("hits"),
+			     _output(Unset),
+			     _threshold(0.),
+			     _mapFileName(),
+			     _mapFile()
+      {}
+      /// forget the cells of the event
+      void clear() {
+	for( const Cell& c : _cells ) if( c.index >= 0 ) _cellOfIndex[ c.index ] = -1 ;
+	_cellOfCellID.clear() ;
+	_cells.clear() ;
+      }
+    };
+
+
+    /// template specialization for c'tor in order to define properties: OutputMode, Threshold, MapFile
+    template <>
+    Geant4SensitiveAction<ForwardCalorimeter>::Geant4SensitiveAction(Geant4Context* ctxt,
+								      const std::string& nam,
+								      DetElement det,
+								      Detector& lcdd_ref)
+      : Geant4Sensitive(ctxt,nam,det,lcdd_ref), m_collectionID(0)
+    {
+      initialize();
+      defineCollections();
+      InstanceCount::increment(this);
+      // "hits": hits of the cells above threshold, "map": occupancy map of each event in MapFile
+      declareProperty("OutputMode", m_userData._outputMode = "hits" );
+      declareProperty("Threshold", m_userData._threshold = 0. );
+      declareProperty("MapFile", m_userData._mapFileName = m_sensitive.readout().name() + ".bxmap" );
+      m_userData._cellIndex = m_detector.extension<lcgeo::DenseCellIndex>( false ) ;
+      if( m_userData._cellIndex ) m_userData._cellOfIndex.assign( m_userData._cellIndex->size(), -1 ) ;
+      else warning("%s has no lcgeo::DenseCellIndex - cells are looked up by cellID", m_detector.name() ) ;
+    }
+
+    /// Method for generating hit(s) using the information of G4Step object.
+    template <> bool Geant4SensitiveAction<ForwardCalorimeter>::process(G4Step* step,G4TouchableHistory*) {
+      typedef ForwardCalorimeter::Cell Cell;
+      Geant4StepHandler h(step);
+      const double deposit = h.totalEnergy();
+      if ( deposit < std::numeric_limits<double>::epsilon() )  {
+        return true;
+      }
+      const long long int cell = cellID(step);
+      const long index = m_userData._cellIndex ? m_userData._cellIndex->index(cell) : -1 ;
+      int& slot = ( index >= 0 ) ? m_userData._cellOfIndex[index] : m_userData._cellOfCellID.emplace(cell,-1).first->second ;
+      const double time = h.track->GetGlobalTime();
+      if ( slot < 0 )  {
+        // the position of the cell is only needed once per event
+        const Position global = h.localToGlobal(m_segmentation.position(cell));
+        slot = m_userData._cells.size();
+        m_userData._cells.push_back( Cell{ index, cell, global, 0., time, h.trkID(), h.trackDef()->GetPDGEncoding() } );
+      }
+      Cell& c = m_userData._cells[slot];
+      c.energy += deposit;
+      if ( time < c.time ) c.time = time;
+      if ( m_userData._output == ForwardCalorimeter::Hits ) mark(step);
+      return true;
+    }
+
+    /// Start of the event: no cells hit - in the first event OutputMode is parsed and the map file opened
+    template <> void Geant4SensitiveAction<ForwardCalorimeter>::begin(G4HCofThisEvent* hce) {
+      Geant4Sensitive::begin(hce);
+      ForwardCalorimeter& d = m_userData;
+      if ( d._output == ForwardCalorimeter::Unset )  {
+        try {
+          d._output = ForwardCalorimeter::outputOf(d._outputMode);
+        } catch( const std::exception& e ) {
+          except("%s: %s", c_name(), e.what());
+        }
+        if ( d._output == ForwardCalorimeter::Map )  {
+          if ( !d._cellIndex )  {
+            except("%s: OutputMode map needs the lcgeo::DenseCellIndex of the driver", c_name());
+          }
+          d._mapFile = OccupancyMapFile::open(d._mapFileName, m_sensitive.readout().name(), d._cellIndex->size());
+          if ( !d._mapFile->good() ) except("%s: cannot write %s", c_name(), d._mapFileName.c_str());
+        }
+      }
+      d.clear();
+    }
+
+    /// End of the event: hits or occupancy map of the cells above threshold
+    template <> void Geant4SensitiveAction<ForwardCalorimeter>::end(G4HCofThisEvent* hce) {
+      typedef ForwardCalorimeter::Hit Hit;
+      typedef ForwardCalorimeter::Cell Cell;
+      ForwardCalorimeter& d = m_userData;
+
+      if ( d._output == ForwardCalorimeter::Hits )  {
+        Geant4HitCollection* coll = collection(m_collectionID);
+        for( const Cell& c : d._cells )  {
+          if ( c.energy < d._threshold ) continue;
+          Hit* hit = new Hit(c.position);
+          hit->cellID = c.cellID;
+          hit->energyDeposit = c.energy;
+          hit->truth.push_back( HitContribution( c.trackID, c.pdgID, c.energy, c.time ) );
+          coll->add(hit);
+        }
+      }
+      else  {
+        std::vector<OccupancyMapFile::Cell> cells;
+        cells.reserve(d._cells.size());
+        long outside = 0;
+        for( const Cell& c : d._cells )  {
+          if ( c.energy < d._threshold ) continue;
+          if ( c.index < 0 )  {
+            ++outside;
+            continue;
+          }
+          cells.push_back( OccupancyMapFile::Cell( c.index, c.energy/CLHEP::GeV ) );
+        }
+        const G4Event* event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+        d._mapFile->write( event ? event->GetEventID() : -1, cells );
+        printM1("%s> %ld cells above threshold", c_name(), long(cells.size()));
+        if ( outside > 0 ) warning("%s: %ld cells outside of the dense cell index not in the map", c_name(), outside);
+      }
+      d.clear();
+      Geant4Sensitive::end(hce);
+    }
+
+
+    typedef Geant4SensitiveAction<ForwardCalorimeter> ForwardCaloSDAction;
+
+  } // namespace
+} // namespace
+
+
+
+#include "DDG4/Factories.h"
+DECLARE_GEANT4SENSITIVE( ForwardCaloSDAction )
@@ -0,0 +1,277 @@
+#include "DDG4/Geant4GeneratorAction.h"
+#include "DDG4/Geant4Context.h"
+#include "DDG4/Geant4Particle.h"
+#include "DDG4/Geant4Primary.h"
+#include "DDG4/Geant4Vertex.h"
+#include "DD4hep/InstanceCount.h"
+#include "CLHEP/Units/PhysicalConstants.h"
+#include "CLHEP/Units/SystemOfUnits.h"
+#include "G4RunManager.hh"
+
+#include "GuineaPigPairs.h"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// Namespace for the AIDA detector description toolkit
+namespace dd4hep {
+
+  /// Namespace for the Geant4 based simulation part of the AIDA detector description toolkit
+  namespace sim   {
+
+    /**
+     *  The bunch crossings of a list of GuineaPig pair files, parsed by a thread that stays ReadAhead
+     *  crossings ahead of the events, shared by all input actions with the same name (e.g. the worker
+     *  threads). The crossings are taken in the order of the files or, if random, drawn from the files
+     *  with replacement.
+     */
+    class PairCrossingBuffer {
+    public:
+      typedef std::vector<lcgeo::GuineaPigParticle> Crossing ;
+
+      struct Config {
+	std::vector<std::string> files {} ;
+	std::size_t readAhead = 2 ;
+	unsigned threads = 2 ;
+	bool random = false ;
+	unsigned seed = 0 ;
+      };
+
+      static std::shared_ptr<PairCrossingBuffer> open( const std::string& name, const Config& cfg ) {
+	static std::mutex mutex ;
+	static std::map< std::string, std::weak_ptr<PairCrossingBuffer> > buffers ;
+	std::lock_guard<std::mutex> lock( mutex ) ;
+	std::shared_ptr<PairCrossingBuffer> buffer = buffers[ name ].lock() ;
+	if( ! buffer ) {
+	  buffer.reset( new PairCrossingBuffer( cfg ) ) ;
+	  buffers[ name ] = buffer ;
+	}
+	return buffer ;
+      }
+
+      ~PairCrossingBuffer() {
+	{
+	  std::lock_guard<std::mutex> lock( _mutex ) ;
+	  _stop = true ;
+	}
+	_notFull.notify_all() ;
+	_thread.join() ;
+      }
+
+      /// the next crossing and the index of its file - false at the end of the files
+      bool next( Crossing& crossing, int& file ) {
+	std::unique_lock<std::mutex> lock( _mutex ) ;
+	_notEmpty.wait( lock, [this]{ return ! _queue.empty() || _done ; } ) ;
+	if( _queue.empty() ) {
+	  if( _error ) std::rethrow_exception( _error ) ;
+	  return false ;
+	}
+	file = _queue.front().first ;
+	crossing.swap( _queue.front().second ) ;
+	_queue.pop_front() ;
+	lock.unlock() ;
+	_notFull.notify_one() ;
+	return true ;
+      }
+
+    private:
+      explicit PairCrossingBuffer( const Config& cfg ) : _cfg( cfg ) {
+	if( _cfg.readAhead < 1 ) _cfg.readAhead = 1 ;
+	_thread = std::thread( &PairCrossingBuffer::produce, this ) ;
+      }
+
+      void produce() {
+	try {
+	  std::mt19937 rng( _cfg.seed ) ;
+	  std::uniform_int_distribution<int> pick( 0, int( _cfg.files.size() ) - 1 ) ;
+	  for( std::size_t n = 0 ; _cfg.random || n < _cfg.files.size() ; ++n ) {
+	    if( _cfg.files.empty() ) break ;
+	    const int file = _cfg.random ? pick( rng ) : int( n ) ;
+	    Crossing crossing, chunk ;
+	    lcgeo::GuineaPigPairFile pairs( _cfg.files[ file ] ) ;
+	    while( pairs.read( chunk, 0, _cfg.threads ) ) crossing.insert( crossing.end(), chunk.begin(), chunk.end() ) ;
+
+	    std::unique_lock<std::mutex> lock( _mutex ) ;
+	    _notFull.wait( lock, [this]{ return _queue.size() < _cfg.readAhead || _stop ; } ) ;
+	    if( _stop ) return ;
+	    _queue.push_back( std::make_pair( file, std::move( crossing ) ) ) ;
+	    lock.unlock() ;
+	    _notEmpty.notify_all() ;
+	  }
+	} catch( ... ) {
+	  std::lock_guard<std::mutex> lock( _mutex ) ;
+	  _error = std::current_exception() ;
+	}
+	{
+	  std::lock_guard<std::mutex> lock( _mutex ) ;
+	  _done = true ;
+	}
+	_notEmpty.notify_all() ;
+      }
+
+      Config _cfg ;
+      std::mutex _mutex {} ;
+      std::condition_variable _notEmpty {}, _notFull {} ;
+      std::deque< std::pair<int,Crossing> > _queue {} ;
+      bool _done = false ;
+      bool _stop = false ;
+      std::exception_ptr _error {} ;
+      std::thread _thread {} ;
+    };
+
+    /**
+     *  Generator action that reads the particles of GuineaPig pair background files (.pair, one bunch
+     *  crossing per file) directly into a Geant4PrimaryInteraction, without converting them to LCIO.
+     *  BunchCrossings crossings are overlaid in each event, taken in the order of the files in Input or,
+     *  with RandomCrossings, drawn at random (Seed). The files are parsed by a separate thread ReadAhead
+     *  crossings in advance (see PairCrossingBuffer), so that Geant4 transports one crossing while the
+     *  next ones are parsed. As in GuineaPigToLCIO the vertices can be shifted by ZOffset and the
+     *  particles are boosted for CrossingAngleBoost (half the crossing angle, as in ddsim).
+     *  At the end of the files the run is aborted.
+     *
+     *  \ingroup DD4HEP_SIMULATION
+     */
+    class GuineaPigInputAction : public Geant4GeneratorAction {
+    public:
+      GuineaPigInputAction(Geant4Context* ctxt, const std::string& nam)
+	: Geant4GeneratorAction(ctxt,nam)
+      {
+	declareProperty("Input", m_input );
+	declareProperty("Mask", m_mask = 0 );
+	declareProperty("BunchCrossings", m_bunchCrossings = 1 );
+	declareProperty("RandomCrossings", m_randomCrossings = false );
+	declareProperty("Seed", m_seed = 0 );
+	declareProperty("ReadAhead", m_readAhead = 2 );
+	declareProperty("Threads", m_threads = 2 );
+	declareProperty("ZOffset", m_zOffset = 0. );
+	declareProperty("CrossingAngleBoost", m_crossingAngleBoost = 0. );
+	InstanceCount::increment(this);
+      }
+
+      virtual ~GuineaPigInputAction() {
+	InstanceCount::decrement(this);
+      }
+
+      /// Fill the primary interaction of the event with the particles of the next bunch crossings
+      virtual void operator()(G4Event*) override {
+
+	if( ! m_buffer ) {
+	  if( m_input.empty() ) except("no pair files given in Input");
+	  PairCrossingBuffer::Config cfg ;
+	  cfg.files = m_input ;
+	  cfg.readAhead = std::max( 1, m_readAhead ) ;
+	  cfg.threads = std::max( 1, m_threads ) ;
+	  cfg.random = m_randomCrossings ;
+	  cfg.seed = m_seed ;
+	  m_buffer = PairCrossingBuffer::open( name(), cfg ) ;
+	}
+
+	Geant4PrimaryInteraction* inter = new Geant4PrimaryInteraction();
+	inter->mask = m_mask;
+	int nCrossings = 0 ;
+	std::size_t nParticles = 0 ;
+	for( ; nCrossings < m_bunchCrossings ; ++nCrossings ) {
+	  int file = -1 ;
+	  try {
+	    if( ! m_buffer->next( m_crossing, file ) ) break ;
+	  } catch( const std::exception& e ) {
+	    delete inter ;
+	    except("%s", e.what());
+	  }
+	  nParticles += m_crossing.size() ;
+	  addCrossing( inter ) ;
+	  printout( DEBUG, name(), "%zu particles of %s", m_crossing.size(), m_input[ file ].c_str() ) ;
+	}
+
+	if( nCrossings == 0 ) {
+	  delete inter ;
+	  warning("end of the pair files reached - aborting the run");
+	  G4RunManager::GetRunManager()->AbortRun(true);
+	  return ;
+	}
+	if( nCrossings < m_bunchCrossings )
+	  warning("only %d of %d bunch crossings left in the pair files", nCrossings, m_bunchCrossings);
+
+	context()->event().extension<Geant4PrimaryEvent>()->add(m_mask, inter);
+	info("%zu particles of %d bunch crossings", nParticles, nCrossings);
+      }
+
+    private:
+
+      /// one particle with its own vertex for each particle of the crossing
+      void addCrossing( Geant4PrimaryInteraction* inter ) {
+	const double betaGamma = std::tan( m_crossingAngleBoost ) ;
+	const double gamma = std::sqrt( 1. + betaGamma * betaGamma ) ;
+	const double mass = CLHEP::electron_mass_c2 ;
+	std::vector<Geant4Vertex*>& vertices = inter->vertices[ m_mask ] ;
+	vertices.reserve( vertices.size() + m_crossing.size() ) ;
+
+	for( const lcgeo::GuineaPigParticle& gp : m_crossing ) {
+	  const double energy = std::fabs( gp.energy ) * CLHEP::GeV ;
+	  double px = gp.betaX * energy, py = gp.betaY * energy, pz = gp.betaZ * energy ;
+	  double x = gp.x * CLHEP::nanometer, y = gp.y * CLHEP::nanometer, z = gp.z * CLHEP::nanometer + m_zOffset * CLHEP::mm ;
+	  double t = 0. ;
+	  if( m_crossingAngleBoost != 0. ) {
+	    const double e = std::sqrt( px * px + py * py + pz * pz + mass * mass ) ;
+	    px = gamma * px + betaGamma * e ;
+	    t = betaGamma * x / CLHEP::c_light ;
+	    x = gamma * x ;
+	  }
+
+	  Geant4Particle* p = new Geant4Particle( inter->particles.size() ) ;
+	  p->pdgID = gp.pdg() ;
+	  p->charge = int( 3. * gp.charge() ) ;
+	  p->mass = mass ;
+	  p->genStatus = 1 ;
+	  p->status |= G4PARTICLE_GEN_STABLE ;
+	  p->mask = m_mask ;
+	  p->psx = p->pex = px ;
+	  p->psy = p->pey = py ;
+	  p->psz = p->pez = pz ;
+	  p->vsx = p->vex = x ;
+	  p->vsy = p->vey = y ;
+	  p->vsz = p->vez = z ;
+	  p->time = t ;
+	  inter->particles.insert( std::make_pair( p->id, p ) ) ;
+
+	  Geant4Vertex* v = new Geant4Vertex() ;
+	  v->x = x ;
+	  v->y = y ;
+	  v->z = z ;
+	  v->time = t ;
+	  v->mask = m_mask ;
+	  v->out.insert( p->id ) ;
+	  vertices.push_back( v ) ;
+	}
+      }
+
+      std::vector<std::string> m_input ;
+      int m_mask ;
+      int m_bunchCrossings ;
+      bool m_randomCrossings ;
+      int m_seed ;
+      int m_readAhead ;
+      int m_threads ;
+      double m_zOffset ;
+      double m_crossingAngleBoost ;
+      std::shared_ptr<PairCrossingBuffer> m_buffer ;
+      PairCrossingBuffer::Crossing m_crossing ;
+    };
+
+  } // namespace
+} // namespace
+
+
+#include "DDG4/Factories.h"
+DECLARE_GEANT4ACTION( GuineaPigInputAction )
@@ -24,7 +24,12 @@
 #include <DDRec/DetectorData.h>
 #include <DDRec/SurfaceHelper.h>
 
+#include <fnmatch.h>
+
+#include <cmath>
+
 #include <map>
+#include <regex>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -36,12 +41,101 @@ using dd4hep::PrintLevel;
 
 namespace {
 
+  /// One rule of the sorting policy: path pattern and the parameters of the linear function
+  struct SortingRule {
+    enum Kind { Substring, Glob, Regex };
+
+    std::string pattern{};
+    Kind kind = Substring;
+    std::regex regex{};
+    std::vector<double> parameters = std::vector<double>(3, 0.0);
+    int nDetElements = 0;
+    int nSurfaces = 0;
+
+    /// patterns starting with "regex:" or "glob:" are regular expressions or shell wildcards,
+    /// otherwise the pattern has to be contained in the path
+    explicit SortingRule(std::string const& argument) {
+      if (argument.compare(0, 6, "regex:") == 0) {
+        kind = Regex;
+        pattern = argument.substr(6);
+        regex = std::regex(pattern);
+      } else if (argument.compare(0, 5, "glob:") == 0) {
+        kind = Glob;
+        pattern = argument.substr(5);
+      } else {
+        pattern = argument;
+      }
+    }
+
+    bool matches(std::string const& path) const {
+      switch (kind) {
+      case Regex: return std::regex_search(path, regex);
+      case Glob:  return fnmatch(pattern.c_str(), path.c_str(), 0) == 0;
+      default:    return path.find(pattern) != std::string::npos;
+      }
+    }
+  };
+
+  typedef std::map<DetElement::Object*, std::vector<dd4hep::rec::Surface*>> SurfacesOfDetElement;
+
+  /** Find the first matching rule for the DetElement and all its daughters and set the sorting policy
+   *  of their surfaces.
+   *
+   * Rules with an index of firstSubstringMatch or above do not need to be checked: an ancestor
+   * already contains that substring rule in its path, so do all its daughters.
+   */
+  void applyRules(DetElement de, std::vector<SortingRule>& rules, SurfacesOfDetElement const& surfaces,
+                  unsigned firstSubstringMatch, std::string const& LOG_SOURCE) {
+
+    std::string const& path = de.path();
+    unsigned ruleIndex = firstSubstringMatch;
+    unsigned daughterSubstringMatch = firstSubstringMatch;
+    for (unsigned i = 0; i < firstSubstringMatch; ++i) {
+      if (not rules[i].matches(path)) continue;
+      if (ruleIndex == firstSubstringMatch) ruleIndex = i;
+      if (rules[i].kind == SortingRule::Substring) {
+        daughterSubstringMatch = i;
+        break;
+      }
+    }
+
+    auto surfs = surfaces.find(de.ptr());
+    if (ruleIndex < rules.size() and surfs != surfaces.end()) {
+      SortingRule& rule = rules[ruleIndex];
+      std::vector<double> const& parameters = rule.parameters;
+      ++rule.nDetElements;
+
+      // use existing map, or create a new one
+      auto* para = de.extension<dd4hep::rec::DoubleParameters>(false);
+      if (para == nullptr) {
+        para = new dd4hep::rec::DoubleParameters;
+        de.addExtension<dd4hep::rec::DoubleParameters>(para);
+      }
+
+      for (dd4hep::rec::Surface* surf : surfs->second) {
+        double zPosition = std::fabs(surf->origin()[2]);
+        double rValue = parameters.at(2) * (zPosition-parameters.at(0)) + parameters.at(1);
+        para->doubleParameters["SortingPolicy"] = rValue;
+        ++rule.nSurfaces;
+        printout(PrintLevel::DEBUG, LOG_SOURCE, "Added extension to %s, matching %s "
+                 " path %s, type %s, zPos %3.5f, value %3.5f",
+                 surf->volume()->GetName(), rule.pattern.c_str(), path.c_str(), de.type().c_str(),
+                 zPosition, rValue);
+      }
+    }
+
+    for (auto const& child : de.children()) {
+      applyRules(child.second, rules, surfaces, daughterSubstringMatch, LOG_SOURCE);
+    }
+  }
+
   /** Plugin for adding the SortingPolicy parameter to surface
    * 
    * The sorting policy is calculated from the z Position of the surface and a first order polynomial
    *  sp = p[2] * (zPosition - p[0]) + p[1]
    * Arguments are:
-   *  - Path indentifying the DetElement
+   *  - Path indentifying the DetElement, either a part of the path, or a regular expression
+   *    ("regex:<expression>") or a shell wildcard pattern for the full path ("glob:<pattern>")
    *  - zOffset for the function
    *  - rOffset for the function
    *  - Slope for the function
@@ -49,64 +143,47 @@ namespace {
    * any number of these four arguments can be given. The evaluation order is in the order the
    * four-tuple is provided, the first match will be used to calculate the sorting policy
    *
+   * The paths are matched once per DetElement, not per surface. The number of DetElements and
+   * surfaces set by every rule is printed.
+   *
    * @author A.Sailer, CERN
    */
   static long addSortingPolicy(dd4hep::Detector& description, int argc, char** argv) {
     const std::string LOG_SOURCE("SortingPolicyPlugin");
 
     // use a vector to keep the same order as in the arguments given
-    std::vector<std::pair<std::string, std::vector<double>>> pathToLinear;
-
-    {
-      std::string path = "";
-      for(int i=0; i<argc; ++i)  {
-        if(i % 4 == 0){
-          path = std::string(argv[i]);
-          dd4hep::printout(PrintLevel::DEBUG, LOG_SOURCE, "argument[%d]: %s", i, argv[i]);
-          pathToLinear.emplace_back(path, std::vector<double>(3, 0.0));
-        } else {
-          const int variableID = (i % 4) - 1;
-          pathToLinear.back().second[variableID] = dd4hep::_toDouble(argv[i]);
-          dd4hep::printout(PrintLevel::DEBUG, LOG_SOURCE, "argument[%d]: %s --> %3.5f", i, argv[i],
-                           pathToLinear.back().second[variableID]);
-        }
+    std::vector<SortingRule> rules;
+
+    for(int i=0; i<argc; ++i)  {
+      if(i % 4 == 0){
+        dd4hep::printout(PrintLevel::DEBUG, LOG_SOURCE, "argument[%d]: %s", i, argv[i]);
+        rules.emplace_back(std::string(argv[i]));
+      } else {
+        const int variableID = (i % 4) - 1;
+        rules.back().parameters[variableID] = dd4hep::_toDouble(argv[i]);
+        dd4hep::printout(PrintLevel::DEBUG, LOG_SOURCE, "argument[%d]: %s --> %3.5f", i, argv[i],
+                         rules.back().parameters[variableID]);
       }
     }
 
     auto world = description.world();
 
+    // group the surfaces by their DetElement, keeping their order
     dd4hep::rec::SurfaceHelper ds( world );
     dd4hep::rec::SurfaceList const& detSL = ds.surfaceList();
+    SurfacesOfDetElement surfaces;
     for(dd4hep::rec::ISurface* surf: detSL){
-      dd4hep::Volume volume = ((dd4hep::rec::Surface*)surf)->volume();
       auto* ddsurf  = ((dd4hep::rec::Surface*)surf);
-      auto const volumeName = std::string(volume->GetName());
       if(not ddsurf->detElement().isValid()) continue;
-      std::string path = ddsurf->detElement().path();
-      for (auto const& pathAndValues : pathToLinear) {
-        if(path.find(pathAndValues.first) != std::string::npos) {
-          std::vector<double> const& parameters = pathAndValues.second;
-          double zPosition = std::fabs(surf->origin()[2]);
-          double rValue = parameters.at(2) * (zPosition-parameters.at(0)) + parameters.at(1);
-
-          dd4hep::rec::DoubleParameters* para = nullptr;
-          try { // use existing map, or create a new one
-            para = ddsurf->detElement().extension<dd4hep::rec::DoubleParameters>();
-            para->doubleParameters["SortingPolicy"] = rValue;
-          } catch(...){
-            para = new dd4hep::rec::DoubleParameters;
-            para->doubleParameters["SortingPolicy"] = rValue;
-            ddsurf->detElement().addExtension<dd4hep::rec::DoubleParameters>(para);
-          }
-          printout(PrintLevel::DEBUG, LOG_SOURCE, "Added extension to %s, matching %s "
-                   " path %s, type %s, zPos %3.5f, value %3.5f",
-                   volumeName.c_str(), pathAndValues.first.c_str(),
-                   ddsurf->detElement().path().c_str(),
-                   ddsurf->detElement().type().c_str(),
-                   zPosition, para->doubleParameters["SortingPolicy"]);
-          break;
-        }
-      }// for all paths
+      surfaces[ddsurf->detElement().ptr()].push_back(ddsurf);
+    }
+
+    applyRules(world, rules, surfaces, rules.size(), LOG_SOURCE);
+
+    for (auto const& rule : rules) {
+      dd4hep::printout(rule.nSurfaces ? PrintLevel::INFO : PrintLevel::WARNING, LOG_SOURCE,
+                       "rule %-40s: %5d DetElements, %6d surfaces", rule.pattern.c_str(), rule.nDetElements,
+                       rule.nSurfaces);
     }
 
     return 0;
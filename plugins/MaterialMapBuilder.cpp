@@ -0,0 +1,230 @@
+//==========================================================================
+// iLCSoft - linear collider geometry
+//--------------------------------------------------------------------------
+//
+// For the licensing terms see lcgeo/LICENSE.
+//
+//==========================================================================
+//
+// Material Map
+//
+// Bakes the material of the tracking region into an (r,z) map, see
+// MaterialMap.h, and attaches it as extension to the world DetElement.
+// The map can be written to and read back from a file, so that it only
+// has to be made once per model.
+//
+//==========================================================================
+
+#include "MaterialMap.h"
+
+#include <DD4hep/DD4hepUnits.h>
+#include <DD4hep/DetElement.h>
+#include <DD4hep/Detector.h>
+#include <DD4hep/Factories.h>
+#include <DD4hep/Printout.h>
+
+#include <TGeoManager.h>
+#include <TGeoMaterial.h>
+#include <TGeoMedium.h>
+#include <TGeoNavigator.h>
+#include <TGeoNode.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+namespace {
+
+  const std::string LOG_SOURCE("MaterialMap");
+
+  /// average the material of every cell over nSamples x nSamples points in (r,z) and nPhi points in phi
+  void bakeMap( TGeoNavigator* nav, lcgeo::MaterialMap& map, int nSamples, int nPhi ){
+
+    const double dR = map.rMax() / map.nR(), dZ = 2. * map.zMax() / map.nZ() ;
+
+    for( int iz = 0 ; iz < map.nZ() ; ++iz ){
+      for( int ir = 0 ; ir < map.nR() ; ++ir ){
+
+	double volume = 0., mass = 0., invX0 = 0., invLambda = 0., ZoverA = 0. ;
+
+	for( int sr = 0 ; sr < nSamples ; ++sr ){
+	  // volume weight of the sample at radius r
+	  const double r = ( ir + ( sr + 0.5 ) / nSamples ) * dR ;
+	  for( int sz = 0 ; sz < nSamples ; ++sz ){
+	    const double z = map.z( iz ) + ( ( sz + 0.5 ) / nSamples - 0.5 ) * dZ ;
+	    for( int sp = 0 ; sp < nPhi ; ++sp ){
+	      const double phi = ( sp + 0.5 ) * 2. * M_PI / nPhi ;
+	      const TGeoNode* node = nav->FindNode( r * std::cos( phi ), r * std::sin( phi ), z ) ;
+	      volume += r ;
+	      if( node == nullptr ) continue ;
+	      const TGeoMaterial* mat = node->GetMedium()->GetMaterial() ;
+	      if( mat->GetDensity() <= 0. ) continue ;
+	      mass      += r * mat->GetDensity() ;
+	      invX0     += r / mat->GetRadLen() ;
+	      invLambda += r / mat->GetIntLen() ;
+	      ZoverA    += r * mat->GetDensity() * mat->GetZ() / mat->GetA() ;
+	    }
+	  }
+	}
+
+	lcgeo::MaterialMap::Cell& cell = map.cell( ir, iz ) ;
+	cell.density   = mass / volume ;
+	cell.invX0     = invX0 / volume ;
+	cell.invLambda = invLambda / volume ;
+	cell.ZoverA    = mass > 0. ? ZoverA / mass : 0. ;
+      }
+    }
+  }
+
+  /// number of radiation lengths between p0 and p1 from the navigation in the geometry
+  double exactRadiationLengths( TGeoNavigator* nav, const double* p0, const double* p1 ){
+    const double d[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] } ;
+    const double length = std::sqrt( d[0]*d[0] + d[1]*d[1] + d[2]*d[2] ) ;
+    const double dir[3] = { d[0] / length, d[1] / length, d[2] / length } ;
+    nav->InitTrack( p0, dir ) ;
+    double s = 0., x0 = 0. ;
+    for( int nSteps = 0 ; nSteps < 100000 && s < length && ! nav->IsOutside() ; ++nSteps ){
+      const TGeoMaterial* mat = nav->GetCurrentNode()->GetMedium()->GetMaterial() ;
+      nav->FindNextBoundaryAndStep( length - s ) ;
+      const double step = nav->GetStep() ;
+      s += step ;
+      if( mat->GetDensity() > 0. ) x0 += step / mat->GetRadLen() ;
+    }
+    return x0 ;
+  }
+
+  /** compare the map with the navigation for straight lines from the IP to the outer boundary of the map,
+   *  lines with less than minX0 radiation lengths are ignored
+   */
+  void validateMap( TGeoNavigator* nav, lcgeo::MaterialMap& map, int nLines, double minX0 ){
+
+    std::mt19937 rng( 4711 ) ;
+    std::uniform_real_distribution<double> uniform( 0., 1. ) ;
+
+    double sumRel = 0., maxRel = 0. ;
+    int n = 0 ;
+    for( int i = 0 ; i < nLines ; ++i ){
+      const double cosTheta = 2. * uniform( rng ) - 1. ;
+      const double sinTheta = std::sqrt( 1. - cosTheta * cosTheta ) ;
+      const double phi = 2. * M_PI * uniform( rng ) ;
+      const double dir[3] = { sinTheta * std::cos( phi ), sinTheta * std::sin( phi ), cosTheta } ;
+      const double length = std::min( sinTheta > 0. ? map.rMax() / sinTheta : 1e300,
+				       cosTheta != 0. ? map.zMax() / std::fabs( cosTheta ) : 1e300 ) * ( 1. - 1e-9 ) ;
+      const double p0[3] = { 0., 0., 0. } ;
+      const double p1[3] = { length * dir[0], length * dir[1], length * dir[2] } ;
+
+      const double exact = exactRadiationLengths( nav, p0, p1 ) ;
+      if( exact < minX0 ) continue ;
+      const double rel = std::fabs( map.radiationLengths( p0, p1 ) - exact ) / exact ;
+      sumRel += rel ;
+      maxRel = std::max( maxRel, rel ) ;
+      ++n ;
+    }
+    map.setValidation( n ? sumRel / n : 0., maxRel ) ;
+  }
+
+  /** Plugin for attaching an (r,z) material map of the tracking region to the world DetElement
+   *
+   * Arguments are:
+   *  - -nr <n>, -nz <n>:    number of cells in r and z (default: 200, 400)
+   *  - -rmax <length>, -zmax <length>: extent of the map (default: tracker_region_rmax, tracker_region_zmax)
+   *  - -samples <n>:        sample points per cell in r and z (default: 4)
+   *  - -phi <n>:            sample points in phi (default: 36)
+   *  - -validate <n>:       number of lines from the IP used to compare the map with the navigation (default: 1000)
+   *  - -write <file>:       write the map to this file
+   *  - -read <file>:        read the map from this file instead of making it, the file has to be made for
+   *                         this model and extent (and binning, if -nr and -nz are given)
+   *
+   * Usage: geoPluginRun -input compact.xml -plugin lcgeo_MaterialMap -write materialMap.bin
+   *
+   * In the reconstruction the map is available as world().extension<lcgeo::MaterialMap>()
+   */
+  static long addMaterialMap(dd4hep::Detector& description, int argc, char** argv) {
+
+    int nR = 0, nZ = 0, nSamples = 4, nPhi = 36, nValidate = 1000 ;
+    double rMax = 0., zMax = 0. ;
+    std::string inputFile, outputFile ;
+
+    for( int i = 0 ; i < argc ; ++i ){
+      const std::string arg( argv[i] ) ;
+      if( i + 1 >= argc ){
+	dd4hep::printout( dd4hep::ERROR, LOG_SOURCE, "missing value for argument %s", arg.c_str() ) ;
+	return 0 ;
+      }
+      if     ( arg == "-nr" )       nR = std::atoi( argv[++i] ) ;
+      else if( arg == "-nz" )       nZ = std::atoi( argv[++i] ) ;
+      else if( arg == "-rmax" )     rMax = dd4hep::_toDouble( argv[++i] ) ;
+      else if( arg == "-zmax" )     zMax = dd4hep::_toDouble( argv[++i] ) ;
+      else if( arg == "-samples" )  nSamples = std::atoi( argv[++i] ) ;
+      else if( arg == "-phi" )      nPhi = std::atoi( argv[++i] ) ;
+      else if( arg == "-validate" ) nValidate = std::atoi( argv[++i] ) ;
+      else if( arg == "-write" )    outputFile = argv[++i] ;
+      else if( arg == "-read" )     inputFile = argv[++i] ;
+      else {
+	dd4hep::printout( dd4hep::ERROR, LOG_SOURCE, "unknown argument %s", arg.c_str() ) ;
+	return 0 ;
+      }
+    }
+
+    if( rMax <= 0. ) rMax = description.constantAsDouble( "tracker_region_rmax" ) ;
+    if( zMax <= 0. ) zMax = description.constantAsDouble( "tracker_region_zmax" ) ;
+    const std::string model = description.header().isValid() ? description.header().name() : "" ;
+
+    lcgeo::MaterialMap* map = nullptr ;
+
+    if( ! inputFile.empty() ){
+
+      map = new lcgeo::MaterialMap( lcgeo::MaterialMap::read( inputFile ) ) ;
+      std::string reason ;
+      if( ! map->isCompatible( model, rMax, zMax, nR, nZ, reason ) ){
+	dd4hep::printout( dd4hep::ERROR, LOG_SOURCE, "cannot use the map in %s: %s", inputFile.c_str(), reason.c_str() ) ;
+	delete map ;
+	return 0 ;
+      }
+      dd4hep::printout( dd4hep::INFO, LOG_SOURCE, "read %d x %d map (r < %.1f mm, |z| < %.1f mm) of %s from %s",
+			map->nR(), map->nZ(), map->rMax() / dd4hep::mm, map->zMax() / dd4hep::mm, map->model().c_str(),
+			inputFile.c_str() ) ;
+
+    } else {
+
+      if( nR == 0 ) nR = 200 ;
+      if( nZ == 0 ) nZ = 400 ;
+      if( nR <= 0 || nZ <= 0 || nSamples <= 0 || nPhi <= 0 ){
+	dd4hep::printout( dd4hep::ERROR, LOG_SOURCE, "invalid number of cells or samples" ) ;
+	return 0 ;
+      }
+
+      TGeoNavigator* nav = description.manager().GetCurrentNavigator() ;
+      auto start = std::chrono::steady_clock::now() ;
+
+      map = new lcgeo::MaterialMap( nR, rMax, nZ, zMax ) ;
+      map->setModel( model ) ;
+      bakeMap( nav, *map, nSamples, nPhi ) ;
+      auto baked = std::chrono::steady_clock::now() ;
+
+      if( nValidate > 0 ) validateMap( nav, *map, nValidate, 1e-4 ) ;
+
+      dd4hep::printout( dd4hep::INFO, LOG_SOURCE, "made %d x %d map (r < %.1f mm, |z| < %.1f mm) in %.1f s",
+			nR, nZ, rMax / dd4hep::mm, zMax / dd4hep::mm,
+			std::chrono::duration<double>( baked - start ).count() ) ;
+    }
+
+    if( map->meanRelativeError() >= 0. )
+      dd4hep::printout( dd4hep::INFO, LOG_SOURCE, "deviation of the radiation lengths from the navigation: mean %.2f%%, max %.2f%%",
+			100. * map->meanRelativeError(), 100. * map->maxRelativeError() ) ;
+
+    if( ! outputFile.empty() ){
+      map->write( outputFile ) ;
+      dd4hep::printout( dd4hep::INFO, LOG_SOURCE, "written map to %s", outputFile.c_str() ) ;
+    }
+
+    description.world().addExtension<lcgeo::MaterialMap>( map ) ;
+
+    return 1;
+  }
+}
+
+DECLARE_APPLY(lcgeo_MaterialMap, ::addMaterialMap)
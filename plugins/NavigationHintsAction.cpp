@@ -0,0 +1,88 @@
+#include "DDG4/Geant4DetectorConstruction.h"
+#include "DDG4/Geant4GeometryInfo.h"
+#include "DD4hep/InstanceCount.h"
+#include "DD4hep/Detector.h"
+#include "G4GeometryManager.hh"
+#include "G4LogicalVolume.hh"
+
+#include "NavigationHints.h"
+
+#include <chrono>
+
+/// Namespace for the AIDA detector description toolkit
+namespace dd4hep {
+
+  /// Namespace for the Geant4 based simulation part of the AIDA detector description toolkit
+  namespace sim   {
+
+    /**
+     *  Detector construction action that applies the Geant4 navigation hints of the lcgeo drivers
+     *  (see lcgeo::NavigationHints) to the converted logical volumes, i.e. sets the smartless values
+     *  of the tagged mother volumes before Geant4 voxelises the geometry.
+     *  With the property ReportVoxels the geometry is closed once before and once after applying the
+     *  hints, Geant4 then prints the memory used by the voxels and the time needed for each closing.
+     *
+     *  \ingroup DD4HEP_SIMULATION
+     */
+    class NavigationHintsAction : public Geant4DetectorConstruction {
+    public:
+      NavigationHintsAction(Geant4Context* ctxt, const std::string& nam)
+	: Geant4DetectorConstruction(ctxt,nam)
+      {
+	declareProperty("ReportVoxels", m_reportVoxels = false );
+	InstanceCount::increment(this);
+      }
+
+      virtual ~NavigationHintsAction() {
+	InstanceCount::decrement(this);
+      }
+
+      /// Set the smartless values of the tagged volumes
+      virtual void constructGeo(Geant4DetectorConstructionContext* ctxt) override {
+
+	if( m_reportVoxels ) closeGeometry( "default smartless values" ) ;
+
+	auto& g4Volumes = ctxt->geometry->g4Volumes ;
+	int nTagged = 0, nMissing = 0 ;
+	for( const auto& c : ctxt->description.world().children() ){
+	  const lcgeo::NavigationHints* hints = c.second.extension<lcgeo::NavigationHints>( false ) ;
+	  if( ! hints ) continue ;
+	  for( const lcgeo::NavigationHints::Hint& h : hints->hints() ){
+	    auto it = g4Volumes.find( h.volume.ptr() ) ;
+	    if( it == g4Volumes.end() ){
+	      ++nMissing ;
+	      continue ;
+	    }
+	    it->second->SetSmartless( h.smartless ) ;
+	    printout( DEBUG, name(), "%s: smartless %g for %s (%s)", c.first.c_str(), h.smartless,
+		      h.volume.name(), h.kind.c_str() ) ;
+	    ++nTagged ;
+	  }
+	}
+	info( "set smartless values of %d volumes", nTagged ) ;
+	if( nMissing ) warning( "%d tagged volumes are not in the Geant4 geometry", nMissing ) ;
+
+	if( m_reportVoxels ) closeGeometry( "navigation hints" ) ;
+      }
+
+    private:
+
+      /// close and reopen the geometry - Geant4 prints the voxel statistics
+      void closeGeometry( const char* what ){
+	G4GeometryManager* manager = G4GeometryManager::GetInstance() ;
+	auto start = std::chrono::steady_clock::now() ;
+	manager->CloseGeometry( true, true ) ;
+	info( "closing the geometry with %s took %.2f s", what,
+	      std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count() ) ;
+	manager->OpenGeometry() ;
+      }
+
+      bool m_reportVoxels ;
+    };
+
+  } // namespace
+} // namespace
+
+
+#include "DDG4/Factories.h"
+DECLARE_GEANT4ACTION( NavigationHintsAction )
@@ -0,0 +1,590 @@
+//==========================================================================
+// iLCSoft - linear collider geometry
+//--------------------------------------------------------------------------
+//
+// For the licensing terms see lcgeo/LICENSE.
+//
+//==========================================================================
+//
+// Parallel Overlap Check
+//
+// Checks the geometry for overlaps and extrusions, partitioned by the
+// subdetectors (children of the world DetElement). The logical volumes of
+// all subdetectors are checked concurrently on a pool of threads. Known
+// false positives, as listed in the FalsePositiveOverlaps.txt files of the
+// models, are suppressed and the result is written as a JSON report, that
+// can be used as input for an incremental check of only the subdetectors
+// that changed.
+//
+//==========================================================================
+
+#include <DD4hep/DD4hepUnits.h>
+#include <DD4hep/DetElement.h>
+#include <DD4hep/Detector.h>
+#include <DD4hep/Factories.h>
+#include <DD4hep/Printout.h>
+
+#include <TGeoBBox.h>
+#include <TGeoBoolNode.h>
+#include <TGeoCompositeShape.h>
+#include <TGeoManager.h>
+#include <TGeoMatrix.h>
+#include <TGeoNode.h>
+#include <TGeoVolume.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+  const std::string LOG_SOURCE("ParallelOverlapCheck");
+
+  /// a placement: its logical volume, copy number and the assembly it is placed in (if any)
+  struct PlacementKey {
+    const TGeoVolume* volume = nullptr ;
+    const TGeoVolume* assembly = nullptr ;
+    int copy = 0 ;
+    bool operator<( const PlacementKey& o ) const {
+      return std::tie( volume, assembly, copy ) < std::tie( o.volume, o.assembly, o.copy ) ;
+    }
+  };
+
+  typedef std::set<std::pair<PlacementKey, PlacementKey> > FalsePositives ;
+
+  struct Overlap {
+    int subdetector = 0 ;
+    std::string mother {} ;
+    std::string volume {} ;
+    std::string other {} ;   // empty for an extrusion of the mother
+    PlacementKey volumeKey {} ;
+    PlacementKey otherKey {} ;  // no volume for an extrusion
+    double depth = 0. ;      // [cm]
+    double point[3] = { 0., 0., 0. } ; // in the frame of the mother
+    bool suppressed = false ;
+  };
+
+  struct Subdetector {
+    std::string name {} ;
+    std::uint64_t fingerprint = 0 ;
+    bool reused = false ;   // result taken from the previous report
+    long nVolumes = 0 ;
+    double time = 0. ;      // [s] summed over all threads
+    std::vector<Overlap> overlaps {} ;
+  };
+
+  struct Task {
+    TGeoVolume* volume ;
+    int subdetector ;
+  };
+
+  //--------------------------------------------------------------------------------------------
+
+  /// FNV-1a hash of the built geometry, changes when the XML or the driver of a subdetector changes
+  class Fingerprint {
+  public:
+    void add( const void* data, std::size_t n ){
+      const unsigned char* c = static_cast<const unsigned char*>( data ) ;
+      for( std::size_t i = 0 ; i < n ; ++i ){ _hash ^= c[i] ; _hash *= 1099511628211ULL ; }
+    }
+    void add( const std::string& s ){ add( s.data(), s.size() ) ; }
+    void add( double d ){ add( &d, sizeof(d) ) ; }
+    void add( const TGeoMatrix* m ){
+      if( m == nullptr ) return ;
+      for( int i = 0 ; i < 3 ; ++i ) add( m->GetTranslation()[i] ) ;
+      for( int i = 0 ; i < 9 ; ++i ) add( m->GetRotationMatrix()[i] ) ;
+    }
+    void add( const TGeoShape* s ){
+      add( std::string( s->ClassName() ) ) ;
+      const TGeoBBox* box = static_cast<const TGeoBBox*>( s ) ;
+      add( box->GetDX() ) ; add( box->GetDY() ) ; add( box->GetDZ() ) ;
+      for( int i = 0 ; i < 3 ; ++i ) add( box->GetOrigin()[i] ) ;
+      if( const TGeoCompositeShape* comp = dynamic_cast<const TGeoCompositeShape*>( s ) ){
+	const TGeoBoolNode* node = comp->GetBoolNode() ;
+	add( double( node->GetBooleanOperator() ) ) ;
+	add( node->GetLeftShape() ) ;  add( node->GetLeftMatrix() ) ;
+	add( node->GetRightShape() ) ; add( node->GetRightMatrix() ) ;
+      } else if( ! s->IsAssembly() ) {
+	add( s->Capacity() ) ;
+      }
+    }
+    void add( const TGeoVolume* vol, std::set<const TGeoVolume*>& visited ){
+      add( std::string( vol->GetName() ) ) ;
+      if( ! visited.insert( vol ).second ) return ;
+      add( vol->GetShape() ) ;
+      if( vol->GetMedium() ) add( std::string( vol->GetMedium()->GetName() ) ) ;
+      for( int i = 0, n = vol->GetNdaughters() ; i < n ; ++i ){
+	add( vol->GetNode( i )->GetMatrix() ) ;
+	add( vol->GetNode( i )->GetVolume(), visited ) ;
+      }
+    }
+    std::uint64_t value() const { return _hash ; }
+  private:
+    std::uint64_t _hash = 14695981039346656037ULL ;
+  };
+
+  //--------------------------------------------------------------------------------------------
+
+  /// placement name from the Geant4 overlap check output, for the contents of an assembly
+  /// (av_<assembly>_impr_<imprint>_<volume>_pv_<index>) the volume name and the index in the assembly
+  struct Geant4Name {
+    std::string name {} ;
+    int index = -1 ;
+    bool operator<( const Geant4Name& o ) const { return std::tie( name, index ) < std::tie( o.name, o.index ) ; }
+  };
+
+  Geant4Name geant4Name( const std::string& name ){
+    static const std::regex assembly( "^av_[0-9]+_impr_[0-9]+_(.*)_pv_([0-9]+)$" ) ;
+    std::smatch m ;
+    if( std::regex_match( name, m, assembly ) ) return { m[1], std::atoi( m[2].str().c_str() ) } ;
+    return { name, -1 } ;
+  }
+
+  /** Known false positives from the Geant4 overlap check output, as pairs of placements of this geometry.
+   *  A placement name is the name of the TGeoNode, the contents of an assembly are named after their
+   *  logical volume and their index in the assembly (the order in which the Geant4Converter adds them to
+   *  the G4AssemblyVolume). The imprint number does not identify the placement of the assembly, so the
+   *  entries apply to the contents of all placements of that assembly.
+   */
+  FalsePositives readFalsePositives( const std::string& fileName, TGeoManager* mgr ){
+    FalsePositives entries ;
+    std::ifstream in( fileName ) ;
+    if( ! in ){
+      dd4hep::printout( dd4hep::ERROR, LOG_SOURCE, "cannot read false positives from %s", fileName.c_str() ) ;
+      return entries ;
+    }
+    static const std::regex detected( ".*Overlap is detected for volume ([^ ]+).*" ) ;
+    static const std::regex withMother( ".*with its mother volume ([^ ]+).*" ) ;
+    static const std::regex withOther( ".*with ([^ ]+) volume's.*" ) ;
+    std::vector<std::pair<Geant4Name, Geant4Name> > names ;
+    std::string line, volume ;
+    std::smatch m ;
+    while( std::getline( in, line ) ){
+      if( std::regex_match( line, m, detected ) ){
+	volume = m[1] ;
+      } else if( ! volume.empty() && std::regex_match( line, m, withMother ) ){
+	names.push_back( { geant4Name( volume ), Geant4Name() } ) ;
+	volume.clear() ;
+      } else if( ! volume.empty() && std::regex_match( line, m, withOther ) ){
+	names.push_back( { geant4Name( volume ), geant4Name( m[1] ) } ) ;
+	volume.clear() ;
+      }
+    }
+
+    // the placements with these names
+    std::map<Geant4Name, std::vector<PlacementKey> > keys ;
+    for( const auto& n : names ){ keys[ n.first ] ; if( ! n.second.name.empty() ) keys[ n.second ] ; }
+    TIter next( mgr->GetListOfVolumes() ) ;
+    while( const TGeoVolume* vol = static_cast<const TGeoVolume*>( next() ) ){
+      for( int i = 0, n = vol->GetNdaughters() ; i < n ; ++i ){
+	const TGeoNode* node = vol->GetNode( i ) ;
+	const PlacementKey key { node->GetVolume(), vol->IsAssembly() ? vol : nullptr, node->GetNumber() } ;
+	auto it = keys.find( vol->IsAssembly() ? Geant4Name{ node->GetVolume()->GetName(), i } : Geant4Name{ node->GetName(), -1 } ) ;
+	if( it != keys.end() ) it->second.push_back( key ) ;
+      }
+    }
+
+    for( const auto& n : names ){
+      for( const PlacementKey& a : keys[ n.first ] ){
+	if( n.second.name.empty() ){
+	  entries.insert( { a, PlacementKey() } ) ;
+	  continue ;
+	}
+	for( const PlacementKey& b : keys[ n.second ] )
+	  entries.insert( { std::min( a, b ), std::max( a, b ) } ) ;
+      }
+      if( keys[ n.first ].empty() || ( ! n.second.name.empty() && keys[ n.second ].empty() ) )
+	dd4hep::printout( dd4hep::WARNING, LOG_SOURCE, "no placement found for the false positive %s - %s",
+			  n.first.name.c_str(), n.second.name.c_str() ) ;
+    }
+    dd4hep::printout( dd4hep::INFO, LOG_SOURCE, "read %zu known false positive overlaps (%zu pairs of placements) from %s",
+		      names.size(), entries.size(), fileName.c_str() ) ;
+    return entries ;
+  }
+
+  bool isFalsePositive( const FalsePositives& falsePositives, const Overlap& o ){
+    if( o.other.empty() ) return falsePositives.count( { o.volumeKey, PlacementKey() } ) ;
+    return falsePositives.count( { std::min( o.volumeKey, o.otherKey ), std::max( o.volumeKey, o.otherKey ) } ) ;
+  }
+
+  //--------------------------------------------------------------------------------------------
+
+  struct Daughter {
+    const TGeoNode* node ;
+    PlacementKey key ;
+    TGeoHMatrix matrix ;  // to the frame of the mother, through the assemblies in between
+    const TGeoShape* shape ;
+    double lo[3], hi[3] ; // bounding box in the frame of the mother
+  };
+
+  Daughter makeDaughter( const TGeoNode* node, const TGeoVolume* assembly, const TGeoHMatrix& matrix ){
+    Daughter d { node, { node->GetVolume(), assembly, node->GetNumber() }, matrix, node->GetVolume()->GetShape(), {}, {} } ;
+    const TGeoBBox* box = static_cast<const TGeoBBox*>( d.shape ) ;
+    const double* o = box->GetOrigin() ;
+    const double dim[3] = { box->GetDX(), box->GetDY(), box->GetDZ() } ;
+    for( int k = 0 ; k < 3 ; ++k ){ d.lo[k] = 1e300 ; d.hi[k] = -1e300 ; }
+    for( int c = 0 ; c < 8 ; ++c ){
+      double local[3], master[3] ;
+      for( int k = 0 ; k < 3 ; ++k ) local[k] = o[k] + ( ( c >> k ) & 1 ? dim[k] : -dim[k] ) ;
+      d.matrix.LocalToMaster( local, master ) ;
+      for( int k = 0 ; k < 3 ; ++k ){ d.lo[k] = std::min( d.lo[k], master[k] ) ; d.hi[k] = std::max( d.hi[k], master[k] ) ; }
+    }
+    return d ;
+  }
+
+  /// the daughters of vol, with the contents of assemblies in place of the assemblies (as TGeoChecker does)
+  void addDaughters( const TGeoVolume* vol, const TGeoHMatrix& matrix, std::vector<Daughter>& daughters ){
+    for( int i = 0, n = vol->GetNdaughters() ; i < n ; ++i ){
+      const TGeoNode* node = vol->GetNode( i ) ;
+      TGeoHMatrix m( matrix ) ;
+      m.Multiply( node->GetMatrix() ) ;
+      if( node->GetVolume()->IsAssembly() )
+	addDaughters( node->GetVolume(), m, daughters ) ;
+      else
+	daughters.push_back( makeDaughter( node, vol->IsAssembly() ? vol : nullptr, m ) ) ;
+    }
+  }
+
+  /** Check the daughters of one logical volume: random points inside every daughter have to be
+   *  inside the mother and outside of all other daughters. The contents of assemblies are checked
+   *  in the volumes the assemblies are placed in, against the real mother and its other daughters.
+   */
+  void checkVolume( TGeoVolume* vol, int subdetector, int nPoints, double tolerance, std::vector<Overlap>& result ){
+
+    // an assembly has no shape of its own, its contents are checked with its mother
+    if( vol->IsAssembly() || vol->GetNdaughters() == 0 ) return ;
+
+    const TGeoShape* motherShape = vol->GetShape() ;
+
+    std::vector<Daughter> daughters ;
+    addDaughters( vol, TGeoHMatrix(), daughters ) ;
+
+    // candidate pairs from overlapping bounding boxes (sort and sweep along x)
+    std::vector<int> sorted( daughters.size() ) ;
+    for( unsigned i = 0 ; i < sorted.size() ; ++i ) sorted[i] = i ;
+    std::sort( sorted.begin(), sorted.end(), [&]( int a, int b ){ return daughters[a].lo[0] < daughters[b].lo[0] ; } ) ;
+    std::vector<std::vector<int> > candidates( daughters.size() ) ;
+    for( unsigned a = 0 ; a < sorted.size() ; ++a ){
+      const Daughter& da = daughters[ sorted[a] ] ;
+      for( unsigned b = a + 1 ; b < sorted.size() && daughters[ sorted[b] ].lo[0] < da.hi[0] ; ++b ){
+	const Daughter& db = daughters[ sorted[b] ] ;
+	if( da.lo[1] < db.hi[1] && db.lo[1] < da.hi[1] && da.lo[2] < db.hi[2] && db.lo[2] < da.hi[2] ){
+	  candidates[ sorted[a] ].push_back( sorted[b] ) ;
+	  candidates[ sorted[b] ].push_back( sorted[a] ) ;
+	}
+      }
+    }
+
+    // reproducible results independent of the number of threads
+    std::mt19937_64 rng( std::hash<std::string>()( vol->GetName() ) ) ;
+    std::uniform_real_distribution<double> uniform( -1., 1. ) ;
+
+    // worst overlap per pair of daughters, -1 for the mother
+    std::map<std::pair<int,int>, Overlap> worst ;
+    auto record = [&]( int i, int j, double depth, const double* point ){
+      if( depth <= tolerance ) return ;
+      Overlap& o = worst[ { std::min( i, j ), std::max( i, j ) } ] ;
+      if( depth <= o.depth ) return ;
+      o.subdetector = subdetector ;
+      o.mother = vol->GetName() ;
+      o.volume = daughters[ j < 0 ? i : std::min( i, j ) ].node->GetName() ;
+      o.other = j < 0 ? "" : daughters[ std::max( i, j ) ].node->GetName() ;
+      o.volumeKey = daughters[ j < 0 ? i : std::min( i, j ) ].key ;
+      o.otherKey = j < 0 ? PlacementKey() : daughters[ std::max( i, j ) ].key ;
+      o.depth = depth ;
+      std::copy( point, point + 3, o.point ) ;
+    } ;
+
+    for( unsigned i = 0 ; i < daughters.size() ; ++i ){
+      const Daughter& d = daughters[i] ;
+
+      const TGeoBBox* box = static_cast<const TGeoBBox*>( d.shape ) ;
+      const double* o = box->GetOrigin() ;
+      int accepted = 0 ;
+      for( int trial = 0 ; trial < 100 * nPoints && accepted < nPoints ; ++trial ){
+	double local[3] = { o[0] + uniform( rng ) * box->GetDX(), o[1] + uniform( rng ) * box->GetDY(), o[2] + uniform( rng ) * box->GetDZ() } ;
+	if( ! d.shape->Contains( local ) ) continue ;
+	++accepted ;
+
+	const double inside = d.shape->Safety( local, true ) ;
+	if( inside <= tolerance ) continue ;
+
+	double master[3] ;
+	d.matrix.LocalToMaster( local, master ) ;
+
+	if( ! motherShape->Contains( master ) )
+	  record( i, -1, std::min( inside, motherShape->Safety( master, false ) ), master ) ;
+
+	for( int j : candidates[i] ){
+	  double other[3] ;
+	  daughters[j].matrix.MasterToLocal( master, other ) ;
+	  if( daughters[j].shape->Contains( other ) )
+	    record( i, j, std::min( inside, daughters[j].shape->Safety( other, true ) ), master ) ;
+	}
+      }
+    }
+
+    for( auto& w : worst ) result.push_back( w.second ) ;
+  }
+
+  /// the placement keys of an overlap taken from a previous report, found by name in its mother volume
+  void findKeys( TGeoManager* mgr, Overlap& o ){
+    const TGeoVolume* mother = mgr->GetVolume( o.mother.c_str() ) ;
+    if( mother == nullptr ) return ;
+    std::vector<Daughter> daughters ;
+    addDaughters( mother, TGeoHMatrix(), daughters ) ;
+    for( const Daughter& d : daughters ){
+      if( o.volume == d.node->GetName() ) o.volumeKey = d.key ;
+      if( o.other  == d.node->GetName() ) o.otherKey  = d.key ;
+    }
+  }
+
+  //--------------------------------------------------------------------------------------------
+
+  /// value of "key": in a single line of the JSON report written by writeReport
+  std::string jsonValue( const std::string& line, const std::string& key ){
+    std::string::size_type pos = line.find( "\"" + key + "\":" ) ;
+    if( pos == std::string::npos ) return "" ;
+    pos = line.find_first_not_of( " \"", pos + key.size() + 3 ) ;
+    std::string::size_type end = line.find_first_of( "\",}]", pos ) ;
+    return line.substr( pos, end - pos ) ;
+  }
+
+  /// subdetectors (with their overlaps) of a previous report
+  std::map<std::string, Subdetector> readReport( const std::string& fileName ){
+    std::map<std::string, Subdetector> previous ;
+    std::ifstream in( fileName ) ;
+    if( ! in ){
+      dd4hep::printout( dd4hep::WARNING, LOG_SOURCE, "cannot read previous report %s - checking all subdetectors",
+			fileName.c_str() ) ;
+      return previous ;
+    }
+    std::string line ;
+    while( std::getline( in, line ) ){
+      if( line.find( "\"fingerprint\":" ) != std::string::npos ){
+	Subdetector& s = previous[ jsonValue( line, "subdetector" ) ] ;
+	s.name = jsonValue( line, "subdetector" ) ;
+	s.fingerprint = std::strtoull( jsonValue( line, "fingerprint" ).c_str(), nullptr, 16 ) ;
+	s.nVolumes = std::atol( jsonValue( line, "volumes" ).c_str() ) ;
+      } else if( line.find( "\"depth_mm\":" ) != std::string::npos ){
+	Overlap o ;
+	o.mother = jsonValue( line, "mother" ) ;
+	o.volume = jsonValue( line, "volume" ) ;
+	o.other  = jsonValue( line, "other" ) ;
+	o.depth  = std::atof( jsonValue( line, "depth_mm" ).c_str() ) / 10. ;
+	std::istringstream point( line.substr( line.find( "\"point_mm\":" ) + 13 ) ) ;
+	char sep ;
+	point >> o.point[0] >> sep >> o.point[1] >> sep >> o.point[2] ;
+	for( double& x : o.point ) x /= 10. ;
+	previous[ jsonValue( line, "subdetector" ) ].overlaps.push_back( o ) ;
+      }
+    }
+    return previous ;
+  }
+
+  void writeReport( const std::string& fileName, const std::vector<Subdetector>& subdetectors ){
+    std::ofstream out( fileName ) ;
+    if( ! out ){
+      dd4hep::printout( dd4hep::ERROR, LOG_SOURCE, "cannot write report %s", fileName.c_str() ) ;
+      return ;
+    }
+    // one entry per line - this is what readReport() expects
+    out << "{\n  \"subdetectors\": [\n" ;
+    for( unsigned i = 0 ; i < subdetectors.size() ; ++i ){
+      const Subdetector& s = subdetectors[i] ;
+      char fingerprint[32] ;
+      std::snprintf( fingerprint, sizeof(fingerprint), "%016llx", (unsigned long long) s.fingerprint ) ;
+      out << "    { \"subdetector\": \"" << s.name << "\", \"fingerprint\": \"" << fingerprint << "\", "
+	  << "\"reused\": " << ( s.reused ? "true" : "false" ) << ", \"volumes\": " << s.nVolumes << ", "
+	  << "\"time_s\": " << s.time << " }" << ( i + 1 < subdetectors.size() ? "," : "" ) << "\n" ;
+    }
+    out << "  ],\n  \"overlaps\": [\n" ;
+    bool first = true ;
+    for( const Subdetector& s : subdetectors ){
+      for( const Overlap& o : s.overlaps ){
+	out << ( first ? "" : ",\n" )
+	    << "    { \"subdetector\": \"" << s.name << "\", \"mother\": \"" << o.mother << "\", "
+	    << "\"volume\": \"" << o.volume << "\", \"other\": \"" << o.other << "\", "
+	    << "\"type\": \"" << ( o.other.empty() ? "extrusion" : "overlap" ) << "\", "
+	    << "\"depth_mm\": " << o.depth * 10. << ", "
+	    << "\"point_mm\": [" << o.point[0] * 10. << ", " << o.point[1] * 10. << ", " << o.point[2] * 10. << "], "
+	    << "\"suppressed\": " << ( o.suppressed ? "true" : "false" ) << " }" ;
+	first = false ;
+      }
+    }
+    out << ( first ? "" : "\n" ) << "  ]\n}\n" ;
+  }
+
+  //--------------------------------------------------------------------------------------------
+
+  /** Plugin for a parallel overlap check of the geometry
+   *
+   * Every logical volume is checked once, with random points inside its daughters, and attributed
+   * to the first subdetector it is found in. The contents of assemblies are checked as daughters of
+   * the volumes the assemblies are placed in. Overlaps deeper than the tolerance are reported.
+   * Arguments are:
+   *  - -threads <n>:        number of threads (default: hardware concurrency)
+   *  - -points <n>:         number of points per daughter volume (default: 1000)
+   *  - -tolerance <length>: overlaps below are ignored (default: 1 um)
+   *  - -falsepositives <file>: FalsePositiveOverlaps.txt with known overlaps (Geant4 output format)
+   *  - -report <file>:      write the result as JSON
+   *  - -incremental <file>: report of a previous run, subdetectors whose geometry did not change
+   *                         are not checked again and their previous result is reused
+   *  - -detector <name>:    only check this subdetector, can be given several times
+   *
+   * Usage: geoPluginRun -input compact.xml -plugin lcgeo_ParallelOverlapCheck -threads 8 -report overlaps.json
+   *
+   * The return value is 0 if unsuppressed overlaps were found
+   */
+  static long parallelOverlapCheck(dd4hep::Detector& description, int argc, char** argv) {
+
+    unsigned nThreads = std::max( 1u, std::thread::hardware_concurrency() ) ;
+    int nPoints = 1000 ;
+    double tolerance = 1. * dd4hep::um ;
+    std::string falsePositivesFile, reportFile, previousFile ;
+    std::set<std::string> selected ;
+
+    for( int i = 0 ; i < argc ; ++i ){
+      const std::string arg( argv[i] ) ;
+      if( i + 1 >= argc ){
+	dd4hep::printout( dd4hep::ERROR, LOG_SOURCE, "missing value for argument %s", arg.c_str() ) ;
+	return 0 ;
+      }
+      if     ( arg == "-threads" )        nThreads = std::max( 1, std::atoi( argv[++i] ) ) ;
+      else if( arg == "-points" )         nPoints = std::atoi( argv[++i] ) ;
+      else if( arg == "-tolerance" )      tolerance = dd4hep::_toDouble( argv[++i] ) ;
+      else if( arg == "-falsepositives" ) falsePositivesFile = argv[++i] ;
+      else if( arg == "-report" )         reportFile = argv[++i] ;
+      else if( arg == "-incremental" )    previousFile = argv[++i] ;
+      else if( arg == "-detector" )       selected.insert( argv[++i] ) ;
+      else {
+	dd4hep::printout( dd4hep::ERROR, LOG_SOURCE, "unknown argument %s", arg.c_str() ) ;
+	return 0 ;
+      }
+    }
+
+    TGeoManager* mgr = &description.manager() ;
+
+    FalsePositives falsePositives ;
+    if( ! falsePositivesFile.empty() ) falsePositives = readFalsePositives( falsePositivesFile, mgr ) ;
+
+    std::map<std::string, Subdetector> previous ;
+    if( ! previousFile.empty() ) previous = readReport( previousFile ) ;
+
+    // partition the geometry by subdetector, the placements of the world volume are a separate task
+    std::vector<Subdetector> subdetectors( 1 ) ;
+    subdetectors[0].name = "world" ;
+    std::vector<Task> tasks { { description.worldVolume().ptr(), 0 } } ;
+    std::set<const TGeoVolume*> assigned { description.worldVolume().ptr() } ;
+
+    for( const auto& child : description.world().children() ){
+      if( ! selected.empty() && ! selected.count( child.first ) ) continue ;
+      dd4hep::PlacedVolume pv = child.second.placement() ;
+      if( ! pv.isValid() ) continue ;
+
+      Subdetector s ;
+      s.name = child.first ;
+      Fingerprint fp ;
+      std::set<const TGeoVolume*> visited ;
+      fp.add( pv->GetMatrix() ) ;
+      fp.add( pv.volume().ptr(), visited ) ;
+      s.fingerprint = fp.value() ;
+
+      auto prev = previous.find( s.name ) ;
+      if( prev != previous.end() && prev->second.fingerprint == s.fingerprint ){
+	s.reused = true ;
+	s.nVolumes = prev->second.nVolumes ;
+	s.overlaps = prev->second.overlaps ;
+	subdetectors.push_back( s ) ;
+	continue ;
+      }
+      for( const TGeoVolume* vol : visited ){
+	if( ! assigned.insert( vol ).second ) continue ;
+	tasks.push_back( { const_cast<TGeoVolume*>( vol ), int( subdetectors.size() ) } ) ;
+	++s.nVolumes ;
+      }
+      subdetectors.push_back( s ) ;
+    }
+    subdetectors[0].nVolumes = 1 ;
+
+    // largest volumes first for a better load balance
+    std::sort( tasks.begin(), tasks.end(), []( const Task& a, const Task& b ){
+	return a.volume->GetNdaughters() > b.volume->GetNdaughters() ; } ) ;
+
+    dd4hep::printout( dd4hep::INFO, LOG_SOURCE, "checking %zu logical volumes of %zu subdetectors with %u threads",
+		      tasks.size(), subdetectors.size(), nThreads ) ;
+
+    // the shapes keep their temporary data per thread
+    mgr->SetMaxThreads( nThreads ) ;
+
+    std::atomic<std::size_t> nextTask( 0 ) ;
+    std::mutex resultMutex ;
+    auto start = std::chrono::steady_clock::now() ;
+
+    auto worker = [&](){
+      std::vector<Overlap> overlaps ;
+      std::vector<double> times( subdetectors.size(), 0. ) ;
+      for( std::size_t t = nextTask++ ; t < tasks.size() ; t = nextTask++ ){
+	auto begin = std::chrono::steady_clock::now() ;
+	checkVolume( tasks[t].volume, tasks[t].subdetector, nPoints, tolerance, overlaps ) ;
+	times[ tasks[t].subdetector ] += std::chrono::duration<double>( std::chrono::steady_clock::now() - begin ).count() ;
+      }
+      std::lock_guard<std::mutex> lock( resultMutex ) ;
+      for( Overlap& o : overlaps ) subdetectors[ o.subdetector ].overlaps.push_back( o ) ;
+      for( unsigned i = 0 ; i < times.size() ; ++i ) subdetectors[i].time += times[i] ;
+    } ;
+
+    std::vector<std::thread> threads ;
+    for( unsigned i = 1 ; i < nThreads ; ++i ) threads.emplace_back( worker ) ;
+    worker() ;
+    for( auto& t : threads ) t.join() ;
+    mgr->ClearThreadsMap() ;
+
+    const double elapsed = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count() ;
+
+    long nOverlaps = 0, nSuppressed = 0 ;
+    for( Subdetector& s : subdetectors ){
+      std::sort( s.overlaps.begin(), s.overlaps.end(), []( const Overlap& a, const Overlap& b ){ return a.depth > b.depth ; } ) ;
+      for( Overlap& o : s.overlaps ){
+	if( s.reused ) findKeys( mgr, o ) ;
+	o.suppressed = isFalsePositive( falsePositives, o ) ;
+	if( o.suppressed ){ ++nSuppressed ; continue ; }
+	++nOverlaps ;
+	if( o.other.empty() )
+	  dd4hep::printout( dd4hep::ERROR, LOG_SOURCE, "%s: %s extrudes its mother %s by %.4g mm at (%.4g, %.4g, %.4g) mm",
+			    s.name.c_str(), o.volume.c_str(), o.mother.c_str(), o.depth / dd4hep::mm,
+			    o.point[0] / dd4hep::mm, o.point[1] / dd4hep::mm, o.point[2] / dd4hep::mm ) ;
+	else
+	  dd4hep::printout( dd4hep::ERROR, LOG_SOURCE, "%s: %s overlaps with %s in %s by %.4g mm at (%.4g, %.4g, %.4g) mm",
+			    s.name.c_str(), o.volume.c_str(), o.other.c_str(), o.mother.c_str(), o.depth / dd4hep::mm,
+			    o.point[0] / dd4hep::mm, o.point[1] / dd4hep::mm, o.point[2] / dd4hep::mm ) ;
+      }
+      dd4hep::printout( dd4hep::INFO, LOG_SOURCE, "%-30s %6ld volumes %8.2f s %s", s.name.c_str(), s.nVolumes, s.time,
+			s.reused ? "(unchanged, previous result)" : "" ) ;
+    }
+
+    dd4hep::printout( nOverlaps ? dd4hep::ERROR : dd4hep::INFO, LOG_SOURCE,
+		      "%ld overlaps found (%ld known false positives suppressed) in %.1f s", nOverlaps, nSuppressed, elapsed ) ;
+
+    if( ! reportFile.empty() ) writeReport( reportFile, subdetectors ) ;
+
+    return nOverlaps ? 0 : 1 ;
+  }
+}
+
+DECLARE_APPLY(lcgeo_ParallelOverlapCheck, ::parallelOverlapCheck)
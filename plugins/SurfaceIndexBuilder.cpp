@@ -0,0 +1,67 @@
+//==========================================================================
+// iLCSoft - linear collider geometry
+//--------------------------------------------------------------------------
+//
+// For the licensing terms see lcgeo/LICENSE.
+//
+//==========================================================================
+//
+// Surface Index
+//
+// Builds a bounding volume hierarchy over all DDRec surfaces of the
+// geometry, see SurfaceIndex.h, and attaches it as extension to the world
+// DetElement.
+//
+//==========================================================================
+
+#include "SurfaceIndex.h"
+
+#include <DD4hep/DetElement.h>
+#include <DD4hep/Detector.h>
+#include <DD4hep/Factories.h>
+#include <DD4hep/Printout.h>
+
+#include <DDRec/SurfaceHelper.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+  /** Plugin for attaching a spatial index over all surfaces to the world DetElement
+   *
+   * Arguments are:
+   *  - -leafsize <n>: maximal number of surfaces in a leaf of the tree (default: 4)
+   *
+   * Usage: geoPluginRun -input compact.xml -plugin lcgeo_SurfaceIndex
+   *
+   * In the reconstruction the index is available as world().extension<lcgeo::SurfaceIndex>()
+   */
+  static long addSurfaceIndex(dd4hep::Detector& description, int argc, char** argv) {
+    const std::string LOG_SOURCE("SurfaceIndexPlugin");
+
+    unsigned leafSize = 4 ;
+    for( int i = 0 ; i < argc ; ++i ){
+      if( std::string( argv[i] ) == "-leafsize" && i + 1 < argc )
+	leafSize = std::max( 1, std::atoi( argv[++i] ) ) ;
+    }
+
+    auto start = std::chrono::steady_clock::now() ;
+
+    dd4hep::rec::SurfaceHelper ds( description.world() ) ;
+    const dd4hep::rec::SurfaceList& surfaces = ds.surfaceList() ;
+    std::vector<dd4hep::rec::ISurface*> surfaceVec( surfaces.begin(), surfaces.end() ) ;
+
+    lcgeo::SurfaceIndex* index = new lcgeo::SurfaceIndex( surfaceVec, leafSize ) ;
+    description.world().addExtension<lcgeo::SurfaceIndex>( index ) ;
+
+    dd4hep::printout( dd4hep::INFO, LOG_SOURCE, "indexed %zu surfaces in %zu nodes in %.2f s", index->size(), index->nodes(),
+		      std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count() ) ;
+    return 1;
+  }
+}
+
+DECLARE_APPLY(lcgeo_SurfaceIndex, ::addSurfaceIndex)
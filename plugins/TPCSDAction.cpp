@@ -1,8 +1,15 @@
 #include "DDG4/Geant4SensDetAction.inl"
 #include "DDG4/Geant4EventAction.h"
 #include "DDG4/Geant4Mapping.h"
+#include "DDRec/Surface.h"
 #include "G4OpticalPhoton.hh"
+#include "G4VPhysicalVolume.hh"
 #include "G4VProcess.hh"
+#include "TGeoTube.h"
+
+#include <cmath>
+#include <unordered_map>
+#include <vector>
 
 /// Namespace for the AIDA detector description toolkit
 namespace dd4hep {
@@ -15,6 +22,9 @@ namespace dd4hep {
      *  of a TPC, where every pad row is devided into two halfs in order to get
      *  the position from the crossing of the middle of the pad row from
      *  geant4 via volume boundary. Ported of Mokka/TPCSD04.cc
+     *  If a pad row is a single volume (TPC10 with TPC_pad_row_doublets="false"),
+     *  the crossing of the pad-row centre, taken from the radius of the surface of
+     *  the pad row, is computed within the step instead.
      * 
      *  \author  F.Gaede ( ported from Mokka/TPCSD04.cc )
      *  \version 1.0
@@ -57,6 +67,11 @@ namespace dd4hep {
       G4int CurrentTrackID{}; //< the TrackID of the particle causing the cumulative energy deposit
       G4double CurrentGlobalTime{}; ///< the global time of the track causing the cumulative energy deposit
       G4int CurrentCopyNumber{}; ///< copy number of the preStepPoint's TouchableHandle for the cumulative energy deposit
+
+      std::vector<double> padRowCentre{}; ///< radius of the centre of each pad row (layer), 0 if not known
+      std::vector<char> singleVolumeRow{}; ///< true if the pad row (layer) is one volume, the centre lies inside it
+      bool anySingleVolumeRow{}; ///< false for the doublets of half rings, then the per-step lookups are skipped
+      std::unordered_map<const G4VPhysicalVolume*, int> layerOfVolume{}; ///< layer of the pad-row volumes seen so far
       
 
       TPCSDData() : 
@@ -128,6 +143,66 @@ namespace dd4hep {
 
 
 
+      /** the radii of the pad-row centres from the surfaces of the pad-row DetElements below det, and whether
+       *  the centre lies inside the volume of the DetElement (one volume per pad row) or on its boundary
+       *  (the upper half of a doublet of half rings)
+       */
+      void findPadRowCentres( DetElement det ) {
+	for( const auto& c : det.children() ) {
+	  DetElement child = c.second ;
+	  const rec::VolSurfaceList* surfaces = child.extension<rec::VolSurfaceList>( false ) ;
+	  if( surfaces && ! surfaces->empty() ) {
+	    const int layer = layerField->value( child.volumeID() ) ;
+	    if( layer >= int( padRowCentre.size() ) ) {
+	      padRowCentre.resize( layer + 1, 0. ) ;
+	      singleVolumeRow.resize( layer + 1, false ) ;
+	    }
+	    const double rc = surfaces->front().origin().rho() ;
+	    padRowCentre[ layer ] = rc / dd4hep::mm * CLHEP::mm ;
+	    const TGeoTube* tube = dynamic_cast<const TGeoTube*>( child.volume().solid().ptr() ) ;
+	    const double tolerance = 1e-3 * dd4hep::mm ;
+	    singleVolumeRow[ layer ] = tube && rc > tube->GetRmin() + tolerance && rc < tube->GetRmax() - tolerance ;
+	    anySingleVolumeRow = anySingleVolumeRow || singleVolumeRow[ layer ] ;
+	  }
+	  findPadRowCentres( child ) ;
+	}
+      }
+
+      /// the layer of the pre-step volume if it is a whole pad row, -1 otherwise - looked up once per volume
+      int singleVolumePadRow( G4Step* s ) {
+	const G4VPhysicalVolume* pv = s->GetPreStepPoint()->GetPhysicalVolume() ;
+	auto it = layerOfVolume.find( pv ) ;
+	if( it == layerOfVolume.end() ) {
+	  const int layer = getCopyNumber( s, false ) ;
+	  const bool single = layer >= 0 && layer < int( singleVolumeRow.size() ) && singleVolumeRow[ layer ] ;
+	  it = layerOfVolume.emplace( pv, single ? layer : -1 ).first ;
+	}
+	return it->second ;
+      }
+
+      /// record the point where the step crosses the cylinder of radius rc, if it does
+      void recordCrossingInStep( G4Step* s, double rc ) {
+	const G4StepPoint* pre = s->GetPreStepPoint() ;
+	const G4StepPoint* post = s->GetPostStepPoint() ;
+	const G4ThreeVector p0 = pre->GetPosition() ;
+	const G4ThreeVector d = post->GetPosition() - p0 ;
+	const double r0 = p0.perp(), r1 = post->GetPosition().perp() ;
+	if( ( r0 - rc ) * ( r1 - rc ) > 0. || r0 == r1 ) return ;
+	// |p0 + t d|_xy = rc for t in [0,1]
+	const double a = d.x() * d.x() + d.y() * d.y() ;
+	const double b = 2. * ( p0.x() * d.x() + p0.y() * d.y() ) ;
+	const double c = r0 * r0 - rc * rc ;
+	const double disc = b * b - 4. * a * c ;
+	if( a <= 0. || disc < 0. ) return ;
+	const double sq = std::sqrt( disc ) ;
+	double t = ( -b + sq ) / ( 2. * a ) ;
+	if( t < 0. || t > 1. ) t = ( -b - sq ) / ( 2. * a ) ;
+	if( t < 0. || t > 1. ) return ;
+	CrossingOfPadRingCentre = p0 + t * d ;
+	MomentumAtPadRingCentre = ( 1. - t ) * pre->GetMomentum() + t * post->GetMomentum() ;
+	globalTimeAtPadRingCentre = ( 1. - t ) * pre->GetGlobalTime() + t * post->GetGlobalTime() ;
+      }
+
       /// Method for generating hit(s) using the information of G4Step object.
       G4bool process(G4Step* step, G4TouchableHistory* ) {
 
@@ -161,13 +236,18 @@ namespace dd4hep {
 
 	if( ptSQRD >= (Control.TPCLowPtCut*Control.TPCLowPtCut) ){
 
+	  // one volume per pad row: the centre is crossed inside the volume, not on a boundary
+	  const int singleLayer = anySingleVolumeRow ? singleVolumePadRow( step ) : -1 ;
+	  const bool singleVolume = singleLayer >= 0 ;
+	  if( singleVolume ) recordCrossingInStep( step, padRowCentre[ singleLayer ] ) ;
+
 	  //=========================================================================================================
 	  // Step finishes at a geometric boundry
 
 	  if(step->GetPostStepPoint()->GetStepStatus() == fGeomBoundary) {
 
 	    // step within the same pair of upper and lower pad ring halves
-	    if( getCopyNumber( step, false ) == getCopyNumber( step, true ) ){
+	    if( ! singleVolume && getCopyNumber( step, false ) == getCopyNumber( step, true ) ){
 
 	      //this step must have ended on the boundry between these two pad ring halfs 
 	      //record the tracks coordinates at this position 
@@ -484,6 +564,7 @@ namespace dd4hep {
 
       IDDescriptor dsc = m_sensitive.idSpec() ;
       m_userData.layerField = dsc.field( "layer" ) ;
+      m_userData.findPadRowCentres( m_detector ) ;
 
     }
 
@@ -0,0 +1,282 @@
+#include "DDG4/Geant4GeneratorAction.h"
+#include "DDG4/Geant4OutputAction.h"
+#include "DDG4/Geant4Context.h"
+#include "DDG4/Geant4Data.h"
+#include "DDG4/Geant4HitCollection.h"
+#include "DDG4/Geant4Particle.h"
+#include "DDG4/Geant4Primary.h"
+#include "DDG4/Geant4Vertex.h"
+#include "DD4hep/InstanceCount.h"
+#include "CLHEP/Units/SystemOfUnits.h"
+#include "G4Event.hh"
+#include "G4HCofThisEvent.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4ParticleTable.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4Run.hh"
+#include "G4RunManager.hh"
+
+#include "BeamProfile.h"
+
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+/// Namespace for the AIDA detector description toolkit
+namespace dd4hep {
+
+  /// Namespace for the Geant4 based simulation part of the AIDA detector description toolkit
+  namespace sim   {
+
+    /// the energy point of the current run: the runs of a scan are numbered from zero
+    static int currentEnergyPoint( const Geant4Action& action, const std::vector<double>& energies ) {
+      const G4Run* run = G4RunManager::GetRunManager()->GetCurrentRun();
+      const int point = run ? run->GetRunID() : 0;
+      if( energies.empty() ) action.except("no energy points given in Energies");
+      if( point < 0 || point >= int( energies.size() ) )
+	action.except("run %d is not one of the %d energy points", point, int( energies.size() ));
+      return point;
+    }
+
+    /**
+     *  Generator action for the test beam scans of TestBeamScan: one particle per event with the energy
+     *  of the current energy point, one point per run (run n uses Energies[n], in GeV), drawn from the
+     *  beam profile (see lcgeo::BeamProfile): Profile gaussian or flat with the centre MeanX, MeanY and
+     *  widths WidthX, WidthY at Z (mm), the divergences DivergenceX, DivergenceY (rad) and the relative
+     *  EnergySpread. The beam of an event only depends on Seed, the point and the event number, not on
+     *  the thread that simulates it.
+     *
+     *  \ingroup DD4HEP_SIMULATION
+     */
+    class TestBeamGun : public Geant4GeneratorAction {
+    public:
+      TestBeamGun(Geant4Context* ctxt, const std::string& nam)
+	: Geant4GeneratorAction(ctxt,nam)
+      {
+	declareProperty("Particle", m_particle = "pi+" );
+	declareProperty("Energies", m_energies );
+	declareProperty("Mask", m_mask = 0 );
+	declareProperty("Profile", m_profile = "gaussian" );
+	declareProperty("MeanX", m_beam.meanX = 0. );
+	declareProperty("MeanY", m_beam.meanY = 0. );
+	declareProperty("WidthX", m_beam.widthX = 0. );
+	declareProperty("WidthY", m_beam.widthY = 0. );
+	declareProperty("Z", m_beam.z = 0. );
+	declareProperty("DivergenceX", m_beam.divergenceX = 0. );
+	declareProperty("DivergenceY", m_beam.divergenceY = 0. );
+	declareProperty("EnergySpread", m_beam.energySpread = 0. );
+	declareProperty("Seed", m_seed = 0 );
+	InstanceCount::increment(this);
+      }
+
+      virtual ~TestBeamGun() {
+	InstanceCount::decrement(this);
+      }
+
+      /// Fill the primary interaction of the event with one beam particle
+      virtual void operator()(G4Event* event) override {
+
+	const G4ParticleDefinition* def = G4ParticleTable::GetParticleTable()->FindParticle(m_particle);
+	if( ! def ) except("unknown particle %s", m_particle.c_str());
+	try {
+	  m_beam.shape = lcgeo::BeamProfile::shapeOf( m_profile ) ;
+	} catch( const std::exception& e ) {
+	  except("%s", e.what());
+	}
+	m_beam.seed = m_seed ;
+
+	const int point = currentEnergyPoint( *this, m_energies );
+	const lcgeo::BeamParticle beam = m_beam.sample( m_energies[point], point, event->GetEventID() );
+
+	const double mass = def->GetPDGMass();
+	const double energy = beam.energy * CLHEP::GeV + mass;
+	const double momentum = std::sqrt( energy * energy - mass * mass );
+
+	Geant4PrimaryInteraction* inter = new Geant4PrimaryInteraction();
+	inter->mask = m_mask;
+	Geant4Particle* p = new Geant4Particle(0);
+	p->pdgID = def->GetPDGEncoding();
+	p->charge = int( 3. * def->GetPDGCharge() );
+	p->mass = mass;
+	p->genStatus = 1;
+	p->status |= G4PARTICLE_GEN_STABLE;
+	p->mask = m_mask;
+	p->psx = p->pex = momentum * beam.dx;
+	p->psy = p->pey = momentum * beam.dy;
+	p->psz = p->pez = momentum * beam.dz;
+	p->vsx = p->vex = beam.x * CLHEP::mm;
+	p->vsy = p->vey = beam.y * CLHEP::mm;
+	p->vsz = p->vez = beam.z * CLHEP::mm;
+	p->time = 0.;
+	inter->particles.insert( std::make_pair( p->id, p ) );
+
+	Geant4Vertex* v = new Geant4Vertex();
+	v->x = p->vsx;
+	v->y = p->vsy;
+	v->z = p->vsz;
+	v->time = 0.;
+	v->mask = m_mask;
+	v->out.insert( p->id );
+	inter->vertices[ m_mask ].push_back( v );
+
+	context()->event().extension<Geant4PrimaryEvent>()->add(m_mask, inter);
+	printout( DEBUG, name(), "%s of %g GeV at (%g,%g) mm", m_particle.c_str(), beam.energy, beam.x, beam.y );
+      }
+
+    private:
+      std::string m_particle ;
+      std::vector<double> m_energies ;
+      int m_mask ;
+      std::string m_profile ;
+      int m_seed ;
+      lcgeo::BeamProfile m_beam ;
+    };
+
+
+    /**
+     *  Text file of the events of one energy point, shared by all output actions writing to the same file
+     *  name (e.g. the worker threads). The file is created by the first writer, with a header naming the
+     *  columns, and appended to if it is opened again in the same process.
+     */
+    class TestBeamPointFile {
+    public:
+      static std::shared_ptr<TestBeamPointFile> open( const std::string& fileName ) {
+	static std::mutex mutex ;
+	static std::map< std::string, std::weak_ptr<TestBeamPointFile> > files ;
+	static std::set<std::string> created ;
+	std::lock_guard<std::mutex> lock( mutex ) ;
+	std::shared_ptr<TestBeamPointFile> file = files[ fileName ].lock() ;
+	if( ! file ) {
+	  const bool append = ! created.insert( fileName ).second ;
+	  file.reset( new TestBeamPointFile( fileName, append ) ) ;
+	  files[ fileName ] = file ;
+	}
+	return file ;
+      }
+
+      /// one line per event, the header with the collection names before the first one
+      void write( const std::string& collections, const std::string& line ) {
+	std::lock_guard<std::mutex> lock( _mutex ) ;
+	if( ! _header ) {
+	  _out << "# event energy[GeV] x[mm] y[mm] dx dy" << collections << "\n" ;
+	  _header = true ;
+	}
+	_out << line << "\n" ;
+      }
+
+      bool good() const { return _out.good() ; }
+
+    private:
+      TestBeamPointFile( const std::string& fileName, bool append )
+	: _out( fileName, append ? std::ios::app : std::ios::trunc ), _header( append ) {}
+      std::mutex _mutex {} ;
+      std::ofstream _out ;
+      bool _header ;
+    };
+
+    /**
+     *  Output action for the test beam scans of TestBeamScan: instead of the hits, one line per event is
+     *  written to the file of the energy point of the run (Output with the energy of Energies[run] in GeV
+     *  inserted before the extension, e.g. scan_10GeV.txt) with the energy and start of the beam particle
+     *  and, for each hit collection, the sum of the deposited energies in GeV and the number of hits.
+     *  That is what energy scans (response, linearity, resolution) need, in files of a few kB per point.
+     *
+     *  \ingroup DD4HEP_SIMULATION
+     */
+    class TestBeamScanOutput : public Geant4OutputAction {
+    public:
+      TestBeamScanOutput(Geant4Context* ctxt, const std::string& nam)
+	: Geant4OutputAction(ctxt,nam)
+      {
+	declareProperty("Energies", m_energies );
+	InstanceCount::increment(this);
+      }
+
+      virtual ~TestBeamScanOutput() {
+	InstanceCount::decrement(this);
+      }
+
+      /// the file of the energy point is opened with the first event of the run
+      virtual void beginRun(const G4Run*) override {
+	m_file.reset();
+      }
+
+      /// release the file, it is closed when the last thread is done with it
+      virtual void endRun(const G4Run*) override {
+	m_file.reset();
+      }
+
+      /// the beam particle of the event
+      virtual void saveEvent(OutputContext<G4Event>& ctxt) override {
+	const G4Event* event = ctxt.context;
+	m_columns.clear();
+	m_line.str("");
+	m_line << event->GetEventID();
+	const G4PrimaryVertex* vertex = event->GetPrimaryVertex(0);
+	const G4PrimaryParticle* particle = vertex ? vertex->GetPrimary(0) : 0;
+	if( particle ) {
+	  const G4ThreeVector dir = particle->GetMomentumDirection();
+	  m_line << " " << particle->GetKineticEnergy() / CLHEP::GeV
+		 << " " << vertex->GetX0() / CLHEP::mm << " " << vertex->GetY0() / CLHEP::mm
+		 << " " << dir.x() << " " << dir.y();
+	} else {
+	  m_line << " 0 0 0 0 0";
+	}
+      }
+
+      /// energy sum and number of hits of a collection
+      virtual void saveCollection(OutputContext<G4Event>&, G4VHitsCollection* collection) override {
+	Geant4HitCollection* coll = dynamic_cast<Geant4HitCollection*>(collection);
+	if( ! coll ) return;
+	const std::size_t nhits = coll->GetSize();
+	const std::type_info& type = coll->type().type();
+	double energy = 0.;
+	if( type == typeid(Geant4Calorimeter::Hit) ) {
+	  for( std::size_t i = 0; i < nhits; ++i ) {
+	    const Geant4Calorimeter::Hit* hit = coll->hit(i);
+	    energy += hit->energyDeposit;
+	  }
+	} else if( type == typeid(Geant4Tracker::Hit) ) {
+	  for( std::size_t i = 0; i < nhits; ++i ) {
+	    const Geant4Tracker::Hit* hit = coll->hit(i);
+	    energy += hit->energyDeposit;
+	  }
+	}
+	m_columns += " " + coll->GetName() + "_E[GeV] " + coll->GetName() + "_nHits";
+	m_line << " " << energy / CLHEP::GeV << " " << nhits;
+      }
+
+      /// write the line of the event
+      virtual void commit(OutputContext<G4Event>&) override {
+	if( ! m_file ) {
+	  const int point = currentEnergyPoint( *this, m_energies );
+	  const std::string fileName = lcgeo::energyPointFileName( m_output, m_energies[point] );
+	  m_file = TestBeamPointFile::open( fileName );
+	  if( ! m_file->good() ) except("cannot write %s", fileName.c_str());
+	  info("writing the events of %g GeV to %s", m_energies[point], fileName.c_str());
+	}
+	m_file->write( m_columns, m_line.str() );
+      }
+
+    private:
+      std::vector<double> m_energies ;
+      std::shared_ptr<TestBeamPointFile> m_file ;
+      std::string m_columns ;
+      std::stringstream m_line ;
+    };
+
+  } // namespace
+} // namespace
+
+
+#include "DDG4/Factories.h"
+DECLARE_GEANT4ACTION( TestBeamGun )
+DECLARE_GEANT4ACTION( TestBeamScanOutput )
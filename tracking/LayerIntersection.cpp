@@ -0,0 +1,328 @@
+//==========================================================================
+// iLCSoft - linear collider geometry
+//--------------------------------------------------------------------------
+//
+// For the licensing terms see lcgeo/LICENSE.
+//
+//==========================================================================
+//
+// Layer Intersection
+//
+// Tables of the tracker layers in ZPlanarData and ZDiskPetalsData and the
+// batched intersection of straight tracks with them, see
+// LayerIntersection.h.
+//
+// The kernels loop over the tracks of a batch for one layer at a time,
+// reading the structure of arrays of the tracks and writing the one of the
+// hits. The ladder or petal closest in phi and its two neighbours are the
+// candidates: the per layer tables of their normals are padded with copies,
+// so that the candidates are read without wrapping the index, and the best
+// one is kept with conditional assignments. The loop bodies have no
+// branches, gcc vectorises both kernels at -O3 with AVX2 (-march=x86-64-v3,
+// checked with -fopt-info-vec). This needs -fno-math-errno, with which the
+// library is built, otherwise std::sqrt is a call with a branch for the
+// errno, and the IVDEP loops as the hit arrays cannot alias the tables.
+// There are no explicit SIMD intrinsics and only straight tracks.
+//
+//==========================================================================
+
+#include "LayerIntersection.h"
+#include "LcgeoExceptions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+  /// ladder or petal number k wrapped into [0,n), also for n = 1 and 2 where the neighbours wrap more than once
+  inline int wrap( int k, int n ){
+    k %= n ;
+    return k < 0 ? k + n : k ;
+  }
+
+  /// phi0 moved to [-pi,pi), the ladder or petal guessed from phi in [-pi,pi] is then in [-n,n]
+  inline double normalisedPhi( double phi0 ){
+    return phi0 - 2. * M_PI * std::floor( ( phi0 + M_PI ) / ( 2. * M_PI ) ) ;
+  }
+
+  /// the padded tables of a layer with n ladders or petals have the entries k in [-n-2,2n+2]: the guessed
+  /// one and its neighbours are in [-n-2,n+2], so that they are read without wrapping k, the last entry
+  /// is the one of a miss, with the index -1
+  inline int padding( int n ){
+    return n + 2 ;
+  }
+
+  /// the entry of a miss in the padded tables
+  inline int missEntry( int n ){
+    return n + padding( n ) ;
+  }
+
+  /// the ladder or petal closest in phi, clamped to [-n-1,n+1] against rounding and NaN - floor is
+  /// done by truncation of the shifted positive value
+  inline int guess( double phi, double phi0, double invDphi, int n ){
+    const double k = std::min( double( n + 1 ), std::max( double( -n - 1 ), ( phi - phi0 ) * invDphi + 0.5 ) ) ;
+    return int( k + ( n + 2 ) ) - ( n + 2 ) ;
+  }
+
+  /// atan2 without branches and library call, absolute error below 1e-5 - only used to select the
+  /// ladder or petal, which is then checked exactly
+  inline double fastAtan2( double y, double x ){
+    const double ax = std::fabs( x ), ay = std::fabs( y ) ;
+    // pi/2 - atan( ay / ax ) = pi/4 - atan( a ) with a in [-1,1], the quadrant from the signs of x and y
+    const double a = ( ay - ax ) / ( ay + ax + std::numeric_limits<double>::min() ) ;
+    const double a2 = a * a ;
+    const double q = 0.25 * M_PI - a * ( 0.99997726 + a2 * ( -0.33262347 + a2 * ( 0.19354346 + a2 * ( -0.11643287
+		 + a2 * ( 0.05265332 + a2 * -0.01172120 ) ) ) ) ) ;
+    return std::copysign( 0.5 * M_PI - std::copysign( q, x ), y ) ;
+  }
+}
+
+// the tracks of a batch and the hits cannot overlap the tables of the layers
+#if defined(__clang__)
+#define IVDEP _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__)
+#define IVDEP _Pragma("GCC ivdep")
+#else
+#define IVDEP
+#endif
+
+namespace lcgeo {
+
+  PlanarLayerTable::PlanarLayerTable( const dd4hep::rec::ZPlanarData& data ){
+
+    const std::size_t n = data.layers.size() ;
+    _nLadders.reserve( n ) ; _phi0.reserve( n ) ; _invDphi.reserve( n ) ;
+    _distance.reserve( n ) ; _offset.reserve( n ) ; _halfWidth.reserve( n ) ; _zHalf.reserve( n ) ;
+    _first.reserve( n ) ;
+
+    for( const auto& l : data.layers ){
+      if( l.ladderNumber <= 0 )
+	throw GeometryException( "PlanarLayerTable: layer without ladders in ZPlanarData" ) ;
+
+      const double dphi = 2. * M_PI / l.ladderNumber ;
+      _nLadders.push_back( l.ladderNumber ) ;
+      _phi0.push_back( normalisedPhi( l.phi0 ) ) ;
+      _invDphi.push_back( 1. / dphi ) ;
+      _distance.push_back( l.distanceSensitive + 0.5 * l.thicknessSensitive ) ;
+      _offset.push_back( l.offsetSensitive ) ;
+      _halfWidth.push_back( 0.5 * l.widthSensitive ) ;
+      _zHalf.push_back( l.zHalfSensitive ) ;
+
+      _first.push_back( _cos.size() + padding( l.ladderNumber ) ) ;
+      for( int k = -padding( l.ladderNumber ) ; k <= missEntry( l.ladderNumber ) ; ++k ){
+	const int ladder = wrap( k, l.ladderNumber ) ;
+	_index.push_back( k == missEntry( l.ladderNumber ) ? -1 : ladder ) ;
+	_cos.push_back( std::cos( l.phi0 + ladder * dphi ) ) ;
+	_sin.push_back( std::sin( l.phi0 + ladder * dphi ) ) ;
+      }
+    }
+  }
+
+  void PlanarLayerTable::intersect( const RayBatch& rays, LayerHits& hits ) const {
+
+    const std::size_t nTracks = rays.size() ;
+    hits.resize( size(), nTracks ) ;
+
+    const double* ox = rays.x.data() ;
+    const double* oy = rays.y.data() ;
+    const double* oz = rays.z.data() ;
+    const double* dx = rays.dx.data() ;
+    const double* dy = rays.dy.data() ;
+    const double* dz = rays.dz.data() ;
+    const double inf = std::numeric_limits<double>::infinity() ;
+
+    for( std::size_t l = 0 ; l < size() ; ++l ){
+
+      const int n = _nLadders[l] ;
+      const double phi0 = _phi0[l], invDphi = _invDphi[l] ;
+      const double d = _distance[l], offset = _offset[l], halfWidth = _halfWidth[l], zHalf = _zHalf[l] ;
+      const double* indexTable = _index.data() + _first[l] ;
+      const double* cosTable = _cos.data() + _first[l] ;
+      const double* sinTable = _sin.data() + _first[l] ;
+
+      int* index = hits.index.data() + l * nTracks ;
+      double* hx = hits.x.data() + l * nTracks ;
+      double* hy = hits.y.data() + l * nTracks ;
+      double* hz = hits.z.data() + l * nTracks ;
+      double* hs = hits.s.data() + l * nTracks ;
+      double* he = hits.edge.data() + l * nTracks ;
+
+      IVDEP
+      for( std::size_t i = 0 ; i < nTracks ; ++i ){
+
+	// the ladder closest in phi to the crossing with the cylinder of radius d
+	const double a = dx[i] * dx[i] + dy[i] * dy[i] ;
+	const double b = ox[i] * dx[i] + oy[i] * dy[i] ;
+	const double c = ox[i] * ox[i] + oy[i] * oy[i] - d * d ;
+	const double disc = std::max( b * b - a * c, 0. ) ;
+	const double sc = ( -b + std::sqrt( disc ) ) / std::max( a, std::numeric_limits<double>::min() ) ;
+	const double phi = fastAtan2( oy[i] + sc * dy[i], ox[i] + sc * dx[i] ) ;
+	const int k0 = guess( phi, phi0, invDphi, n ) ;
+
+	// the first of this ladder and its neighbours that contains the crossing with its plane
+	int bestK = missEntry( n ) ;
+	double bestS = inf, bestEdge = -inf, closestEdge = -inf ;
+	for( int k = k0 - 1 ; k <= k0 + 1 ; ++k ){
+	  const double cn = cosTable[k], sn = sinTable[k] ;
+	  const double un = cn * dx[i] + sn * dy[i] ;
+	  const double s = ( d - cn * ox[i] - sn * oy[i] ) / un ;
+	  const double px = ox[i] + s * dx[i], py = oy[i] + s * dy[i], pz = oz[i] + s * dz[i] ;
+	  const double v = cn * py - sn * px ;
+	  const double edge = std::min( halfWidth - std::fabs( v - offset ), zHalf - std::fabs( pz ) ) ;
+	  // quiet comparisons, they are evaluated also for NaN from un = 0
+	  const bool crossing = std::isgreater( un, 0. ) & std::isgreater( s, 0. ) ;
+	  const bool better = crossing & std::isgreaterequal( edge, 0. ) & std::isless( s, bestS ) ;
+	  const bool closer = crossing & std::isgreater( edge, closestEdge ) ;
+	  bestK = better ? k : bestK ;
+	  bestS = better ? s : bestS ;
+	  bestEdge = better ? edge : bestEdge ;
+	  closestEdge = closer ? edge : closestEdge ;
+	}
+
+	const bool found = bestS < inf ;
+	const double s = found ? bestS : 0. ;
+	index[i] = int( indexTable[bestK] ) ;
+	he[i] = found ? bestEdge : closestEdge ;
+	hs[i] = s ;
+	hx[i] = ox[i] + s * dx[i] ;
+	hy[i] = oy[i] + s * dy[i] ;
+	hz[i] = oz[i] + s * dz[i] ;
+      }
+    }
+  }
+
+
+  DiskLayerTable::DiskLayerTable( const dd4hep::rec::ZDiskPetalsData& data, bool reflected ){
+
+    if( data.layers.empty() ) return ;
+    _nDataLayers = data.layers.size() ;
+
+    const std::size_t n = ( reflected ? 2 : 1 ) * _nDataLayers ;
+    _nPetals.reserve( n ) ; _phi0.reserve( n ) ; _invDphi.reserve( n ) ; _z.reserve( n ) ; _zOffset.reserve( n ) ;
+    _rMin.reserve( n ) ; _rMax.reserve( n ) ; _halfWidthInner.reserve( n ) ; _halfWidthOuter.reserve( n ) ;
+    _sinHalf.reserve( n ) ; _cosHalf.reserve( n ) ; _first.reserve( n ) ;
+
+    for( int sign : { 1, -1 } ){
+      if( sign < 0 && ! reflected ) break ;
+      for( const auto& l : data.layers ){
+	const int nPetals = std::max( l.petalNumber, 1 ) ;
+	_nPetals.push_back( nPetals ) ;
+	_phi0.push_back( normalisedPhi( l.phi0 ) ) ;
+	_invDphi.push_back( nPetals / ( 2. * M_PI ) ) ;
+	_z.push_back( sign * l.zPosition ) ;
+	_zOffset.push_back( sign * l.zOffsetSensitive ) ;
+	_rMin.push_back( l.distanceSensitive ) ;
+	_rMax.push_back( l.distanceSensitive + l.lengthSensitive ) ;
+	_halfWidthInner.push_back( 0.5 * l.widthInnerSensitive ) ;
+	_halfWidthOuter.push_back( 0.5 * l.widthOuterSensitive ) ;
+	_sinHalf.push_back( std::sin( M_PI / nPetals ) ) ;
+	_cosHalf.push_back( std::cos( M_PI / nPetals ) ) ;
+
+	_first.push_back( _cos.size() + padding( nPetals ) ) ;
+	for( int k = -padding( nPetals ) ; k <= missEntry( nPetals ) ; ++k ){
+	  const int petal = wrap( k, nPetals ) ;
+	  _index.push_back( k == missEntry( nPetals ) ? -1 : petal ) ;
+	  _zSign.push_back( petal % 2 ? -1. : 1. ) ;
+	  _cos.push_back( std::cos( l.phi0 + petal * 2. * M_PI / nPetals ) ) ;
+	  _sin.push_back( std::sin( l.phi0 + petal * 2. * M_PI / nPetals ) ) ;
+	}
+      }
+    }
+  }
+
+  void DiskLayerTable::intersect( const RayBatch& rays, LayerHits& hits ) const {
+
+    const std::size_t nTracks = rays.size() ;
+    hits.resize( size(), nTracks ) ;
+
+    const double* ox = rays.x.data() ;
+    const double* oy = rays.y.data() ;
+    const double* oz = rays.z.data() ;
+    const double* dx = rays.dx.data() ;
+    const double* dy = rays.dy.data() ;
+    const double* dz = rays.dz.data() ;
+    const double inf = std::numeric_limits<double>::infinity() ;
+
+    for( std::size_t l = 0 ; l < size() ; ++l ){
+
+      const int n = _nPetals[l] ;
+      const double phi0 = _phi0[l], invDphi = _invDphi[l] ;
+      const double z0 = _z[l], zOffset = _zOffset[l] ;
+      const double rMin = _rMin[l], rMax = _rMax[l] ;
+      const double hwInner = _halfWidthInner[l], hwOuter = _halfWidthOuter[l] ;
+      const double hwSlope = rMax > rMin ? ( hwOuter - hwInner ) / ( rMax - rMin ) : 0. ;
+      // the radial coordinate u is the distance from the axis along the petal for a trapezoid and the
+      // radius for a ring sector, the side distance is side0 + sideSlope * ( u - rMin ) + sideAlong * along
+      // - sideV * |v|, for a single petal that is not a trapezoid, the full ring, larger than any radial one
+      const bool trapezoid = hwOuter > 0. ;
+      const bool fullRing = ! trapezoid && n == 1 ;
+      const double uAlong = trapezoid ? 1. : 0., uRadius = trapezoid ? 0. : 1. ;
+      const double side0 = trapezoid ? hwInner : fullRing ? rMax - rMin : 0. ;
+      const double sideSlope = trapezoid ? hwSlope : 0. ;
+      const double sideAlong = trapezoid || fullRing ? 0. : _sinHalf[l] ;
+      const double sideV = trapezoid ? 1. : fullRing ? 0. : _cosHalf[l] ;
+      const double* indexTable = _index.data() + _first[l] ;
+      const double* zSignTable = _zSign.data() + _first[l] ;
+      const double* cosTable = _cos.data() + _first[l] ;
+      const double* sinTable = _sin.data() + _first[l] ;
+
+      int* index = hits.index.data() + l * nTracks ;
+      double* hx = hits.x.data() + l * nTracks ;
+      double* hy = hits.y.data() + l * nTracks ;
+      double* hz = hits.z.data() + l * nTracks ;
+      double* hs = hits.s.data() + l * nTracks ;
+      double* he = hits.edge.data() + l * nTracks ;
+
+      IVDEP
+      for( std::size_t i = 0 ; i < nTracks ; ++i ){
+
+	// the petal closest in phi to the crossing with the plane of the layer
+	const bool crossing = dz[i] != 0. ;
+	const double invDz = 1. / dz[i] ; // infinite for tracks in the plane, which are not crossing
+	const double s0 = ( z0 - oz[i] ) * invDz ;
+	const double phi = fastAtan2( oy[i] + s0 * dy[i], ox[i] + s0 * dx[i] ) ;
+	const int k0 = guess( phi, phi0, invDphi, n ) ;
+
+	// the first of this petal and its neighbours that contains the crossing with its plane,
+	// the position of the closest petal for a miss
+	int bestK = missEntry( n ) ;
+	double bestS = inf, bestEdge = -inf, bestZ = z0 ;
+	double closestS = 0., closestEdge = -inf, closestZ = z0 ;
+	for( int k = k0 - 1 ; k <= k0 + 1 ; ++k ){
+	  const double zk = z0 + zSignTable[k] * zOffset ;
+	  const double s = ( zk - oz[i] ) * invDz ;
+	  const double px = ox[i] + s * dx[i], py = oy[i] + s * dy[i] ;
+
+	  const double cn = cosTable[k], sn = sinTable[k] ;
+	  const double along = cn * px + sn * py ;
+	  const double v = cn * py - sn * px ;
+	  const double u = uAlong * along + uRadius * std::sqrt( px * px + py * py ) ;
+	  const double side = side0 + sideSlope * ( u - rMin ) + sideAlong * along - sideV * std::fabs( v ) ;
+	  const double edge = std::min( std::min( u - rMin, rMax - u ), side ) ;
+	  const bool valid = crossing & std::isgreater( s, 0. ) ;
+
+	  const bool better = valid & std::isgreaterequal( edge, 0. ) & std::isless( s, bestS ) ;
+	  const bool closer = valid & std::isgreater( edge, closestEdge ) ;
+	  bestK = better ? k : bestK ;
+	  bestS = better ? s : bestS ;
+	  bestEdge = better ? edge : bestEdge ;
+	  bestZ = better ? zk : bestZ ;
+	  closestS = closer ? s : closestS ;
+	  closestEdge = closer ? edge : closestEdge ;
+	  closestZ = closer ? zk : closestZ ;
+	}
+
+	const bool found = bestS < inf ;
+	const double s = found ? bestS : closestS ;
+	index[i] = int( indexTable[bestK] ) ;
+	he[i] = found ? bestEdge : closestEdge ;
+	hs[i] = s ;
+	hx[i] = ox[i] + s * dx[i] ;
+	hy[i] = oy[i] + s * dy[i] ;
+	hz[i] = found ? bestZ : closestZ ;
+      }
+    }
+  }
+
+}